@@ -386,6 +386,18 @@ Crit3DDate getDateFromJulianDay(long julianDay)
 }
 
 
+Crit3DSerialDate::Crit3DSerialDate(const Crit3DDate& myDate)
+{
+    julianDay = getJulianDay(myDate.day, myDate.month, myDate.year);
+}
+
+
+Crit3DDate Crit3DSerialDate::toDate() const
+{
+    return getDateFromJulianDay(julianDay);
+}
+
+
 std::string Crit3DDate::toISOString() const
 {
     char myStr[11];
@@ -53,6 +53,42 @@
     };
 
 
+    // compact date: serial day number (julian day)
+    // daysTo, addDays and comparisons are integer operations (long loops on daily series)
+    class Crit3DSerialDate
+    {
+    public:
+        long julianDay;
+
+        Crit3DSerialDate() { julianDay = 0; }
+        explicit Crit3DSerialDate(const Crit3DDate& myDate);
+
+        static Crit3DSerialDate fromJulianDay(long myJulianDay)
+        {
+            Crit3DSerialDate myDate;
+            myDate.julianDay = myJulianDay;
+            return myDate;
+        }
+
+        Crit3DDate toDate() const;
+
+        bool isNullDate() const { return julianDay == 0; }
+
+        Crit3DSerialDate addDays(long offset) const { return fromJulianDay(julianDay + offset); }
+        int daysTo(const Crit3DSerialDate& newDate) const { return int(newDate.julianDay - julianDay); }
+
+        Crit3DSerialDate& operator ++ () { ++julianDay; return *this; }
+        Crit3DSerialDate& operator -- () { --julianDay; return *this; }
+
+        bool operator == (const Crit3DSerialDate& other) const { return julianDay == other.julianDay; }
+        bool operator != (const Crit3DSerialDate& other) const { return julianDay != other.julianDay; }
+        bool operator <  (const Crit3DSerialDate& other) const { return julianDay < other.julianDay; }
+        bool operator <= (const Crit3DSerialDate& other) const { return julianDay <= other.julianDay; }
+        bool operator >  (const Crit3DSerialDate& other) const { return julianDay > other.julianDay; }
+        bool operator >= (const Crit3DSerialDate& other) const { return julianDay >= other.julianDay; }
+    };
+
+
     class Crit3DTime
     {
     public:
@@ -927,16 +927,18 @@ int CriteriaOutputProject::createAggregationFile(bool isReorder)
     logger.writeInfo("Reference shape to raster...");
     gis::Crit3DRasterGrid rasterRef;
     initializeRasterFromShape(shapeRef, rasterRef, cellSize);
-    fillRasterWithShapeNumber(rasterRef, shapeRef);
+    fillRasterWithShapeNumber(rasterRef, shapeRef, true);
+    Crit3DZoneIndex refIndex;
+    refIndex.build(rasterRef, shapeRef.getShapeCount());
 
     logger.writeInfo("Values shape to raster...");
     gis::Crit3DRasterGrid rasterVal;
     initializeRasterFromShape(shapeVal, rasterVal, cellSize);
-    fillRasterWithShapeNumber(rasterVal, shapeVal);
+    fillRasterWithShapeNumber(rasterVal, shapeVal, true);
 
     logger.writeInfo("Matrix Analysis...");
     std::vector <int> vectorNull;
-    std::vector <std::vector<int> > matrix = computeMatrixAnalysis(shapeRef, shapeVal, rasterRef, rasterVal, vectorNull);
+    std::vector <std::vector<int> > matrix = computeMatrixAnalysis(refIndex, shapeVal, rasterVal, vectorNull, true);
 
     bool isOk = false;
     for(int i=0; i < aggregationVariable.outputVarName.size(); i++)
@@ -1081,7 +1083,7 @@ bool CriteriaOutputProject::convertShapeToNetcdf(Crit3DShapeHandler &shapeHandle
 
     // rasterize shape
     gis::Crit3DRasterGrid tmpRaster;
-    if (! rasterizeShape(shapeHandler, tmpRaster, field, cellSize))
+    if (! rasterizeShape(shapeHandler, tmpRaster, field, cellSize, true))
     {
         projectError = "Error in rasterize shape.";
         return false;
@@ -1874,6 +1874,113 @@ bool Crit3DMeteoGridDbHandler::loadGridDailyData(QString &errorStr, const QStrin
 }
 
 
+/*!
+ * \brief loadGridDailyDataPoints
+ * loads all the daily variables of a list of points (copies of grid cells: the table is given by the id),
+ * the data loaded on the grid are not modified.
+ * The daily tables are read with UNION ALL queries of MAX_TABLES_QUERY tables, the points without data are left empty.
+ */
+bool Crit3DMeteoGridDbHandler::loadGridDailyDataPoints(QString &errorStr, std::vector<Crit3DMeteoPoint> &pointList,
+                                                       const QDate &firstDate, const QDate &lastDate)
+{
+    // SQLite default limit of the terms of a compound select is 500
+    const unsigned int MAX_TABLES_QUERY = 100;
+
+    errorStr = "";
+
+    int numberOfDays = firstDate.daysTo(lastDate) + 1;
+    for (unsigned int i = 0; i < pointList.size(); i++)
+    {
+        pointList[i].initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+    }
+
+    if (_firstDailyDate.isValid() && _lastDailyDate.isValid())
+    {
+        if (_firstDailyDate.year() != 1800 && _lastDailyDate.year() != 1800)
+        {
+            if (firstDate > _lastDailyDate || lastDate < _firstDailyDate)
+                return true;
+        }
+    }
+
+    bool isFixedFields = _gridStructure.isFixedFields();
+    QString fieldList;
+    if (isFixedFields)
+    {
+        for (unsigned int j = 0; j < _tableDaily.varcode.size(); j++)
+        {
+            fieldList += ", `" + _tableDaily.varcode[j].varField + "`";
+        }
+    }
+    else
+    {
+        fieldList = ", `VariableCode`, `Value`";
+    }
+
+    QSqlQuery qry(_db);
+    for (unsigned int firstPoint = 0; firstPoint < pointList.size(); firstPoint += MAX_TABLES_QUERY)
+    {
+        unsigned int lastPoint = std::min(firstPoint + MAX_TABLES_QUERY, unsigned(pointList.size()));
+
+        QList<QString> selectList;
+        for (unsigned int i = firstPoint; i < lastPoint; i++)
+        {
+            QString tableD = _tableDaily.prefix + QString::fromStdString(pointList[i].id) + _tableDaily.postFix;
+            selectList.append(QString("SELECT %1 AS PointIndex, `%2`%3 FROM `%4` WHERE `%2` >= '%5' AND `%2` <= '%6'")
+                                  .arg(i).arg(_tableDaily.fieldTime, fieldList, tableD,
+                                               firstDate.toString("yyyy-MM-dd"), lastDate.toString("yyyy-MM-dd")));
+        }
+
+        if (! qry.exec(selectList.join(" UNION ALL ")))
+        {
+            errorStr = qry.lastError().text();
+            return false;
+        }
+
+        int varCode;
+        float value;
+        QDate date;
+        while (qry.next())
+        {
+            unsigned int i = qry.value(0).toUInt();
+            if (i >= pointList.size() || ! getValue(qry.value(1), &date))
+            {
+                errorStr = "Missing " + _tableDaily.fieldTime;
+                return false;
+            }
+            Crit3DDate myDate = getCrit3DDate(date);
+
+            if (isFixedFields)
+            {
+                for (unsigned int j = 0; j < _tableDaily.varcode.size(); j++)
+                {
+                    if (getValue(qry.value(int(j) + 2), &value))
+                    {
+                        pointList[i].setMeteoPointValueD(myDate, getDailyVarEnum(_tableDaily.varcode[j].varCode), value);
+                    }
+                }
+            }
+            else
+            {
+                if (! getValue(qry.value(3), &value))
+                    continue;
+
+                if (! getValue(qry.value(2), &varCode))
+                {
+                    errorStr = "Missing VariableCode";
+                    return false;
+                }
+
+                pointList[i].setMeteoPointValueD(myDate, getDailyVarEnum(varCode), value);
+            }
+        }
+        qry.clear();
+    }
+
+    return true;
+}
+
+
 bool Crit3DMeteoGridDbHandler::loadGridDailyMeteoPrec(QString &errorStr, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate)
 {
     errorStr = "";
@@ -2935,17 +3042,26 @@ bool Crit3DMeteoGridDbHandler::saveCellGridDailyData(QString &errorStr, const QS
     {
         statement =  QString(("REPLACE INTO `%1` VALUES")).arg(tableD);
 
+        const Crit3DMeteoPoint &meteoPoint = meteoGrid()->meteoPoint(row, col);
+
+        // day index of firstDate and date strings: computed once for all the variables
+        int nrDays = firstDate.daysTo(lastDate) + 1;
+        int firstIndex = Crit3DSerialDate(meteoPoint.getFirstDailyData()).daysTo(getSerialDate(firstDate));
+        QList<QString> dateStrList;
+        for (int i = 0; i < nrDays; i++)
+            dateStrList.append(firstDate.addDays(i).toString("yyyy-MM-dd"));
+
         foreach (meteoVariable meteoVar, meteoVariableList)
             if (getVarFrequency(meteoVar) == daily)
             {
                 int varCode = getDailyVarCode(meteoVar);
-                for (QDate date = firstDate; date <= lastDate; date = date.addDays(1))
+                for (int i = 0; i < nrDays; i++)
                 {
-                    float value = meteoGrid()->meteoPoint(row, col).getMeteoPointValueD(getCrit3DDate(date), meteoVar, meteoSettings);
+                    float value = meteoPoint.getMeteoPointValueD(firstIndex + i, meteoVar, meteoSettings);
                     QString valueS = QString("'%1'").arg(double(value));
                     if (isEqual(value, NODATA)) valueS = "NULL";
 
-                    statement += QString(" ('%1','%2',%3),").arg(date.toString("yyyy-MM-dd")).arg(varCode).arg(valueS);
+                    statement += QString(" ('%1','%2',%3),").arg(dateStrList[i]).arg(varCode).arg(valueS);
                 }
             }
 
@@ -2982,18 +3098,26 @@ bool Crit3DMeteoGridDbHandler::deleteAndWriteCellGridDailyData(QString &errorStr
 
     statement =  QString(("INSERT INTO `%1` VALUES")).arg(tableD);
 
+    const Crit3DMeteoPoint &meteoPoint = meteoGrid()->meteoPoint(row, col);
+
+    int nrDays = firstDate.daysTo(lastDate) + 1;
+    int firstIndex = Crit3DSerialDate(meteoPoint.getFirstDailyData()).daysTo(getSerialDate(firstDate));
+    QList<QString> dateStrList;
+    for (int i = 0; i < nrDays; i++)
+        dateStrList.append(firstDate.addDays(i).toString("yyyy-MM-dd"));
+
     foreach (meteoVariable meteoVar, meteoVariableList)
     {
         if (getVarFrequency(meteoVar) == daily)
         {
             int varCode = getDailyVarCode(meteoVar);
-            for (QDate date = firstDate; date <= lastDate; date = date.addDays(1))
+            for (int i = 0; i < nrDays; i++)
             {
-                float value = meteoGrid()->meteoPoint(row, col).getMeteoPointValueD(getCrit3DDate(date), meteoVar, meteoSettings);
+                float value = meteoPoint.getMeteoPointValueD(firstIndex + i, meteoVar, meteoSettings);
                 QString valueS = QString("'%1'").arg(double(value));
                 if (isEqual(value, NODATA)) valueS = "NULL";
 
-                statement += QString(" ('%1','%2',%3),").arg(date.toString("yyyy-MM-dd")).arg(varCode).arg(valueS);
+                statement += QString(" ('%1','%2',%3),").arg(dateStrList[i]).arg(varCode).arg(valueS);
             }
         }
     }
@@ -3027,12 +3151,14 @@ bool Crit3DMeteoGridDbHandler::saveCellGridDailyDataEnsemble(QString &errorStr,
     {
         statement =  QString(("REPLACE INTO `%1` (%2, VariableCode, Value, MemberNr) VALUES ")).arg(tableD, _tableDaily.fieldTime);
 
+        const Crit3DMeteoPoint &meteoPoint = meteoGrid()->meteoPoint(row, col);
         foreach (meteoVariable meteoVar, meteoVariableList)
             if (getVarFrequency(meteoVar) == daily)
             {
-                for (QDate date = firstDate; date <= lastDate; date = date.addDays(1))
+                int dayIndex = meteoPoint.getFirstDailyData().daysTo(getCrit3DDate(firstDate));
+                for (QDate date = firstDate; date <= lastDate; date = date.addDays(1), dayIndex++)
                 {
-                    float value = meteoGrid()->meteoPoint(row, col).getMeteoPointValueD(getCrit3DDate(date), meteoVar, meteoSettings);
+                    float value = meteoPoint.getMeteoPointValueD(dayIndex, meteoVar, meteoSettings);
                     QString valueS = QString("'%1'").arg(value);
                     if (isEqual(value, NODATA)) valueS = "NULL";
 
@@ -3407,13 +3533,22 @@ bool Crit3DMeteoGridDbHandler::saveCellGridDailyDataFF(QString &errorStr, const
     {
         statement =  QString(("REPLACE INTO `%1` VALUES")).arg(tableD);
         int nrDays = firstDate.daysTo(lastDate) + 1;
+        const Crit3DMeteoPoint &meteoPoint = meteoGrid()->meteoPoint(row, col);
+        int firstIndex = meteoPoint.getFirstDailyData().daysTo(getCrit3DDate(firstDate));
+
+        std::vector<meteoVariable> varList;
+        for (unsigned int j = 0; j < _tableDaily.varcode.size(); j++)
+        {
+            varList.push_back(getDailyVarFieldEnum(_tableDaily.varcode[j].varField));
+        }
+
         for (int i = 0; i < nrDays; i++)
         {
             QDate date = firstDate.addDays(i);
             statement += QString(" ('%1',").arg(date.toString("yyyy-MM-dd"));
-            for (unsigned int j = 0; j < _tableDaily.varcode.size(); j++)
+            for (unsigned int j = 0; j < varList.size(); j++)
             {
-                float value = meteoGrid()->meteoPoint(row,col).getMeteoPointValueD(getCrit3DDate(date), getDailyVarFieldEnum(_tableDaily.varcode[j].varField), meteoSettings);
+                float value = meteoPoint.getMeteoPointValueD(firstIndex + i, varList[j], meteoSettings);
 
                 QString valueS = QString("'%1'").arg(value);
                 if (value == NODATA)
@@ -3584,21 +3719,15 @@ bool Crit3DMeteoGridDbHandler::saveCellCurrentGridDailyFF(QString& errorStr, QSt
 bool Crit3DMeteoGridDbHandler::saveCellGridMonthlyData(QString &errorStr, const QString &meteoPointID, int row, int col,
                                                        QDate firstDate, QDate lastDate, const QList<meteoVariable> &meteoVariableList)
 {
-    QSqlQuery qry(_db);
-    QString table = "MonthlyData";
-
-    QString statement = QString("CREATE TABLE IF NOT EXISTS `%1`"
-                                "(PragaYear smallint(4) UNSIGNED, PragaMonth tinyint(2) UNSIGNED, PointCode VARCHAR(6), "
-                                "VariableCode tinyint(3) UNSIGNED, Value float(6,1), PRIMARY KEY(PragaYear,PragaMonth,PointCode,VariableCode))").arg(table);
-
-    if(! qry.exec(statement))
+    if (! createMonthlyTable(errorStr))
     {
-        errorStr = qry.lastError().text();
         return false;
     }
     else
     {
-        statement =  QString(("REPLACE INTO `%1` VALUES")).arg(table);
+        QSqlQuery qry(_db);
+        QString table = "MonthlyData";
+        QString statement =  QString(("REPLACE INTO `%1` VALUES")).arg(table);
 
         // set day=1 to better comparison
         firstDate.setDate(firstDate.year(),firstDate.month(),1);
@@ -3634,6 +3763,199 @@ bool Crit3DMeteoGridDbHandler::saveCellGridMonthlyData(QString &errorStr, const
 }
 
 
+bool Crit3DMeteoGridDbHandler::createMonthlyTable(QString &errorStr)
+{
+    QSqlQuery qry(_db);
+    QString statement = QString("CREATE TABLE IF NOT EXISTS `MonthlyData`"
+                                "(PragaYear smallint(4) UNSIGNED, PragaMonth tinyint(2) UNSIGNED, PointCode VARCHAR(6), "
+                                "VariableCode tinyint(3) UNSIGNED, Value float(6,1), PRIMARY KEY(PragaYear,PragaMonth,PointCode,VariableCode))");
+
+    if(! qry.exec(statement))
+    {
+        errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief saveGridMonthlyData
+ * saves the monthly data of a list of points (copies of grid cells) in a single transaction, with multi-row REPLACE statements.
+ * pointVariableList is indexed as pointList: the points with an empty list are skipped
+ */
+bool Crit3DMeteoGridDbHandler::saveGridMonthlyData(QString &errorStr, QDate firstDate, QDate lastDate, const std::vector<Crit3DMeteoPoint> &pointList,
+                                                   const std::vector<QList<meteoVariable>> &pointVariableList)
+{
+    const int MAX_ROWS_STATEMENT = 10000;
+
+    if (! createMonthlyTable(errorStr))
+        return false;
+
+    // set day=1 to better comparison
+    firstDate.setDate(firstDate.year(), firstDate.month(), 1);
+    lastDate.setDate(lastDate.year(), lastDate.month(), 1);
+
+    QSqlQuery qry(_db);
+    QString insertStr = "REPLACE INTO `MonthlyData` VALUES";
+    QString statement = insertStr;
+    int nrRows = 0;
+
+    _db.transaction();
+
+    for (unsigned int i = 0; i < pointList.size() && i < pointVariableList.size(); i++)
+    {
+        if (pointVariableList[i].isEmpty())
+            continue;
+
+        const Crit3DMeteoPoint &meteoPoint = pointList[i];
+        QString meteoPointID = QString::fromStdString(meteoPoint.id);
+
+        foreach (meteoVariable meteoVar, pointVariableList[i])
+        {
+            if (getVarFrequency(meteoVar) != monthly)
+                continue;
+
+            int varCode = getMonthlyVarCode(meteoVar);
+
+            for (QDate date = firstDate; date <= lastDate; date = date.addMonths(1))
+            {
+                float value = meteoPoint.getMeteoPointValueM(getCrit3DDate(date), meteoVar);
+                QString valueStr = QString("'%1'").arg(value);
+
+                if (isEqual(value, NODATA))
+                    valueStr = "NULL";
+
+                statement += QString(" (%1,%2,'%3','%4',%5),").arg(date.year()).arg(date.month()).arg(meteoPointID).arg(varCode).arg(valueStr);
+                nrRows++;
+            }
+
+            if (nrRows >= MAX_ROWS_STATEMENT)
+            {
+                statement = statement.left(statement.length() - 1);
+                if (! qry.exec(statement))
+                {
+                    errorStr = qry.lastError().text();
+                    _db.rollback();
+                    return false;
+                }
+                statement = insertStr;
+                nrRows = 0;
+            }
+        }
+    }
+
+    if (nrRows > 0)
+    {
+        statement = statement.left(statement.length() - 1);
+        if (! qry.exec(statement))
+        {
+            errorStr = qry.lastError().text();
+            _db.rollback();
+            return false;
+        }
+    }
+
+    if (! _db.commit())
+    {
+        errorStr = _db.lastError().text();
+        _db.rollback();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::createUpdatedDailyPeriodTable(QString &errorStr)
+{
+    QSqlQuery qry(_db);
+    QString statement = QString("CREATE TABLE IF NOT EXISTS `UpdatedDailyPeriod`"
+                                "(PeriodId tinyint(1) UNSIGNED, FirstDate DATE, LastDate DATE, PRIMARY KEY(PeriodId))");
+
+    if(! qry.exec(statement))
+    {
+        errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief getUpdatedDailyPeriod
+ * period of the daily data saved on the whole grid since the last clear,
+ * firstDate and lastDate are not valid if no data have been saved
+ */
+bool Crit3DMeteoGridDbHandler::getUpdatedDailyPeriod(QDate &firstDate, QDate &lastDate, QString &errorStr)
+{
+    firstDate = QDate();
+    lastDate = QDate();
+
+    if (! createUpdatedDailyPeriodTable(errorStr))
+        return false;
+
+    QSqlQuery qry(_db);
+    if (! qry.exec("SELECT FirstDate, LastDate FROM `UpdatedDailyPeriod` WHERE PeriodId = 1"))
+    {
+        errorStr = qry.lastError().text();
+        return false;
+    }
+
+    if (qry.next())
+    {
+        getValue(qry.value(0), &firstDate);
+        getValue(qry.value(1), &lastDate);
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoGridDbHandler::clearUpdatedDailyPeriod(QString &errorStr)
+{
+    if (! createUpdatedDailyPeriodTable(errorStr))
+        return false;
+
+    QSqlQuery qry(_db);
+    if (! qry.exec("DELETE FROM `UpdatedDailyPeriod`"))
+    {
+        errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+// extends the stored period of the updated daily data (monthly aggregation of the updated months)
+bool Crit3DMeteoGridDbHandler::addUpdatedDailyPeriod(const QDate &firstDate, const QDate &lastDate, QString &errorStr)
+{
+    QDate firstUpdatedDate, lastUpdatedDate;
+    if (! getUpdatedDailyPeriod(firstUpdatedDate, lastUpdatedDate, errorStr))
+        return false;
+
+    if (! firstUpdatedDate.isValid() || firstDate < firstUpdatedDate)
+        firstUpdatedDate = firstDate;
+
+    if (! lastUpdatedDate.isValid() || lastDate > lastUpdatedDate)
+        lastUpdatedDate = lastDate;
+
+    QSqlQuery qry(_db);
+    QString statement = QString("REPLACE INTO `UpdatedDailyPeriod` VALUES (1,'%1','%2')")
+                            .arg(firstUpdatedDate.toString("yyyy-MM-dd"), lastUpdatedDate.toString("yyyy-MM-dd"));
+    if (! qry.exec(statement))
+    {
+        errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
 bool Crit3DMeteoGridDbHandler::saveGridData(QString &errorStr, const QDateTime &firstTime,
                                             const QDateTime &lastTime, QList<meteoVariable> meteoVariableList,
                                             Crit3DMeteoSettings *meteoSettings)
@@ -3673,6 +3995,9 @@ bool Crit3DMeteoGridDbHandler::saveGridData(QString &errorStr, const QDateTime &
         }
     }
 
+    if (isDaily)
+        return addUpdatedDailyPeriod(firstTime.date(), lastDate, errorStr);
+
     return true;
 }
 
@@ -3727,7 +4052,7 @@ bool Crit3DMeteoGridDbHandler::saveGridDailyData(QString &errorStr, const QDateT
         }
     }
 
-    return true;
+    return addUpdatedDailyPeriod(firstDate.date(), lastDate.date(), errorStr);
 }
 
 
@@ -4331,8 +4656,8 @@ bool Crit3DMeteoGridDbHandler::exportDailyDataCsv(const QList<meteoVariable> &va
     {
         for (int col = 0; col < gridStructure().header().nrCols; col++)
         {
-            QString id = QString::fromStdString(meteoGrid()->meteoPoints()[row][col]->id);
-            if (idList.contains(id) || (! isList && meteoGrid()->meteoPoints()[row][col]->active))
+            QString id = QString::fromStdString(meteoGrid()->meteoPointPointer(row, col)->id);
+            if (idList.contains(id) || (! isList && meteoGrid()->meteoPointPointer(row, col)->active))
             {
                 // read data
                 if (gridStructure().isEnsemble())
@@ -4465,8 +4790,8 @@ bool Crit3DMeteoGridDbHandler::exportHourlyDataCsv(const QList<meteoVariable> &v
     {
         for (int col = 0; col < gridStructure().header().nrCols; col++)
         {
-            QString id = QString::fromStdString(meteoGrid()->meteoPoints()[row][col]->id);
-            if (idList.contains(id) || (! isList && meteoGrid()->meteoPoints()[row][col]->active))
+            QString id = QString::fromStdString(meteoGrid()->meteoPointPointer(row, col)->id);
+            if (idList.contains(id) || (! isList && meteoGrid()->meteoPointPointer(row, col)->active))
             {
                 // read data
                 if (gridStructure().isEnsemble())
@@ -117,6 +117,8 @@
         bool loadGridDailyData(QString &errorStr, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate);
         bool loadGridDailyDataFixedFields(QString &errorStr, QString meteoPoint, QDate first, QDate last);
         bool loadGridDailyDataEnsemble(QString &errorStr, QString meteoPoint, int memberNr, QDate first, QDate last);
+        bool loadGridDailyDataPoints(QString &errorStr, std::vector<Crit3DMeteoPoint> &pointList,
+                                     const QDate &firstDate, const QDate &lastDate);
         bool loadGridDailyMeteoPrec(QString &errorStr, const QString &meteoPointId, const QDate &firstDate, const QDate &lastDate);
         bool loadGridHourlyData(QSqlDatabase &myDb, const QString &meteoPointId,
                                 const QDateTime &firstDate, const QDateTime &lastDate, QString &errorStr);
@@ -174,6 +176,9 @@
         bool saveCellGridMonthlyData(QString &errorStr, const QString &meteoPointID, int row, int col,
                                      QDate firstDate, QDate lastDate, const QList<meteoVariable> &meteoVariableList);
 
+        bool saveGridMonthlyData(QString &errorStr, QDate firstDate, QDate lastDate, const std::vector<Crit3DMeteoPoint> &pointList,
+                                 const std::vector<QList<meteoVariable>> &pointVariableList);
+
         bool saveListDailyDataEnsemble(QString &errorStr, const QString &meteoPointID, const QDate &date,
                                        meteoVariable meteoVar, const QList<float> &values);
 
@@ -224,6 +229,10 @@
         QDate getFirstMonthlytDate() const;
         QDate getLastMonthlyDate() const;
 
+        // period of the daily data saved on the whole grid since the last clear (stored in the grid db)
+        bool getUpdatedDailyPeriod(QDate &firstDate, QDate &lastDate, QString &errorStr);
+        bool clearUpdatedDailyPeriod(QString &errorStr);
+
         bool isDaily();
         bool isHourly();
         bool isMonthly();
@@ -266,6 +275,9 @@
         QMap<meteoVariable, QString> _mapDailyMySqlVarType;
         QMap<meteoVariable, QString> _mapHourlyMySqlVarType;
 
+        bool addUpdatedDailyPeriod(const QDate &firstDate, const QDate &lastDate, QString &errorStr);
+        bool createUpdatedDailyPeriodTable(QString &errorStr);
+        bool createMonthlyTable(QString &errorStr);
     };
 
 
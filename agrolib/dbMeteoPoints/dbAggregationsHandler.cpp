@@ -43,9 +43,14 @@ Crit3DAggregationsDbHandler::~Crit3DAggregationsDbHandler()
 bool Crit3DAggregationsDbHandler::saveAggregationData(const std::vector<int> &idZoneVector, const QString &aggrType,
                                                         const QString &periodType, const QDate &startDate,
                                                         const QDate &endDate, meteoVariable variable,
-                                                        const std::vector<std::vector<float> > &aggregatedValues)
+                                                        const std::vector<std::vector<float> > &aggregatedValues,
+                                                        bool isInitTables)
 {
-    initAggregatedTables(idZoneVector, aggrType, periodType, startDate, endDate, variable);
+    // isInitTables = false: tables already initialized on the whole period (data saved in blocks)
+    if (isInitTables)
+    {
+        initAggregatedTables(idZoneVector, aggrType, periodType, startDate, endDate, variable);
+    }
     createTmpAggrTable();
 
     int idVariable = getIdfromMeteoVar(variable);
@@ -39,7 +39,8 @@
 
         bool saveAggregationData(const std::vector<int> &idZoneVector, const QString &aggrType,
                                 const QString &periodType, const QDate &startDate, const QDate &endDate,
-                                meteoVariable variable, const std::vector<std::vector<float>> &aggregatedValues);
+                                meteoVariable variable, const std::vector<std::vector<float>> &aggregatedValues,
+                                bool isInitTables = true);
 
         bool insertTmpAggr(QDate startDate, QDate endDate, meteoVariable variable, std::vector< std::vector<float> > aggregatedValues, int nZones);
         bool saveTmpAggrData(QString aggrType, QString periodType, int nZones);
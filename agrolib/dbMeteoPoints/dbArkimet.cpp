@@ -194,6 +194,8 @@ void DbArkimet::initStationsDailyTables(const QDate &startDate, const QDate &end
 
         qry = QSqlQuery(statement, _db);
         qry.exec();
+
+        invalidateAggregates(stationList[i]);
     }
 }
 
@@ -320,9 +322,12 @@ bool DbArkimet::saveDailyData()
             setErrorString(_db.lastError().text());
             return false;
         }
+
+        if (! invalidateAggregates(id_point))
+            return false;
     }
 
-    return true;
+    return invalidateTmpDataSpatialQualityFlags();
 }
 
 
@@ -358,7 +363,29 @@ bool DbArkimet::saveHourlyData()
         }
     }
 
-    return true;
+    return invalidateTmpDataSpatialQualityFlags();
+}
+
+
+// invalidates the spatial quality flags of the variables and period of the imported data (TmpData)
+bool DbArkimet::invalidateTmpDataSpatialQualityFlags()
+{
+    std::vector<int> idVarList;
+    QSqlQuery qry = _db.exec("SELECT DISTINCT id_variable FROM TmpData");
+    while (qry.next())
+        idVarList.push_back(qry.value(0).toInt());
+
+    if (idVarList.empty())
+        return true;
+
+    qry = _db.exec("SELECT MIN(date_time), MAX(date_time) FROM TmpData");
+    if (! qry.next())
+    {
+        setErrorString(_db.lastError().text());
+        return false;
+    }
+
+    return invalidateSpatialQualityFlags(idVarList, qry.value(0).toString(), qry.value(1).toString());
 }
 
 
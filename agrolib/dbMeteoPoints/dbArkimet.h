@@ -45,6 +45,9 @@
 
             bool readVmDataDaily(const QString &vmFileName, bool isPrec0024, QString &errorString);
 
+        private:
+            bool invalidateTmpDataSpatialQualityFlags();
+
     signals:
 
         protected slots:
@@ -6,6 +6,7 @@
 #include "meteoPoint.h"
 
 #include <QtSql>
+#include <algorithm>
 
 #define MAX_TABLES_CHECK_NR 200
 
@@ -13,6 +14,9 @@ Crit3DMeteoPointsDbHandler::Crit3DMeteoPointsDbHandler()
 {
     _errorStr = "";
     _mapIdMeteoVar.clear();
+    _isAggregatesTableReady = false;
+    _isSpatialQualityTableReady = false;
+    _spatialQualityVersion = 0;
 }
 
 Crit3DMeteoPointsDbHandler::Crit3DMeteoPointsDbHandler(QString provider_, QString host_, QString dbname_, int port_,
@@ -20,6 +24,9 @@ Crit3DMeteoPointsDbHandler::Crit3DMeteoPointsDbHandler(QString provider_, QStrin
 {
     _errorStr = "";
     _mapIdMeteoVar.clear();
+    _isAggregatesTableReady = false;
+    _isSpatialQualityTableReady = false;
+    _spatialQualityVersion = 0;
 
     if(_db.isOpen())
     {
@@ -49,6 +56,9 @@ Crit3DMeteoPointsDbHandler::Crit3DMeteoPointsDbHandler(QString _dbName)
 {
     _errorStr = "";
     _mapIdMeteoVar.clear();
+    _isAggregatesTableReady = false;
+    _isSpatialQualityTableReady = false;
+    _spatialQualityVersion = 0;
 
     if(_db.isOpen())
     {
@@ -456,6 +466,9 @@ bool Crit3DMeteoPointsDbHandler::deleteData(const QString &pointCode, frequencyT
         QString lastStr = lastDate.toString("yyyy-MM-dd");
         statement = QString( "DELETE FROM `%1` WHERE date_time BETWEEN DATE('%2') AND DATE('%3')")
                                 .arg(tableName, firstStr, lastStr);
+
+        if (! invalidateAggregates(pointCode))
+            return false;
     }
     else
     {
@@ -465,7 +478,11 @@ bool Crit3DMeteoPointsDbHandler::deleteData(const QString &pointCode, frequencyT
                                 .arg(tableName, firstStr, lastStr);
     }
 
-    return qry.exec(statement);
+    if (! qry.exec(statement))
+        return false;
+
+    return invalidateSpatialQualityFlags(getIdVarList(frequency), firstDate.toString("yyyy-MM-dd"),
+                                         lastDate.toString("yyyy-MM-dd") + " 23:59:59");
 }
 
 
@@ -474,9 +491,11 @@ bool Crit3DMeteoPointsDbHandler::deleteData(const QString &pointCode, frequencyT
     QString tableName = pointCode + ((frequency == daily) ?  "_D" : "_H");
     QString idList;
     QString id;
+    std::vector<int> idVarList;
     for (int i = 0; i < varList.size(); i++)
     {
-        id = QString::number(getIdfromMeteoVar(varList[i]));
+        idVarList.push_back(getIdfromMeteoVar(varList[i]));
+        id = QString::number(idVarList.back());
         idList += id + ",";
     }
     idList = idList.left(idList.length() - 1);
@@ -489,6 +508,9 @@ bool Crit3DMeteoPointsDbHandler::deleteData(const QString &pointCode, frequencyT
         QString lastStr = lastDate.toString("yyyy-MM-dd");
         statement = QString( "DELETE FROM `%1` WHERE date_time BETWEEN DATE('%2') AND DATE('%3') AND `%4` IN (%5)")
                                 .arg(tableName, firstStr, lastStr, FIELD_METEO_VARIABLE, idList);
+
+        if (! invalidateAggregates(pointCode))
+            return false;
     }
     else
     {
@@ -501,7 +523,11 @@ bool Crit3DMeteoPointsDbHandler::deleteData(const QString &pointCode, frequencyT
                             .arg(tableName, firstStr, lastStr, FIELD_METEO_VARIABLE, idList);
     }
 
-    return qry.exec(statement);
+    if (! qry.exec(statement))
+        return false;
+
+    return invalidateSpatialQualityFlags(idVarList, firstDate.toString("yyyy-MM-dd"),
+                                         lastDate.toString("yyyy-MM-dd") + " 23:59:59");
 }
 
 
@@ -542,6 +568,14 @@ bool Crit3DMeteoPointsDbHandler::deleteAllData(frequencyType frequency)
         }
     }
 
+    if (! invalidateSpatialQualityFlags(getIdVarList(frequency), "", ""))
+        return false;
+
+    if (frequency == daily)
+    {
+        return invalidateAllAggregates();
+    }
+
     return true;
 }
 
@@ -1608,6 +1642,16 @@ bool Crit3DMeteoPointsDbHandler::writeDailyDataList(const QString &pointCode, co
         return false;
     }
 
+    std::vector<int> idVarList;
+    QString firstTime, lastTime;
+    getEntriesRange(listEntries, idVarList, firstTime, lastTime);
+
+    if (! invalidateAggregates(pointCode) || ! invalidateSpatialQualityFlags(idVarList, firstTime, lastTime))
+    {
+        log += "\nError in invalidate aggregates: " + _errorStr;
+        return false;
+    }
+
     return true;
 }
 
@@ -1641,10 +1685,624 @@ bool Crit3DMeteoPointsDbHandler::writeHourlyDataList(const QString &pointCode, c
         return false;
     }
 
+    std::vector<int> idVarList;
+    QString firstTime, lastTime;
+    getEntriesRange(listEntries, idVarList, firstTime, lastTime);
+
+    if (! invalidateSpatialQualityFlags(idVarList, firstTime, lastTime))
+    {
+        log += "\nError in invalidate spatial quality flags: " + _errorStr;
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief writeDataBatch
+ * writes a block of values of many points with one prepared statement for each point table,
+ * all in a single transaction
+ * values: index = (timeIndex * nrVariables + varIndex) * nrPoints + pointIndex
+ */
+bool Crit3DMeteoPointsDbHandler::writeDataBatch(frequencyType frequency, const std::vector<QString> &pointCodes,
+                                                const std::vector<QString> &timeList, const std::vector<int> &idVarList,
+                                                const std::vector<float> &values, QString& log)
+{
+    size_t nrPoints = pointCodes.size();
+    size_t nrTimes = timeList.size();
+    size_t nrVariables = idVarList.size();
+
+    if (nrPoints == 0 || nrTimes == 0 || nrVariables == 0)
+        return true;
+
+    if (values.size() != nrTimes * nrVariables * nrPoints)
+    {
+        log += "\nWrong number of values.";
+        return false;
+    }
+
+    QString postFix = (frequency == daily) ? "_D" : "_H";
+    bool isOk = true;
+
+    _db.transaction();
+
+    for (size_t i = 0; i < nrPoints; i++)
+    {
+        if (! existIdPoint(pointCodes[i]))
+        {
+            log += "\nID " + pointCodes[i] + " is not present in the point properties table.";
+            isOk = false;
+            continue;
+        }
+
+        QString tableName = pointCodes[i] + postFix;
+        if (! createTable(tableName, false))
+        {
+            log += "\nError in create table: " + tableName + _db.lastError().text();
+            isOk = false;
+            continue;
+        }
+
+        QSqlQuery qry(_db);
+        qry.prepare(QString("INSERT OR REPLACE INTO `%1` VALUES (?, ?, ?)").arg(tableName));
+
+        for (size_t t = 0; t < nrTimes; t++)
+        {
+            for (size_t v = 0; v < nrVariables; v++)
+            {
+                qry.addBindValue(timeList[t]);
+                qry.addBindValue(idVarList[v]);
+                qry.addBindValue(double(values[(t * nrVariables + v) * nrPoints + i]));
+
+                if (! qry.exec())
+                {
+                    log += "\nError in execute query: " + qry.lastError().text();
+                    _db.rollback();
+                    return false;
+                }
+            }
+        }
+
+        if (frequency == daily && ! invalidateAggregates(pointCodes[i]))
+        {
+            log += "\nError in invalidate aggregates: " + _errorStr;
+            isOk = false;
+        }
+    }
+
+    if (! _db.commit())
+    {
+        log += "\nError in commit: " + _db.lastError().text();
+        return false;
+    }
+
+    auto timeRange = std::minmax_element(timeList.begin(), timeList.end());
+    if (! invalidateSpatialQualityFlags(idVarList, *(timeRange.first), *(timeRange.second)))
+    {
+        log += "\nError in invalidate spatial quality flags: " + _errorStr;
+        return false;
+    }
+
+    return isOk;
+}
+
+
+/*!
+ * \brief createAggregatesTable
+ * per-station monthly sums and counts of the daily variables, the row with year = 0 marks
+ * that the variable of the point has been computed. The table is created once for each connection.
+ */
+bool Crit3DMeteoPointsDbHandler::createAggregatesTable()
+{
+    if (_isAggregatesTableReady)
+        return true;
+
+    QSqlQuery qry(_db);
+
+    // table of a previous version (without quality counts): it is a cache, recompute it
+    QSqlRecord record = _db.record(AGGREGATE_SERIES_TABLE);
+    if (! record.isEmpty() && ! record.contains("nr_accepted"))
+    {
+        if (! qry.exec(QString("DROP TABLE `%1`").arg(AGGREGATE_SERIES_TABLE)))
+        {
+            _errorStr = qry.lastError().text();
+            return false;
+        }
+    }
+
+    QString queryStr = QString("CREATE TABLE IF NOT EXISTS `%1`"
+                               "(id_point TEXT, id_variable INTEGER, year INTEGER, month INTEGER, "
+                               "sum REAL, nr_valid INTEGER, nr_accepted INTEGER, "
+                               "PRIMARY KEY(id_point, id_variable, year, month))")
+                               .arg(AGGREGATE_SERIES_TABLE);
+    if (! qry.exec(queryStr))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    _isAggregatesTableReady = true;
+    return true;
+}
+
+
+/*!
+ * \brief computeAggregates
+ * the same values used by the elaborations on loaded daily data (preElaborationWithoutLoad + computeStatistic):
+ * sum and nr_valid on all the values different from NODATA,
+ * nr_accepted on the values that pass the syntactic quality control
+ */
+bool Crit3DMeteoPointsDbHandler::computeAggregates(const QString &idPoint, meteoVariable variable, int idVar)
+{
+    QSqlQuery qry(_db);
+    _db.transaction();
+
+    QString statement = QString("DELETE FROM `%1` WHERE id_point = '%2' AND id_variable = %3")
+                            .arg(AGGREGATE_SERIES_TABLE, idPoint).arg(idVar);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        _db.rollback();
+        return false;
+    }
+
+    // year * 12 + month - 1
+    std::map<int, double> monthlySum;
+    std::map<int, int> monthlyNrValid;
+    std::map<int, int> monthlyNrAccepted;
+
+    if (hasData(daily, idPoint.toStdString()))
+    {
+        statement = QString("SELECT date_time, value FROM `%1_D` WHERE id_variable = %2 AND value IS NOT NULL")
+                        .arg(idPoint).arg(idVar);
+        if (! qry.exec(statement))
+        {
+            _errorStr = qry.lastError().text();
+            _db.rollback();
+            return false;
+        }
+
+        Crit3DQuality qualityCheck;
+        while (qry.next())
+        {
+            // same conversion of loadDailyData
+            float value = qry.value(1).toFloat();
+            if (isEqual(value, NODATA))
+                continue;
+
+            QDate myDate = qry.value(0).toDate();
+            if (! myDate.isValid())
+                continue;
+
+            int index = myDate.year() * 12 + myDate.month() - 1;
+            monthlySum[index] += double(value);
+            monthlyNrValid[index]++;
+            if (qualityCheck.syntacticQualitySingleValue(variable, value) == quality::accepted)
+                monthlyNrAccepted[index]++;
+        }
+    }
+
+    qry.prepare(QString("INSERT INTO `%1` VALUES (:id_point, :id_variable, :year, :month, :sum, :nr_valid, :nr_accepted)")
+                    .arg(AGGREGATE_SERIES_TABLE));
+
+    // marker row
+    monthlySum[-1] = 0;
+    for (auto it = monthlySum.begin(); it != monthlySum.end(); ++it)
+    {
+        bool isMarker = (it->first == -1);
+        qry.bindValue(":id_point", idPoint);
+        qry.bindValue(":id_variable", idVar);
+        qry.bindValue(":year", isMarker ? 0 : it->first / 12);
+        qry.bindValue(":month", isMarker ? 0 : it->first % 12 + 1);
+        qry.bindValue(":sum", it->second);
+        qry.bindValue(":nr_valid", isMarker ? 0 : monthlyNrValid[it->first]);
+        qry.bindValue(":nr_accepted", isMarker ? 0 : monthlyNrAccepted[it->first]);
+
+        if (! qry.exec())
+        {
+            _errorStr = qry.lastError().text();
+            _db.rollback();
+            return false;
+        }
+    }
+
+    return _db.commit();
+}
+
+
+/*!
+ * \brief loadMonthlyAggregates
+ * reads the monthly aggregates of a daily variable (see computeAggregates), computing them on first request
+ * output vectors: (lastYear - firstYear + 1) * 12 values, index = (year - firstYear) * 12 + month - 1
+ */
+bool Crit3DMeteoPointsDbHandler::loadMonthlyAggregates(const QString &idPoint, meteoVariable variable,
+                                                       int firstYear, int lastYear, std::vector<double> &monthlySum,
+                                                       std::vector<int> &monthlyNrValid, std::vector<int> &monthlyNrAccepted)
+{
+    monthlySum.clear();
+    monthlyNrValid.clear();
+    monthlyNrAccepted.clear();
+
+    int idVar = getIdfromMeteoVar(variable);
+    if (idVar == NODATA)
+    {
+        _errorStr = "Missing variable: " + QString::fromStdString(getMeteoVarName(variable));
+        return false;
+    }
+
+    if (lastYear < firstYear)
+    {
+        _errorStr = "Wrong years";
+        return false;
+    }
+
+    if (! createAggregatesTable())
+        return false;
+
+    QSqlQuery qry(_db);
+    QString statement = QString("SELECT 1 FROM `%1` WHERE id_point = '%2' AND id_variable = %3 AND year = 0")
+                            .arg(AGGREGATE_SERIES_TABLE, idPoint).arg(idVar);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    if (! qry.next())
+    {
+        if (! computeAggregates(idPoint, variable, idVar))
+            return false;
+    }
+
+    unsigned int nrValues = unsigned(lastYear - firstYear + 1) * 12;
+    monthlySum.resize(nrValues, 0);
+    monthlyNrValid.resize(nrValues, 0);
+    monthlyNrAccepted.resize(nrValues, 0);
+
+    statement = QString("SELECT year, month, sum, nr_valid, nr_accepted FROM `%1` "
+                        "WHERE id_point = '%2' AND id_variable = %3 AND year BETWEEN %4 AND %5")
+                    .arg(AGGREGATE_SERIES_TABLE, idPoint).arg(idVar).arg(firstYear).arg(lastYear);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    while (qry.next())
+    {
+        int month = qry.value(1).toInt();
+        if (month < 1 || month > 12)
+            continue;
+
+        unsigned int index = unsigned(qry.value(0).toInt() - firstYear) * 12 + unsigned(month - 1);
+        monthlySum[index] = qry.value(2).toDouble();
+        monthlyNrValid[index] = qry.value(3).toInt();
+        monthlyNrAccepted[index] = qry.value(4).toInt();
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoPointsDbHandler::invalidateAggregates(const QString &idPoint)
+{
+    if (! createAggregatesTable())
+        return false;
+
+    QSqlQuery qry(_db);
+    QString statement = QString("DELETE FROM `%1` WHERE id_point = '%2'").arg(AGGREGATE_SERIES_TABLE, idPoint);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Crit3DMeteoPointsDbHandler::invalidateAllAggregates()
+{
+    QSqlQuery qry(_db);
+    QString statement = QString("DROP TABLE IF EXISTS `%1`").arg(AGGREGATE_SERIES_TABLE);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    _isAggregatesTableReady = false;
+    return true;
+}
+
+
+QString Crit3DMeteoPointsDbHandler::getSpatialQualityTimeString(meteoVariable variable, const Crit3DTime &myTime)
+{
+    if (getVarFrequency(variable) == daily)
+        return getQDate(myTime.date).toString("yyyy-MM-dd");
+    else
+        return getQDateTime(myTime).toString("yyyy-MM-dd hh:mm:ss");
+}
+
+
+/*!
+ * \brief createSpatialQualityTable
+ * quality flags (quality::qualityType) of the spatial control of a period, only the data not missing are saved.
+ * The settings table holds for each variable the key of the quality settings and of the points used by the control
+ */
+bool Crit3DMeteoPointsDbHandler::createSpatialQualityTable()
+{
+    if (_isSpatialQualityTableReady)
+        return true;
+
+    QSqlQuery qry(_db);
+    QString queryStr = QString("CREATE TABLE IF NOT EXISTS `%1`"
+                               "(id_variable INTEGER, date_time TEXT(20), id_point TEXT, flag INTEGER, "
+                               "PRIMARY KEY(id_variable, date_time, id_point))").arg(SPATIAL_QC_TABLE);
+    if (! qry.exec(queryStr))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    queryStr = QString("CREATE TABLE IF NOT EXISTS `%1`(id_variable INTEGER PRIMARY KEY, settings_key TEXT)")
+                   .arg(SPATIAL_QC_SETTINGS_TABLE);
+    if (! qry.exec(queryStr))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    _isSpatialQualityTableReady = true;
+    return true;
+}
+
+
+// true if the tables of the spatial quality flags exist (checked once for each connection)
+bool Crit3DMeteoPointsDbHandler::checkSpatialQualityTable()
+{
+    if (! _isSpatialQualityTableReady)
+    {
+        QList<QString> tableList = _db.tables();
+        _isSpatialQualityTableReady = tableList.contains(SPATIAL_QC_TABLE) && tableList.contains(SPATIAL_QC_SETTINGS_TABLE);
+    }
+
+    return _isSpatialQualityTableReady;
+}
+
+
+// settings key of the stored flags, empty if the variable has not been checked
+bool Crit3DMeteoPointsDbHandler::getSpatialQualityKey(int idVar, QString &settingsKey)
+{
+    settingsKey = "";
+
+    QSqlQuery qry(_db);
+    QString statement = QString("SELECT settings_key FROM `%1` WHERE id_variable = %2").arg(SPATIAL_QC_SETTINGS_TABLE).arg(idVar);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    if (qry.next())
+        settingsKey = qry.value(0).toString();
+
+    return true;
+}
+
+
+/*!
+ * \brief writeSpatialQualityFlags
+ * qualityFlags: output of spatialQualityControlPeriod, index = step * nrPoints + i
+ * settingsKey: quality settings and points used by the control,
+ * the flags of the variable computed with a different key are deleted
+ */
+bool Crit3DMeteoPointsDbHandler::writeSpatialQualityFlags(meteoVariable variable, const std::vector<Crit3DTime> &timeList,
+                                                          const std::vector<Crit3DMeteoPoint> &meteoPoints,
+                                                          const std::vector<int> &qualityFlags, const QString &settingsKey)
+{
+    int idVar = getIdfromMeteoVar(variable);
+    if (idVar == NODATA)
+    {
+        _errorStr = "Missing variable: " + QString::fromStdString(getMeteoVarName(variable));
+        return false;
+    }
+
+    size_t nrPoints = meteoPoints.size();
+    if (qualityFlags.size() != timeList.size() * nrPoints)
+    {
+        _errorStr = "Wrong number of quality flags";
+        return false;
+    }
+
+    if (! createSpatialQualityTable())
+        return false;
+
+    QString storedKey;
+    if (! getSpatialQualityKey(idVar, storedKey))
+        return false;
+
+    QSqlQuery qry(_db);
+    _db.transaction();
+    _spatialQualityVersion++;
+
+    if (storedKey != settingsKey)
+    {
+        QString statement = QString("DELETE FROM `%1` WHERE id_variable = %2").arg(SPATIAL_QC_TABLE).arg(idVar);
+        if (! qry.exec(statement))
+        {
+            _errorStr = qry.lastError().text();
+            _db.rollback();
+            return false;
+        }
+
+        qry.prepare(QString("INSERT OR REPLACE INTO `%1` VALUES (?, ?)").arg(SPATIAL_QC_SETTINGS_TABLE));
+        qry.addBindValue(idVar);
+        qry.addBindValue(settingsKey);
+        if (! qry.exec())
+        {
+            _errorStr = qry.lastError().text();
+            _db.rollback();
+            return false;
+        }
+    }
+
+    qry.prepare(QString("INSERT OR REPLACE INTO `%1` VALUES (?, ?, ?, ?)").arg(SPATIAL_QC_TABLE));
+
+    for (size_t step = 0; step < timeList.size(); step++)
+    {
+        QString timeStr = getSpatialQualityTimeString(variable, timeList[step]);
+        for (size_t i = 0; i < nrPoints; i++)
+        {
+            int flag = qualityFlags[step * nrPoints + i];
+            if (flag == quality::missing_data)
+                continue;
+
+            qry.addBindValue(idVar);
+            qry.addBindValue(timeStr);
+            qry.addBindValue(QString::fromStdString(meteoPoints[i].id));
+            qry.addBindValue(flag);
+            if (! qry.exec())
+            {
+                _errorStr = qry.lastError().text();
+                _db.rollback();
+                return false;
+            }
+        }
+    }
+
+    return _db.commit();
+}
+
+
+/*!
+ * \brief loadSpatialQualityFlags
+ * flags of the period [firstTime, lastTime], flagMap: time string -> id_point -> quality flag
+ * returns true with an empty map if the period has not been checked with the same settingsKey
+ */
+bool Crit3DMeteoPointsDbHandler::loadSpatialQualityFlags(meteoVariable variable, const Crit3DTime &firstTime,
+                                                         const Crit3DTime &lastTime, const QString &settingsKey,
+                                                         QMap<QString, QMap<QString, int>> &flagMap)
+{
+    flagMap.clear();
+
+    if (! checkSpatialQualityTable())
+        return true;
+
+    int idVar = getIdfromMeteoVar(variable);
+    if (idVar == NODATA)
+    {
+        _errorStr = "Missing variable: " + QString::fromStdString(getMeteoVarName(variable));
+        return false;
+    }
+
+    QString storedKey;
+    if (! getSpatialQualityKey(idVar, storedKey))
+        return false;
+
+    if (storedKey != settingsKey)
+        return true;
+
+    QSqlQuery qry(_db);
+    QString statement = QString("SELECT date_time, id_point, flag FROM `%1` WHERE id_variable = %2 "
+                                "AND date_time >= '%3' AND date_time <= '%4'")
+                            .arg(SPATIAL_QC_TABLE).arg(idVar)
+                            .arg(getSpatialQualityTimeString(variable, firstTime), getSpatialQualityTimeString(variable, lastTime));
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    while (qry.next())
+    {
+        flagMap[qry.value(0).toString()].insert(qry.value(1).toString(), qry.value(2).toInt());
+    }
+
     return true;
 }
 
 
+/*!
+ * \brief invalidateSpatialQualityFlags
+ * the spatial control depends on all the stations: a change of data invalidates the stored flags
+ * of all the points, for the changed variables and period only.
+ * idVarList empty: all the variables; firstTime, lastTime (as getSpatialQualityTimeString) empty: no bound
+ */
+bool Crit3DMeteoPointsDbHandler::invalidateSpatialQualityFlags(const std::vector<int> &idVarList,
+                                                               const QString &firstTime, const QString &lastTime)
+{
+    _spatialQualityVersion++;
+
+    if (! checkSpatialQualityTable())
+        return true;
+
+    QStringList conditions;
+    if (! idVarList.empty())
+    {
+        QStringList idList;
+        for (int idVar : idVarList)
+            idList << QString::number(idVar);
+        conditions << QString("id_variable IN (%1)").arg(idList.join(","));
+    }
+    if (! firstTime.isEmpty())
+        conditions << QString("date_time >= '%1'").arg(firstTime);
+    if (! lastTime.isEmpty())
+        conditions << QString("date_time <= '%1'").arg(lastTime);
+
+    QString statement = QString("DELETE FROM `%1`").arg(SPATIAL_QC_TABLE);
+    if (! conditions.isEmpty())
+        statement += " WHERE " + conditions.join(" AND ");
+
+    QSqlQuery qry(_db);
+    if (! qry.exec(statement))
+    {
+        _errorStr = qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+
+// id of the variables of a frequency (all the variables if noFrequency)
+std::vector<int> Crit3DMeteoPointsDbHandler::getIdVarList(frequencyType frequency)
+{
+    std::vector<int> idVarList;
+    for (const auto &item : _mapIdMeteoVar)
+    {
+        if (frequency == noFrequency || getVarFrequency(item.second) == frequency)
+            idVarList.push_back(item.first);
+    }
+
+    return idVarList;
+}
+
+
+// variables and period of a list of entries ('date_time',id_variable,value)
+void Crit3DMeteoPointsDbHandler::getEntriesRange(const QList<QString> &listEntries, std::vector<int> &idVarList,
+                                                 QString &firstTime, QString &lastTime)
+{
+    idVarList.clear();
+    firstTime = "";
+    lastTime = "";
+
+    for (const QString &entry : listEntries)
+    {
+        QString timeStr = entry.section('\'', 1, 1);
+        int idVar = entry.section(',', 1, 1).toInt();
+
+        if (std::find(idVarList.begin(), idVarList.end(), idVar) == idVarList.end())
+            idVarList.push_back(idVar);
+        if (firstTime.isEmpty() || timeStr < firstTime)
+            firstTime = timeStr;
+        if (lastTime.isEmpty() || timeStr > lastTime)
+            lastTime = timeStr;
+    }
+}
+
+
 bool Crit3DMeteoPointsDbHandler::setAllPointsActive()
 {
     QSqlQuery qry(_db);
@@ -1815,6 +2473,18 @@ bool Crit3DMeteoPointsDbHandler::deleteAllPointsFromIdList(const QList<QString>&
         {
             _errorStr += "\n" + qry.lastError().text();
         }
+
+        QString previousError = _errorStr;
+        if (! invalidateAggregates(id_point))
+        {
+            _errorStr = previousError + "\n" + _errorStr;
+        }
+    }
+
+    QString previousError = _errorStr;
+    if (! invalidateSpatialQualityFlags(std::vector<int>(), "", ""))
+    {
+        _errorStr = previousError + "\n" + _errorStr;
     }
 
     return true;
@@ -17,6 +17,13 @@
     #ifndef QOBJECT_H
         #include <QObject>
     #endif
+    #ifndef QMAP_H
+        #include <QMap>
+    #endif
+
+    #define AGGREGATE_SERIES_TABLE "aggregate_series"
+    #define SPATIAL_QC_TABLE "spatial_qc_flags"
+    #define SPATIAL_QC_SETTINGS_TABLE "spatial_qc_settings"
 
 
     class Crit3DMeteoPointsDbHandler : public QObject
@@ -104,6 +111,24 @@
 
         bool writeDailyDataList(const QString &pointCode, const QList<QString> &listEntries, QString& log);
         bool writeHourlyDataList(const QString &pointCode, const QList<QString> &listEntries, QString& log);
+        bool writeDataBatch(frequencyType frequency, const std::vector<QString> &pointCodes,
+                            const std::vector<QString> &timeList, const std::vector<int> &idVarList,
+                            const std::vector<float> &values, QString& log);
+
+        bool loadMonthlyAggregates(const QString &idPoint, meteoVariable variable, int firstYear, int lastYear,
+                                   std::vector<double> &monthlySum, std::vector<int> &monthlyNrValid,
+                                   std::vector<int> &monthlyNrAccepted);
+        bool invalidateAggregates(const QString &idPoint);
+        bool invalidateAllAggregates();
+
+        bool writeSpatialQualityFlags(meteoVariable variable, const std::vector<Crit3DTime> &timeList,
+                                      const std::vector<Crit3DMeteoPoint> &meteoPoints, const std::vector<int> &qualityFlags,
+                                      const QString &settingsKey);
+        bool loadSpatialQualityFlags(meteoVariable variable, const Crit3DTime &firstTime, const Crit3DTime &lastTime,
+                                     const QString &settingsKey, QMap<QString, QMap<QString, int>> &flagMap);
+        bool invalidateSpatialQualityFlags(const std::vector<int> &idVarList, const QString &firstTime, const QString &lastTime);
+        int getSpatialQualityVersion() const { return _spatialQualityVersion; }
+        static QString getSpatialQualityTimeString(meteoVariable variable, const Crit3DTime &myTime);
 
         bool setAllPointsActive();
         bool setAllPointsNotActive();
@@ -133,6 +158,20 @@
 
         QSqlDatabase _db;
         std::map<int, meteoVariable> _mapIdMeteoVar;
+
+        bool _isAggregatesTableReady;
+        bool _isSpatialQualityTableReady;
+        int _spatialQualityVersion;
+
+        bool createAggregatesTable();
+        bool computeAggregates(const QString &idPoint, meteoVariable variable, int idVar);
+        bool createSpatialQualityTable();
+        bool checkSpatialQualityTable();
+        bool getSpatialQualityKey(int idVar, QString &settingsKey);
+        std::vector<int> getIdVarList(frequencyType frequency);
+        void getEntriesRange(const QList<QString> &listEntries, std::vector<int> &idVarList,
+                             QString &firstTime, QString &lastTime);
+
     signals:
 
     protected slots:
@@ -29,6 +29,19 @@
 #include <algorithm>
 #include <set>
 #include <unordered_set>
+#include <new>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 #include "commonConstants.h"
 #include "basicMath.h"
@@ -245,6 +258,8 @@ namespace gis
 
     /******************     RASTER GRID     ********************/
 
+    #define RASTER_BUFFER_ALIGNMENT 64
+
     Crit3DRasterGrid::Crit3DRasterGrid()
     {
         isLoaded = false;
@@ -253,6 +268,9 @@ namespace gis
         minimum = NODATA;
         maximum = NODATA;
         value = nullptr;
+        _data = nullptr;
+        _mappedView = nullptr;
+        _mappedSize = 0;
     }
 
 
@@ -262,17 +280,35 @@ namespace gis
     }
 
 
-    void Crit3DRasterGrid::clear()
+    void Crit3DRasterGrid::releaseData()
     {
-        if (value != nullptr && header->nrRows > 0)
+        if (_mappedView != nullptr)
+        {
+        #ifdef _WIN32
+            UnmapViewOfFile(_mappedView);
+        #else
+            munmap(_mappedView, _mappedSize);
+        #endif
+            _mappedView = nullptr;
+            _mappedSize = 0;
+        }
+        else if (_data != nullptr)
         {
-            for (int row = 0; row < header->nrRows; row++)
-                if (value[row] != nullptr)
-                    delete [] value[row];
+            ::operator delete[](_data, std::align_val_t(RASTER_BUFFER_ALIGNMENT));
+        }
+        _data = nullptr;
 
+        if (value != nullptr)
+        {
             delete [] value;
             value = nullptr;
         }
+    }
+
+
+    void Crit3DRasterGrid::clear()
+    {
+        releaseData();
 
         mapTime.setNullTime();
         minimum = NODATA;
@@ -292,27 +328,131 @@ namespace gis
     // clean the grid (set all NO DATA)
     void Crit3DRasterGrid::emptyGrid()
     {
+        if (_data != nullptr)
+            std::fill(_data, _data + nrCells(), header->flag);
+    }
+
+
+    void Crit3DRasterGrid::setRowPointers()
+    {
+        value = new float*[unsigned(header->nrRows)];
+
         for (int row = 0; row < header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                value[row][col] = header->flag;
+            value[row] = _data + long(row) * header->nrCols;
     }
 
 
+    // one aligned buffer for all the cells, value[row] are views on it
     bool Crit3DRasterGrid::initializeGrid()
     {
-        this->value = new float*[unsigned(this->header->nrRows)];
+        releaseData();
 
-        for (int row = 0; row < this->header->nrRows; row++)
+        size_t nrBytes = size_t(nrCells()) * sizeof(float);
+        _data = static_cast<float*>(::operator new[](std::max(nrBytes, sizeof(float)),
+                                                     std::align_val_t(RASTER_BUFFER_ALIGNMENT), std::nothrow));
+        if (_data == nullptr)
         {
-            this->value[row] = new float[unsigned(this->header->nrCols)];
-            if (this->value[row] == nullptr)
-            {
-                // Memory error: file too big
-                this->clear();
-                return false;
-            }
+            // Memory error: file too big
+            this->clear();
+            return false;
+        }
+
+        setRowPointers();
+        return true;
+    }
+
+
+    bool Crit3DRasterGrid::mapFloatData(const std::string &fileName, std::string &errorStr)
+    {
+        releaseData();
+
+        size_t dataSize = size_t(nrCells()) * sizeof(float);
+        if (header->nrBytes != 4 || dataSize == 0)
+        {
+            errorStr = "Memory map is available only for float data.";
+            return false;
+        }
+
+    #ifdef _WIN32
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            errorStr = "Error in opening raster file.";
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (! GetFileSizeEx(file, &fileSize) || size_t(fileSize.QuadPart) < dataSize)
+        {
+            CloseHandle(file);
+            errorStr = "Error reading raster data.";
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        void* view = nullptr;
+        if (mapping != nullptr)
+        {
+            view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, dataSize);
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+    #else
+        int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            errorStr = "Error in opening raster file.";
+            return false;
+        }
+
+        struct stat fileInfo;
+        if (fstat(fileDescriptor, &fileInfo) != 0 || size_t(fileInfo.st_size) < dataSize)
+        {
+            close(fileDescriptor);
+            errorStr = "Error reading raster data.";
+            return false;
+        }
+
+        // private mapping: written pages are copied, the file is never modified
+        void* view = mmap(nullptr, dataSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+        close(fileDescriptor);
+        if (view == MAP_FAILED)
+            view = nullptr;
+    #endif
+
+        if (view == nullptr)
+        {
+            errorStr = "Error in mapping raster file.";
+            return false;
         }
 
+        _mappedView = view;
+        _mappedSize = dataSize;
+        _data = static_cast<float*>(view);
+        setRowPointers();
+
+        return true;
+    }
+
+
+    // replace the memory map with an owned buffer (needed before overwriting the mapped file)
+    bool Crit3DRasterGrid::copyMappedData()
+    {
+        if (_mappedView == nullptr)
+            return true;
+
+        size_t nrValues = size_t(nrCells());
+        float* buffer = static_cast<float*>(::operator new[](std::max(nrValues * sizeof(float), sizeof(float)),
+                                                            std::align_val_t(RASTER_BUFFER_ALIGNMENT), std::nothrow));
+        if (buffer == nullptr)
+            return false;
+
+        std::copy(_data, _data + nrValues, buffer);
+        releaseData();
+        _data = buffer;
+        setRowPointers();
+
         return true;
     }
 
@@ -373,9 +513,8 @@ namespace gis
 
     void Crit3DRasterGrid::setConstantValue(float initValue)
     {
-        for (int row = 0; row < this->header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                value[row][col] = initValue;
+        if (_data != nullptr)
+            std::fill(_data, _data + nrCells(), initValue);
 
         this->minimum = initValue;
         this->maximum = initValue;
@@ -389,11 +528,11 @@ namespace gis
         *(header) = *(initGrid.header);
         *(colorScale) = *(initGrid.colorScale);
 
-        initializeGrid();
+        if (! initializeGrid())
+            return false;
 
-        for (int row = 0; row < header->nrRows; row++)
-            for (int col = 0; col < header->nrCols; col++)
-                    value[row][col] = initGrid.value[row][col];
+        if (initGrid.data() != nullptr)
+            std::copy(initGrid.data(), initGrid.data() + nrCells(), _data);
 
         gis::updateMinMaxRasterGrid(this);
         isLoaded = true;
@@ -1267,8 +1406,30 @@ namespace gis
     }
 
 
+    // map-map operation on valid values (division by zero is skipped by the caller)
+    static inline float algebraOperation(float x, float y, operationType myOperation)
+    {
+        switch (myOperation)
+        {
+            case operationMin:
+                return std::min(x, y);
+            case operationMax:
+                return std::max(x, y);
+            case operationSum:
+                return x + y;
+            case operationSubtract:
+                return x - y;
+            case operationProduct:
+                return x * y;
+            case operationDivide:
+                return x / y;
+        }
+        return x;
+    }
+
+
     bool mapAlgebra(gis::Crit3DRasterGrid* map1, gis::Crit3DRasterGrid* map2,
-                    gis::Crit3DRasterGrid* outputMap, operationType myOperation)
+                    gis::Crit3DRasterGrid* outputMap, operationType myOperation, bool isParallelComputing)
     {
         if (! map1 || ! map2 || ! outputMap)
             return false;
@@ -1280,79 +1441,98 @@ namespace gis
         if (! outputMap->initializeGrid(*(map1->header)))
             return false;
 
-        float x, y;
-        for (int row=0; row < outputMap->header->nrRows; ++row)
-            for (int col=0; col < outputMap->header->nrCols; ++col)
+        const int nrRows = outputMap->header->nrRows;
+        const int nrCols = outputMap->header->nrCols;
+        const float flag1 = map1->header->flag;
+        const float flag2 = map2->header->flag;
+        const bool isDivide = (myOperation == operationDivide);
+
+        #pragma omp parallel for if(isParallelComputing)
+        for (int row = 0; row < nrRows; ++row)
+        {
+            const float* values1 = map1->value[row];
+            float* outValues = outputMap->value[row];
+
+            if (isSameHeader)
             {
-                x = map1->value[row][col];
-                if (! isEqual(x, map1->header->flag))
+                // contiguous rows: no branches on the row/col position
+                const float* values2 = map2->value[row];
+                for (int col = 0; col < nrCols; ++col)
                 {
-                    if (isSameHeader)
-                    {
-                        y = map2->value[row][col];
-                    }
-                    else
-                    {
-                        double utmx, utmy;
-                        map1->getXY(row, col, utmx, utmy);
-                        y = map2->getValueFromXY(utmx, utmy);
-                    }
+                    const float x = values1[col];
+                    const float y = values2[col];
+                    const bool isValid = ! isEqual(x, flag1) && ! isEqual(y, flag2) && ! (isDivide && y == 0.f);
+                    outValues[col] = isValid ? algebraOperation(x, y, myOperation) : outValues[col];
+                }
+            }
+            else
+            {
+                for (int col = 0; col < nrCols; ++col)
+                {
+                    const float x = values1[col];
+                    if (isEqual(x, flag1))
+                        continue;
 
-                    if (! isEqual(y, map2->header->flag))
-                    {
-                        if (myOperation == operationMin)
-                            outputMap->value[row][col] = std::min(x, y);
-                        else if (myOperation == operationMax)
-                            outputMap->value[row][col] = std::max(x, y);
-                        else if (myOperation == operationSum)
-                            outputMap->value[row][col] = (x + y);
-                        else if (myOperation == operationSubtract)
-                            outputMap->value[row][col] = (x - y);
-                        else if (myOperation == operationProduct)
-                            outputMap->value[row][col] = (x * y);
-                        else if (myOperation == operationDivide)
-                        {
-                            if (map2->value[row][col] != 0.f)
-                                outputMap->value[row][col] = (x / y);
-                        }
-                    }
+                    double utmx, utmy;
+                    map1->getXY(row, col, utmx, utmy);
+                    const float y = map2->getValueFromXY(utmx, utmy);
+
+                    if (! isEqual(y, flag2) && ! (isDivide && y == 0.f))
+                        outValues[col] = algebraOperation(x, y, myOperation);
                 }
             }
+        }
 
         return true;
     }
 
 
     bool mapAlgebra(gis::Crit3DRasterGrid* map1, float myValue,
-                    gis::Crit3DRasterGrid* outputMap, operationType myOperation)
+                    gis::Crit3DRasterGrid* outputMap, operationType myOperation, bool isParallelComputing)
     {
         if (outputMap == nullptr || map1 == nullptr) return false;
         if (! (*(map1->header) == *(outputMap->header))) return false;
 
-        for (int row=0; row<outputMap->header->nrRows; row++)
-            for (int col=0; col<outputMap->header->nrCols; col++)
+        const long nrCells = map1->nrCells();
+        const float flag = map1->header->flag;
+        const float* inValues = map1->data();
+        float* outValues = outputMap->data();
+
+        if (myOperation == operationDivide && myValue == 0.f)
+        {
+            // fails only if there is at least one valid value
+            for (long i = 0; i < nrCells; i++)
             {
-                if (! isEqual(map1->value[row][col], map1->header->flag))
-                {
-                    if (myOperation == operationMin)
-                        outputMap->value[row][col] = MINVALUE(map1->value[row][col], myValue);
-                    else if (myOperation == operationMax)
-                        outputMap->value[row][col] = MAXVALUE(map1->value[row][col], myValue);
-                    else if (myOperation == operationSum)
-                        outputMap->value[row][col] = (map1->value[row][col] + myValue);
-                    else if (myOperation == operationSubtract)
-                        outputMap->value[row][col] = (map1->value[row][col] - myValue);
-                    else if (myOperation == operationProduct)
-                        outputMap->value[row][col] = (map1->value[row][col] * myValue);
-                    else if (myOperation == operationDivide)
-                    {
-                        if (myValue != 0.f)
-                            outputMap->value[row][col] = (map1->value[row][col] / myValue);
-                        else
-                            return false;
-                    }
-                }
+                if (! isEqual(inValues[i], flag))
+                    return false;
+            }
+            return true;
+        }
+
+        #pragma omp parallel for if(isParallelComputing)
+        for (long i = 0; i < nrCells; i++)
+        {
+            const float x = inValues[i];
+            float result;
+            switch (myOperation)
+            {
+                case operationMin:
+                    result = MINVALUE(x, myValue); break;
+                case operationMax:
+                    result = MAXVALUE(x, myValue); break;
+                case operationSum:
+                    result = x + myValue; break;
+                case operationSubtract:
+                    result = x - myValue; break;
+                case operationProduct:
+                    result = x * myValue; break;
+                case operationDivide:
+                    result = x / myValue; break;
+                default:
+                    result = outValues[i];
             }
+            outValues[i] = isEqual(x, flag) ? outValues[i] : result;
+        }
 
         return true;
     }
@@ -1720,67 +1900,95 @@ namespace gis
 
 
     void resampleGrid(const gis::Crit3DRasterGrid& oldGrid, gis::Crit3DRasterGrid* newGrid,
-                      gis::Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold)
+                      gis::Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold,
+                      bool isParallelComputing)
     {
         *(newGrid->header) = *newHeader;
 
         double resampleFactor = newGrid->header->cellSize / oldGrid.header->cellSize;
 
-        int row, col, tmpRow, tmpCol, nrValues;
-        gis::Crit3DPoint myLL, myUR;
-        std::vector<float> values;
-
         newGrid->initializeGrid();
 
-        for (row = 0; row < newGrid->header->nrRows; row++)
-            for (col = 0; col < newGrid->header->nrCols; col++)
+        const int nrRows = newGrid->header->nrRows;
+        const int nrCols = newGrid->header->nrCols;
+        const Crit3DRasterHeader* oldHeader = oldGrid.header;
+        const bool isPointSampling = (resampleFactor <= 1. || elab == aggrCenter);
+
+        int nrStep = int(floor(resampleFactor)) + 1;
+        double step = newGrid->header->cellSize / nrStep;
+        double halfStep = step * 0.5;
+
+        #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+        for (int row = 0; row < nrRows; row++)
+        {
+            // per thread buffers: source row/col of each sample step
+            std::vector<float> values;
+            std::vector<int> sampleRows, sampleCols;
+            if (! isPointSampling)
+            {
+                values.reserve(size_t(nrStep * nrStep));
+                sampleRows.resize(size_t(nrStep));
+                sampleCols.resize(size_t(nrStep));
+            }
+
+            for (int col = 0; col < nrCols; col++)
             {
                 // initialize
                 newGrid->value[row][col] = newGrid->header->flag;
                 float value = NODATA;
 
-                if (resampleFactor <= 1. || elab == aggrCenter)
+                if (isPointSampling)
                 {
+                    int tmpRow, tmpCol;
                     double x, y;
                     newGrid->getXY(row, col, x, y);
                     oldGrid.getRowCol(x, y, tmpRow, tmpCol);
                     if (! gis::isOutOfGridRowCol(tmpRow, tmpCol, oldGrid))
                     {
                         float tmpValue = oldGrid.value[tmpRow][tmpCol];
-                        if (! isEqual(tmpValue, oldGrid.header->flag))
+                        if (! isEqual(tmpValue, oldHeader->flag))
                             value = tmpValue;
                     }
                 }
                 else
                 {
-                    int nrStep = int(floor(resampleFactor)) + 1;
-                    double step = newGrid->header->cellSize / nrStep;
-                    double halfStep = step * 0.5;
-
                     double x0, y0;
                     newGrid->getXY(row, col, x0, y0);
-                    myLL.utm.x = x0 - (newGrid->header->cellSize / 2) + halfStep;
-                    myLL.utm.y = y0 - (newGrid->header->cellSize / 2) + halfStep;
-                    myUR.utm.x = x0 + (newGrid->header->cellSize / 2) - halfStep;
-                    myUR.utm.y = y0 + (newGrid->header->cellSize / 2) - halfStep;
+                    double llx = x0 - (newGrid->header->cellSize / 2) + halfStep;
+                    double lly = y0 - (newGrid->header->cellSize / 2) + halfStep;
+
+                    // the source col depends only on x and the source row only on y
+                    for (int i = 0; i < nrStep; i++)
+                    {
+                        double x = llx + step * i;
+                        int tmpCol = int((x - oldHeader->llCorner.x) * oldHeader->invCellSize);
+                        sampleCols[i] = (unsigned(tmpCol) < unsigned(oldHeader->nrCols)) ? tmpCol : -1;
+
+                        double y = lly + step * i;
+                        int tmpRow = (oldHeader->nrRows - 1) - int((y - oldHeader->llCorner.y) * oldHeader->invCellSize);
+                        sampleRows[i] = (unsigned(tmpRow) < unsigned(oldHeader->nrRows)) ? tmpRow : -1;
+                    }
 
                     values.clear();
-                    int maxNrValues = 0;
+                    int maxNrValues = nrStep * nrStep;
                     for (int i = 0; i < nrStep; i++)
                     {
-                        double x = myLL.utm.x + step * i;
+                        if (sampleCols[i] == -1)
+                            continue;
+
                         for (int j = 0; j < nrStep; j++)
                         {
-                            double y = myLL.utm.y + step * j;
-                            float tmpValue = gis::getValueFromXY(oldGrid, x, y);
-                            if (! isEqual(tmpValue, oldGrid.header->flag))
+                            if (sampleRows[j] == -1)
+                                continue;
+
+                            float tmpValue = oldGrid.value[sampleRows[j]][sampleCols[i]];
+                            if (! isEqual(tmpValue, oldHeader->flag))
                             {
                                 values.push_back(tmpValue);
                             }
-                            maxNrValues++;
                         }
                     }
-                    nrValues = int(values.size());
+                    int nrValues = int(values.size());
 
                     if (maxNrValues > 0)
                     {
@@ -1807,6 +2015,7 @@ namespace gis
                     newGrid->value[row][col] = value;
                 }
             }
+        }
 
         gis::updateMinMaxRasterGrid(newGrid);
         newGrid->isLoaded = true;
@@ -159,7 +159,7 @@
         public:
             Crit3DRasterHeader* header;
             Crit3DColorScale* colorScale;
-            float** value;
+            float** value;                      // row pointers into the contiguous buffer data()
             float minimum, maximum;
             bool isLoaded;
             Crit3DTime mapTime;
@@ -196,6 +196,24 @@
 
             Crit3DTime getMapTime() const;
             void setMapTime(const Crit3DTime &value);
+
+            // contiguous row-major buffer of nrRows * nrCols values (64-byte aligned when allocated)
+            float* data() { return _data; }
+            const float* data() const { return _data; }
+            long nrCells() const { return long(header->nrRows) * long(header->nrCols); }
+
+            // read a float (4 bytes) data file as a private copy-on-write memory map: the file is never modified
+            bool mapFloatData(const std::string &fileName, std::string &errorStr);
+            bool isMemoryMapped() const { return _mappedView != nullptr; }
+            bool copyMappedData();
+
+        private:
+            float* _data;
+            void* _mappedView;
+            size_t _mappedSize;
+
+            void setRowPointers();
+            void releaseData();
         };
 
 
@@ -266,14 +284,15 @@
         bool openRaster(std::string fileName, Crit3DRasterGrid *rasterGrid, int currentUtmZone, std::string &errorStr);
 
         bool readEsriGrid(const std::string &fileName, Crit3DRasterGrid* rasterGrid, std::string &errorStr);
+        bool readEsriGridMapped(const std::string &fileName, Crit3DRasterGrid* rasterGrid, std::string &errorStr);
         bool readEsriGridAscii(const std::string &fileName, gis::Crit3DRasterGrid *rasterGrid, std::string &errorStr);
         bool writeEsriGrid(const std::string &fileName, Crit3DRasterGrid *rasterGrid, std::string &errorStr);
 
         bool readEnviGrid(std::string fileName, Crit3DRasterGrid* rasterGrid, int currentUtmZone, std::string &errorStr);
         bool writeEnviGrid(std::string fileName, int utmZone, Crit3DRasterGrid *rasterGrid, std::string &errorStr);
 
-        bool mapAlgebra(Crit3DRasterGrid* myMap1, Crit3DRasterGrid* myMap2, Crit3DRasterGrid *outputMap, operationType myOperation);
-        bool mapAlgebra(Crit3DRasterGrid* myMap1, float myValue, Crit3DRasterGrid *outputMap, operationType myOperation);
+        bool mapAlgebra(Crit3DRasterGrid* myMap1, Crit3DRasterGrid* myMap2, Crit3DRasterGrid *outputMap, operationType myOperation, bool isParallelComputing);
+        bool mapAlgebra(Crit3DRasterGrid* myMap1, float myValue, Crit3DRasterGrid *outputMap, operationType myOperation, bool isParallelComputing);
 
         bool prevailingMap(const Crit3DRasterGrid& inputMap,  Crit3DRasterGrid *outputMap);
         float prevailingValue(const std::vector<float> &valueList);
@@ -303,7 +322,8 @@
         float closestDistanceFromGrid(Crit3DPoint myPoint, const gis::Crit3DRasterGrid& dem);
         bool compareGrids(const gis::Crit3DRasterGrid& first, const gis::Crit3DRasterGrid& second);
         void resampleGrid(const gis::Crit3DRasterGrid& oldGrid, gis::Crit3DRasterGrid* newGrid,
-                          Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold);
+                          Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold,
+                          bool isParallelComputing);
         bool temporalYearlyInterpolation(const gis::Crit3DRasterGrid& firstGrid, const gis::Crit3DRasterGrid& secondGrid,
                                          int myYear, float minValue, float maxValue, gis::Crit3DRasterGrid* outGrid);
 
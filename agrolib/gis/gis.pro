@@ -26,6 +26,9 @@ win32:{
     TARGET = gis
 }
 
+# parallel computing settings
+include($$absolute_path(../parallel.pri))
+
 INCLUDEPATH += ../mathFunctions ../crit3dDate
 
 SOURCES += gis.cpp \
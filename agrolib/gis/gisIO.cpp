@@ -370,21 +370,26 @@ namespace gis
         if (bytes == 2) buffer16.resize(nCols);
         if (bytes == 1) buffer8.resize(nCols);
 
+        if (bytes == 4)
+        {
+            // float: the buffer is contiguous, read all the rows at once
+            size_t nrValues = size_t(rasterGrid->nrCells());
+            if (fread(rasterGrid->data(), sizeof(float), nrValues, filePointer) != nrValues)
+            {
+                errorStr = "Error reading raster data.";
+                fclose(filePointer);
+                return false;
+            }
+
+            fclose (filePointer);
+            return true;
+        }
+
         for (int row = 0; row < nRows; row++)
         {
             float* dst = rasterGrid->value[row];
 
-            if (bytes == 4)
-            {
-                // float
-                if (fread(dst, sizeof(float), nCols, filePointer) != nCols)
-                {
-                    errorStr = "Error reading raster data.";
-                    fclose(filePointer);
-                    return false;
-                }
-            }
-            else if (bytes == 2)
+            if (bytes == 2)
             {
                 // short
                 if (fread(buffer16.data(), sizeof(int16_t), nCols, filePointer) != nCols)
@@ -482,6 +487,13 @@ namespace gis
         std::string myFileName = fileName + ".flt";
         std::FILE* filePointer;
 
+        // the file could be the mapped one
+        if (! myGrid->copyMappedData())
+        {
+            errorStr = "Memory error.";
+            return false;
+        }
+
         filePointer = fopen(myFileName.c_str(), "wb" );
         if (filePointer == nullptr)
         {
@@ -489,10 +501,7 @@ namespace gis
             return false;
         }
 
-        for (int row = 0; row < myGrid->header->nrRows; row++)
-        {
-            fwrite(myGrid->value[row], sizeof(float), unsigned(myGrid->header->nrCols), filePointer);
-        }
+        fwrite(myGrid->data(), sizeof(float), size_t(myGrid->nrCells()), filePointer);
 
         fclose (filePointer);
         return true;
@@ -564,6 +573,53 @@ namespace gis
     }
 
 
+    /*!
+     * \brief Read a ESRI float raster (.hdr and .flt) as a memory map:
+     * the pages are loaded on first access and copied only when written.
+     * Other formats are read as in readEsriGrid
+     * \return true on success, false otherwise
+     */
+    bool readEsriGridMapped(const std::string &fileName, Crit3DRasterGrid* rasterGrid, std::string &errorStr)
+    {
+        if (rasterGrid == nullptr)
+            return false;
+
+        std::string fileExtension = "";
+        if (fileName.size() > 4)
+        {
+            std::string suffix = fileName.substr(fileName.size() - 4);
+            if (suffix[0] == '.')
+                fileExtension = lowerCase(suffix);
+        }
+
+        if (! fileExtension.empty() && fileExtension != ".flt")
+            return gis::readEsriGrid(fileName, rasterGrid, errorStr);
+
+        rasterGrid->clear();
+
+        if (! gis::readEsriGridHeader(fileName, rasterGrid->header, errorStr))
+            return false;
+
+        std::string fltFileName = fileName;
+        if (fileExtension.empty())
+        {
+            fltFileName = fileName + ".flt";
+        }
+
+        // fallback to the standard reading (e.g. integer data or mapping not available)
+        if (rasterGrid->header->nrBytes != 4 || ! rasterGrid->mapFloatData(fltFileName, errorStr))
+        {
+            if (! gis::readRasterFloatData(fltFileName, rasterGrid, errorStr))
+                return false;
+        }
+
+        gis::updateMinMaxRasterGrid(rasterGrid);
+        rasterGrid->isLoaded = true;
+
+        return true;
+    }
+
+
     /*!
      * \brief Read a ENVI grid data file (.hdr and .img)
      * \return true on success, false otherwise
@@ -746,6 +802,12 @@ namespace gis
         FILE* filePointer;
         string imgFileName = fileName + ".img";
 
+        if (! rasterGrid->copyMappedData())
+        {
+            error = "Memory error.";
+            return false;
+        }
+
         filePointer = fopen(imgFileName.c_str(), "wb" );
         if (filePointer == nullptr)
         {
@@ -754,8 +816,7 @@ namespace gis
         }
 
         // write grid
-        for (int row = 0; row < rasterGrid->header->nrRows; row++)
-            fwrite(rasterGrid->value[row], sizeof(float), unsigned(rasterGrid->header->nrCols), filePointer);
+        fwrite(rasterGrid->data(), sizeof(float), size_t(rasterGrid->nrCells()), filePointer);
 
         fclose (filePointer);
 
@@ -4,6 +4,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QTimeZone>
+#include <QSet>
 
 
 InOutDataXML::InOutDataXML(bool isGrid, Crit3DMeteoPointsDbHandler *meteoPointsDbHandler, Crit3DMeteoGridDbHandler *meteoGridDbHandler, QString xmlFileName)
@@ -398,7 +399,7 @@ bool InOutDataXML::parserXML(QString *myError)
 }
 
 
-bool InOutDataXML::importDataMain(QString fileName, QString& errorStr)
+bool InOutDataXML::importDataMain(QString fileName, bool isParallelComputing, QString& errorStr)
 {
     if (fileName == "")
     {
@@ -409,11 +410,11 @@ bool InOutDataXML::importDataMain(QString fileName, QString& errorStr)
     dataFileName = fileName;
     if (format_type == XMLFORMATFIXED)
     {
-        return importXMLDataFixed(errorStr);
+        return importXMLDataFixed(isParallelComputing, errorStr);
     }
     else
     {
-        return importXMLDataDelimited(errorStr);
+        return importXMLDataDelimited(isParallelComputing, errorStr);
     }
 }
 
@@ -465,10 +466,43 @@ bool InOutDataXML::checkPointCodeFromFileName(QString& myPointCode, QString& err
 }
 
 
-bool InOutDataXML::importXMLDataFixed(QString& errorStr)
+bool InOutDataXML::importXMLDataFixed(bool isParallelComputing, QString& errorStr)
+{
+    if (format_type != XMLFORMATFIXED)
+    {
+        errorStr = "Wrong format type: fixed format is expected.";
+        return false;
+    }
+
+    return importXMLData(isParallelComputing, errorStr);
+}
+
+
+bool InOutDataXML::importXMLDataDelimited(bool isParallelComputing, QString& errorStr)
+{
+    if (format_type != XMLFORMATDELIMITED)
+    {
+        errorStr = "Wrong format type: delimited format is expected.";
+        return false;
+    }
+
+    return importXMLData(isParallelComputing, errorStr);
+}
+
+
+/*!
+ * \brief streaming import of the data file (fixed or delimited format)
+ * the rows are read in chunks of XML_IMPORT_CHUNK_ROWS and parsed in parallel,
+ * then the values are buffered per point (in the file order) and written:
+ * - when the buffer of a point reaches XML_IMPORT_GROUP_ENTRIES values
+ * - when all the buffers reach XML_IMPORT_MAX_ENTRIES values
+ * - at the end of the file
+ * each write of a point is a single statement, so memory does not grow with the file size
+ */
+bool InOutDataXML::importXMLData(bool isParallelComputing, QString& errorStr)
 {
     QFile myFile(dataFileName);
-    if (!myFile.open(QIODevice::ReadOnly))
+    if (! myFile.open(QIODevice::ReadOnly))
     {
         errorStr = "Open file failed: " + dataFileName + "\n " + myFile.errorString();
         return false;
@@ -484,24 +518,86 @@ bool InOutDataXML::importXMLDataFixed(QString& errorStr)
         }
     }
 
-    QTextStream in(&myFile);
-    QVariant myFlagAccepted, myFlag, myValue;
+    QString timeType = time.getType().toUpper();
+    bool isDaily = (timeType == "DAILY");
+    bool isFixedFieldsGrid = isGrid && meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields();
+
+    // resolve the variables (the database handlers are not used by the parser threads)
+    std::vector<XMLImportVariable> importVariables(size_t(variable.size()));
+    for (int i = 0; i < variable.size(); i++)
+    {
+        XMLImportVariable &importVar = importVariables[size_t(i)];
+        std::string varName = variable[i].varField.getType().toStdString();
+        importVar.var = getKeyMeteoVarMeteoMap(isDaily ? MapDailyMeteoVarToString : MapHourlyMeteoVarToString, varName);
+        importVar.varCode = NODATA;
+        if (importVar.var != noMeteoVar)
+        {
+            if (isGrid)
+            {
+                importVar.varCode = isDaily ? meteoGridDbHandler->getDailyVarCode(importVar.var)
+                                            : meteoGridDbHandler->getHourlyVarCode(importVar.var);
+                importVar.pragaName = QString::fromStdString(isDaily ? meteoGridDbHandler->getDailyPragaName(importVar.var)
+                                                                     : meteoGridDbHandler->getHourlyPragaName(importVar.var));
+            }
+            else
+            {
+                importVar.varCode = meteoPointsDbHandler->getIdfromMeteoVar(importVar.var);
+            }
+        }
+    }
 
-    QMultiMap<QString, QList<QString>> mapIdValues;
-    QList<QString> listEntries;
+    QTextStream in(&myFile);
+    QSet<QString> existingPoints;
+    QHash<QString, QList<QString>> groupEntries;
+    QList<QString> groupOrder;
+    long nrBufferedEntries = 0;
 
+    QList<QString> lines;
+    std::vector<XMLImportRow> rows;
     int currentRow = 0;
     int nrErrors = 0;
 
     while (! in.atEnd())
     {
-        QString line = in.readLine();
-        if (currentRow >= nrHeaderRows && !line.isEmpty())
+        // read a chunk of data rows
+        lines.clear();
+        while (! in.atEnd() && lines.size() < XML_IMPORT_CHUNK_ROWS)
         {
+            QString line = in.readLine();
+            if (currentRow >= nrHeaderRows && ! line.isEmpty())
+            {
+                lines.push_back(line);
+            }
+            currentRow++;
+        }
+
+        if (lines.isEmpty())
+            continue;
+
+        // parse and convert the fields
+        int nrRows = int(lines.size());
+        rows.clear();
+        rows.resize(size_t(nrRows));
+
+        #pragma omp parallel for if(isParallelComputing)
+        for (int i = 0; i < nrRows; i++)
+        {
+            parseXMLDataRow(lines.at(i), isDaily, importVariables, rows[size_t(i)]);
+        }
+
+        // check and group the values in the file order
+        for (int i = 0; i < nrRows; i++)
+        {
+            XMLImportRow &row = rows[size_t(i)];
+
             if (! isSinglePoint)
             {
                 // multipoint
-                myPointCode = parseXMLPointCode(line);
+                if (row.isPointCodeField)
+                {
+                    myPointCode = row.pointCode;
+                }
+
                 if (myPointCode.isEmpty())
                 {
                     errorStr = "Point code not found for file: " + dataFileName;
@@ -511,618 +607,317 @@ bool InOutDataXML::importXMLDataFixed(QString& errorStr)
                 if (myPointCode != previousPointCode)
                 {
                     // check if myPointCode exists
-                    if (isGrid)
+                    if (! existingPoints.contains(myPointCode))
                     {
-                        if(!meteoGridDbHandler->meteoGrid()->existsMeteoPointFromId(myPointCode.toStdString()))
+                        bool isExisting;
+                        if (isGrid)
                         {
-                            errorStr = "Point code: " + myPointCode + "not exists for file: " + dataFileName;
-                            return false;
+                            isExisting = meteoGridDbHandler->meteoGrid()->existsMeteoPointFromId(myPointCode.toStdString());
                         }
-                    }
-                    else
-                    {
-                        if (!meteoPointsDbHandler->existIdPoint(myPointCode))
+                        else
+                        {
+                            isExisting = meteoPointsDbHandler->existIdPoint(myPointCode);
+                        }
+
+                        if (! isExisting)
                         {
-                            errorStr = "Point code: " + myPointCode + "not exists for file: " + dataFileName;
+                            errorStr = "Point code: " + myPointCode + " not exists for file: " + dataFileName;
                             return false;
                         }
+                        existingPoints.insert(myPointCode);
                     }
 
-                    if (previousPointCode != "" && ! listEntries.isEmpty())
-                    {
-                        mapIdValues.insert(previousPointCode, listEntries);
-                        listEntries.clear();
-                    }
                     previousPointCode = myPointCode;
                 }
             }
 
-            // DAILY
-            if (time.getType().toUpper() == "DAILY")
+            if (! row.errorStr.isEmpty())
             {
-                QDate myDate = parseXMLDate(line);
-                if (! myDate.isValid() || myDate.year() == 1800)
-                {
-                    errorStr = "Date not found or invalid in file:\n" + dataFileName;
-                    return false;
-                }
-                for (int i = 0; i<variable.size(); i++)
-                {
-                    if (variable[i].nReplication > 1)
-                    {
-                        // TO DO (anche in vb)
-                    }
-                    else
-                    {
-                        int nReplication = 0;
-
-                        // FLAG
-                        if (!variable[i].flagAccepted.isEmpty())
-                        {
-                            QString format = variable[i].flagField.getFormat();
-                            if (format.isEmpty() || format == "%s" || format == "%d")
-                            {
-                                myFlagAccepted = variable[i].flagAccepted;
-                                myFlag = parseXMLFixedValue(line, nReplication, variable[i].flagField);
-                            }
-                        }
-                        else
-                        {
-                            myFlagAccepted = 0;
-                            myFlag = 0;
-                        }
-
-                        myValue  = parseXMLFixedValue(line, nReplication, variable[i].varField);
-                        if (myValue.toString() == "ERROR")
-                        {
-                            nrErrors++;
-                            myValue = missingValue;
-                        }
-                        else if (myFlag != myFlagAccepted)
-                        {
-                            myValue = missingValue;
-                        }
-
-                    } // end flag if
-
-                    if (myValue != missingValue)
-                    {
-                        // write myValue
-                        meteoVariable var = getKeyMeteoVarMeteoMap(MapDailyMeteoVarToString, variable[i].varField.getType().toStdString());
-                        if (var == noMeteoVar)
-                        {
-                            errorStr = "Meteovariable not found or not valid for file:\n" + dataFileName;
-                            return false;
-                        }
-                        if (isGrid)
-                        {
-                            listEntries.push_back(QString("('%1',%2,%3)").arg(myDate.toString("yyyy-MM-dd")).arg(meteoGridDbHandler->getDailyVarCode(var)).arg(myValue.toFloat()));
-                        }
-                        else
-                        {
-                            listEntries.push_back(QString("('%1',%2,%3)").arg(myDate.toString("yyyy-MM-dd")).arg(meteoPointsDbHandler->getIdfromMeteoVar(var)).arg(myValue.toFloat()));
-                        }
+                errorStr = row.errorStr;
+                return false;
+            }
 
-                        // TO DO isFixedFields non è ottimizzata la scrittura, struttura non piu' utilizzata
-                        if (isGrid && meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
-                        {
-                            if (!meteoGridDbHandler->saveCellCurrentGridDailyFF(errorStr, myPointCode, myDate, QString::fromStdString(meteoGridDbHandler->getDailyPragaName(var)), myValue.toFloat()))
-                            {
-                                return false;
-                            }
-                        }
-                    }
-                }
-            } // end daily
+            nrErrors += row.nrErrors;
 
-            // HOURLY
-            else if (time.getType().toUpper() == "HOURLY")
+            // TO DO isFixedFields non è ottimizzata la scrittura, struttura non piu' utilizzata
+            if (isFixedFieldsGrid)
             {
-                QDateTime myDateTime = parseXMLDateTime(line);
-                if (! myDateTime.isValid() || myDateTime.date().year() == 1800)
-                {
-                    errorStr = "Date not found or invalid in file:\n" + dataFileName + "\n" + line;
-                    return false;
-                }
-                for (int i = 0; i < variable.size(); i++)
+                for (const auto &value : row.values)
                 {
-                    if (variable[i].nReplication > 1)
-                    {
-                        // TO DO (anche in vb)
-                    }
+                    const QString &pragaName = importVariables[size_t(value.first)].pragaName;
+                    bool isOk;
+                    if (isDaily)
+                        isOk = meteoGridDbHandler->saveCellCurrentGridDailyFF(errorStr, myPointCode, row.date, pragaName, value.second);
                     else
-                    {
-                        int nReplication = 0;
-
-                        // FLAG
-                        if (!variable[i].flagAccepted.isEmpty())
-                        {
-                            QString format = variable[i].flagField.getFormat();
-                            if (format.isEmpty() || format == "%s" || format == "%d")
-                            {
-                                myFlagAccepted = variable[i].flagAccepted;
-                                myFlag = parseXMLFixedValue(line, nReplication, variable[i].flagField);
-                            }
-                        }
-                        else
-                        {
-                            myFlagAccepted = 0;
-                            myFlag = 0;
-                        }
-
-                        if (myFlag != myFlagAccepted)
-                        {
-                            myValue = missingValue;
-                        }
-                        else
-                        {
-                            myValue  = parseXMLFixedValue(line, nReplication, variable[i].varField);
-                            if (myValue.toString() == "ERROR")
-                            {
-                                nrErrors++;
-                                myValue = missingValue;
-                            }
-                        }
-                    }
-
-                    if (myValue != missingValue)
-                    {
-                        // write myValue
-                        meteoVariable var = getKeyMeteoVarMeteoMap(MapHourlyMeteoVarToString, variable[i].varField.getType().toStdString());
-                        if (var == noMeteoVar)
-                        {
-                            errorStr = "Meteovariable not found or not valid for file:\n" + dataFileName;
-                            return false;
-                        }
-                        if (isGrid)
-                        {
-                            listEntries.push_back(QString("('%1',%2,%3)").arg(myDateTime.toString("yyyy-MM-dd hh:mm:ss")).arg(meteoGridDbHandler->getHourlyVarCode(var)).arg(myValue.toFloat()));
-                        }
-                        else
-                        {
-                            listEntries.push_back(QString("('%1',%2,%3)").arg(myDateTime.toString("yyyy-MM-dd hh:mm:ss")).arg(meteoPointsDbHandler->getIdfromMeteoVar(var)).arg(myValue.toFloat()));
-                        }
+                        isOk = meteoGridDbHandler->saveCellCurrentGridHourlyFF(errorStr, myPointCode, row.dateTime, pragaName, value.second);
 
-                        // TO DO isFixedFields non è ottimizzata la scrittura, struttura non piu' utilizzata
-                        if (isGrid && meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
-                        {
-                            if (!meteoGridDbHandler->saveCellCurrentGridHourlyFF(errorStr, myPointCode, myDateTime, QString::fromStdString(meteoGridDbHandler->getHourlyPragaName(var)), myValue.toFloat()))
-                            {
-                                return false;
-                            }
-                        }
-                    }
+                    if (! isOk)
+                        return false;
                 }
-            } // end hourly
-
-            else
-            {
-                errorStr = "Unknown time type" + time.getType().toUpper() + "for file: " + dataFileName;
-                return false;
+                continue;
             }
-        }
 
-        currentRow++;
-    }
-     myFile.close();
+            if (row.entries.isEmpty())
+                continue;
 
-    // last point code
-    if (myPointCode != "" && ! listEntries.isEmpty())
-    {
-        mapIdValues.insert(myPointCode, listEntries);
-        listEntries.clear();
-    }
+            // buffer
+            if (! groupEntries.contains(myPointCode))
+            {
+                groupOrder.push_back(myPointCode);
+            }
+            QList<QString> &entries = groupEntries[myPointCode];
+            entries.append(row.entries);
+            nrBufferedEntries += row.entries.size();
 
-    if (isGrid && !meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
-    {
-        QList<QString> keys = mapIdValues.uniqueKeys();
-        if (time.getType().toUpper() == "DAILY")
-        {
-            for (int i = 0; i < keys.size(); i++)
+            if (entries.size() >= XML_IMPORT_GROUP_ENTRIES)
             {
-                if (!meteoGridDbHandler->saveCellCurrentGridDailyList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
+                nrBufferedEntries -= entries.size();
+                if (! writeXMLDataGroup(myPointCode, isDaily, entries, errorStr))
                     return false;
-                }
             }
-        }
-        else if (time.getType().toUpper() == "HOURLY")
-        {
-            for (int i = 0; i < keys.size(); i++)
+
+            if (nrBufferedEntries >= XML_IMPORT_MAX_ENTRIES)
             {
-                if (!meteoGridDbHandler->saveCellCurrentGridHourlyList(keys[i], mapIdValues.value(keys[i]), errorStr))
+                for (const QString &code : groupOrder)
                 {
-                    return false;
+                    if (! writeXMLDataGroup(code, isDaily, groupEntries[code], errorStr))
+                        return false;
                 }
+                groupEntries.clear();
+                groupOrder.clear();
+                nrBufferedEntries = 0;
             }
         }
     }
-    else
+    myFile.close();
+
+    // write the remaining values
+    for (const QString &code : groupOrder)
     {
-        QList<QString> keys = mapIdValues.uniqueKeys();
-        if (time.getType().toUpper() == "DAILY")
-        {
-            for (int i = 0; i < keys.size(); i++)
-            {
-                if (!meteoPointsDbHandler->writeDailyDataList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
-            }
-        }
-        else if (time.getType().toUpper() == "HOURLY")
-        {
-            for (int i = 0; i < keys.size(); i++)
-            {
-                if (!meteoPointsDbHandler->writeHourlyDataList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
-            }
-        }
+        if (! writeXMLDataGroup(code, isDaily, groupEntries[code], errorStr))
+            return false;
     }
 
     if (nrErrors != 0)
     {
-        errorStr = QString::number(nrErrors);
+        if (format_type == XMLFORMATFIXED)
+            errorStr = QString::number(nrErrors);
+        else
+            errorStr = "Not valid or missing data: " + QString::number(nrErrors);
     }
+
     return true;
 }
 
 
-bool InOutDataXML::importXMLDataDelimited(QString& errorStr)
+// write the buffered values of a point in a single statement, then empty the buffer
+bool InOutDataXML::writeXMLDataGroup(const QString &pointCode, bool isDaily, QList<QString> &entries, QString &errorStr)
 {
-    QFile myFile(dataFileName);
-    if ( !myFile.open(QIODevice::ReadOnly) )
+    if (entries.isEmpty())
+        return true;
+
+    bool isOk;
+    if (isGrid)
     {
-        errorStr = "Open file failed: " + dataFileName + "\n " + myFile.errorString();
-        return false;
+        if (isDaily)
+            isOk = meteoGridDbHandler->saveCellCurrentGridDailyList(pointCode, entries, errorStr);
+        else
+            isOk = meteoGridDbHandler->saveCellCurrentGridHourlyList(pointCode, entries, errorStr);
     }
-
-    QString myPointCode = "";
-    QString previousPointCode = "";
-    if (isSinglePoint)
+    else
     {
-        if (! checkPointCodeFromFileName(myPointCode, errorStr))
-        {
-            return false;
-        }
+        if (isDaily)
+            isOk = meteoPointsDbHandler->writeDailyDataList(pointCode, entries, errorStr);
+        else
+            isOk = meteoPointsDbHandler->writeHourlyDataList(pointCode, entries, errorStr);
     }
 
-    QTextStream in(&myFile);
-    QVariant myValue;
+    entries.clear();
+    return isOk;
+}
 
-    QMultiMap<QString, QList<QString>> mapIdValues;
-    QList<QString> listEntries;
 
-    int currentRow = 0;
-    int nrErrors = 0;
+/*!
+ * \brief parse a data row: point code, time and values
+ * it only reads the settings, so it can be called in parallel
+ * a fatal error is returned in row.errorStr
+ */
+void InOutDataXML::parseXMLDataRow(const QString &line, bool isDaily, const std::vector<XMLImportVariable> &importVariables, XMLImportRow &row)
+{
+    row.isPointCodeField = false;
+    row.nrErrors = 0;
 
-    while (! in.atEnd())
+    QString timeType = time.getType().toUpper();
+    if (timeType != "DAILY" && timeType != "HOURLY")
     {
-        QString line = in.readLine();
-
-        if (currentRow >= nrHeaderRows && !line.isEmpty())
-        {
-            if (! isSinglePoint)
-            {
-                QList<QString> myFields = line.split(format_delimiter);
-
-                if (pointCode.getPosition()-1 < myFields.size())
-                {
-                    myPointCode = parseXMLPointCode(line);
-                }
-
-                if (myPointCode.isEmpty())
-                {
-                    errorStr = "Point code not found for file: " + dataFileName;
-                    return false;
-                }
-
-                if (myPointCode != previousPointCode)
-                {
-                    // check if point code exists
-                    if (isGrid)
-                    {
-                        if(! meteoGridDbHandler->meteoGrid()->existsMeteoPointFromId(myPointCode.toStdString()))
-                        {
-                          errorStr = "Cell code: " + myPointCode + "not exists for file: " + dataFileName;
-                          return false;
-                        }
-                    }
-                    else
-                    {
-                        if (! meteoPointsDbHandler->existIdPoint(myPointCode))
-                        {
-                           errorStr = "Point code: " + myPointCode + "not exists for file: " + dataFileName;
-                           return false;
-                        }
-                    }
-
-                    if (previousPointCode != "" && ! listEntries.isEmpty())
-                    {
-                        mapIdValues.insert(previousPointCode, listEntries);
-                        listEntries.clear();
-                    }
-                    previousPointCode = myPointCode;
-                }
-            } // end multiPoint case
+        row.errorStr = "Unknown time type" + timeType + "for file: " + dataFileName;
+        return;
+    }
 
-            if (time.getType().toUpper() == "DAILY")
-            {
-                QList<QString> myFields = line.split(format_delimiter);
-                QDate myDate(1800,1,1);
+    QList<QString> fields;
+    if (format_type == XMLFORMATDELIMITED)
+    {
+        fields = line.split(format_delimiter);
+    }
 
-                if (time.getPosition() <= 0)
-                {
-                    errorStr = "Wrong Time field position (the number of fields must start from 1): " + QString::number(time.getPosition());
-                    return false;
-                }
+    // point code
+    if (! isSinglePoint)
+    {
+        if (format_type == XMLFORMATFIXED || pointCode.getPosition()-1 < fields.size())
+        {
+            row.pointCode = parseXMLPointCode(line);
+            row.isPointCodeField = true;
+        }
+    }
 
-                if (time.getPosition()-1 < myFields.size())
-                {
-                    myDate = parseXMLDate(myFields[time.getPosition()-1]);
-                }
+    // time
+    QString timeStr;
+    if (format_type == XMLFORMATFIXED)
+    {
+        timeStr = line;
+    }
+    else
+    {
+        if (time.getPosition() <= 0)
+        {
+            row.errorStr = "Wrong Time field position (the number of fields must start from 1): " + QString::number(time.getPosition());
+            return;
+        }
+        if (time.getPosition()-1 < fields.size())
+        {
+            timeStr = fields[time.getPosition()-1];
+        }
+    }
 
-                if (! myDate.isValid() || myDate.year() == 1800)
-                {
-                    errorStr = "Date not found or invalid in file:\n" + dataFileName;
-                    return false;
-                }
+    QString timeToString;
+    if (isDaily)
+    {
+        row.date = timeStr.isEmpty() ? QDate(1800,1,1) : parseXMLDate(timeStr);
+        if (! row.date.isValid() || row.date.year() == 1800)
+        {
+            row.errorStr = "Date not found or invalid in file:\n" + dataFileName;
+            return;
+        }
+        timeToString = row.date.toString("yyyy-MM-dd");
+    }
+    else
+    {
+        row.dateTime = timeStr.isEmpty() ? QDateTime(QDate(1800,1,1), QTime(0,0,0), Qt::UTC) : parseXMLDateTime(timeStr);
+        if (! row.dateTime.isValid() || row.dateTime.date().year() == 1800)
+        {
+            row.errorStr = "Date not found or invalid in file:\n" + dataFileName + "\n" + line;
+            return;
+        }
+        timeToString = row.dateTime.toString("yyyy-MM-dd hh:mm:ss");
+    }
 
-                for (int i = 0; i<variable.size(); i++)
-                {
-                    if (variable[i].nReplication > 1)
-                    {
-                        // TO DO (anche in vb)
-                    }
-                    else
-                    {
-                        int nReplication = 0;
+    // values
+    for (int i = 0; i < variable.size(); i++)
+    {
+        const VariableXML &myVariable = variable.at(i);
+        if (myVariable.nReplication > 1)
+        {
+            // TO DO (anche in vb)
+            continue;
+        }
 
-                        if (! variable[i].flagAccepted.isEmpty() && variable[i].flagField.getPosition()>0 && variable[i].flagField.getPosition()-1 < myFields.size())
-                        {
-                            if (variable[i].varField.getPosition() > 0 && variable[i].varField.getPosition()-1 < myFields.size())
-                            {
-                                myValue  = parseXMLFixedValue(myFields[variable[i].varField.getPosition()-1], nReplication, variable[i].varField);
-                                if (myValue.toString() == "ERROR")
-                                {
-                                    nrErrors++;
-                                    myValue = missingValue;
-                                }
-                            }
-                            else
-                            {
-                                nrErrors++;
-                                myValue = missingValue;
-                                return false;
-                            }
-                            // check FLAG
-                            if (myFields[variable[i].flagField.getPosition()-1] != variable[i].flagAccepted)
-                            {
-                                myValue = missingValue;
-                            }
-                        }
-                        else
-                        {
-                            if (variable[i].varField.getPosition() > 0 && variable[i].varField.getPosition()-1 < myFields.size())
-                            {
-                                myValue  = parseXMLFixedValue(myFields[variable[i].varField.getPosition()-1], nReplication, variable[i].varField);
-                                if (myValue.toString() == "ERROR")
-                                {
-                                    nrErrors++;
-                                    myValue = missingValue;
-                                }
-                            }
-                            else
-                            {
-                                nrErrors++;
-                                myValue = missingValue;
-                                return false;
-                            }
-                        }
-                        if (myValue != missingValue && myValue != NODATA)
-                        {
-                            // write value
-                            meteoVariable var = getKeyMeteoVarMeteoMap(MapDailyMeteoVarToString, variable[i].varField.getType().toStdString());
-                            if (var == noMeteoVar)
-                            {
-                                errorStr = "Meteovariable not found or not valid for file:\n" + dataFileName;
-                                return false;
-                            }
+        QVariant myValue = parseXMLDataRowValue(line, fields, myVariable, isDaily, row);
+        if (! row.errorStr.isEmpty())
+            return;
 
-                            if (isGrid)
-                            {
-                                listEntries.push_back(QString("('%1',%2,%3)").arg(myDate.toString("yyyy-MM-dd")).arg(meteoGridDbHandler->getDailyVarCode(var)).arg(myValue.toFloat()));
-                            }
-                            else
-                            {
-                                listEntries.push_back(QString("('%1',%2,%3)").arg(myDate.toString("yyyy-MM-dd")).arg(meteoPointsDbHandler->getIdfromMeteoVar(var)).arg(myValue.toFloat()));
-                            }
+        bool isValid = (myValue != missingValue);
+        if (format_type == XMLFORMATDELIMITED)
+            isValid = isValid && (myValue != NODATA);
 
-                            // TO DO isFixedFields non è ottimizzata la scrittura, struttura non piu' utilizzata
-                            if (isGrid && meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
-                            {
-                                if (!meteoGridDbHandler->saveCellCurrentGridDailyFF(errorStr, myPointCode, myDate, QString::fromStdString(meteoGridDbHandler->getDailyPragaName(var)), myValue.toFloat()))
-                                {
-                                    return false;
-                                }
-                            }
-                        }
-                    }
-                }
-            } // end daily
-
-            else if (time.getType().toUpper() == "HOURLY")
+        if (isValid)
+        {
+            const XMLImportVariable &importVar = importVariables[size_t(i)];
+            if (importVar.var == noMeteoVar)
             {
-                QList<QString> myFields = line.split(format_delimiter);
-                QDateTime myDateTime(QDate(1800,1,1), QTime(0,0,0), Qt::UTC);
-
-                if (time.getPosition()-1 < myFields.size())
-                {
-                     myDateTime = parseXMLDateTime(myFields[time.getPosition()-1]);
-                }
-
-                if (! myDateTime.isValid() || myDateTime.date().year() == 1800)
-                {
-                    errorStr = "Date not found or invalid in file:\n" + dataFileName + "\n" + line;
-                    return false;
-                }
-
-                for (int i = 0; i<variable.size(); i++)
-                {
-                    if (variable[i].nReplication > 1)
-                    {
-                        // TO DO (anche in vb)
-                    }
-                    else
-                    {
-                        int nReplication = 0;
+                row.errorStr = "Meteovariable not found or not valid for file:\n" + dataFileName;
+                return;
+            }
 
-                        if (!variable[i].flagAccepted.isEmpty() && variable[i].flagField.getPosition()>0 && variable[i].flagField.getPosition()-1 < myFields.size())
-                        {
-                            if (variable[i].varField.getPosition() > 0 && variable[i].varField.getPosition()-1 < myFields.size())
-                            {
-                                myValue  = parseXMLFixedValue(myFields[variable[i].varField.getPosition()-1], nReplication, variable[i].varField);
-                                if (myValue.toString() == "ERROR")
-                                {
-                                    nrErrors++;
-                                    myValue = missingValue;
-                                }
-                            }
-                            else
-                            {
-                                nrErrors++;
-                                myValue = missingValue;
-                                return false;
-                            }
-                            // check FLAG
-                            if (myFields[variable[i].flagField.getPosition()-1] != variable[i].flagAccepted)
-                            {
-                                myValue = missingValue;
-                            }
-                        }
-                        else
-                        {
-                            if (variable[i].varField.getPosition() > 0 && variable[i].varField.getPosition()-1 < myFields.size())
-                            {
-                                myValue  = parseXMLFixedValue(myFields[variable[i].varField.getPosition()-1], nReplication, variable[i].varField);
-                                if (myValue.toString() == "ERROR")
-                                {
-                                    nrErrors++;
-                                    myValue = missingValue;
-                                }
-                            }
-                            else
-                            {
-                                nrErrors++;
-                                myValue = missingValue;
-                                return false;
-                            }
-                        }
-                        if (myValue != missingValue && myValue != NODATA)
-                        {
-                            // write myValue
-                            meteoVariable var = getKeyMeteoVarMeteoMap(MapHourlyMeteoVarToString, variable[i].varField.getType().toStdString());
-                            if (var == noMeteoVar)
-                            {
-                                errorStr = "Meteovariable not found or not valid for file:\n" + dataFileName;
-                                return false;
-                            }
-                            if (isGrid)
-                            {
-                                listEntries.push_back(QString("('%1',%2,%3)").arg(myDateTime.toString("yyyy-MM-dd hh:mm:ss")).arg(meteoGridDbHandler->getHourlyVarCode(var)).arg(myValue.toFloat()));
-                            }
-                            else
-                            {
-                                listEntries.push_back(QString("('%1',%2,%3)").arg(myDateTime.toString("yyyy-MM-dd hh:mm:ss")).arg(meteoPointsDbHandler->getIdfromMeteoVar(var)).arg(myValue.toFloat()));
-                            }
+            row.entries.push_back(QString("('%1',%2,%3)").arg(timeToString).arg(importVar.varCode).arg(myValue.toFloat()));
 
-                            // TO DO isFixedFields non è ottimizzata la scrittura, struttura non piu' utilizzata
-                            if (isGrid && meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
-                            {
-                                if (!meteoGridDbHandler->saveCellCurrentGridHourlyFF(errorStr, myPointCode, myDateTime, QString::fromStdString(meteoGridDbHandler->getDailyPragaName(var)), myValue.toFloat()))
-                                {
-                                    return false;
-                                }
-                            }
-                        }
-                    }
-                }
-            } // end hourly
-            else
+            if (isGrid)
             {
-                errorStr = "Unknown time type" + time.getType().toUpper() + "for file: " + dataFileName;
-                return false;
+                row.values.push_back(std::make_pair(i, myValue.toFloat()));
             }
         }
-
-        currentRow++;
     }
-    myFile.close();
+}
 
-    // last point code
-    if (myPointCode != "" && ! listEntries.isEmpty())
-    {
-        mapIdValues.insert(myPointCode, listEntries);
-        listEntries.clear();
-    }
 
-    if (isGrid && !meteoGridDbHandler->meteoGrid()->gridStructure().isFixedFields())
+// value of a variable in a data row (missingValue if not valid or not accepted by the flag)
+QVariant InOutDataXML::parseXMLDataRowValue(const QString &line, const QList<QString> &fields, const VariableXML &myVariable,
+                                            bool isDaily, XMLImportRow &row)
+{
+    int nReplication = 0;
+    QVariant myValue;
+
+    if (format_type == XMLFORMATFIXED)
     {
-        QList<QString> keys = mapIdValues.uniqueKeys();
-        if (time.getType().toUpper() == "DAILY")
+        QVariant myFlagAccepted = 0;
+        QVariant myFlag = 0;
+
+        // FLAG
+        if (! myVariable.flagAccepted.isEmpty())
         {
-            for (int i = 0; i<keys.size(); i++)
+            QString format = myVariable.flagField.getFormat();
+            if (format.isEmpty() || format == "%s" || format == "%d")
             {
-                if (! meteoGridDbHandler->saveCellCurrentGridDailyList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
+                myFlagAccepted = myVariable.flagAccepted;
+                myFlag = parseXMLFixedValue(line, nReplication, myVariable.flagField);
             }
         }
-        else if (time.getType().toUpper() == "HOURLY")
+
+        if (! isDaily && myFlag != myFlagAccepted)
         {
-            for (int i = 0; i < keys.size(); i++)
-            {
-                if (! meteoGridDbHandler->saveCellCurrentGridHourlyList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
-            }
+            return missingValue;
         }
-    }
-    else
-    {
-        QList<QString> keys = mapIdValues.uniqueKeys();
-        if (time.getType().toUpper() == "DAILY")
+
+        myValue = parseXMLFixedValue(line, nReplication, myVariable.varField);
+        if (myValue.toString() == "ERROR")
         {
-            for (int i = 0; i<keys.size(); i++)
-            {
-                if (! meteoPointsDbHandler->writeDailyDataList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
-            }
+            row.nrErrors++;
+            return missingValue;
         }
-        else if (time.getType().toUpper() == "HOURLY")
+        if (myFlag != myFlagAccepted)
         {
-            for (int i = 0; i<keys.size(); i++)
-            {
-                if (! meteoPointsDbHandler->writeHourlyDataList(keys[i], mapIdValues.value(keys[i]), errorStr))
-                {
-                    return false;
-                }
-            }
+            return missingValue;
         }
+
+        return myValue;
     }
 
-    if (nrErrors != 0)
+    // delimited
+    int varPosition = myVariable.varField.getPosition();
+    if (varPosition <= 0 || varPosition-1 >= fields.size())
     {
-        errorStr = "Not valid or missing data: " + QString::number(nrErrors);
+        row.nrErrors++;
+        row.errorStr = "Wrong variable field position in file:\n" + dataFileName;
+        return missingValue;
     }
 
-    return true;
+    myValue = parseXMLFixedValue(fields[varPosition-1], nReplication, myVariable.varField);
+    if (myValue.toString() == "ERROR")
+    {
+        row.nrErrors++;
+        myValue = missingValue;
+    }
+
+    // check FLAG
+    int flagPosition = myVariable.flagField.getPosition();
+    if (! myVariable.flagAccepted.isEmpty() && flagPosition > 0 && flagPosition-1 < fields.size())
+    {
+        if (fields[flagPosition-1] != myVariable.flagAccepted)
+        {
+            myValue = missingValue;
+        }
+    }
+
+    return myValue;
 }
 
 
@@ -9,6 +9,8 @@
 #include <QList>
 #include <QDate>
 #include <QVariant>
+#include <QHash>
+#include <vector>
 #include "fieldXML.h"
 #include "variableXML.h"
 #include "dbMeteoPointsHandler.h"
@@ -16,6 +18,11 @@
 
 enum formatType{ XMLFORMATFIXED, XMLFORMATDELIMITED};
 
+// streaming import: rows parsed in parallel for each chunk, values buffered per point
+#define XML_IMPORT_CHUNK_ROWS 20000
+#define XML_IMPORT_GROUP_ENTRIES 50000
+#define XML_IMPORT_MAX_ENTRIES 1000000
+
 class InOutDataXML
 {
 public:
@@ -24,10 +31,10 @@ public:
 
     bool parseXMLFile(QDomDocument* xmlDoc, QString *error);
     bool parserXML(QString *error);
-    bool importDataMain(QString fileName, QString &error);
+    bool importDataMain(QString fileName, bool isParallelComputing, QString &error);
     QDateTime parseXMLDateTime(QString text);
-    bool importXMLDataFixed(QString &error);
-    bool importXMLDataDelimited(QString &error);
+    bool importXMLDataFixed(bool isParallelComputing, QString &error);
+    bool importXMLDataDelimited(bool isParallelComputing, QString &error);
     QString parseXMLPointCode(QString text);
     QDate parseXMLDate(QString text);
     QVariant parseXMLFixedValue(QString text, int nReplication, FieldXML myField);
@@ -51,6 +58,33 @@ public:
     float getFormatMissingValue();
 
 private:
+    // variable of the data file, resolved before the import
+    struct XMLImportVariable
+    {
+        meteoVariable var;
+        int varCode;
+        QString pragaName;
+    };
+
+    // one parsed data row
+    struct XMLImportRow
+    {
+        QString pointCode;
+        bool isPointCodeField;
+        QDate date;
+        QDateTime dateTime;
+        QList<QString> entries;
+        std::vector<std::pair<int, float>> values;      // (variable index, value) for the fixed fields grid
+        int nrErrors;
+        QString errorStr;
+    };
+
+    bool importXMLData(bool isParallelComputing, QString &errorStr);
+    void parseXMLDataRow(const QString &line, bool isDaily, const std::vector<XMLImportVariable> &importVariables, XMLImportRow &row);
+    QVariant parseXMLDataRowValue(const QString &line, const QList<QString> &fields, const VariableXML &myVariable,
+                                  bool isDaily, XMLImportRow &row);
+    bool writeXMLDataGroup(const QString &pointCode, bool isDaily, QList<QString> &entries, QString &errorStr);
+
     bool isGrid;
     bool isSinglePoint;
     formatType format_type;
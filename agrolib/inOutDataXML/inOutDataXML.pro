@@ -25,6 +25,9 @@ win32:{
     TARGET = inOutDataXML
 }
 
+# parallel computing settings
+include($$absolute_path(../parallel.pri))
+
 INCLUDEPATH += ../crit3dDate ../mathFunctions ../meteo ../gis ../interpolation ../dbMeteoPoints ../dbMeteoGrid
 
 SOURCES += inOutDataXML.cpp \
@@ -26,6 +26,9 @@ win32:{
     TARGET = interpolation
 }
 
+# parallel computing settings
+include($$absolute_path(../parallel.pri))
+
 INCLUDEPATH += ../crit3dDate ../mathFunctions ../gis ../meteo
 
 SOURCES += interpolation.cpp \
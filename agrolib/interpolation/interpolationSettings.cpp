@@ -484,7 +484,7 @@ bool Crit3DInterpolationSettings::isGlocalReady(bool isGrid)
     {
         for (int i = 0; i < getMacroAreasSize(); i++)
         {
-            Crit3DMacroArea macroArea = getMacroArea(i);
+            const Crit3DMacroArea& macroArea = getMacroArea(i);
             if ((isGrid && macroArea.getAreaCellsGridSize() > 0) ||
                 (!isGrid && macroArea.getAreaCellsDemSize() > 0))
                 return true;
@@ -899,8 +899,8 @@ Crit3DMacroArea::Crit3DMacroArea()
 
 void Crit3DMacroArea::clear()
 {
-    areaCellsDEM.clear();
-    areaCellsGrid.clear();
+    areaCellsDEM = std::make_shared<const TMacroAreaCells>();
+    areaCellsGrid = std::make_shared<const TMacroAreaCells>();
     areaParameters.clear();
     areaCombination.clear();
     meteoPoints.clear();
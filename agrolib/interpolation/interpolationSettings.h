@@ -2,6 +2,7 @@
 #define INTERPOLATIONSETTINGS_H
 
 #include <functional>
+#include <memory>
 #ifndef INTERPOLATIONCONSTS_H
         #include "interpolationConstants.h"
     #endif
@@ -146,14 +147,32 @@
     };
 
 
+    // cells of a macro area: index = row * nrCols + col, weight of the cell in the area
+    struct TMacroAreaCells
+    {
+        std::vector<unsigned int> index;
+        std::vector<float> weight;
+
+        std::size_t size() const { return index.size(); }
+        bool empty() const { return index.empty(); }
+        void push_back(unsigned int cellIndex, float cellWeight)
+        {
+            index.push_back(cellIndex);
+            weight.push_back(cellWeight);
+        }
+    };
+
+
     class Crit3DMacroArea
     {
     private:
         Crit3DProxyCombination areaCombination;
         std::vector<std::vector<double>> areaParameters;
         std::vector<int> meteoPoints;
-        std::vector<float> areaCellsDEM;
-        std::vector<float> areaCellsGrid;
+
+        // read only: shared between copies (and threads)
+        std::shared_ptr<const TMacroAreaCells> areaCellsDEM;
+        std::shared_ptr<const TMacroAreaCells> areaCellsGrid;
 
     public:
         Crit3DMacroArea();
@@ -164,18 +183,24 @@
         { return int(meteoPoints.size()); }
 
         void setMeteoPoints (std::vector<int> myMeteoPoints) { meteoPoints = myMeteoPoints; }
-        std::vector<int> getMeteoPoints() const { return meteoPoints; }
-
-        void setAreaCellsDEM (std::vector<float> myCells) { areaCellsDEM = myCells; }
-        const std::vector<float>& getAreaCellsDEM() const { return areaCellsDEM; }
-        int getAreaCellsDemSize() const { return int(areaCellsDEM.size()); }
-
-        void setAreaCellsGrid (std::vector<float> myCells) { areaCellsGrid = myCells; }
-        std::vector<float> getAreaCellsGrid() const { return areaCellsGrid; }
-        int getAreaCellsGridSize() const { return int(areaCellsGrid.size()); }
+        const std::vector<int>& getMeteoPoints() const { return meteoPoints; }
+
+        void setAreaCellsDEM (TMacroAreaCells myCells)
+        { areaCellsDEM = std::make_shared<const TMacroAreaCells>(std::move(myCells)); }
+        void setAreaCellsDEM (const std::shared_ptr<const TMacroAreaCells> &myCells) { areaCellsDEM = myCells; }
+        const std::shared_ptr<const TMacroAreaCells>& getAreaCellsDEMPtr() const { return areaCellsDEM; }
+        const TMacroAreaCells& getAreaCellsDEM() const { return *areaCellsDEM; }
+        int getAreaCellsDemSize() const { return int(areaCellsDEM->size()); }
+
+        void setAreaCellsGrid (TMacroAreaCells myCells)
+        { areaCellsGrid = std::make_shared<const TMacroAreaCells>(std::move(myCells)); }
+        void setAreaCellsGrid (const std::shared_ptr<const TMacroAreaCells> &myCells) { areaCellsGrid = myCells; }
+        const std::shared_ptr<const TMacroAreaCells>& getAreaCellsGridPtr() const { return areaCellsGrid; }
+        const TMacroAreaCells& getAreaCellsGrid() const { return *areaCellsGrid; }
+        int getAreaCellsGridSize() const { return int(areaCellsGrid->size()); }
 
         void setParameters (std::vector<std::vector<double>> myParameters) { areaParameters = myParameters; }
-        std::vector<std::vector<double>> getParameters() const { return areaParameters; }
+        const std::vector<std::vector<double>>& getParameters() const { return areaParameters; }
 
         void setCombination (Crit3DProxyCombination myCombination) { areaCombination = myCombination; }
         Crit3DProxyCombination getCombination() const { return areaCombination; }
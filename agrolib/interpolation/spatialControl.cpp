@@ -237,7 +237,6 @@ bool computeResidualsGlocalDetrending(meteoVariable myVar, const Crit3DMacroArea
     //TODO: glocal cv with grid ONLY (no DEM)
     std::vector<Crit3DInterpolationDataPoint> areaInterpolationPoints;
     std::vector<int> meteoPointsList = myArea.getMeteoPoints();
-    std::vector<float> areaCells;
     std::vector<double> myProxyValues;
     bool isValid;
 
@@ -256,17 +255,17 @@ bool computeResidualsGlocalDetrending(meteoVariable myVar, const Crit3DMacroArea
             float weight = NODATA;
 
             //valido solo per DEM
-            areaCells = myArea.getAreaCellsDEM();
+            //const TMacroAreaCells& areaCells = myArea.getAreaCellsDEM();
             //std::string name = meteoPoints[meteoPointsList[i]].name;
             //std::string id = meteoPoints[meteoPointsList[i]].id;
 
             gis::getRowColFromXY(*(interpolationSettings.getCurrentDEM()->header), meteoPoints[meteoPointsList[i]].point.utm, &row, &col);
             //long temp = interpolationSettings.getCurrentDEM()->header->nrCols*row + col;
 
-            /*for (int k = 0; k < (int)areaCells.size(); k = k + 2)
+            /*for (std::size_t k = 0; k < areaCells.size(); k++)
             {
-                if (areaCells[k] == temp)
-                    weight = areaCells[k+1];
+                if (areaCells.index[k] == temp)
+                    weight = areaCells.weight[k];
             }*/
             weight = 1;
 
@@ -328,14 +327,195 @@ float computeErrorCrossValidation(const std::vector<Crit3DMeteoPoint> &meteoPoin
 }
 
 
+bool isSpatialQualityVar(meteoVariable myVar)
+{
+    return (myVar != precipitation && myVar != dailyPrecipitation
+            && myVar != windVectorX && myVar != windVectorY
+            && myVar != windVectorDirection && myVar != dailyWindVectorDirectionPrevailing);
+}
+
+
+/*!
+ * \brief buildNeighbourIndex
+ * computes once the nearest neighbours of every meteo point (geometric distance),
+ * points with null distance are excluded as in neighbourhoodVariability
+ */
+void buildNeighbourIndex(const std::vector<Crit3DMeteoPoint> &meteoPoints, unsigned maxNrNeighbours,
+                         TNeighbourIndex &neighbourIndex, bool isParallelComputing)
+{
+    int nrPoints = int(meteoPoints.size());
+    std::vector<std::vector<std::pair<float, int>>> neighbours(nrPoints);
+    std::vector<bool> isComplete(nrPoints, true);
+
+    #pragma omp parallel for schedule(dynamic) if(isParallelComputing)
+    for (int i = 0; i < nrPoints; i++)
+    {
+        float x = float(meteoPoints[i].point.utm.x);
+        float y = float(meteoPoints[i].point.utm.y);
+
+        std::vector<std::pair<float, int>> candidates;
+        candidates.reserve(nrPoints);
+        for (int j = 0; j < nrPoints; j++)
+        {
+            if (j == i) continue;
+
+            float distance = gis::computeDistance(x, y, float(meteoPoints[j].point.utm.x), float(meteoPoints[j].point.utm.y));
+            if (! isEqual(distance, 0))
+                candidates.push_back(std::make_pair(distance, j));
+        }
+
+        if (candidates.size() > maxNrNeighbours)
+        {
+            std::partial_sort(candidates.begin(), candidates.begin() + maxNrNeighbours, candidates.end());
+            candidates.resize(maxNrNeighbours);
+            isComplete[i] = false;
+        }
+        else
+        {
+            std::sort(candidates.begin(), candidates.end());
+        }
+
+        neighbours[i].swap(candidates);
+    }
+
+    neighbourIndex.offset.assign(nrPoints + 1, 0);
+    for (int i = 0; i < nrPoints; i++)
+        neighbourIndex.offset[i+1] = neighbourIndex.offset[i] + unsigned(neighbours[i].size());
+
+    neighbourIndex.pointIndex.resize(neighbourIndex.offset[nrPoints]);
+    neighbourIndex.distance.resize(neighbourIndex.offset[nrPoints]);
+    for (int i = 0; i < nrPoints; i++)
+    {
+        unsigned k = neighbourIndex.offset[i];
+        for (const auto &neighbour : neighbours[i])
+        {
+            neighbourIndex.distance[k] = neighbour.first;
+            neighbourIndex.pointIndex[k] = neighbour.second;
+            k++;
+        }
+    }
+
+    neighbourIndex.isComplete = isComplete;
+}
+
+
+/*!
+ * \brief neighbourhoodVariabilityFromIndex
+ * same statistics of neighbourhoodVariability, computed on the neighbour index
+ * isComputed = false if the index does not hold enough valid neighbours (full scan is needed)
+ */
+static bool neighbourhoodVariabilityFromIndex(const TNeighbourIndex &neighbourIndex, unsigned pointIndex,
+                                              const std::vector<Crit3DMeteoPoint> &meteoPoints,
+                                              const std::vector<bool> &isInterpolationPoint,
+                                              const Crit3DInterpolationSettings &interpolationSettings,
+                                              int maxNrPoints, float &devSt, float &avgDeltaZ, float &minDistance,
+                                              bool &isComputed)
+{
+    std::vector<float> dataNeighborhood;
+    std::vector<int> validIndex;
+    dataNeighborhood.reserve(maxNrPoints);
+    validIndex.reserve(maxNrPoints);
+
+    for (unsigned k = neighbourIndex.offset[pointIndex]; k < neighbourIndex.offset[pointIndex+1]; k++)
+    {
+        int j = neighbourIndex.pointIndex[k];
+        if (! isInterpolationPoint[j])
+            continue;
+        if (! checkLapseRateCode(meteoPoints[j].lapseRateCode, interpolationSettings.getUseLapseRateCode(), false))
+            continue;
+
+        if (validIndex.empty())
+            minDistance = neighbourIndex.distance[k];
+
+        dataNeighborhood.push_back(meteoPoints[j].currentValue);
+        validIndex.push_back(j);
+        if (int(validIndex.size()) == maxNrPoints)
+            break;
+    }
+
+    isComputed = (int(validIndex.size()) == maxNrPoints || neighbourIndex.isComplete[pointIndex]);
+    if (! isComputed)
+        return false;
+
+    int nrValidPoints = int(validIndex.size());
+    if (nrValidPoints <= 1)
+        return false;
+
+    devSt = statistics::standardDeviation(dataNeighborhood, nrValidPoints);
+
+    float z = float(meteoPoints[pointIndex].point.z);
+    if (z != NODATA)
+    {
+        std::vector<float> deltaZ;
+        for (int j : validIndex)
+        {
+            if (! isEqual(meteoPoints[j].point.z, NODATA))
+                deltaZ.push_back(float(fabs(meteoPoints[j].point.z - z)));
+        }
+        avgDeltaZ = statistics::mean(deltaZ);
+    }
+    else
+    {
+        avgDeltaZ = NODATA;
+    }
+
+    return true;
+}
+
+
+static bool getNeighbourhoodVariability(meteoVariable myVar, const TNeighbourIndex *neighbourIndex, unsigned pointIndex,
+                                        const std::vector<Crit3DMeteoPoint> &meteoPoints, const std::vector<bool> &isInterpolationPoint,
+                                        std::vector<Crit3DInterpolationDataPoint> &interpolationPoints,
+                                        const Crit3DInterpolationSettings &interpolationSettings,
+                                        float &devSt, float &avgDeltaZ, float &minDistance)
+{
+    int nrPointsMax = 10;
+
+    // topographic distance is not stored in the index
+    if (neighbourIndex != nullptr && ! isInterpolationPoint.empty())
+    {
+        bool isComputed;
+        bool isOk = neighbourhoodVariabilityFromIndex(*neighbourIndex, pointIndex, meteoPoints, isInterpolationPoint,
+                                                      interpolationSettings, nrPointsMax, devSt, avgDeltaZ, minDistance, isComputed);
+        if (isComputed)
+            return isOk;
+    }
+
+    return neighbourhoodVariability(myVar, interpolationPoints, interpolationSettings, float(meteoPoints[pointIndex].point.utm.x),
+                                    float(meteoPoints[pointIndex].point.utm.y), float(meteoPoints[pointIndex].point.z),
+                                    nrPointsMax, devSt, avgDeltaZ, minDistance);
+}
+
+
+static void getInterpolationPointMask(const std::vector<Crit3DMeteoPoint> &meteoPoints,
+                                      const std::vector<Crit3DInterpolationDataPoint> &interpolationPoints,
+                                      std::vector<bool> &isInterpolationPoint)
+{
+    isInterpolationPoint.assign(meteoPoints.size(), false);
+    for (const auto &interpolationPoint : interpolationPoints)
+        isInterpolationPoint[interpolationPoint.index] = true;
+}
+
+
 bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
                            Crit3DInterpolationSettings &interpolationSettings, Crit3DMeteoSettings* meteoSettings,
-                           Crit3DClimateParameters* climateParameters, const Crit3DTime &myTime, std::string &errorStr)
+                           Crit3DClimateParameters* climateParameters, const Crit3DTime &myTime, std::string &errorStr,
+                           const TNeighbourIndex *neighbourIndex)
 {
     float stdDev, avgDeltaZ, minDist, myValue, myResidual;
     std::vector <int> listIndex;
     std::vector <float> listResiduals;
     std::vector <Crit3DInterpolationDataPoint> myInterpolationPoints;
+    std::vector <bool> isInterpolationPoint;
+
+    if (neighbourIndex != nullptr)
+    {
+        if (neighbourIndex->nrPoints() != meteoPoints.size()
+            || (interpolationSettings.getUseTD() && getUseTdVar(myVar)))
+        {
+            neighbourIndex = nullptr;
+        }
+    }
 
     if (passDataToInterpolation(meteoPoints, myInterpolationPoints, interpolationSettings))
     {
@@ -353,14 +533,15 @@ bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &m
             return false;
         }
 
+        if (neighbourIndex != nullptr)
+            getInterpolationPointMask(meteoPoints, myInterpolationPoints, isInterpolationPoint);
+
         for (size_t i = 0; i < meteoPoints.size(); i++)
         {
             if (meteoPoints[i].quality == quality::accepted)
             {
-                int nrPointsMax = 10;
-                if (neighbourhoodVariability(myVar, myInterpolationPoints, interpolationSettings, float(meteoPoints[i].point.utm.x),
-                         float(meteoPoints[i].point.utm.y),float(meteoPoints[i].point.z),
-                         nrPointsMax, stdDev, avgDeltaZ, minDist))
+                if (getNeighbourhoodVariability(myVar, neighbourIndex, unsigned(i), meteoPoints, isInterpolationPoint,
+                                                myInterpolationPoints, interpolationSettings, stdDev, avgDeltaZ, minDist))
                 {
                     myValue = meteoPoints[i].currentValue;
                     myResidual = meteoPoints[i].residual;
@@ -391,7 +572,7 @@ bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &m
                                             float(meteoPoints[listIndex[i]].point.utm.x),
                                             float(meteoPoints[listIndex[i]].point.utm.y),
                                             float(meteoPoints[listIndex[i]].point.z),
-                                            meteoPoints[i].getProxyValues(),
+                                            meteoPoints[listIndex[i]].getProxyValues(),
                                             false);
 
                     myValue = meteoPoints[listIndex[i]].currentValue;
@@ -399,13 +580,13 @@ bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &m
                     listResiduals.push_back(interpolatedValue - myValue);
                 }
 
+                if (neighbourIndex != nullptr)
+                    getInterpolationPointMask(meteoPoints, myInterpolationPoints, isInterpolationPoint);
+
                 for (size_t i=0; i < listIndex.size(); i++)
                 {
-                    int nrPointsMax = 10;
-                    if (neighbourhoodVariability(myVar, myInterpolationPoints, interpolationSettings, float(meteoPoints[listIndex[i]].point.utm.x),
-                             float(meteoPoints[listIndex[i]].point.utm.y),
-                             float(meteoPoints[listIndex[i]].point.z),
-                             nrPointsMax, stdDev, avgDeltaZ, minDist))
+                    if (getNeighbourhoodVariability(myVar, neighbourIndex, unsigned(listIndex[i]), meteoPoints, isInterpolationPoint,
+                                                    myInterpolationPoints, interpolationSettings, stdDev, avgDeltaZ, minDist))
                     {
                         myResidual = listResiduals[i];
 
@@ -427,10 +608,110 @@ bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &m
 }
 
 
+/*!
+ * \brief spatialQualityControlPeriod
+ * syntactic and spatial quality control of a series of time steps:
+ * the neighbour index is built once and the time steps are processed in parallel
+ * on private copies of the points (observations are not copied) and of the settings.
+ * output: qualityFlags[step * nrPoints + i] (quality::qualityType)
+ */
+bool spatialQualityControlPeriod(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
+                                 const std::vector<Crit3DTime> &timeList, Crit3DInterpolationSettings &interpolationSettings,
+                                 Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters,
+                                 bool isParallelComputing, std::vector<int> &qualityFlags, std::string &errorStr)
+{
+    qualityFlags.clear();
+    if (meteoPoints.empty() || timeList.empty())
+    {
+        errorStr = "No data.";
+        return false;
+    }
+
+    size_t nrPoints = meteoPoints.size();
+    int nrSteps = int(timeList.size());
+    std::vector<float> values(nrSteps * nrPoints);
+    qualityFlags.resize(nrSteps * nrPoints);
+
+    // values and syntactic control (serial: reads the observations)
+    for (int step = 0; step < nrSteps; step++)
+    {
+        for (size_t i = 0; i < nrPoints; i++)
+            meteoPoints[i].currentValue = meteoPoints[i].getMeteoPointValue(timeList[step], myVar, meteoSettings);
+
+        myQuality->syntacticQualityControl(myVar, meteoPoints);
+
+        for (size_t i = 0; i < nrPoints; i++)
+        {
+            values[step * nrPoints + i] = meteoPoints[i].currentValue;
+            qualityFlags[step * nrPoints + i] = int(meteoPoints[i].quality);
+        }
+    }
+
+    if (! isSpatialQualityVar(myVar))
+        return true;
+
+    TNeighbourIndex neighbourIndex;
+    buildNeighbourIndex(meteoPoints, SPATIAL_QC_NR_NEIGHBOURS, neighbourIndex, isParallelComputing);
+
+    // copy of the points without observations
+    std::vector<Crit3DMeteoPoint> pointProperties(nrPoints);
+    for (size_t i = 0; i < nrPoints; i++)
+        meteoPoints[i].copyPropertiesTo(pointProperties[i]);
+
+    bool isOk = true;
+
+    #pragma omp parallel if(isParallelComputing)
+    {
+        std::vector<Crit3DMeteoPoint> stepPoints = pointProperties;
+        Crit3DInterpolationSettings stepSettings = interpolationSettings;
+        std::string stepError;
+
+        #pragma omp for schedule(dynamic)
+        for (int step = 0; step < nrSteps; step++)
+        {
+            for (size_t i = 0; i < nrPoints; i++)
+            {
+                stepPoints[i].currentValue = values[step * nrPoints + i];
+                stepPoints[i].quality = quality::qualityType(qualityFlags[step * nrPoints + i]);
+            }
+
+            if (! spatialQualityControl(myVar, stepPoints, stepSettings, meteoSettings, climateParameters,
+                                       timeList[step], stepError, &neighbourIndex))
+            {
+                #pragma omp critical
+                {
+                    isOk = false;
+                    errorStr = stepError;
+                }
+                continue;
+            }
+
+            for (size_t i = 0; i < nrPoints; i++)
+                qualityFlags[step * nrPoints + i] = int(stepPoints[i].quality);
+        }
+    }
+
+    return isOk;
+}
+
+
+// assign stored spatial flags (index of meteoPoints) to the data accepted by the syntactic control
+void applySpatialQualityFlags(std::vector<Crit3DMeteoPoint> &meteoPoints, const std::vector<int> &spatialFlags)
+{
+    for (size_t i = 0; i < meteoPoints.size(); i++)
+    {
+        if (meteoPoints[i].quality == quality::accepted && spatialFlags[i] == quality::wrong_spatial)
+            meteoPoints[i].quality = quality::wrong_spatial;
+    }
+}
+
+
 bool checkData(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
             const Crit3DTime &myTime, Crit3DInterpolationSettings &spatialQualityInterpolationSettings,
-            Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters, bool checkSpatial, std::string &errorStr)
+            Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters, bool checkSpatial,
+            std::string &errorStr, const std::vector<int> *storedSpatialFlags)
 {
+
     if (meteoPoints.empty())
         return false;
 
@@ -468,12 +749,14 @@ bool checkData(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3D
         myQuality->syntacticQualityControl(myVar, meteoPoints);
 
         // quality control - spatial
-        if (checkSpatial && myVar != precipitation && myVar != dailyPrecipitation
-                         && myVar != windVectorX && myVar != windVectorY
-                         && myVar != windVectorDirection && myVar != dailyWindVectorDirectionPrevailing)
+        if (checkSpatial && isSpatialQualityVar(myVar))
         {
-            if (! spatialQualityControl(myVar, meteoPoints, spatialQualityInterpolationSettings,
-                                       meteoSettings, climateParameters, myTime, errorStr))
+            if (storedSpatialFlags != nullptr && storedSpatialFlags->size() == meteoPoints.size())
+            {
+                applySpatialQualityFlags(meteoPoints, *storedSpatialFlags);
+            }
+            else if (! spatialQualityControl(myVar, meteoPoints, spatialQualityInterpolationSettings,
+                                            meteoSettings, climateParameters, myTime, errorStr))
             {
                 return false;
             }
@@ -489,10 +772,10 @@ bool checkAndPassDataToInterpolation(Crit3DQuality* myQuality, meteoVariable myV
                                      const Crit3DTime &myTime, Crit3DInterpolationSettings &SQinterpolationSettings,
                                      Crit3DInterpolationSettings &interpolationSettings, Crit3DMeteoSettings *meteoSettings,
                                      Crit3DClimateParameters *climateParameters, std::vector<Crit3DInterpolationDataPoint> &interpolationPoints,
-                                     bool checkSpatial, std::string &errorStr)
+                                     bool checkSpatial, std::string &errorStr, const std::vector<int> *storedSpatialFlags)
 {
     if (! checkData(myQuality, myVar, meteoPoints, myTime, SQinterpolationSettings,
-                   meteoSettings, climateParameters, checkSpatial, errorStr))
+                   meteoSettings, climateParameters, checkSpatial, errorStr, storedSpatialFlags))
         return false;
 
     // return true if at least one valid data
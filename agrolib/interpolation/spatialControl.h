@@ -14,15 +14,30 @@
         #include "interpolationPoint.h"
     #endif
 
+    #define SPATIAL_QC_NR_NEIGHBOURS 30
+
+    // neighbours of each meteo point sorted by distance (CSR layout):
+    // neighbours of point i are in [offset[i], offset[i+1])
+    struct TNeighbourIndex
+    {
+        std::vector<unsigned> offset;
+        std::vector<int> pointIndex;
+        std::vector<float> distance;
+        std::vector<bool> isComplete;       // true if the list holds all the other points
+
+        unsigned nrPoints() const { return offset.empty() ? 0 : unsigned(offset.size() - 1); }
+    };
+
 bool checkData(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
                const Crit3DTime &myTime, Crit3DInterpolationSettings &spatialQualityInterpolationSettings,
-               Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters, bool checkSpatial, std::string &errorStr);
+               Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters, bool checkSpatial,
+               std::string &errorStr, const std::vector<int> *storedSpatialFlags = nullptr);
 
 bool checkAndPassDataToInterpolation(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
                                      const Crit3DTime &myTime, Crit3DInterpolationSettings &SQinterpolationSettings,
                                      Crit3DInterpolationSettings &interpolationSettings, Crit3DMeteoSettings *meteoSettings,
                                      Crit3DClimateParameters *climateParameters, std::vector<Crit3DInterpolationDataPoint> &interpolationPoints,
-                                     bool checkSpatial, std::string &errorStr);
+                                     bool checkSpatial, std::string &errorStr, const std::vector<int> *storedSpatialFlags = nullptr);
 
     bool passDataToInterpolation(const std::vector<Crit3DMeteoPoint> &meteoPoints,
                                  std::vector<Crit3DInterpolationDataPoint> &myInterpolationPoints,
@@ -46,9 +61,22 @@ bool checkAndPassDataToInterpolation(Crit3DQuality* myQuality, meteoVariable myV
 
     float computeErrorCrossValidation(const std::vector<Crit3DMeteoPoint> &meteoPoints);
 
+    bool isSpatialQualityVar(meteoVariable myVar);
+
+    void buildNeighbourIndex(const std::vector<Crit3DMeteoPoint> &meteoPoints, unsigned maxNrNeighbours,
+                             TNeighbourIndex &neighbourIndex, bool isParallelComputing);
+
     bool spatialQualityControl(meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
                                Crit3DInterpolationSettings &interpolationSettings, Crit3DMeteoSettings* meteoSettings,
-                               Crit3DClimateParameters* climateParameters, const Crit3DTime &myTime, std::string &errorStr);
+                               Crit3DClimateParameters* climateParameters, const Crit3DTime &myTime, std::string &errorStr,
+                               const TNeighbourIndex *neighbourIndex = nullptr);
+
+    bool spatialQualityControlPeriod(Crit3DQuality* myQuality, meteoVariable myVar, std::vector<Crit3DMeteoPoint> &meteoPoints,
+                                     const std::vector<Crit3DTime> &timeList, Crit3DInterpolationSettings &interpolationSettings,
+                                     Crit3DMeteoSettings* meteoSettings, Crit3DClimateParameters* climateParameters,
+                                     bool isParallelComputing, std::vector<int> &qualityFlags, std::string &errorStr);
+
+    void applySpatialQualityFlags(std::vector<Crit3DMeteoPoint> &meteoPoints, const std::vector<int> &spatialFlags);
 
     float getSpatialThresholdVar(meteoVariable myVar, Crit3DMeteoSettings* meteoSettings,
                                  float value, float stdDev, int nrStdDev, float avgDeltaZ, float minDistance);
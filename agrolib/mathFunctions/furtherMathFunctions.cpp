@@ -200,6 +200,118 @@ double functionLinear_intercept(double x, std::vector <double>& par)
     return par[0] * x + par[1];
 }
 
+
+/*!
+ *  analytic derivatives of the fitting functions with respect to the parameters,
+ *  they replace the finite differences in the Marquardt jacobian
+ */
+
+void functionLinear_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives)
+{
+    (void) par;
+    derivatives[0] = x;
+}
+
+void functionLinear_intercept_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives)
+{
+    (void) par;
+    derivatives[0] = x;
+    derivatives[1] = 1;
+}
+
+void lapseRatePiecewise_two_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives)
+{
+    derivatives[1] = 1;
+    if (x < par[0])
+    {
+        derivatives[0] = -par[2];
+        derivatives[2] = x - par[0];
+        derivatives[3] = 0;
+    }
+    else
+    {
+        derivatives[0] = -par[3];
+        derivatives[2] = 0;
+        derivatives[3] = x - par[0];
+    }
+}
+
+// par[2] is assumed already limited (>= 10) by lapseRatePiecewise_three
+void lapseRatePiecewise_three_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives)
+{
+    double xb = par[2]+par[0];
+    derivatives[1] = 1;
+    if (x < par[0])
+    {
+        derivatives[0] = -par[4];
+        derivatives[2] = 0;
+        derivatives[3] = 0;
+        derivatives[4] = x - par[0];
+    }
+    else if (x > xb)
+    {
+        derivatives[0] = -par[4];
+        derivatives[2] = par[3] - par[4];
+        derivatives[3] = par[2];
+        derivatives[4] = x - par[0] - par[2];
+    }
+    else
+    {
+        derivatives[0] = -par[3];
+        derivatives[2] = 0;
+        derivatives[3] = x - par[0];
+        derivatives[4] = 0;
+    }
+}
+
+// par[2] is assumed already limited (>= 10) by lapseRatePiecewise_three_free
+void lapseRatePiecewise_three_free_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives)
+{
+    double xb = par[0]+par[2];
+    derivatives[1] = 1;
+    if (x < par[0])
+    {
+        derivatives[0] = -par[4];
+        derivatives[2] = 0;
+        derivatives[3] = 0;
+        derivatives[4] = x - par[0];
+        derivatives[5] = 0;
+    }
+    else if (x > xb)
+    {
+        derivatives[0] = -par[5];
+        derivatives[2] = par[3] - par[5];
+        derivatives[3] = par[2];
+        derivatives[4] = 0;
+        derivatives[5] = x - par[0] - par[2];
+    }
+    else
+    {
+        derivatives[0] = -par[3];
+        derivatives[2] = 0;
+        derivatives[3] = x - par[0];
+        derivatives[4] = 0;
+        derivatives[5] = 0;
+    }
+}
+
+// returns nullptr if the function has no analytic derivatives (finite differences are used)
+fittingDerivatives getFittingDerivatives(double (*func)(double, std::vector<double>&))
+{
+    if (func == functionLinear)
+        return functionLinear_derivatives;
+    if (func == functionLinear_intercept)
+        return functionLinear_intercept_derivatives;
+    if (func == lapseRatePiecewise_two)
+        return lapseRatePiecewise_two_derivatives;
+    if (func == lapseRatePiecewise_three)
+        return lapseRatePiecewise_three_derivatives;
+    if (func == lapseRatePiecewise_three_free)
+        return lapseRatePiecewise_three_free_derivatives;
+
+    return nullptr;
+}
+
 double multilinear(std::vector<double> &x, std::vector<double> &par)
 {
     if (par.size() != (x.size()+1))
@@ -1353,6 +1465,242 @@ namespace interpolation
      *      BEST FITTING MARQUARDT
      */
 
+    // work arrays of the Marquardt fitting: allocated once for all the iterations and first guesses
+    struct MarquardtWorkspace
+    {
+        std::vector<double> P;                  // jacobian [nrData x nrParameters]
+        std::vector<double> normalMatrix;       // P'WP (upper triangle) [nrParameters x nrParameters]
+        std::vector<double> gradient;           // P'W(y - estimates)
+        std::vector<double> a;                  // damped system [nrParameters x nrParameters]
+        std::vector<double> g;
+        std::vector<double> firstEst;
+        std::vector<double> newEst;
+        std::vector<double> paramChange;
+        std::vector<double> newParameters;
+        std::vector<double> lambda;
+        std::vector<double> derivatives;
+        std::vector<double> ones;
+
+        void initialize(int nrParameters, int nrData)
+        {
+            P.resize(size_t(nrParameters * nrData));
+            normalMatrix.resize(size_t(nrParameters * nrParameters));
+            gradient.resize(size_t(nrParameters));
+            a.resize(size_t(nrParameters * nrParameters));
+            g.resize(size_t(nrParameters));
+            firstEst.resize(size_t(nrData));
+            newEst.resize(size_t(nrData));
+            paramChange.assign(size_t(nrParameters), 0);
+            newParameters.assign(size_t(nrParameters), 0);
+            lambda.assign(size_t(nrParameters), 0.01);
+            derivatives.resize(size_t(nrParameters));
+        }
+    };
+
+
+    /*!
+     * \brief Marquardt fitting for one-dimensional functions (elevation)
+     * the jacobian is analytic when derivatives != nullptr, otherwise it is computed by finite differences
+     * weights == nullptr means no weights
+     * a rejected step leaves the parameters unchanged: the estimates, the jacobian and the normal matrix
+     * are reused and only the damping changes
+     */
+    static bool fittingMarquardtWorkspace(double (*func) (double, std::vector<double>&), fittingDerivatives derivatives,
+                                          const std::vector<double> &parametersMin, const std::vector<double> &parametersMax,
+                                          std::vector<double> &parameters, const std::vector<double> &parametersDelta,
+                                          int maxIterationsNr, double myEpsilon,
+                                          const std::vector <double>& x, const std::vector<double>& y,
+                                          const double* weights, MarquardtWorkspace &ws)
+    {
+        int i,j,k;
+        double mySSE, diffSSE, newSSE;
+        static double VFACTOR = 10;
+        int nrParameters = int(parameters.size());
+        int nrData = int(y.size());
+        ws.initialize(nrParameters, nrData);
+
+        double* P = ws.P.data();
+        double* normalMatrix = ws.normalMatrix.data();
+        double* gradient = ws.gradient.data();
+        double* a = ws.a.data();
+        double* g = ws.g.data();
+        double* paramChange = ws.paramChange.data();
+        std::vector<double> &newParameters = ws.newParameters;
+        double* lambda = ws.lambda.data();
+
+        // unit weights when weights are not used
+        const double* w = weights;
+        if (w == nullptr)
+        {
+            ws.ones.assign(size_t(nrData), 1.);
+            w = ws.ones.data();
+        }
+
+        // first set of estimates
+        double error = 0;
+        mySSE = 0;
+        for (i = 0; i < nrData; i++)
+        {
+            ws.firstEst[i] = func(x[i], parameters);
+            error = y[i] - ws.firstEst[i];
+            mySSE += error * error * w[i] * w[i];
+        }
+
+        int iterationNr = 0;
+        double pivot, mult, top;
+        bool isParametersChanged = true;
+        do
+        {
+            if (isParametersChanged)
+            {
+                const double* firstEst = ws.firstEst.data();
+
+                // matrix P corresponds to the Jacobian (one row for each data)
+                if (derivatives != nullptr)
+                {
+                    for (j = 0; j < nrData; j++)
+                    {
+                        derivatives(x[j], parameters, ws.derivatives);
+                        for (k = 0; k < nrParameters; k++)
+                        {
+                            P[j*nrParameters + k] = ws.derivatives[k];
+                        }
+                    }
+                }
+                else
+                {
+                    // change parameters and compute derivatives
+                    for (k = 0; k < nrParameters; k++)
+                    {
+                        parameters[k] += parametersDelta[k];
+                        for (j = 0; j < nrData; j++)
+                        {
+                            P[j*nrParameters + k] = (func(x[j], parameters) - firstEst[j]) / parametersDelta[k];
+                        }
+                        parameters[k] -= parametersDelta[k];
+                    }
+                }
+
+                // normal matrix (upper triangle) and gradient, accumulated by data
+                std::fill(ws.normalMatrix.begin(), ws.normalMatrix.end(), 0.);
+                std::fill(ws.gradient.begin(), ws.gradient.end(), 0.);
+                for (k = 0; k < nrData; k++)
+                {
+                    const double* Pk = P + k*nrParameters;
+                    double residual = y[k] - firstEst[k];
+                    for (i = 0; i < nrParameters; i++)
+                    {
+                        double* ni = normalMatrix + i*nrParameters;
+                        for (j = i; j < nrParameters; j++)
+                        {
+                            ni[j] += Pk[i] * (w[k] * Pk[j]);
+                        }
+                        gradient[i] += Pk[i] * w[k] * residual;
+                    }
+                }
+            }
+
+            // damped system
+            for (i = 0; i < nrParameters; i++)
+            {
+                g[i] = gradient[i];
+                for (j = i; j < nrParameters; j++)
+                {
+                    a[i*nrParameters + j] = normalMatrix[i*nrParameters + j];
+                }
+            }
+            for (k = 0; k < nrParameters; k++)
+            {
+                a[k*nrParameters + k] += lambda[k] * a[k*nrParameters + k];
+                for (j = k+1; j < nrParameters; j++)
+                {
+                    a[j*nrParameters + k] = a[k*nrParameters + j];
+                }
+            }
+
+            // linear system resolution by matrix inversion
+            for (j = 0; j < (nrParameters - 1); j++)
+            {
+                pivot = std::max(a[j*nrParameters + j], EPSILON);
+                for (i = j + 1 ; i < nrParameters; i++)
+                {
+                    mult = a[i*nrParameters + j] / pivot;
+                    for (k = j + 1; k < nrParameters; k++)
+                    {
+                        a[i*nrParameters + k] -= mult * a[j*nrParameters + k];
+                    }
+                    g[i] -= mult * g[j];
+                }
+            }
+
+            paramChange[nrParameters-1] = g[nrParameters-1] / std::max(a[(nrParameters-1)*nrParameters + nrParameters-1], EPSILON);
+
+            for (i = nrParameters - 2; i >= 0; i--)
+            {
+                top = g[i];
+                for (k = i + 1; k < nrParameters; k++)
+                {
+                    top -= a[i*nrParameters + k] * paramChange[k];
+                }
+                paramChange[i] = top / std::max(a[i*nrParameters + i], EPSILON);
+            }
+
+            // change parameters
+            for (j = 0; j < nrParameters; j++)
+            {
+                newParameters[j] = parameters[j] + paramChange[j];
+                if ((newParameters[j] > parametersMax[j]) && (lambda[j] < 1000))
+                {
+                    newParameters[j] = parametersMax[j];
+                    if (lambda[j] < 1000)
+                        lambda[j] *= VFACTOR;
+                }
+                if (newParameters[j] < parametersMin[j])
+                {
+                    newParameters[j] = parametersMin[j];
+                    if (lambda[j] < 1000)
+                        lambda[j] *= VFACTOR;
+                }
+            }
+
+            newSSE = 0;
+            for (i = 0; i < nrData; i++)
+            {
+                ws.newEst[i] = func(x[i], newParameters);
+                error = y[i] - ws.newEst[i];
+                newSSE += error * error * w[i] * w[i];
+            }
+
+            if (newSSE == NODATA)
+                return false;
+
+            diffSSE = mySSE - newSSE ;
+
+            if (diffSSE > 0)
+            {
+                mySSE = newSSE;
+                for (j = 0; j < nrParameters; j++)
+                {
+                    parameters[j] = newParameters[j];
+                    lambda[j] /= VFACTOR;
+                }
+                ws.firstEst.swap(ws.newEst);
+                isParametersChanged = true;
+            }
+            else
+            {
+                for (j = 0; j < nrParameters; j++)
+                {
+                    lambda[j] *= VFACTOR;
+                }
+                isParametersChanged = false;
+            }
+            iterationNr++;
+        } while (fabs(diffSSE) > myEpsilon && iterationNr <= maxIterationsNr);
+
+        return (fabs(diffSSE) <= myEpsilon);
+    }
+
 
     /*! bestFittingMarquardt for ELEVATION
      *  fitting with WEIGHTS (local detrending)
@@ -1363,7 +1711,7 @@ namespace interpolation
                                            std::vector <double>& parameters, std::vector <double>& parametersDelta,
                                            int maxIterationsNr, double myEpsilon, double deltaR2,
                                            std::vector <double>& x ,std::vector<double>& y,
-                                           std::vector<double>& weights, std::vector<std::vector<double>> firstGuessCombinations)
+                                           std::vector<double>& weights, const std::vector<std::vector<double>> &firstGuessCombinations)
     {
         int i,j;
         int nrData = int(y.size());
@@ -1378,14 +1726,16 @@ namespace interpolation
         std::vector <double> R2Previous(nrMinima,NODATA);
         std::vector<double> ySim(nrData);
 
+        // the first guesses share the work arrays and the jacobian function
+        MarquardtWorkspace workspace;
+        fittingDerivatives derivatives = getFittingDerivatives(func);
+
         //grigliato
         for (int k = 0; k < (int)firstGuessCombinations.size(); k++)
         {
             parameters = firstGuessCombinations[k];
-            fittingMarquardt_nDimension(func,parametersMin,
-                                        parametersMax,parameters,
-                                        parametersDelta,maxIterationsNr,
-                                        myEpsilon,x,y,weights);
+            fittingMarquardtWorkspace(func, derivatives, parametersMin, parametersMax, parameters,
+                                      parametersDelta, maxIterationsNr, myEpsilon, x, y, weights.data(), workspace);
 
             for (i=0;i<nrData;i++)
             {
@@ -1418,10 +1768,8 @@ namespace interpolation
         if (bestR2 < 0)
         {
             parameters = firstGuessCombinations[RMSEindex];
-            fittingMarquardt_nDimension(func,parametersMin,
-                                        parametersMax,parameters,
-                                        parametersDelta,maxIterationsNr,
-                                        myEpsilon,x,y,weights);
+            fittingMarquardtWorkspace(func, derivatives, parametersMin, parametersMax, parameters,
+                                      parametersDelta, maxIterationsNr, myEpsilon, x, y, weights.data(), workspace);
         }
         return bestR2;
     }
@@ -1436,7 +1784,7 @@ namespace interpolation
                                            std::vector <double>& parameters, std::vector <double>& parametersDelta,
                                            int maxIterationsNr, double myEpsilon, double deltaR2,
                                            std::vector <double>& x ,std::vector<double>& y,
-                                           std::vector<std::vector<double>> firstGuessCombinations)
+                                           const std::vector<std::vector<double>> &firstGuessCombinations)
     {
         int nrData = int(y.size());
         int nrParameters = int(parameters.size());
@@ -1460,13 +1808,15 @@ namespace interpolation
 
         bool isValid = true;
 
+        // the first guesses share the work arrays and the jacobian function
+        MarquardtWorkspace workspace;
+        fittingDerivatives derivatives = getFittingDerivatives(func);
+
         for (int k = 0; k < int(firstGuessCombinations.size()); k++)
         {
             parameters = firstGuessCombinations[k];
-            fittingMarquardt_nDimension(func,parametersMin,
-                                        parametersMax,parameters,
-                                        parametersDelta,maxIterationsNr,
-                                        myEpsilon,x,y);
+            fittingMarquardtWorkspace(func, derivatives, parametersMin, parametersMax, parameters,
+                                      parametersDelta, maxIterationsNr, myEpsilon, x, y, nullptr, workspace);
 
             bool rangeFlag = true;
             for (size_t i=0; i < parameters.size(); i++)
@@ -1519,10 +1869,8 @@ namespace interpolation
         if (bestR2 < 0 && (RMSEindex != NODATA))
         {
             parameters = firstGuessCombinations[RMSEindex];
-            fittingMarquardt_nDimension(func,parametersMin,
-                                        parametersMax,parameters,
-                                        parametersDelta,maxIterationsNr,
-                                        myEpsilon,x,y);
+            fittingMarquardtWorkspace(func, derivatives, parametersMin, parametersMax, parameters,
+                                      parametersDelta, maxIterationsNr, myEpsilon, x, y, nullptr, workspace);
         }
 
         return bestR2;
@@ -1768,27 +2116,44 @@ namespace interpolation
 
         mySSE = normGeneric_nDimension(func,myFunc, parameters, x, y, weights);
 
+        int nrParametersTotal = 0;
+        for (i=0; i<nrPredictors;i++)
+        {
+            nrParametersTotal += nrParameters[i];
+        }
+
+        // work arrays, allocated once for all the iterations
+        std::vector<double> g(nrParametersTotal);
+        std::vector<double> firstEst(nrData);
+        std::vector<std::vector<double>> a(nrParametersTotal, std::vector<double>(nrParametersTotal));
+        std::vector<std::vector<double>> P(nrParametersTotal, std::vector<double>(nrData));
+        std::vector<std::vector<double>> weightsP(nrParametersTotal, std::vector<double>(nrData));
+
+        // analytic jacobian for a sum of functions with known derivatives
+        std::vector<fittingDerivatives> derivatives(nrPredictors, nullptr);
+        std::vector<double> functionDerivatives;
+        bool isAnalyticJacobian = (func == functionSum);
+        for (i=0; i<nrPredictors && isAnalyticJacobian; i++)
+        {
+            auto target = myFunc[i].target<double(*)(double, std::vector<double>&)>();
+            if (target != nullptr)
+                derivatives[i] = getFittingDerivatives(*target);
+            isAnalyticJacobian = (derivatives[i] != nullptr);
+        }
+
         int iterationNr = 0;
         do
         {
             //least squares function
             int i,j,k;
             double pivot, mult, top;
-            int nrParametersTotal = 0;
-            std::vector <int> nrParameters(nrPredictors);
-            for (i=0; i<nrPredictors;i++)
+
+            std::fill(g.begin(), g.end(), 0.);
+            for (i = 0; i < nrParametersTotal; i++)
             {
-                nrParameters[i] = int(parameters[i].size());
-                nrParametersTotal += nrParameters[i];
+                std::fill(a[i].begin(), a[i].end(), 0.);
             }
 
-            std::vector<double> g(nrParametersTotal,0);
-            //std::vector<double> z(nrParametersTotal);
-            std::vector<double> firstEst(nrData);
-            std::vector<std::vector<double>> a(nrParametersTotal, std::vector<double>(nrParametersTotal,0));
-            std::vector<std::vector<double>> P(nrParametersTotal, std::vector<double>(nrData));
-            std::vector<std::vector<double>> weightsP(nrParametersTotal, std::vector<double>(nrData));
-
             // matrix P corresponds to the Jacobian
             // first set of estimates
             for (i = 0; i < nrData; i++)
@@ -1796,22 +2161,38 @@ namespace interpolation
                 firstEst[i] = func(myFunc,x[i], parameters);
             }
 
-            // change parameters and compute derivatives
             int counterDim = 0;
-            //double newEst;
-            for (i = 0; i < nrPredictors; i++)
+            if (isAnalyticJacobian)
             {
-                for (k=0;k<nrParameters[i];k++)
+                for (i = 0; i < nrPredictors; i++)
                 {
-                    parameters[i][k] += parametersDelta[i][k];
+                    functionDerivatives.resize(nrParameters[i]);
                     for (j = 0; j < nrData; j++)
                     {
-
-                        //newEst = func(myFunc,x[j], parameters);
-                        P[counterDim][j] = (func(myFunc,x[j], parameters) - firstEst[j]) / parametersDelta[i][k];
+                        derivatives[i](x[j][i], parameters[i], functionDerivatives);
+                        for (k=0;k<nrParameters[i];k++)
+                        {
+                            P[counterDim+k][j] = functionDerivatives[k];
+                        }
+                    }
+                    counterDim += nrParameters[i];
+                }
+            }
+            else
+            {
+                // change parameters and compute derivatives
+                for (i = 0; i < nrPredictors; i++)
+                {
+                    for (k=0;k<nrParameters[i];k++)
+                    {
+                        parameters[i][k] += parametersDelta[i][k];
+                        for (j = 0; j < nrData; j++)
+                        {
+                            P[counterDim][j] = (func(myFunc,x[j], parameters) - firstEst[j]) / parametersDelta[i][k];
+                        }
+                        parameters[i][k] -= parametersDelta[i][k];
+                        counterDim++;
                     }
-                    parameters[i][k] -= parametersDelta[i][k];
-                    counterDim++;
                 }
             }
 
@@ -1958,163 +2339,9 @@ namespace interpolation
                                      std::vector <double>& x, std::vector<double>& y,
                                      std::vector<double>& weights)
     {
-        int i,j,k;
-        double mySSE, diffSSE, newSSE;
-        static double VFACTOR = 10;
-        int nrParameters = int(parameters.size());
-        std::vector <double> paramChange(nrParameters,0);
-        std::vector <double> newParameters(nrParameters,0);
-        std::vector <double> lambda (nrParameters,0.01);
-        int nrData = int(y.size());
-
-        double error = 0;
-        mySSE = 0;
-        for (i = 0; i < nrData; i++)
-        {
-            error = y[i] - func(x[i], parameters);
-            mySSE += error * error * weights[i] * weights[i];
-        }
-        int iterationNr = 0;
-        do
-        {
-            double pivot, mult, top;
-            std::vector<double> g(nrParameters,0);
-            std::vector<double> firstEst(nrData);
-            std::vector<std::vector<double>> a(nrParameters, std::vector<double>(nrParameters,0));
-            std::vector<std::vector<double>> P(nrParameters, std::vector<double>(nrData));
-            std::vector<std::vector<double>> weightsP(nrParameters, std::vector<double>(nrData));
-
-            // matrix P corresponds to the Jacobian
-            // first set of estimates
-            for (i = 0; i < nrData; i++)
-            {
-                firstEst[i] = func(x[i], parameters);
-            }
-
-            // change parameters and compute derivatives
-            for (k=0;k<nrParameters;k++)
-            {
-                parameters[k] += parametersDelta[k];
-                for (j = 0; j < nrData; j++)
-                {
-                    P[k][j] = (func(x[j], parameters) - firstEst[j]) / parametersDelta[k];
-                }
-                parameters[k] -= parametersDelta[k];
-            }
-
-            for (i = 0; i < nrParameters; i++)
-            {
-                for (k = 0; k < nrData; k++)
-                {
-                    weightsP[i][k] = weights[k]*P[i][k];
-                }
-            }
-
-            for (i = 0; i < nrParameters; i++)
-            {
-                for (j = i; j < nrParameters; j++)
-                {
-                    //a[i][j] = 0;
-                    for (k = 0; k < nrData; k++)
-                    {
-                        a[i][j] += ((P[i][k] * weightsP[j][k]));
-                    }
-                }
-            }
-
-            for (i = 0; i < nrParameters; i++)
-            {
-                //g[i] = 0.;
-                for (k = 0 ; k < nrData ; k++)
-                {
-                    g[i] += P[i][k] * weights[k]* (y[k] - firstEst[k]);
-                }
-            }
-            for (k=0;k<nrParameters;k++)
-            {
-                a[k][k] += lambda[k]*a[k][k];
-                for (j = k+1; j < nrParameters; j++)
-                {
-                    a[j][k] = a[k][j];
-                }
-            }
-            // linear system resolution by matrix inversion
-
-            for (j = 0; j < (nrParameters - 1); j++)
-            {
-                pivot = std::max(a[j][j],EPSILON);
-                for (i = j + 1 ; i < nrParameters; i++)
-                {
-                    mult = a[i][j] / pivot;
-                    for (k = j + 1; k < nrParameters; k++)
-                    {
-                        a[i][k] -= mult * a[j][k];
-                    }
-                    g[i] -= mult * g[j];
-                }
-            }
-
-            paramChange[nrParameters -1] = g[nrParameters - 1] / std::max(a[nrParameters - 1][nrParameters - 1], EPSILON);
-
-            for (i = nrParameters - 2; i >= 0; i--)
-            {
-                top = g[i];
-                for (k = i + 1; k < nrParameters; k++)
-                {
-                    top -= a[i][k] * paramChange[k];
-                }
-                paramChange[i] = top / std::max(a[i][i], EPSILON);
-            }
-
-            // change parameters
-            for (j=0; j<nrParameters; j++)
-            {
-                newParameters[j] = parameters[j] + paramChange[j];
-                if ((newParameters[j] > parametersMax[j]) && (lambda[j] < 1000))
-                {
-                    newParameters[j] = parametersMax[j];
-                    if (lambda[j] < 1000)
-                        lambda[j] *= VFACTOR;
-                }
-                if (newParameters[j] < parametersMin[j])
-                {
-                    newParameters[j] = parametersMin[j];
-                    if (lambda[j] < 1000)
-                        lambda[j] *= VFACTOR;
-                }
-            }
-
-            newSSE = 0;
-            for (i = 0; i < nrData; i++)
-            {
-                error = y[i] - func(x[i], newParameters);
-                newSSE += error * error * weights[i] * weights[i];
-            }
-
-            if (newSSE == NODATA)
-                return false;
-
-            diffSSE = mySSE - newSSE ;
-
-            if (diffSSE > 0)
-            {
-                mySSE = newSSE;
-                for (j=0; j<nrParameters; j++)
-                {
-                    parameters[j] = newParameters[j];
-                    lambda[j] /= VFACTOR;
-                }
-            }
-            else
-            {
-                for (j=0; j<nrParameters; j++)
-                {
-                    lambda[j] *= VFACTOR;
-                }
-            }
-            iterationNr++;
-        } while (fabs(diffSSE) > myEpsilon && iterationNr <= maxIterationsNr);
-        return (fabs(diffSSE) <= myEpsilon);
+        MarquardtWorkspace workspace;
+        return fittingMarquardtWorkspace(func, getFittingDerivatives(func), parametersMin, parametersMax, parameters,
+                                         parametersDelta, maxIterationsNr, myEpsilon, x, y, weights.data(), workspace);
     }
 
 
@@ -2128,158 +2355,9 @@ namespace interpolation
                                      int maxIterationsNr, double myEpsilon,
                                      std::vector <double>& x, std::vector<double>& y)
     {
-        int i,j,k;
-        double mySSE, diffSSE, newSSE;
-        static double VFACTOR = 10;
-        int nrParameters = int(parameters.size());
-        std::vector <double> paramChange(nrParameters,0);
-        std::vector <double> newParameters(nrParameters,0);
-        std::vector <double> lambda (nrParameters,0.01);
-        int nrData = int(y.size());
-
-        double error = 0;
-        mySSE = 0;
-        for (i = 0; i < nrData; i++)
-        {
-            error = y[i] - func(x[i], parameters);
-            mySSE += error * error;
-        }
-        int iterationNr = 0;
-        double pivot, mult, top;
-        std::vector<double> firstEst(nrData);
-        std::vector<std::vector<double>> P(nrParameters, std::vector<double>(nrData));
-        do
-        {
-
-            std::vector<double> g(nrParameters,0);
-
-            std::vector<std::vector<double>> a(nrParameters, std::vector<double>(nrParameters,0));
-
-            //std::vector<std::vector<double>> weightsP(nrParameters, std::vector<double>(nrData));
-
-            // matrix P corresponds to the Jacobian
-            // first set of estimates
-            for (i = 0; i < nrData; i++)
-            {
-                firstEst[i] = func(x[i], parameters);
-            }
-
-            // change parameters and compute derivatives
-            for (k=0;k<nrParameters;k++)
-            {
-                parameters[k] += parametersDelta[k];
-                for (j = 0; j < nrData; j++)
-                {
-                    P[k][j] = (func(x[j], parameters) - firstEst[j]) / parametersDelta[k];
-                }
-                parameters[k] -= parametersDelta[k];
-            }
-
-            for (i = 0; i < nrParameters; i++)
-            {
-                for (j = i; j < nrParameters; j++)
-                {
-                    //a[i][j] = 0;
-                    for (k = 0; k < nrData; k++)
-                    {
-                        a[i][j] += ((P[i][k] * P[j][k]));
-                    }
-                }
-            }
-
-            for (i = 0; i < nrParameters; i++)
-            {
-                //g[i] = 0.;
-                for (k = 0 ; k < nrData ; k++)
-                {
-                    g[i] += P[i][k] * (y[k] - firstEst[k]);
-                }
-            }
-            for (k=0;k<nrParameters;k++)
-            {
-                a[k][k] += lambda[k]*a[k][k];
-                for (j = k+1; j < nrParameters; j++)
-                {
-                    a[j][k] = a[k][j];
-                }
-            }
-            // linear system resolution by matrix inversion
-
-            for (j = 0; j < (nrParameters - 1); j++)
-            {
-                pivot = std::max(a[j][j],EPSILON);
-                for (i = j + 1 ; i < nrParameters; i++)
-                {
-                    mult = a[i][j] / pivot;
-                    for (k = j + 1; k < nrParameters; k++)
-                    {
-                        a[i][k] -= mult * a[j][k];
-                    }
-                    g[i] -= mult * g[j];
-                }
-            }
-
-            paramChange[nrParameters -1] = g[nrParameters - 1] / std::max(a[nrParameters - 1][nrParameters - 1], EPSILON);
-
-            for (i = nrParameters - 2; i >= 0; i--)
-            {
-                top = g[i];
-                for (k = i + 1; k < nrParameters; k++)
-                {
-                    top -= a[i][k] * paramChange[k];
-                }
-                paramChange[i] = top / std::max(a[i][i], EPSILON);
-            }
-
-            // change parameters
-            for (j=0; j<nrParameters; j++)
-            {
-                newParameters[j] = parameters[j] + paramChange[j];
-                if ((newParameters[j] > parametersMax[j]) && (lambda[j] < 1000))
-                {
-                    newParameters[j] = parametersMax[j];
-                    if (lambda[j] < 1000)
-                        lambda[j] *= VFACTOR;
-                }
-                if (newParameters[j] < parametersMin[j])
-                {
-                    newParameters[j] = parametersMin[j];
-                    if (lambda[j] < 1000)
-                        lambda[j] *= VFACTOR;
-                }
-            }
-
-            newSSE = 0;
-            for (i = 0; i < nrData; i++)
-            {
-                error = y[i] - func(x[i], newParameters);
-                newSSE += error * error;
-            }
-
-            if (newSSE == NODATA)
-                return false;
-
-            diffSSE = mySSE - newSSE ;
-
-            if (diffSSE > 0)
-            {
-                mySSE = newSSE;
-                for (j=0; j<nrParameters; j++)
-                {
-                    parameters[j] = newParameters[j];
-                    lambda[j] /= VFACTOR;
-                }
-            }
-            else
-            {
-                for (j=0; j<nrParameters; j++)
-                {
-                    lambda[j] *= VFACTOR;
-                }
-            }
-            iterationNr++;
-        } while (fabs(diffSSE) > myEpsilon && iterationNr <= maxIterationsNr);
-        return (fabs(diffSSE) <= myEpsilon);
+        MarquardtWorkspace workspace;
+        return fittingMarquardtWorkspace(func, getFittingDerivatives(func), parametersMin, parametersMax, parameters,
+                                         parametersDelta, maxIterationsNr, myEpsilon, x, y, nullptr, workspace);
     }
 
 
@@ -2772,7 +2850,7 @@ namespace interpolation
 
 
     double normGeneric_nDimension(double (*func)(std::vector<std::function<double(double, std::vector<double>&)>>&, std::vector<double>&, std::vector <std::vector <double>>&),
-                                  std::vector<std::function<double (double, std::vector <double>&)>> myFunc,
+                                  std::vector<std::function<double (double, std::vector <double>&)>> &myFunc,
                                   std::vector <std::vector <double>> &parameters,std::vector <std::vector <double>>& x,
                                   std::vector<double>& y, std::vector<double>& weights)
     {
@@ -2787,7 +2865,7 @@ namespace interpolation
         return norm;
     }
     double normGeneric_nDimension(double (*func)(std::vector<std::function<double(double, std::vector<double>&)>>&, std::vector<double>&, std::vector <std::vector <double>>&),
-                                  std::vector<std::function<double (double, std::vector <double>&)>> myFunc,
+                                  std::vector<std::function<double (double, std::vector <double>&)>> &myFunc,
                                   std::vector <std::vector <double>> &parameters,std::vector <std::vector <double>>& x,
                                   std::vector<double>& y)
     {
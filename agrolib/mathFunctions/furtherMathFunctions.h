@@ -60,6 +60,15 @@ enum estimatedFunction {FUNCTION_CODE_SPHERICAL, FUNCTION_CODE_LINEAR, FUNCTION_
     double lapseRatePiecewise_three(double x, std::vector <double>& par);
     double lapseRatePiecewise_three_free(double x, std::vector <double>& par);
 
+    // analytic derivatives with respect to the parameters (Marquardt jacobian)
+    typedef void (*fittingDerivatives)(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    void functionLinear_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    void functionLinear_intercept_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    void lapseRatePiecewise_two_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    void lapseRatePiecewise_three_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    void lapseRatePiecewise_three_free_derivatives(double x, const std::vector <double>& par, std::vector <double>& derivatives);
+    fittingDerivatives getFittingDerivatives(double (*func)(double, std::vector<double>&));
+
     int dijkstraFindMinDistanceNode(const std::vector<double>& dist, const std::vector<bool>& visited, int n);
     void dijkstraShortestPathway(const std::vector<std::vector<double>>& graph, int src, std::vector<double> &dist);
 
@@ -170,19 +179,19 @@ enum estimatedFunction {FUNCTION_CODE_SPHERICAL, FUNCTION_CODE_LINEAR, FUNCTION_
                                                std::vector <double>& parameters, std::vector <double>& parametersDelta,
                                                int maxIterationsNr, double myEpsilon, double deltaR2,
                                                std::vector <double>& x , std::vector<double>& y,
-                                               std::vector<double>& weights, std::vector<std::vector<double> > firstGuessCombinations);
+                                               std::vector<double>& weights, const std::vector<std::vector<double> > &firstGuessCombinations);
         double bestFittingMarquardt_nDimension(double (*func)(double, std::vector<double>&), int nrMinima,
                                                std::vector <double>& parametersMin, std::vector <double>& parametersMax,
                                                std::vector <double>& parameters, std::vector <double>& parametersDelta,
                                                int maxIterationsNr, double myEpsilon, double deltaR2,
                                                std::vector <double>& x , std::vector<double>& y,
-                                               std::vector<std::vector<double> > firstGuessCombinations);
+                                               const std::vector<std::vector<double> > &firstGuessCombinations);
 
         double normGeneric_nDimension(double (*func)(std::vector<std::function<double (double, std::vector<double> &)>> &, std::vector<double> &, std::vector <std::vector <double>>&),
-                                      std::vector<std::function<double (double, std::vector<double> &)> > myFunc,
+                                      std::vector<std::function<double (double, std::vector<double> &)> > &myFunc,
                                       std::vector <std::vector <double>> &parameters, std::vector <std::vector <double>>& x, std::vector<double>& y, std::vector<double>& weights);
         double normGeneric_nDimension(double (*func)(std::vector<std::function<double (double, std::vector<double> &)>> &, std::vector<double> &, std::vector <std::vector <double>>&),
-                                      std::vector<std::function<double (double, std::vector<double> &)> > myFunc,
+                                      std::vector<std::function<double (double, std::vector<double> &)> > &myFunc,
                                       std::vector <std::vector <double>> &parameters, std::vector <std::vector <double>>& x, std::vector<double>& y);
 
         void leastSquares_nDimension_withNormalization(double (*func)(std::vector<std::function<double(double, std::vector<double>&)>>&, std::vector<double>& , std::vector <std::vector <double>>&),
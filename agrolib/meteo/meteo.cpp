@@ -412,6 +412,40 @@ float dailyEtpHargreaves(float Tmin, float Tmax, const Crit3DDate &date, double
 }
 
 
+
+/*!
+ * \brief dailyEtpHargreavesSeries
+ * same as dailyEtpHargreaves on a daily series starting at firstDate (one location):
+ * the quality ranges are read once and the extraterrestrial radiation is computed once for each doy
+ */
+void dailyEtpHargreavesSeries(const std::vector<float> &tMin, const std::vector<float> &tMax, const Crit3DDate &firstDate,
+                              double latitude, Crit3DMeteoSettings* meteoSettings, std::vector<float> &et0)
+{
+    unsigned int nrDays = unsigned(std::min(tMin.size(), tMax.size()));
+    et0.assign(nrDays, NODATA);
+
+    Crit3DQuality qualityCheck;
+    double KT = meteoSettings->getTransSamaniCoefficient();
+    if (KT == NODATA || latitude == NODATA)
+        return;
+
+    std::vector<double> extraTerrRadiation(367, NODATA);
+
+    Crit3DDate date = firstDate;
+    for (unsigned int i = 0; i < nrDays; i++, ++date)
+    {
+        if (qualityCheck.syntacticQualitySingleValue(dailyAirTemperatureMin, tMin[i]) != quality::accepted
+            || qualityCheck.syntacticQualitySingleValue(dailyAirTemperatureMax, tMax[i]) != quality::accepted)
+            continue;
+
+        int doy = getDoyFromDate(date);
+        if (extraTerrRadiation[unsigned(doy)] == NODATA)
+            extraTerrRadiation[unsigned(doy)] = dailyExtrRadiation(latitude, doy);
+
+        et0[i] = float(ET0_HargreavesFromRadiation(KT, extraTerrRadiation[unsigned(doy)], double(tMax[i]), double(tMin[i])));
+    }
+}
+
 float dewPoint(float relHumAir, float tempAir)
 {
     if (relHumAir == NODATA || relHumAir == 0 || tempAir == NODATA)
@@ -681,19 +715,24 @@ double ET0_Penman_hourly_net_rad(double heigth, double netIrradiance, double air
  */
 double ET0_Hargreaves(double KT, double myLat, int myDoy, double tmax, double tmin)
 {
-    double tavg, deltaT, extraTerrRadiation;
-
     if (tmax == NODATA || tmin == NODATA || KT == NODATA || myLat == NODATA || myDoy == NODATA)
         return NODATA;
 
-    extraTerrRadiation = dailyExtrRadiation(myLat, myDoy);
-    deltaT = MAXVALUE(fabs(tmax - tmin), 0.25);
+    return ET0_HargreavesFromRadiation(KT, dailyExtrRadiation(myLat, myDoy), tmax, tmin);
+}
 
-    tavg = (tmax + tmin) * 0.5;
 
-    return std::max(0., 0.0135 * (tavg + 17.78) * KT * (extraTerrRadiation / 2.456) * sqrt(deltaT));
-    
+/*!
+ * \brief ET0_Hargreaves with the extraterrestrial radiation already computed (daily series of a location)
+ * \param extraTerrRadiation [MJ m-2 d-1] daily extraterrestrial radiation
+ */
+double ET0_HargreavesFromRadiation(double KT, double extraTerrRadiation, double tmax, double tmin)
+{
+    double deltaT = MAXVALUE(fabs(tmax - tmin), 0.25);
+    double tavg = (tmax + tmin) * 0.5;
+
     // 2.456 MJ kg-1 latent heat of vaporization
+    return std::max(0., 0.0135 * (tavg + 17.78) * KT * (extraTerrRadiation / 2.456) * sqrt(deltaT));
 }
 
 
@@ -344,6 +344,8 @@
     float dailyThermalRange(float tMin, float tMax);
     float dailyAverageT(float tMin, float tMax);
     float dailyEtpHargreaves(float Tmin, float Tmax, const Crit3DDate& date, double latitude, Crit3DMeteoSettings *meteoSettings);
+    void dailyEtpHargreavesSeries(const std::vector<float> &tMin, const std::vector<float> &tMax, const Crit3DDate& firstDate,
+                                  double latitude, Crit3DMeteoSettings *meteoSettings, std::vector<float> &et0);
     float dewPoint(float relHumAir, float tempAir);
     bool computeLeafWetness(double prec, double relHumidity, short* leafW);
 
@@ -357,6 +359,7 @@
                             double myUmed, double myVmed10, double mySWGlobRad);
 
     double ET0_Hargreaves(double KT, double myLat, int myDoy, double tmax, double tmin);
+    double ET0_HargreavesFromRadiation(double KT, double extraTerrRadiation, double tmax, double tmin);
 
     float computeThomIndex(float temp, float relHum);
 
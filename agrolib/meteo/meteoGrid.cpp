@@ -29,6 +29,8 @@
 #include "statistics.h"
 #include "math.h"
 
+#include <algorithm>
+
 Crit3DMeteoGridStructure::Crit3DMeteoGridStructure()
 {    
 }
@@ -163,14 +165,11 @@ void Crit3DMeteoGridStructure::setNrMembers(int nrMembers)
     _nrMembers = nrMembers;
 }
 
-Crit3DMeteoGridStructure Crit3DMeteoGrid::gridStructure() const
-{
-    return _gridStructure;
-}
-
 Crit3DMeteoGrid::Crit3DMeteoGrid()
 {
     _isAggregationDefined = false;
+    _nrRows = 0;
+    _nrCols = 0;
     _gisSettings.utmZone = 32;
     _isElabValue = false;
     _firstDate = Crit3DDate(1,1,1800);
@@ -180,16 +179,6 @@ Crit3DMeteoGrid::Crit3DMeteoGrid()
 
 Crit3DMeteoGrid::~Crit3DMeteoGrid()
 {
-    for (unsigned int i = 0; i < _meteoPoints.size(); i++)
-    {
-        std::vector<Crit3DMeteoPoint*> meteoPointVector = _meteoPoints[i];
-
-        for (unsigned int j = 0; j < meteoPointVector.size(); j++)
-        {
-            free(meteoPointVector[j]);
-        }
-    }
-
     dataMeteoGrid.clear();
 }
 
@@ -220,7 +209,7 @@ bool Crit3DMeteoGrid::createRasterGrid()
     // not active cells
     for (size_t i=0; i < size_t(_gridStructure.header().nrRows); i++)
         for (size_t j=0; j < size_t(_gridStructure.header().nrCols); j++)
-             if (! _meteoPoints[i][j]->active)
+             if (! meteoPointPointer(i, j)->active)
                  dataMeteoGrid.value[size_t(_gridStructure.header().nrRows)-1-i][j] = NO_ACTIVE;
 
     dataMeteoGrid.isLoaded = true;
@@ -228,51 +217,60 @@ bool Crit3DMeteoGrid::createRasterGrid()
 }
 
 
-std::vector<std::vector<Crit3DMeteoPoint *> > Crit3DMeteoGrid::meteoPoints() const
+Crit3DMeteoPoint& Crit3DMeteoGrid::meteoPoint(unsigned row, unsigned col)
 {
-    return _meteoPoints;
+    return *(meteoPointPointer(row, col));
 }
 
-Crit3DMeteoPoint& Crit3DMeteoGrid::meteoPoint(unsigned row, unsigned col) const
-{
-    return *(_meteoPoints[row][col]);
-}
 
-Crit3DMeteoPoint* Crit3DMeteoGrid::meteoPointPointer(unsigned row, unsigned col) const
+const Crit3DMeteoPoint& Crit3DMeteoGrid::meteoPoint(unsigned row, unsigned col) const
 {
-    return _meteoPoints[row][col];
+    return *(meteoPointPointer(row, col));
 }
 
-void Crit3DMeteoGrid::setMeteoPoints(const std::vector<std::vector<Crit3DMeteoPoint *> > &meteoPoints)
-{
-    _meteoPoints = meteoPoints;
-}
 
+// cells are stored in a single row-major vector: cellIndex = row * nrCols + col
 void Crit3DMeteoGrid::initMeteoPoints(int nRow, int nCol)
 {
+    _meteoPoints.clear();
+    _nrRows = std::max(nRow, 0);
+    _nrCols = std::max(nCol, 0);
+
+    _meteoPoints.resize(size_t(_nrRows) * size_t(_nrCols));
+    for (size_t i = 0; i < _meteoPoints.size(); i++)
+    {
+        _meteoPoints[i].active = false;
+        _meteoPoints[i].selected = false;
+    }
+}
 
-    _meteoPoints.reserve(nRow);
 
-    for (int i = 0; i < nRow; i++)
+void Crit3DMeteoGrid::getActiveCells(std::vector<int> &cellIndexList) const
+{
+    cellIndexList.clear();
+    for (int i = 0; i < nrCells(); i++)
     {
-        std::vector<Crit3DMeteoPoint*> meteoPointVector;
-        meteoPointVector.reserve(nCol);
+        if (_meteoPoints[size_t(i)].active)
+            cellIndexList.push_back(i);
+    }
+}
 
-        for (int j = 0; j < nCol; j++)
-        {
-            Crit3DMeteoPoint* meteoPoint = new Crit3DMeteoPoint;
-            meteoPoint->active = false;
-            meteoPoint->selected = false;
-            meteoPointVector.push_back(meteoPoint);
-        }
 
-        _meteoPoints.push_back(meteoPointVector);
+int Crit3DMeteoGrid::nrActiveCells() const
+{
+    int nrActive = 0;
+    for (size_t i = 0; i < _meteoPoints.size(); i++)
+    {
+        if (_meteoPoints[i].active)
+            nrActive++;
     }
+    return nrActive;
 }
 
+
 void Crit3DMeteoGrid::setActive(unsigned int row,unsigned int col, bool active)
 {
-    _meteoPoints[row][col]->active = active;
+    meteoPointPointer(row, col)->active = active;
 }
 
 
@@ -280,34 +278,36 @@ void Crit3DMeteoGrid::setActive(unsigned int row,unsigned int col, bool active)
 void Crit3DMeteoGrid::fillMeteoPoint(unsigned int row, unsigned int col, const std::string& code, const std::string& name,
                                      const std::string& dataset, int height, bool active, double& utmx, double& utmy)
 {
-    _meteoPoints[row][col]->id = code;
-    _meteoPoints[row][col]->name = name;
-    _meteoPoints[row][col]->dataset = dataset;
-    _meteoPoints[row][col]->point.z = height;
-    _meteoPoints[row][col]->active = active;
+    Crit3DMeteoPoint& cell = meteoPoint(row, col);
+
+    cell.id = code;
+    cell.name = name;
+    cell.dataset = dataset;
+    cell.point.z = height;
+    cell.active = active;
 
     if (_gridStructure.isRegular())
     {
         if (_gridStructure.isUTM())
         {
-            _meteoPoints[row][col]->point.utm.x = _gridStructure.header().llCorner.longitude + _gridStructure.header().dx * (col + 0.5);
-            _meteoPoints[row][col]->point.utm.y = _gridStructure.header().llCorner.latitude + _gridStructure.header().dy * (row + 0.5);
-            gis::utmToLatLon(_gisSettings.utmZone, _gisSettings.startLocation.latitude, _meteoPoints[row][col]->point.utm.x, _meteoPoints[row][col]->point.utm.y, &(_meteoPoints[row][col]->latitude), &(_meteoPoints[row][col]->longitude));    
+            cell.point.utm.x = _gridStructure.header().llCorner.longitude + _gridStructure.header().dx * (col + 0.5);
+            cell.point.utm.y = _gridStructure.header().llCorner.latitude + _gridStructure.header().dy * (row + 0.5);
+            gis::utmToLatLon(_gisSettings.utmZone, _gisSettings.startLocation.latitude, cell.point.utm.x, cell.point.utm.y, &(cell.latitude), &(cell.longitude));
         }
         else
         {
-            _meteoPoints[row][col]->longitude = _gridStructure.header().llCorner.longitude + _gridStructure.header().dx * (col + 0.5);
-            _meteoPoints[row][col]->latitude = _gridStructure.header().llCorner.latitude + _gridStructure.header().dy * (row + 0.5);
+            cell.longitude = _gridStructure.header().llCorner.longitude + _gridStructure.header().dx * (col + 0.5);
+            cell.latitude = _gridStructure.header().llCorner.latitude + _gridStructure.header().dy * (row + 0.5);
 
             gis::Crit3DUtmPoint utmPoint;
-            gis::Crit3DGeoPoint geoPoint(_meteoPoints[row][col]->latitude, _meteoPoints[row][col]->longitude);
+            gis::Crit3DGeoPoint geoPoint(cell.latitude, cell.longitude);
             gis::getUtmFromLatLon(_gisSettings.utmZone, geoPoint, &utmPoint);
-            _meteoPoints[row][col]->point.utm.x = utmPoint.x;
-            _meteoPoints[row][col]->point.utm.y = utmPoint.y;
+            cell.point.utm.x = utmPoint.x;
+            cell.point.utm.y = utmPoint.y;
         }
 
-        utmx = _meteoPoints[row][col]->point.utm.x;
-        utmy = _meteoPoints[row][col]->point.utm.y;
+        utmx = cell.point.utm.x;
+        utmy = cell.point.utm.y;
     }
 }
 
@@ -315,21 +315,21 @@ void Crit3DMeteoGrid::fillCurrentDailyValue(Crit3DDate date, meteoVariable varia
 {
     for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
-            _meteoPoints[row][col]->currentValue = _meteoPoints[row][col]->getMeteoPointValueD(date, variable, meteoSettings);
+            meteoPointPointer(row, col)->currentValue = meteoPointPointer(row, col)->getMeteoPointValueD(date, variable, meteoSettings);
 }
 
 void Crit3DMeteoGrid::fillCurrentHourlyValue(Crit3DDate date, int hour, int minute, meteoVariable variable)
 {
     for (int row = 0; row < _gridStructure.header().nrRows; row++)
         for(int col = 0; col < _gridStructure.header().nrCols; col++)
-            _meteoPoints[row][col]->currentValue = _meteoPoints[row][col]->getMeteoPointValueH(date, hour, minute, variable);
+            meteoPointPointer(row, col)->currentValue = meteoPointPointer(row, col)->getMeteoPointValueH(date, hour, minute, variable);
 }
 
 void Crit3DMeteoGrid::fillCurrentMonthlyValue(Crit3DDate date, meteoVariable variable)
 {
     for (int row = 0; row < _gridStructure.header().nrRows; row++)
         for(int col = 0; col < _gridStructure.header().nrCols; col++)
-            _meteoPoints[row][col]->currentValue = _meteoPoints[row][col]->getMeteoPointValueM(date, variable);
+            meteoPointPointer(row, col)->currentValue = meteoPointPointer(row, col)->getMeteoPointValueM(date, variable);
 }
 
 void Crit3DMeteoGrid::fillMeteoRaster()
@@ -338,9 +338,9 @@ void Crit3DMeteoGrid::fillMeteoRaster()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
-                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = _meteoPoints[i][j]->currentValue;
+                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = meteoPointPointer(i, j)->currentValue;
              }
         }
     }
@@ -352,7 +352,7 @@ void Crit3DMeteoGrid::fillMeteoRasterNoData()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
                  dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = NODATA;
              }
@@ -368,9 +368,9 @@ void Crit3DMeteoGrid::fillMeteoRasterElabValue()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
-                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = _meteoPoints[i][j]->elaboration;
+                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = meteoPointPointer(i, j)->elaboration;
              }
         }
     }
@@ -384,9 +384,9 @@ void Crit3DMeteoGrid::fillMeteoRasterAnomalyValue()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
-                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = _meteoPoints[i][j]->anomaly;
+                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = meteoPointPointer(i, j)->anomaly;
 
              }
         }
@@ -401,9 +401,9 @@ void Crit3DMeteoGrid::fillMeteoRasterAnomalyPercValue()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
-                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = _meteoPoints[i][j]->anomalyPercentage;
+                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = meteoPointPointer(i, j)->anomalyPercentage;
              }
         }
     }
@@ -417,9 +417,9 @@ void Crit3DMeteoGrid::fillMeteoRasterClimateValue()
     {
         for (int j = 0; j < dataMeteoGrid.header->nrCols; j++)
         {
-             if (_meteoPoints[i][j]->active)
+             if (meteoPointPointer(i, j)->active)
              {
-                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = _meteoPoints[i][j]->climate;
+                 dataMeteoGrid.value[_gridStructure.header().nrRows-1-i][j] = meteoPointPointer(i, j)->climate;
              }
         }
     }
@@ -443,7 +443,7 @@ bool Crit3DMeteoGrid::findMeteoPointFromId(unsigned* row, unsigned* col, const s
     {
         for (int j = 0; j < _gridStructure.header().nrCols; j++)
         {
-            if (_meteoPoints[i][j]->id == id)
+            if (meteoPointPointer(i, j)->id == id)
             {
                 *row = i;
                 *col = j;
@@ -463,7 +463,7 @@ bool Crit3DMeteoGrid::existsMeteoPointFromId(const std::string& id)
     {
         for (j = 0; j < unsigned(_gridStructure.header().nrCols); j++)
         {
-            if (_meteoPoints[i][j]->id == id)
+            if (meteoPointPointer(i, j)->id == id)
             {
                 return true;
             }
@@ -480,10 +480,10 @@ bool Crit3DMeteoGrid::getLatLonFromId(std::string id, double* lat, double* lon)
     {
         for (j = 0; j < unsigned(_gridStructure.header().nrCols); j++)
         {
-            if (_meteoPoints[i][j]->id == id)
+            if (meteoPointPointer(i, j)->id == id)
             {
-                *lat = _meteoPoints[i][j]->latitude;
-                *lon = _meteoPoints[i][j]->longitude;
+                *lat = meteoPointPointer(i, j)->latitude;
+                *lon = meteoPointPointer(i, j)->longitude;
                 return true;
             }
         }
@@ -499,9 +499,9 @@ bool Crit3DMeteoGrid::getLatFromId(std::string id, double* lat)
     {
         for (j = 0; j < unsigned(_gridStructure.header().nrCols); j++)
         {
-            if (_meteoPoints[i][j]->id == id)
+            if (meteoPointPointer(i, j)->id == id)
             {
-                *lat = _meteoPoints[i][j]->latitude;
+                *lat = meteoPointPointer(i, j)->latitude;
                 return true;
             }
         }
@@ -517,11 +517,11 @@ bool Crit3DMeteoGrid::getXYZFromId(std::string id, double* x, double* y, double*
     {
         for (j = 0; j < unsigned(_gridStructure.header().nrCols); j++)
         {
-            if (_meteoPoints[i][j]->id == id)
+            if (meteoPointPointer(i, j)->id == id)
             {
-                *x = _meteoPoints[i][j]->point.utm.x;
-                *y = _meteoPoints[i][j]->point.utm.y;
-                *z = _meteoPoints[i][j]->point.z;
+                *x = meteoPointPointer(i, j)->point.utm.x;
+                *y = meteoPointPointer(i, j)->point.utm.y;
+                *z = meteoPointPointer(i, j)->point.z;
                 return true;
             }
         }
@@ -547,13 +547,13 @@ bool Crit3DMeteoGrid::getIdFromLatLon(double lat, double lon, std::string* id)
                     double utmEasting;
                     double utmNorthing;
                     gis::latLonToUtmForceZone(_gisSettings.utmZone, lat, lon, &utmEasting, &utmNorthing);
-                    latitude = _meteoPoints[row][col]->point.utm.y;
-                    longitude = _meteoPoints[row][col]->point.utm.x;
+                    latitude = meteoPointPointer(row, col)->point.utm.y;
+                    longitude = meteoPointPointer(row, col)->point.utm.x;
                     diffLat = fabs(utmNorthing-latitude);
                     diffLon = fabs(utmEasting-longitude);
                     if ( diffLat<(0.5*dy) && diffLon<(0.5*dx))
                     {
-                        *id = _meteoPoints[row][col]->id;
+                        *id = meteoPointPointer(row, col)->id;
                         return true;
                     }
                 }
@@ -565,13 +565,13 @@ bool Crit3DMeteoGrid::getIdFromLatLon(double lat, double lon, std::string* id)
             {
                 for (unsigned int col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
                 {
-                    latitude = _meteoPoints[row][col]->latitude;
-                    longitude = _meteoPoints[row][col]->longitude;
+                    latitude = meteoPointPointer(row, col)->latitude;
+                    longitude = meteoPointPointer(row, col)->longitude;
                     diffLat = fabs(lat-latitude);
                     diffLon = fabs(lon-longitude);
                     if ( diffLat<(0.5*dy) && diffLon<(0.5*dx))
                     {
-                        *id = _meteoPoints[row][col]->id;
+                        *id = meteoPointPointer(row, col)->id;
                         return true;
                     }
                 }
@@ -590,7 +590,7 @@ bool Crit3DMeteoGrid::isMeteoPointActive(int row, int col) const
 {
     if (row >= 0 && row < _gridStructure.header().nrRows && col >= 0 && col < _gridStructure.header().nrCols)
     {
-        return _meteoPoints[row][col]->active;
+        return meteoPointPointer(row, col)->active;
     }
 
     return false;
@@ -601,9 +601,9 @@ bool Crit3DMeteoGrid::getMeteoPointActiveId(int row, int col, std::string &id) c
 {
     if (row >= 0 && row < _gridStructure.header().nrRows && col >= 0 && col < _gridStructure.header().nrCols)
     {
-        if (_meteoPoints[row][col]->active)
+        if (meteoPointPointer(row, col)->active)
         {
-            id = _meteoPoints[row][col]->id;
+            id = meteoPointPointer(row, col)->id;
             return true;
         }
     }
@@ -618,7 +618,7 @@ bool Crit3DMeteoGrid::isActiveMeteoPointFromId(const std::string& id)
     {
         for (int col = 0; col < _gridStructure.header().nrCols; col++)
         {
-            if (_meteoPoints[row][col]->active && _meteoPoints[row][col]->id == id)
+            if (meteoPointPointer(row, col)->active && meteoPointPointer(row, col)->id == id)
             {
                 return true;
             }
@@ -638,11 +638,11 @@ bool Crit3DMeteoGrid::findFirstActiveMeteoPoint(std::string* id, int* row, int*
     {
         for (int j = firstCol; j < _gridStructure.header().nrCols; j++)
         {
-            if (_meteoPoints[i][j]->active)
+            if (meteoPointPointer(i, j)->active)
             {
                 *row = i;
                 *col = j;
-                *id = _meteoPoints[i][j]->id;
+                *id = meteoPointPointer(i, j)->id;
                 return true;
             }
         }
@@ -658,7 +658,7 @@ void Crit3DMeteoGrid::findGridAggregationPoints(gis::Crit3DRasterGrid* myDEM)
 
     for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
-            if (_meteoPoints[row][col]->active)
+            if (meteoPointPointer(row, col)->active)
                 assignCellAggregationPoints(row, col, myDEM, excludeNoData);
 
     _isAggregationDefined = true;
@@ -681,27 +681,27 @@ void Crit3DMeteoGrid::assignCellAggregationPoints(unsigned row, unsigned col, gi
         if (_gridStructure.isUTM())
         {
 
-            _meteoPoints[row][col]->aggregationPoints.clear();
+            meteoPointPointer(row, col)->aggregationPoints.clear();
 
-            utmLL.x = _meteoPoints[row][col]->point.utm.x - (_gridStructure.header().dx / 2) + (myDEM->header->cellSize / 2);
-            utmUR.x = _meteoPoints[row][col]->point.utm.x + (_gridStructure.header().dx / 2);
-            utmLL.y = _meteoPoints[row][col]->point.utm.y - (_gridStructure.header().dy / 2) + (myDEM->header->cellSize / 2);
-            utmUR.y = _meteoPoints[row][col]->point.utm.y + (_gridStructure.header().dy / 2);
+            utmLL.x = meteoPointPointer(row, col)->point.utm.x - (_gridStructure.header().dx / 2) + (myDEM->header->cellSize / 2);
+            utmUR.x = meteoPointPointer(row, col)->point.utm.x + (_gridStructure.header().dx / 2);
+            utmLL.y = meteoPointPointer(row, col)->point.utm.y - (_gridStructure.header().dy / 2) + (myDEM->header->cellSize / 2);
+            utmUR.y = meteoPointPointer(row, col)->point.utm.y + (_gridStructure.header().dy / 2);
 
-            _meteoPoints[row][col]->aggregationPointsMaxNr = 0;
+            meteoPointPointer(row, col)->aggregationPointsMaxNr = 0;
 
             for (double x = utmLL.x; x < utmUR.x; x=x+myDEM->header->cellSize)
             {
                 for (double y = utmLL.y; x < utmUR.y; y=y+myDEM->header->cellSize)
                 {
-                    _meteoPoints[row][col]->aggregationPointsMaxNr = _meteoPoints[row][col]->aggregationPointsMaxNr + 1;
+                    meteoPointPointer(row, col)->aggregationPointsMaxNr = meteoPointPointer(row, col)->aggregationPointsMaxNr + 1;
                     if (!excludeNoData || gis::getValueFromXY(*myDEM, x, y) != myDEM->header->flag )
                     {
                          utmPoint.x = x;
                          utmPoint.y = y;
                          point.utm = utmPoint;
                          point.z = NODATA;
-                        _meteoPoints[row][col]->aggregationPoints.push_back(point);
+                        meteoPointPointer(row, col)->aggregationPoints.push_back(point);
                     }
                 }
             }
@@ -750,8 +750,8 @@ void Crit3DMeteoGrid::assignCellAggregationPoints(unsigned row, unsigned col, gi
 
             myDEM->getRowCol( utmLL.x, utmLL.y, demLL.row, demLL.col);
             myDEM->getRowCol(utmUR.x, utmUR.y, demUR.row, demUR.col);
-            _meteoPoints[row][col]->aggregationPoints.clear();
-            _meteoPoints[row][col]->aggregationPointsMaxNr = 0;
+            meteoPointPointer(row, col)->aggregationPoints.clear();
+            meteoPointPointer(row, col)->aggregationPointsMaxNr = 0;
 
             if ( ((demUR.row >= 0) && (demUR.row < myDEM->header->nrRows)) || ((demLL.row >= 0) && (demLL.row < myDEM->header->nrRows))
                  || ((demUR.col >= 0) && (demUR.col < myDEM->header->nrCols)) || ((demLL.col >= 0) && ( demLL.col < myDEM->header->nrCols)))
@@ -765,7 +765,7 @@ void Crit3DMeteoGrid::assignCellAggregationPoints(unsigned row, unsigned col, gi
 
                         if (pointLatLon.isInsideGrid(latLonHeader))
                         {
-                            _meteoPoints[row][col]->aggregationPointsMaxNr = _meteoPoints[row][col]->aggregationPointsMaxNr + 1;
+                            meteoPointPointer(row, col)->aggregationPointsMaxNr = meteoPointPointer(row, col)->aggregationPointsMaxNr + 1;
                             if (!excludeNoData || myDEM->getValueFromRowCol(demRow, demCol) != myDEM->header->flag )
                             {
                                  gis::getUtmXYFromRowCol(*(myDEM->header), demRow, demCol, &utmX, &utmY);
@@ -773,7 +773,7 @@ void Crit3DMeteoGrid::assignCellAggregationPoints(unsigned row, unsigned col, gi
                                  utmPoint.y = utmY;
                                  point.utm = utmPoint;
                                  point.z = NODATA;
-                                _meteoPoints[row][col]->aggregationPoints.push_back(point);
+                                meteoPointPointer(row, col)->aggregationPoints.push_back(point);
                             }
                         }
                     }
@@ -790,7 +790,7 @@ void Crit3DMeteoGrid::assignGridProxyValues(gis::Crit3DRasterGrid* myRaster)
 
     for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
-            if (_meteoPoints[row][col]->active)
+            if (meteoPointPointer(row, col)->active)
                 assignCellProxyValues(row, col, myRaster, excludeNoData);
 
     return;
@@ -812,10 +812,10 @@ void Crit3DMeteoGrid::assignCellProxyValues(unsigned row, unsigned col, gis::Cri
     {
         if (_gridStructure.isUTM())
         {
-            utmLL.x = _meteoPoints[row][col]->point.utm.x - (_gridStructure.header().dx / 2) + (myRaster->header->cellSize / 2);
-            utmUR.x = _meteoPoints[row][col]->point.utm.x + (_gridStructure.header().dx / 2);
-            utmLL.y = _meteoPoints[row][col]->point.utm.y - (_gridStructure.header().dy / 2) + (myRaster->header->cellSize / 2);
-            utmUR.y = _meteoPoints[row][col]->point.utm.y + (_gridStructure.header().dy / 2);
+            utmLL.x = meteoPointPointer(row, col)->point.utm.x - (_gridStructure.header().dx / 2) + (myRaster->header->cellSize / 2);
+            utmUR.x = meteoPointPointer(row, col)->point.utm.x + (_gridStructure.header().dx / 2);
+            utmLL.y = meteoPointPointer(row, col)->point.utm.y - (_gridStructure.header().dy / 2) + (myRaster->header->cellSize / 2);
+            utmUR.y = meteoPointPointer(row, col)->point.utm.y + (_gridStructure.header().dy / 2);
 
             for (double x = utmLL.x; x < utmUR.x; x=x+myRaster->header->cellSize)
             {
@@ -903,12 +903,12 @@ void Crit3DMeteoGrid::assignCellProxyValues(unsigned row, unsigned col, gis::Cri
             {
                 aggrValue += aggrProxyValues[k];
             }
-            _meteoPoints[row][col]->proxyValues.push_back(aggrValue/aggrProxyValues.size());
+            meteoPointPointer(row, col)->proxyValues.push_back(aggrValue/aggrProxyValues.size());
         }
         else
         {
             aggrValue = NODATA;
-            _meteoPoints[row][col]->proxyValues.push_back(aggrValue);
+            meteoPointPointer(row, col)->proxyValues.push_back(aggrValue);
         }
 
 
@@ -921,12 +921,12 @@ void Crit3DMeteoGrid::assignGridGlocalWeightValues(gis::Crit3DRasterGrid* myRast
 
     for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
-            if (_meteoPoints[row][col]->active)
+            if (meteoPointPointer(row, col)->active)
             {
                 double weight = computeAggrCellGlocalWeightValue(row, col, myRaster, excludeNoData);
 
                 if (! isEqual(weight, NODATA))
-                    _meteoPoints[row][col]->glocalWeights[areaIndex] = (float)weight;
+                    meteoPointPointer(row, col)->glocalWeights[areaIndex] = (float)weight;
             }
 
     return;
@@ -946,10 +946,10 @@ double Crit3DMeteoGrid::computeAggrCellGlocalWeightValue(unsigned row, unsigned
 
     if (_gridStructure.isUTM())
     {
-        utmLL.x = _meteoPoints[row][col]->point.utm.x - (_gridStructure.header().dx / 2) + (myRaster->header->cellSize / 2);
-        utmUR.x = _meteoPoints[row][col]->point.utm.x + (_gridStructure.header().dx / 2);
-        utmLL.y = _meteoPoints[row][col]->point.utm.y - (_gridStructure.header().dy / 2) + (myRaster->header->cellSize / 2);
-        utmUR.y = _meteoPoints[row][col]->point.utm.y + (_gridStructure.header().dy / 2);
+        utmLL.x = meteoPointPointer(row, col)->point.utm.x - (_gridStructure.header().dx / 2) + (myRaster->header->cellSize / 2);
+        utmUR.x = meteoPointPointer(row, col)->point.utm.x + (_gridStructure.header().dx / 2);
+        utmLL.y = meteoPointPointer(row, col)->point.utm.y - (_gridStructure.header().dy / 2) + (myRaster->header->cellSize / 2);
+        utmUR.y = meteoPointPointer(row, col)->point.utm.y + (_gridStructure.header().dy / 2);
 
         for (double x = utmLL.x; x < utmUR.x; x += myRaster->header->cellSize)
             for (double y = utmLL.y; x < utmUR.y; y += myRaster->header->cellSize)
@@ -1042,14 +1042,12 @@ void Crit3DMeteoGrid::initializeData(Crit3DDate dateIni, Crit3DDate dateFin, boo
     int nrDays = dateIni.daysTo(dateFin) + 1;
     int nrMonths = (dateFin.year-dateIni.year)*12+dateFin.month-(dateIni.month-1);
 
-    for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
-        for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
-            if (_meteoPoints[row][col]->active)
-            {
-                if (isHourly) _meteoPoints[row][col]->initializeObsDataH(1, nrDays, dateIni);
-                if (isDaily) _meteoPoints[row][col]->initializeObsDataD(nrDays, dateIni);
-                if (isMonthly) _meteoPoints[row][col]->initializeObsDataM(nrMonths, dateIni.month, dateIni.year);
-            }
+    forEachActiveCell([&](int, int, Crit3DMeteoPoint &meteoPoint)
+    {
+        if (isHourly) meteoPoint.initializeObsDataH(1, nrDays, dateIni);
+        if (isDaily) meteoPoint.initializeObsDataD(nrDays, dateIni);
+        if (isMonthly) meteoPoint.initializeObsDataM(nrMonths, dateIni.month, dateIni.year);
+    });
 }
 
 void Crit3DMeteoGrid::emptyGridData(Crit3DDate dateIni, Crit3DDate dateFin)
@@ -1057,56 +1055,54 @@ void Crit3DMeteoGrid::emptyGridData(Crit3DDate dateIni, Crit3DDate dateFin)
     for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
         {
-            _meteoPoints[row][col]->emptyObsDataH(dateIni, dateFin);
-            _meteoPoints[row][col]->emptyObsDataD(dateIni, dateFin);
-            _meteoPoints[row][col]->emptyObsDataM(dateIni, dateFin);
+            meteoPointPointer(row, col)->emptyObsDataH(dateIni, dateFin);
+            meteoPointPointer(row, col)->emptyObsDataD(dateIni, dateFin);
+            meteoPointPointer(row, col)->emptyObsDataM(dateIni, dateFin);
         }
 }
 
-void Crit3DMeteoGrid::computeRelativeHumidityFromTd(const Crit3DDate myDate, const int myHour)
+void Crit3DMeteoGrid::computeRelativeHumidityFromTd(const Crit3DDate myDate, const int myHour, bool isParallelComputing)
 {
-    float t,td,rh;
+    std::vector<int> activeCells;
+    getActiveCells(activeCells);
 
-    for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
-        for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
-        {
-            if (_meteoPoints[row][col]->active)
-            {
-                t = _meteoPoints[row][col]->getMeteoPointValueH(myDate, myHour, 0, airTemperature);
-                td = _meteoPoints[row][col]->getMeteoPointValueH(myDate, myHour, 0, airDewTemperature);
+    #pragma omp parallel for if(isParallelComputing)
+    for (int i = 0; i < int(activeCells.size()); i++)
+    {
+        Crit3DMeteoPoint* meteoPoint = cellPointer(activeCells[unsigned(i)]);
+        float t = meteoPoint->getMeteoPointValueH(myDate, myHour, 0, airTemperature);
+        float td = meteoPoint->getMeteoPointValueH(myDate, myHour, 0, airDewTemperature);
 
-                if (! isEqual(t, NODATA) && ! isEqual(td, NODATA))
-                {
-                    rh = relHumFromTdew(td, t);
-                    _meteoPoints[row][col]->setMeteoPointValueH(myDate, myHour, 0, airRelHumidity, rh);
-                }
-            }
+        if (! isEqual(t, NODATA) && ! isEqual(td, NODATA))
+        {
+            float rh = relHumFromTdew(td, t);
+            meteoPoint->setMeteoPointValueH(myDate, myHour, 0, airRelHumidity, rh);
         }
+    }
 }
 
-void Crit3DMeteoGrid::computeWindVectorHourly(const Crit3DDate myDate, const int myHour)
+void Crit3DMeteoGrid::computeWindVectorHourly(const Crit3DDate myDate, const int myHour, bool isParallelComputing)
 {
-    float intensity = NODATA, direction = NODATA;
-    float u,v;
+    std::vector<int> activeCells;
+    getActiveCells(activeCells);
 
-    for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
-        for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
+    #pragma omp parallel for if(isParallelComputing)
+    for (int i = 0; i < int(activeCells.size()); i++)
+    {
+        Crit3DMeteoPoint* meteoPoint = cellPointer(activeCells[unsigned(i)]);
+        float u = meteoPoint->getMeteoPointValueH(myDate, myHour, 0, windVectorX);
+        float v = meteoPoint->getMeteoPointValueH(myDate, myHour, 0, windVectorY);
+
+        if (! isEqual(u, NODATA) && ! isEqual(v, NODATA))
         {
-            if (_meteoPoints[row][col]->active)
+            float intensity = NODATA, direction = NODATA;
+            if (computeWindPolar(u, v, &intensity, &direction))
             {
-                u = _meteoPoints[row][col]->getMeteoPointValueH(myDate, myHour, 0, windVectorX);
-                v = _meteoPoints[row][col]->getMeteoPointValueH(myDate, myHour, 0, windVectorY);
-
-                if (! isEqual(u, NODATA) && ! isEqual(v, NODATA))
-                {
-                    if (computeWindPolar(u, v, &intensity, &direction))
-                    {
-                        _meteoPoints[row][col]->setMeteoPointValueH(myDate, myHour, 0, windVectorIntensity, intensity);
-                        _meteoPoints[row][col]->setMeteoPointValueH(myDate, myHour, 0, windVectorDirection, direction);
-                    }
-                }
+                meteoPoint->setMeteoPointValueH(myDate, myHour, 0, windVectorIntensity, intensity);
+                meteoPoint->setMeteoPointValueH(myDate, myHour, 0, windVectorDirection, direction);
             }
         }
+    }
 }
 
 void Crit3DMeteoGrid::fixDailyThermalConsistency(const Crit3DDate myDate)
@@ -1116,16 +1112,16 @@ void Crit3DMeteoGrid::fixDailyThermalConsistency(const Crit3DDate myDate)
     for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
         for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
         {
-            if (_meteoPoints[row][col]->active)
+            if (meteoPointPointer(row, col)->active)
             {
-                tmin = _meteoPoints[row][col]->getMeteoPointValueD(myDate, dailyAirTemperatureMin);
-                tmax = _meteoPoints[row][col]->getMeteoPointValueD(myDate, dailyAirTemperatureMax);
+                tmin = meteoPointPointer(row, col)->getMeteoPointValueD(myDate, dailyAirTemperatureMin);
+                tmax = meteoPointPointer(row, col)->getMeteoPointValueD(myDate, dailyAirTemperatureMax);
 
                 if (! isEqual(tmin, NODATA) && ! isEqual(tmax, NODATA))
                 {
                     if (tmin > tmax)
                     {
-                        _meteoPoints[row][col]->setMeteoPointValueD(myDate, dailyAirTemperatureMin, float(tmax - 0.1));
+                        meteoPointPointer(row, col)->setMeteoPointValueD(myDate, dailyAirTemperatureMin, float(tmax - 0.1));
                     }
                 }
             }
@@ -1142,60 +1138,54 @@ void Crit3DMeteoGrid::spatialAggregateMeteoGrid(meteoVariable myVar, frequencyTy
         findGridAggregationPoints(myDEM);
     }
 
-    for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
+    for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
     {
-        for (unsigned row = 0; row < unsigned(_gridStructure.header().nrRows); row++)
+        for (unsigned col = 0; col < unsigned(_gridStructure.header().nrCols); col++)
         {
-            if (_meteoPoints[row][col]->active)
+            Crit3DMeteoPoint& cell = meteoPoint(row, col);
+            if (! cell.active || cell.aggregationPoints.empty())
+                continue;
+
+            double validValues = 0;
+            for (unsigned int i = 0; i < cell.aggregationPoints.size(); i++)
             {
-                double validValues = 0;
-                for (unsigned int i = 0; i < _meteoPoints[row][col]->aggregationPoints.size(); i++)
+                double x = cell.aggregationPoints[i].utm.x;
+                double y = cell.aggregationPoints[i].utm.y;
+                float interpolatedValue = gis::getValueFromXY(*myRaster, x, y);
+                if (isEqual(interpolatedValue, myRaster->header->flag) == false)
                 {
-                    double x = _meteoPoints[row][col]->aggregationPoints[i].utm.x;
-                    double y = _meteoPoints[row][col]->aggregationPoints[i].utm.y;
-                    float interpolatedValue = gis::getValueFromXY(*myRaster, x, y);
-                    if (isEqual(interpolatedValue, myRaster->header->flag) == false)
-                    {
-                        _meteoPoints[row][col]->aggregationPoints[i].z = double(interpolatedValue);
-                        validValues = validValues + 1;
-                    }
+                    cell.aggregationPoints[i].z = double(interpolatedValue);
+                    validValues = validValues + 1;
                 }
+            }
 
-                if (!_meteoPoints[row][col]->aggregationPoints.empty())
-                {
-
-                    if ( (validValues / _meteoPoints[row][col]->aggregationPointsMaxNr) > ( GRID_MIN_COVERAGE / 100 ) )
-                    {
-
-                        double myValue = spatialAggregateMeteoGridPoint(*(_meteoPoints[row][col]), elab);
-
-                        if (freq == hourly)
-                        {
-                            if (_meteoPoints[row][col]->nrObsDataDaysH == 0)
-                                _meteoPoints[row][col]->initializeObsDataH(1, numberOfDays, date);
-
-                            _meteoPoints[row][col]->setMeteoPointValueH(date, hour, minute, myVar, float(myValue));
-                            _meteoPoints[row][col]->currentValue = float(myValue);
-                        }
-                        else if (freq == daily)
-                        {
-                            if (_meteoPoints[row][col]->nrObsDataDaysD == 0)
-                                _meteoPoints[row][col]->initializeObsDataD(numberOfDays, date);
+            if ( (validValues / cell.aggregationPointsMaxNr) > ( GRID_MIN_COVERAGE / 100 ) )
+            {
+                double myValue = spatialAggregateMeteoGridPoint(cell, elab);
 
-                            _meteoPoints[row][col]->setMeteoPointValueD(date, myVar, float(myValue));
-                            _meteoPoints[row][col]->currentValue = float(myValue);
+                if (freq == hourly)
+                {
+                    if (cell.nrObsDataDaysH == 0)
+                        cell.initializeObsDataH(1, numberOfDays, date);
 
-                        }
-                    }
+                    cell.setMeteoPointValueH(date, hour, minute, myVar, float(myValue));
+                    cell.currentValue = float(myValue);
                 }
+                else if (freq == daily)
+                {
+                    if (cell.nrObsDataDaysD == 0)
+                        cell.initializeObsDataD(numberOfDays, date);
 
+                    cell.setMeteoPointValueD(date, myVar, float(myValue));
+                    cell.currentValue = float(myValue);
+                }
             }
         }
     }
 }
 
 
-double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint, aggregationMethod elab)
+double Crit3DMeteoGrid::spatialAggregateMeteoGridPoint(const Crit3DMeteoPoint &myPoint, aggregationMethod elab)
 {
 
     std::vector <float> validValues;
@@ -1288,73 +1278,124 @@ void Crit3DMeteoGrid::setLastDate(const Crit3DDate &lastDate)
 }
 
 
-void Crit3DMeteoGrid::saveRowColfromZone(gis::Crit3DRasterGrid* zoneGrid, std::vector<std::vector<int> > &meteoGridRow, std::vector<std::vector<int> > &meteoGridCol)
+bool Crit3DMeteoGrid::getActiveRowColFromZoneCell(gis::Crit3DRasterGrid* zoneGrid, int zoneRow, int zoneCol, int &row, int &col)
 {
-    float value;
     double x, y;
+    zoneGrid->getXY(zoneRow, zoneCol, x, y);
+    if (! _gridStructure.isUTM())
+    {
+        double lat, lon;
+        gis::getLatLonFromUtm(_gisSettings, x, y, &lat, &lon);
+        gis::getRowColFromLonLat(_gridStructure.header(), lon, lat, &row, &col);
+    }
+    else
+    {
+        dataMeteoGrid.getRowCol(x, y, row, col);
+    }
+
+    if (row < 0 || col < 0 || row >= _gridStructure.header().nrRows || col >= _gridStructure.header().nrCols)
+        return false;
+
+    return meteoPointPointer(row, col)->active;
+}
+
+
+/*!
+ * \brief saveRowColfromZone
+ * builds the zone index: for each zone (value of zoneGrid) the active meteo grid cells
+ * and the number of zone raster cells falling in each of them. Negative zone values are skipped
+ */
+void Crit3DMeteoGrid::saveRowColfromZone(gis::Crit3DRasterGrid* zoneGrid, TZoneIndex &zoneIndex)
+{
+    zoneIndex.offset.clear();
+    zoneIndex.cellIndex.clear();
+    zoneIndex.weight.clear();
+
+    // pairs (zone, meteo grid cell)
+    std::vector<std::pair<int, int>> zoneCells;
+    int maxZone = -1;
     int myRow, myCol;
+    int nrCols = _gridStructure.header().nrCols;
+
     for (int row = 0; row < zoneGrid->header->nrRows; row++)
     {
         for (int col = 0; col < zoneGrid->header->nrCols; col++)
         {
-            value = zoneGrid->value[row][col];
-            if (value != zoneGrid->header->flag)
-            {
-                zoneGrid->getXY(row, col, x, y);
-                if (! _gridStructure.isUTM())
-                {
-                    double utmX = x;
-                    double utmY = y;
-                    double lat, lon;
-                    gis::getLatLonFromUtm(_gisSettings, utmX, utmY, &lat, &lon);
-                    gis::getRowColFromLonLat(_gridStructure.header(), lon, lat, &myRow, &myCol);
-                }
-                else
-                {
-                    dataMeteoGrid.getRowCol(x, y, myRow, myCol);
-                }
+            float value = zoneGrid->value[row][col];
+            if (isEqual(value, zoneGrid->header->flag) || value < 0)
+                continue;
 
-                if (myRow >= 0 && myCol >= 0 && myRow < _gridStructure.header().nrRows && myCol < _gridStructure.header().nrCols)
-                {
-                    if (_meteoPoints[myRow][myCol]->active == true)
-                    {
-                        meteoGridRow[row][col] = myRow;
-                        meteoGridCol[row][col] = myCol;
-                    }
-                }
+            if (getActiveRowColFromZoneCell(zoneGrid, row, col, myRow, myCol))
+            {
+                int zone = int(value);
+                zoneCells.push_back(std::make_pair(zone, myRow * nrCols + myCol));
+                maxZone = std::max(maxZone, zone);
             }
         }
     }
-}
 
+    std::sort(zoneCells.begin(), zoneCells.end());
 
-void Crit3DMeteoGrid::computeHourlyDerivedVar(Crit3DTime dateTime, meteoVariable myVar, bool useNetRad)
-{
-
-    for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
+    zoneIndex.offset.resize(unsigned(maxZone + 2), 0);
+    for (unsigned int i = 0; i < zoneCells.size(); i++)
     {
-        for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
+        if (i > 0 && zoneCells[i] == zoneCells[i-1])
         {
-            if (_meteoPoints[row][col]->active)
-            {
-                _meteoPoints[row][col]->computeHourlyDerivedVar(dateTime, myVar, useNetRad);
-            }
+            zoneIndex.weight.back() += 1;
+            continue;
         }
+
+        zoneIndex.cellIndex.push_back(zoneCells[i].second);
+        zoneIndex.weight.push_back(1);
+        zoneIndex.offset[unsigned(zoneCells[i].first + 1)]++;
     }
+
+    // cumulative counts
+    for (unsigned int z = 1; z < zoneIndex.offset.size(); z++)
+    {
+        zoneIndex.offset[z] += zoneIndex.offset[z-1];
+    }
+}
+
+
+void Crit3DMeteoGrid::computeHourlyDerivedVar(Crit3DTime dateTime, meteoVariable myVar, bool useNetRad)
+{
+    forEachActiveCell([&](int, int, Crit3DMeteoPoint &meteoPoint)
+    {
+        meteoPoint.computeHourlyDerivedVar(dateTime, myVar, useNetRad);
+    });
 }
 
 void Crit3DMeteoGrid::computeDailyDerivedVar(Crit3DDate date, meteoVariable myVar, Crit3DMeteoSettings& meteoSettings)
 {
+    forEachActiveCell([&](int, int, Crit3DMeteoPoint &meteoPoint)
+    {
+        meteoPoint.computeDailyDerivedVar(date, myVar, meteoSettings);
+    });
+}
 
-    for (unsigned row = 0; row < unsigned(gridStructure().header().nrRows); row++)
+void Crit3DMeteoGrid::computeHourlyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable myVar,
+                                                    bool useNetRad, bool isParallelComputing)
+{
+    std::vector<int> activeCells;
+    getActiveCells(activeCells);
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int i = 0; i < int(activeCells.size()); i++)
     {
-        for (unsigned col = 0; col < unsigned(gridStructure().header().nrCols); col++)
-        {
-            if (_meteoPoints[row][col]->active)
-            {
-                _meteoPoints[row][col]->computeDailyDerivedVar(date, myVar, meteoSettings);
-            }
-        }
+        cellPointer(activeCells[unsigned(i)])->computeHourlyDerivedVarPeriod(firstDate, lastDate, myVar, useNetRad);
     }
 }
 
+void Crit3DMeteoGrid::computeDailyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable myVar,
+                                                   Crit3DMeteoSettings &meteoSettings, bool isParallelComputing)
+{
+    std::vector<int> activeCells;
+    getActiveCells(activeCells);
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int i = 0; i < int(activeCells.size()); i++)
+    {
+        cellPointer(activeCells[unsigned(i)])->computeDailyDerivedVarPeriod(firstDate, lastDate, myVar, meteoSettings);
+    }
+}
@@ -71,6 +71,19 @@
     };
 
 
+    // zone membership of the meteo grid cells in CSR form (zones are the values of a zone raster)
+    // cells of zone z: [offset[z], offset[z+1]), cellIndex = row * nrCols + col of the meteo grid
+    // weight = number of zone raster cells falling in the meteo grid cell
+    struct TZoneIndex
+    {
+        std::vector<unsigned int> offset;
+        std::vector<int> cellIndex;
+        std::vector<float> weight;
+
+        int nrZones() const { return offset.empty() ? 0 : int(offset.size()) - 1; }
+    };
+
+
     class Crit3DMeteoGrid
     {
 
@@ -80,14 +93,43 @@
             Crit3DMeteoGrid();
             ~Crit3DMeteoGrid();
 
-            Crit3DMeteoGridStructure gridStructure() const;
+            const Crit3DMeteoGridStructure& gridStructure() const { return _gridStructure; }
             void setGridStructure(const Crit3DMeteoGridStructure &gridStructure);
 
-            std::vector<std::vector<Crit3DMeteoPoint *>> meteoPoints() const;
-            void setMeteoPoints(const std::vector<std::vector<Crit3DMeteoPoint *> > &meteoPoints);
+            Crit3DMeteoPoint& meteoPoint(unsigned row, unsigned col);
+            const Crit3DMeteoPoint& meteoPoint(unsigned row, unsigned col) const;
+
+            // view on the cell: points are stored contiguously, row-major
+            Crit3DMeteoPoint* meteoPointPointer(unsigned row, unsigned col)
+            { return cellPointer(int(row) * _nrCols + int(col)); }
+
+            const Crit3DMeteoPoint* meteoPointPointer(unsigned row, unsigned col) const
+            { return cellPointer(int(row) * _nrCols + int(col)); }
 
-            Crit3DMeteoPoint& meteoPoint(unsigned row, unsigned col) const;
-            Crit3DMeteoPoint* meteoPointPointer(unsigned row, unsigned col) const;
+            Crit3DMeteoPoint* cellPointer(int cellIndex)
+            { return &_meteoPoints[size_t(cellIndex)]; }
+
+            const Crit3DMeteoPoint* cellPointer(int cellIndex) const
+            { return &_meteoPoints[size_t(cellIndex)]; }
+
+            int nrCells() const { return int(_meteoPoints.size()); }
+            int cellRow(int cellIndex) const { return cellIndex / _nrCols; }
+            int cellCol(int cellIndex) const { return cellIndex % _nrCols; }
+
+            // active cells
+            void getActiveCells(std::vector<int> &cellIndexList) const;
+            int nrActiveCells() const;
+
+            // func(row, col, meteoPoint) is called for each active cell, in row-major order
+            template <typename Function>
+            void forEachActiveCell(Function func)
+            {
+                for (int i = 0; i < nrCells(); i++)
+                {
+                    if (_meteoPoints[size_t(i)].active)
+                        func(cellRow(i), cellCol(i), _meteoPoints[size_t(i)]);
+                }
+            }
 
             void setActive(unsigned int row, unsigned int col, bool active);
 
@@ -137,7 +179,7 @@
             void findGridAggregationPoints(gis::Crit3DRasterGrid* myDEM);
             void assignCellAggregationPoints(unsigned row, unsigned col, gis::Crit3DRasterGrid* myDEM, bool excludeNoData);
             void spatialAggregateMeteoGrid(meteoVariable myVar, frequencyType freq, Crit3DDate date, int  hour, int minute, gis::Crit3DRasterGrid* myDEM, gis::Crit3DRasterGrid *myRaster, aggregationMethod elab);
-            double spatialAggregateMeteoGridPoint(Crit3DMeteoPoint myPoint, aggregationMethod elab);
+            double spatialAggregateMeteoGridPoint(const Crit3DMeteoPoint &myPoint, aggregationMethod elab);
 
             void assignGridProxyValues(gis::Crit3DRasterGrid* myRaster);
             void assignCellProxyValues(unsigned row, unsigned col, gis::Crit3DRasterGrid* myRaster, bool excludeNoData);
@@ -148,24 +190,33 @@
             bool getIsElabValue() const;
             void setIsElabValue(bool isElabValue);
 
-            void saveRowColfromZone(gis::Crit3DRasterGrid* zoneGrid, std::vector<std::vector<int> > &meteoGridRow, std::vector<std::vector<int> > &meteoGridCol);
+            void saveRowColfromZone(gis::Crit3DRasterGrid* zoneGrid, TZoneIndex &zoneIndex);
 
-            void computeRelativeHumidityFromTd(const Crit3DDate myDate, const int myHour);
-            void computeWindVectorHourly(const Crit3DDate myDate, const int myHour);
+            void computeRelativeHumidityFromTd(const Crit3DDate myDate, const int myHour, bool isParallelComputing);
+            void computeWindVectorHourly(const Crit3DDate myDate, const int myHour, bool isParallelComputing);
             void fixDailyThermalConsistency(const Crit3DDate myDate);
             void computeHourlyDerivedVar(Crit3DTime dateTime, meteoVariable myVar, bool useNetRad);
             void computeDailyDerivedVar(Crit3DDate date, meteoVariable myVar, Crit3DMeteoSettings &meteoSettings);
 
+            // derived variables on a period: each active cell is computed on its whole series
+            void computeHourlyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable myVar,
+                                               bool useNetRad, bool isParallelComputing);
+            void computeDailyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable myVar,
+                                              Crit3DMeteoSettings &meteoSettings, bool isParallelComputing);
+
     private:
 
             Crit3DMeteoGridStructure _gridStructure;
-            std::vector<std::vector<Crit3DMeteoPoint*> > _meteoPoints;
+            std::vector<Crit3DMeteoPoint> _meteoPoints;          // nrRows * nrCols cells, row-major
+            int _nrRows, _nrCols;
             gis::Crit3DGisSettings _gisSettings;
 
             bool _isAggregationDefined;
             Crit3DDate _firstDate;
             Crit3DDate _lastDate;
             bool _isElabValue;
+
+            bool getActiveRowColFromZoneCell(gis::Crit3DRasterGrid* zoneGrid, int zoneRow, int zoneCol, int &row, int &col);
     };
 
 
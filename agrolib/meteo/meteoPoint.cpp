@@ -27,6 +27,7 @@
 #include <math.h>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include "commonConstants.h"
 #include "basicMath.h"
@@ -36,6 +37,95 @@
 #include "meteo.h"
 
 
+TDailyVarOffset getDailyVarOffset(meteoVariable myVar)
+{
+    switch(myVar)
+    {
+    case dailyAirTemperatureMax:
+        return &TObsDataD::tMax;
+    case dailyAirTemperatureMin:
+        return &TObsDataD::tMin;
+    case dailyAirTemperatureAvg:
+        return &TObsDataD::tAvg;
+    case dailyPrecipitation:
+        return &TObsDataD::prec;
+    case dailyAirRelHumidityMax:
+        return &TObsDataD::rhMax;
+    case dailyAirRelHumidityMin:
+        return &TObsDataD::rhMin;
+    case dailyAirRelHumidityAvg:
+        return &TObsDataD::rhAvg;
+    case dailyGlobalRadiation:
+        return &TObsDataD::globRad;
+    case dailyReferenceEvapotranspirationHS:
+        return &TObsDataD::et0_hs;
+    case dailyReferenceEvapotranspirationPM:
+        return &TObsDataD::et0_pm;
+    case dailyBIC:
+        return &TObsDataD::bic;
+    case dailyHeatingDegreeDays:
+        return &TObsDataD::dd_heating;
+    case dailyCoolingDegreeDays:
+        return &TObsDataD::dd_cooling;
+    case dailyWindScalarIntensityAvg:
+        return &TObsDataD::windScalIntAvg;
+    case dailyWindScalarIntensityMax:
+        return &TObsDataD::windScalIntMax;
+    case dailyWindVectorIntensityAvg:
+        return &TObsDataD::windVecIntAvg;
+    case dailyWindVectorIntensityMax:
+        return &TObsDataD::windVecIntMax;
+    case dailyWindVectorDirectionPrevailing:
+        return &TObsDataD::windVecDirPrev;
+    case dailyLeafWetness:
+        return &TObsDataD::leafW;
+    case dailyWaterTableDepth:
+        return &TObsDataD::waterTable;
+    default:
+        return nullptr;
+    }
+}
+
+
+// leafWetness is stored as int: not included
+THourlyVarOffset getHourlyVarOffset(meteoVariable myVar)
+{
+    switch(myVar)
+    {
+    case airTemperature:
+        return &TObsDataH::tAir;
+    case precipitation:
+        return &TObsDataH::prec;
+    case airRelHumidity:
+        return &TObsDataH::rhAir;
+    case airDewTemperature:
+        return &TObsDataH::tDew;
+    case globalIrradiance:
+        return &TObsDataH::irradiance;
+    case netIrradiance:
+        return &TObsDataH::netIrradiance;
+    case referenceEvapotranspiration:
+        return &TObsDataH::et0;
+    case windScalarIntensity:
+        return &TObsDataH::windScalInt;
+    case windVectorX:
+        return &TObsDataH::windVecX;
+    case windVectorY:
+        return &TObsDataH::windVecY;
+    case windVectorIntensity:
+        return &TObsDataH::windVecInt;
+    case windVectorDirection:
+        return &TObsDataH::windVecDir;
+    case atmTransmissivity:
+        return &TObsDataH::transmissivity;
+    case atmPressure:
+        return &TObsDataH::pressure;
+    default:
+        return nullptr;
+    }
+}
+
+
 Crit3DMeteoPoint::Crit3DMeteoPoint()
 {
     this->clear();
@@ -69,6 +159,8 @@ void Crit3DMeteoPoint::clear()
     this->hourlyFraction = 1;
 
     this->_obsDataH = nullptr;
+    this->_firstDateD = Crit3DDate();
+    this->_firstSerialDateD = Crit3DSerialDate();
 
     this->currentValue = NODATA;
     this->residual = NODATA;
@@ -233,6 +325,9 @@ void Crit3DMeteoPoint::initializeObsDataD(unsigned int numberOfDays, const Crit3
         obsDataD[i].waterTable = NODATA;
         ++myDate;
     }
+
+    _firstDateD = firstDate;
+    _firstSerialDateD = Crit3DSerialDate(firstDate);
 }
 
 
@@ -303,41 +398,23 @@ void Crit3DMeteoPoint::emptyVarObsDataH(meteoVariable myVar, const Crit3DDate& m
     int i = _obsDataH[0].date.daysTo(myDate);
     residual = NODATA;
 
-    if (i >= 0 && i < nrObsDataDaysH)
-        if (_obsDataH[i].date == myDate)
-            for (int j = 0; j < nrDayValues; j++)
-            {
-                if (myVar == airTemperature)
-                    _obsDataH[i].tAir[j] = NODATA;
-                else if (myVar == precipitation)
-                    _obsDataH[i].prec[j] = NODATA;
-                else if (myVar == airRelHumidity)
-                    _obsDataH[i].rhAir[j] = NODATA;
-                else if (myVar == airDewTemperature)
-                    _obsDataH[i].tDew[j] = NODATA;
-                else if (myVar == globalIrradiance)
-                    _obsDataH[i].irradiance[j] = NODATA;
-                else if (myVar == netIrradiance)
-                    _obsDataH[i].netIrradiance[j] = NODATA;
-                else if (myVar == windScalarIntensity)
-                    _obsDataH[i].windScalInt[j] = NODATA;
-                else if (myVar == windVectorX)
-                    _obsDataH[i].windVecX[j] = NODATA;
-                else if (myVar == windVectorY)
-                    _obsDataH[i].windVecY[j] = NODATA;
-                else if (myVar == windVectorIntensity)
-                    _obsDataH[i].windVecInt[j] = NODATA;
-                else if (myVar == windVectorDirection)
-                    _obsDataH[i].windVecDir[j] = NODATA;
-                else if (myVar == leafWetness)
-                    _obsDataH[i].leafW[j] = NODATA;
-                else if (myVar == atmTransmissivity)
-                    _obsDataH[i].transmissivity[j] = NODATA;
-				else if (myVar == referenceEvapotranspiration)
-                    _obsDataH[i].et0[j] = NODATA;
-                else if (myVar == atmPressure)
-                    _obsDataH[i].pressure[j] = NODATA;
-			}
+    if (i < 0 || i >= nrObsDataDaysH || _obsDataH[i].date != myDate)
+        return;
+
+    if (myVar == leafWetness)
+    {
+        for (int j = 0; j < nrDayValues; j++)
+            _obsDataH[i].leafW[j] = NODATA;
+        return;
+    }
+
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return;
+
+    float* values = _obsDataH[i].*varOffset;
+    for (int j = 0; j < nrDayValues; j++)
+        values[j] = NODATA;
 }
 
 void Crit3DMeteoPoint::emptyVarObsDataH(meteoVariable myVar, const Crit3DDate& date1, const Crit3DDate& date2)
@@ -349,40 +426,24 @@ void Crit3DMeteoPoint::emptyVarObsDataH(meteoVariable myVar, const Crit3DDate& d
     int indexFin = _obsDataH[0].date.daysTo(date2);
     residual = NODATA;
 
+    if (myVar == leafWetness)
+    {
+        for (int i = indexIni; i <= indexFin; i++)
+            for (int j = 0; j < nrDayValues; j++)
+                _obsDataH[i].leafW[j] = NODATA;
+        return;
+    }
+
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return;
+
     for (int i = indexIni; i <= indexFin; i++)
+    {
+        float* values = _obsDataH[i].*varOffset;
         for (int j = 0; j < nrDayValues; j++)
-        {
-            if (myVar == airTemperature)
-                _obsDataH[i].tAir[j] = NODATA;
-            else if (myVar == precipitation)
-                _obsDataH[i].prec[j] = NODATA;
-            else if (myVar == airRelHumidity)
-                _obsDataH[i].rhAir[j] = NODATA;
-            else if (myVar == airDewTemperature)
-                _obsDataH[i].tDew[j] = NODATA;
-            else if (myVar == globalIrradiance)
-                _obsDataH[i].irradiance[j] = NODATA;
-            else if (myVar == netIrradiance)
-                _obsDataH[i].netIrradiance[j] = NODATA;
-            else if (myVar == windScalarIntensity)
-                _obsDataH[i].windScalInt[j] = NODATA;
-            else if (myVar == windVectorX)
-                _obsDataH[i].windVecX[j] = NODATA;
-            else if (myVar == windVectorY)
-                _obsDataH[i].windVecY[j] = NODATA;
-            else if (myVar == windVectorIntensity)
-                _obsDataH[i].windVecInt[j] = NODATA;
-            else if (myVar == windVectorDirection)
-                _obsDataH[i].windVecDir[j] = NODATA;
-            else if (myVar == leafWetness)
-                _obsDataH[i].leafW[j] = NODATA;
-            else if (myVar == atmTransmissivity)
-                _obsDataH[i].transmissivity[j] = NODATA;
-			else if (myVar == referenceEvapotranspiration)
-                _obsDataH[i].et0[j] = NODATA;
-            else if (myVar == atmPressure)
-                _obsDataH[i].pressure[j] = NODATA;
-        }
+            values[j] = NODATA;
+    }
 }
 
 void Crit3DMeteoPoint::emptyObsDataH(const Crit3DDate& date1, const Crit3DDate& date2)
@@ -422,45 +483,12 @@ void Crit3DMeteoPoint::emptyVarObsDataD(meteoVariable myVar, const Crit3DDate& d
     int indexFin = obsDataD[0].date.daysTo(date2);
     residual = NODATA;
 
+    TDailyVarOffset varOffset = getDailyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return;
+
     for (unsigned int i = indexIni; i <= unsigned(indexFin); i++)
-        if (myVar == dailyAirTemperatureMax)
-            obsDataD[i].tMax = NODATA;
-        else if (myVar == dailyAirTemperatureMin)
-            obsDataD[i].tMin = NODATA;
-        else if (myVar == dailyAirTemperatureAvg)
-            obsDataD[i].tAvg = NODATA;
-        else if (myVar == dailyPrecipitation)
-            obsDataD[i].prec = NODATA;
-        else if (myVar == dailyAirRelHumidityMax)
-            obsDataD[i].rhMax = NODATA;
-        else if (myVar == dailyAirRelHumidityMin)
-            obsDataD[i].rhMin = NODATA;
-        else if (myVar == dailyAirRelHumidityAvg)
-            obsDataD[i].rhAvg = NODATA;
-        else if (myVar == dailyGlobalRadiation)
-            obsDataD[i].globRad = NODATA;
-        else if (myVar == dailyWindScalarIntensityAvg)
-            obsDataD[i].windScalIntAvg = NODATA;
-        else if (myVar == dailyWindScalarIntensityMax)
-            obsDataD[i].windScalIntMax = NODATA;
-        else if (myVar == dailyWindVectorIntensityAvg)
-            obsDataD[i].windVecIntAvg = NODATA;
-        else if (myVar == dailyWindVectorIntensityMax)
-            obsDataD[i].windVecIntMax = NODATA;
-        else if (myVar == dailyWindVectorDirectionPrevailing)
-            obsDataD[i].windVecDirPrev = NODATA;
-        else if (myVar == dailyReferenceEvapotranspirationHS)
-            obsDataD[i].et0_hs = NODATA;
-        else if (myVar == dailyReferenceEvapotranspirationPM)
-            obsDataD[i].et0_pm = NODATA;
-        else if (myVar == dailyBIC)
-            obsDataD[i].bic = NODATA;
-        else if (myVar == dailyLeafWetness)
-            obsDataD[i].leafW = NODATA;
-        else if (myVar == dailyHeatingDegreeDays)
-            obsDataD[i].dd_heating = NODATA;
-        else if (myVar == dailyCoolingDegreeDays)
-            obsDataD[i].dd_cooling = NODATA;
+        obsDataD[i].*varOffset = NODATA;
 }
 
 void Crit3DMeteoPoint::emptyObsDataD(const Crit3DDate& date1, const Crit3DDate& date2)
@@ -523,7 +551,7 @@ bool Crit3DMeteoPoint::isDateLoadedH(const Crit3DDate& myDate)
         return true;
 }
 
-bool Crit3DMeteoPoint::isDateTimeLoadedH(const Crit3DTime& myDateTime)
+bool Crit3DMeteoPoint::isDateTimeLoadedH(const Crit3DTime& myDateTime) const
 {
     if (nrObsDataDaysH == 0)
         return false;
@@ -683,6 +711,30 @@ void Crit3DMeteoPoint::cleanAllData()
 }
 
 
+/*!
+ * \brief copyPropertiesTo
+ * copy of the point without observed data: daily and monthly data are not copied,
+ * hourly data are not shared. outPoint must not hold hourly data
+ */
+void Crit3DMeteoPoint::copyPropertiesTo(Crit3DMeteoPoint &outPoint)
+{
+    std::vector<TObsDataD> myObsDataD;
+    std::vector<TObsDataM> myObsDataM;
+    myObsDataD.swap(obsDataD);
+    myObsDataM.swap(obsDataM);
+
+    outPoint = *this;
+
+    obsDataD.swap(myObsDataD);
+    obsDataM.swap(myObsDataM);
+
+    outPoint._obsDataH = nullptr;
+    outPoint.nrObsDataDaysH = 0;
+    outPoint.nrObsDataDaysD = 0;
+    outPoint.nrObsDataDaysM = 0;
+}
+
+
 bool Crit3DMeteoPoint::setMeteoPointValueH(const Crit3DDate& myDate, int myHour, int myMinutes, meteoVariable myVar, float myValue)
 {
     if (myVar == noMeteoVar || _obsDataH == nullptr)
@@ -718,38 +770,6 @@ bool Crit3DMeteoPoint::setMeteoPointValueH(const Crit3DDate& myDate, int myHour,
 
     switch (myVar)
     {
-    case airTemperature:
-        _obsDataH[iDay].tAir[j] = myValue;
-        break;
-
-    case precipitation:
-        _obsDataH[iDay].prec[j] = myValue;
-        break;
-
-    case airRelHumidity:
-        _obsDataH[iDay].rhAir[j] = myValue;
-        break;
-
-    case airDewTemperature:
-        _obsDataH[iDay].tDew[j] = myValue;
-        break;
-
-    case globalIrradiance:
-        _obsDataH[iDay].irradiance[j] = myValue;
-        break;
-
-    case netIrradiance:
-        _obsDataH[iDay].netIrradiance[j] = myValue;
-        break;
-
-    case referenceEvapotranspiration:
-        _obsDataH[iDay].et0[j] = myValue;
-        break;
-
-    case windScalarIntensity:
-        _obsDataH[iDay].windScalInt[j] = myValue;
-        break;
-
     case windVectorX:
     {
         float intensity = NODATA, direction = NODATA;
@@ -794,16 +814,14 @@ bool Crit3DMeteoPoint::setMeteoPointValueH(const Crit3DDate& myDate, int myHour,
         _obsDataH[iDay].leafW[j] = int(myValue);
         break;
 
-    case atmTransmissivity:
-        _obsDataH[iDay].transmissivity[j] = myValue;
-        break;
-
-    case atmPressure:
-        _obsDataH[iDay].pressure[j] = myValue;
-        break;
-
     default:
-        return false;
+    {
+        THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+        if (varOffset == nullptr)
+            return false;
+
+        (_obsDataH[iDay].*varOffset)[j] = myValue;
+    }
     }
 
     return true;
@@ -816,54 +834,20 @@ bool Crit3DMeteoPoint::setMeteoPointValueD(const Crit3DDate& myDate, meteoVariab
     if ((index < 0) || (index >= nrObsDataDaysD))
         return false;
 
-    unsigned i = unsigned(index);
+    return setMeteoPointValueD(int(index), myVar, myValue);
+}
 
-    switch(myVar)
-    {
-    case dailyAirTemperatureMax:
-        obsDataD[i].tMax = myValue; break;
-    case dailyAirTemperatureMin:
-        obsDataD[i].tMin = myValue; break;
-    case dailyAirTemperatureAvg:
-        obsDataD[i].tAvg = myValue; break;
-    case dailyPrecipitation:
-        obsDataD[i].prec = myValue; break;
-    case dailyAirRelHumidityMax:
-        obsDataD[i].rhMax = myValue; break;
-    case dailyAirRelHumidityMin:
-        obsDataD[i].rhMin = myValue; break;
-    case dailyAirRelHumidityAvg:
-        obsDataD[i].rhAvg = myValue; break;
-    case dailyGlobalRadiation:
-        obsDataD[i].globRad = myValue; break;
-    case dailyReferenceEvapotranspirationHS:
-        obsDataD[i].et0_hs = myValue; break;
-    case dailyReferenceEvapotranspirationPM:
-        obsDataD[i].et0_pm = myValue; break;
-    case dailyBIC:
-        obsDataD[i].bic = myValue; break;
-    case dailyHeatingDegreeDays:
-        obsDataD[i].dd_heating = myValue; break;
-    case dailyCoolingDegreeDays:
-        obsDataD[i].dd_cooling = myValue; break;
-    case dailyWindScalarIntensityAvg:
-        obsDataD[i].windScalIntAvg = myValue; break;
-    case dailyWindScalarIntensityMax:
-        obsDataD[i].windScalIntMax = myValue; break;
-    case dailyWindVectorIntensityAvg:
-        obsDataD[i].windVecIntAvg = myValue; break;
-    case dailyWindVectorIntensityMax:
-        obsDataD[i].windVecIntMax = myValue; break;
-    case dailyWindVectorDirectionPrevailing:
-        obsDataD[i].windVecDirPrev = myValue; break;
-    case dailyLeafWetness:
-        obsDataD[i].leafW = myValue; break;
-    case dailyWaterTableDepth:
-        obsDataD[i].waterTable = myValue; break;
-    default:
+
+bool Crit3DMeteoPoint::setMeteoPointValueD(int dayIndex, meteoVariable myVar, float myValue)
+{
+    if ((dayIndex < 0) || (dayIndex >= nrObsDataDaysD))
         return false;
-    }
 
+    TDailyVarOffset varOffset = getDailyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return false;
+
+    obsDataD[unsigned(dayIndex)].*varOffset = myValue;
     return true;
 }
 
@@ -958,45 +942,59 @@ float Crit3DMeteoPoint::getMeteoPointValueH(const Crit3DDate& myDate, int myHour
         return NODATA;
     }
 
-    if (myVar == airTemperature)
-        return (_obsDataH[iDay].tAir[j]);
-    else if (myVar == precipitation)
-        return (_obsDataH[iDay].prec[j]);
-    else if (myVar == airRelHumidity)
-        return (_obsDataH[iDay].rhAir[j]);
-    else if (myVar == airDewTemperature)
+    if (myVar == airDewTemperature)
     {
         if (! isEqual(_obsDataH[iDay].tDew[j], NODATA))
             return _obsDataH[iDay].tDew[j];
         else
             return tDewFromRelHum(_obsDataH[iDay].rhAir[j], _obsDataH[iDay].tAir[j]);
     }
-    else if (myVar == globalIrradiance)
-        return (_obsDataH[iDay].irradiance[j]);
-    else if (myVar == netIrradiance)
-        return (_obsDataH[iDay].netIrradiance[j]);
-    else if (myVar == referenceEvapotranspiration)
-        return (_obsDataH[iDay].et0[j]);
-    else if (myVar == windScalarIntensity)
-        return (_obsDataH[iDay].windScalInt[j]);
-    else if (myVar == windVectorX)
-        return (_obsDataH[iDay].windVecX[j]);
-    else if (myVar == windVectorY)
-        return (_obsDataH[iDay].windVecY[j]);
-    else if (myVar == windVectorIntensity)
-        return (_obsDataH[iDay].windVecInt[j]);
-    else if (myVar == windVectorDirection)
-        return (_obsDataH[iDay].windVecDir[j]);
-    else if (myVar == leafWetness)
+    if (myVar == leafWetness)
         return float(_obsDataH[iDay].leafW[j]);
-    else if (myVar == atmTransmissivity)
-        return (_obsDataH[iDay].transmissivity[j]);
-    else if (myVar == atmPressure)
-        return (_obsDataH[iDay].pressure[j]);
-    else
-    {
+
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr)
         return NODATA;
+
+    return (_obsDataH[iDay].*varOffset)[j];
+}
+
+
+// index of myDate in the hourly series, NODATA if not loaded
+int Crit3DMeteoPoint::getHourlyDayIndex(const Crit3DDate &myDate) const
+{
+    if (_obsDataH == nullptr) return NODATA;
+
+    int iDay = _obsDataH[0].date.daysTo(myDate);
+    if (iDay < 0 || iDay >= nrObsDataDaysH) return NODATA;
+
+    return iDay;
+}
+
+
+// valueIndex: [0, hourlyFraction * 24) the last value of the day is hour 24
+float Crit3DMeteoPoint::getMeteoPointValueH(int dayIndex, int valueIndex, meteoVariable myVar) const
+{
+    if (_obsDataH == nullptr) return NODATA;
+    if (dayIndex < 0 || dayIndex >= nrObsDataDaysH) return NODATA;
+    if (valueIndex < 0 || valueIndex >= hourlyFraction * 24) return NODATA;
+
+    const TObsDataH &dayData = _obsDataH[dayIndex];
+    if (myVar == airDewTemperature)
+    {
+        if (! isEqual(dayData.tDew[valueIndex], NODATA))
+            return dayData.tDew[valueIndex];
+        else
+            return tDewFromRelHum(dayData.rhAir[valueIndex], dayData.tAir[valueIndex]);
     }
+    if (myVar == leafWetness)
+        return float(dayData.leafW[valueIndex]);
+
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return NODATA;
+
+    return (dayData.*varOffset)[valueIndex];
 }
 
 
@@ -1070,22 +1068,59 @@ float Crit3DMeteoPoint::getDailyET0_HS(const TObsDataD &dailyData, const Crit3DD
 }
 
 
-float Crit3DMeteoPoint::getMeteoPointValueD(const Crit3DDate &myDate, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings) const
+// index of myDate in the daily series, NODATA if not loaded
+int Crit3DMeteoPoint::getDailyIndex(const Crit3DDate &myDate) const
 {
-    //check
-    if (myVar == noMeteoVar) return NODATA;
     if (nrObsDataDaysD == 0) return NODATA;
 
     int index = obsDataD[0].date.daysTo(myDate);
     if ((index < 0) || (index >= nrObsDataDaysD)) return NODATA;
 
-    unsigned i = unsigned(index);
+    return index;
+}
+
+
+int Crit3DMeteoPoint::getDailyIndex(const Crit3DSerialDate &myDate) const
+{
+    if (nrObsDataDaysD == 0) return NODATA;
+
+    // obsDataD may be assigned directly: the cached serial date is checked against the first date
+    if (obsDataD[0].date != _firstDateD)
+    {
+        _firstDateD = obsDataD[0].date;
+        _firstSerialDateD = Crit3DSerialDate(_firstDateD);
+    }
+
+    int index = _firstSerialDateD.daysTo(myDate);
+    if ((index < 0) || (index >= nrObsDataDaysD)) return NODATA;
+
+    return index;
+}
+
+
+float Crit3DMeteoPoint::getMeteoPointValueD(const Crit3DDate &myDate, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings) const
+{
+    //check
+    if (myVar == noMeteoVar) return NODATA;
+
+    int index = getDailyIndex(myDate);
+    if (index == NODATA) return NODATA;
+
+    return getMeteoPointValueD(index, myVar, meteoSettings);
+}
+
+
+float Crit3DMeteoPoint::getMeteoPointValueD(int dayIndex, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings) const
+{
+    //check
+    if (myVar == noMeteoVar) return NODATA;
+    if ((dayIndex < 0) || (dayIndex >= nrObsDataDaysD)) return NODATA;
+
+    unsigned i = unsigned(dayIndex);
+    const Crit3DDate &myDate = obsDataD[i].date;
 
-    if (myVar == dailyAirTemperatureMax)
-        return (obsDataD[i].tMax);
-    else if (myVar == dailyAirTemperatureMin)
-        return (obsDataD[i].tMin);
-    else if (myVar == dailyAirTemperatureAvg)
+    // derived values
+    if (myVar == dailyAirTemperatureAvg)
     {
         if (! isEqual(obsDataD[i].tAvg, NODATA))
             return obsDataD[i].tAvg;
@@ -1094,16 +1129,6 @@ float Crit3DMeteoPoint::getMeteoPointValueD(const Crit3DDate &myDate, meteoVaria
         else
             return NODATA;
     }
-    else if (myVar == dailyPrecipitation)
-        return (obsDataD[i].prec);
-    else if (myVar == dailyAirRelHumidityMax)
-        return (obsDataD[i].rhMax);
-    else if (myVar == dailyAirRelHumidityMin)
-        return float(obsDataD[i].rhMin);
-    else if (myVar == dailyAirRelHumidityAvg)
-        return (obsDataD[i].rhAvg);
-    else if (myVar == dailyGlobalRadiation)
-        return (obsDataD[i].globRad);
     else if (myVar == dailyReferenceEvapotranspirationHS)
     {
         return getDailyET0_HS(obsDataD[i], myDate, meteoSettings);
@@ -1125,28 +1150,12 @@ float Crit3DMeteoPoint::getMeteoPointValueD(const Crit3DDate &myDate, meteoVaria
 
         return bic;
     }
-    else if (myVar == dailyReferenceEvapotranspirationPM)
-        return (obsDataD[i].et0_pm);
-    else if (myVar == dailyHeatingDegreeDays)
-        return (obsDataD[i].dd_heating);
-    else if (myVar == dailyCoolingDegreeDays)
-        return (obsDataD[i].dd_cooling);
-    else if (myVar == dailyWindScalarIntensityAvg)
-        return (obsDataD[i].windScalIntAvg);
-    else if (myVar == dailyWindScalarIntensityMax)
-        return (obsDataD[i].windScalIntMax);
-    else if (myVar == dailyWindVectorIntensityAvg)
-        return (obsDataD[i].windVecIntAvg);
-    else if (myVar == dailyWindVectorIntensityMax)
-        return (obsDataD[i].windVecIntMax);
-    else if (myVar == dailyWindVectorDirectionPrevailing)
-        return (obsDataD[i].windVecDirPrev);
-    else if (myVar == dailyLeafWetness)
-        return (obsDataD[i].leafW);
-    else if (myVar == dailyWaterTableDepth)
-        return (obsDataD[i].waterTable);
-    else
+
+    TDailyVarOffset varOffset = getDailyVarOffset(myVar);
+    if (varOffset == nullptr)
         return NODATA;
+
+    return obsDataD[i].*varOffset;
 }
 
 
@@ -1154,55 +1163,98 @@ float Crit3DMeteoPoint::getMeteoPointValueD(const Crit3DDate &myDate, meteoVaria
 {
     //check
     if (myVar == noMeteoVar) return NODATA;
-    if (nrObsDataDaysD == 0) return NODATA;
 
-    int index = obsDataD[0].date.daysTo(myDate);
-    if ((index < 0) || (index >= nrObsDataDaysD)) return NODATA;
+    int index = getDailyIndex(myDate);
+    if (index == NODATA) return NODATA;
 
-    unsigned i = unsigned(index);
+    return getMeteoPointValueD(index, myVar);
+}
 
-    if (myVar == dailyAirTemperatureMax)
-        return (obsDataD[i].tMax);
-    else if (myVar == dailyAirTemperatureMin)
-        return (obsDataD[i].tMin);
-    else if (myVar == dailyAirTemperatureAvg)
-        return obsDataD[i].tAvg;
-    else if (myVar == dailyPrecipitation)
-        return (obsDataD[i].prec);
-    else if (myVar == dailyAirRelHumidityMax)
-        return (obsDataD[i].rhMax);
-    else if (myVar == dailyAirRelHumidityMin)
-        return float(obsDataD[i].rhMin);
-    else if (myVar == dailyAirRelHumidityAvg)
-        return (obsDataD[i].rhAvg);
-    else if (myVar == dailyGlobalRadiation)
-        return (obsDataD[i].globRad);
-    else if (myVar == dailyReferenceEvapotranspirationHS)
-        return obsDataD[i].et0_hs;
-    else if (myVar == dailyReferenceEvapotranspirationPM)
-        return (obsDataD[i].et0_pm);
-    else if (myVar == dailyBIC)
-        return obsDataD[i].bic;
-    else if (myVar == dailyHeatingDegreeDays)
-        return obsDataD[i].dd_heating;
-    else if (myVar == dailyCoolingDegreeDays)
-        return obsDataD[i].dd_cooling;
-    else if (myVar == dailyWindScalarIntensityAvg)
-        return (obsDataD[i].windScalIntAvg);
-    else if (myVar == dailyWindScalarIntensityMax)
-        return (obsDataD[i].windScalIntMax);
-    else if (myVar == dailyWindVectorIntensityAvg)
-        return (obsDataD[i].windVecIntAvg);
-    else if (myVar == dailyWindVectorIntensityMax)
-        return (obsDataD[i].windVecIntMax);
-    else if (myVar == dailyWindVectorDirectionPrevailing)
-        return (obsDataD[i].windVecDirPrev);
-    else if (myVar == dailyLeafWetness)
-        return (obsDataD[i].leafW);
-    else if (myVar == dailyWaterTableDepth)
-        return (obsDataD[i].waterTable);
-    else
+
+float Crit3DMeteoPoint::getMeteoPointValueD(int dayIndex, meteoVariable myVar) const
+{
+    if ((dayIndex < 0) || (dayIndex >= nrObsDataDaysD)) return NODATA;
+
+    TDailyVarOffset varOffset = getDailyVarOffset(myVar);
+    if (varOffset == nullptr)
         return NODATA;
+
+    return obsDataD[unsigned(dayIndex)].*varOffset;
+}
+
+
+// copy the stored values of myVar in [firstDate, lastDate] (one value per day)
+// obsDataD is an array of daily records (one struct per day): the values of a variable
+// are strided, so a contiguous view is not possible and the series is gathered into a copy
+bool Crit3DMeteoPoint::getDailySeries(meteoVariable myVar, const Crit3DDate& firstDate, const Crit3DDate& lastDate,
+                                      std::vector<float> &values) const
+{
+    values.clear();
+    TDailyVarOffset varOffset = getDailyVarOffset(myVar);
+    if (varOffset == nullptr || lastDate < firstDate)
+        return false;
+
+    int nrDays = firstDate.daysTo(lastDate) + 1;
+    values.resize(unsigned(nrDays), NODATA);
+    if (nrObsDataDaysD == 0)
+        return true;
+
+    int firstIndex = obsDataD[0].date.daysTo(firstDate);
+    int i1 = std::max(0, -firstIndex);
+    int i2 = std::min(nrDays, int(nrObsDataDaysD) - firstIndex);
+    for (int i = i1; i < i2; i++)
+    {
+        values[unsigned(i)] = obsDataD[unsigned(firstIndex + i)].*varOffset;
+    }
+
+    return true;
+}
+
+
+// contiguous values of a day: hourlyFraction * 24 values, from the first interval to hour 24
+// nullptr if the day is not loaded or the variable is not stored as float
+const float* Crit3DMeteoPoint::getHourlyDayValues(meteoVariable myVar, const Crit3DDate& myDate) const
+{
+    if (_obsDataH == nullptr)
+        return nullptr;
+
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr)
+        return nullptr;
+
+    int iDay = _obsDataH[0].date.daysTo(myDate);
+    if (iDay < 0 || iDay >= nrObsDataDaysH)
+        return nullptr;
+
+    return _obsDataH[iDay].*varOffset;
+}
+
+
+// copy the stored values of myVar in [firstDate, lastDate] (hourlyFraction * 24 values per day)
+bool Crit3DMeteoPoint::getHourlySeries(meteoVariable myVar, const Crit3DDate& firstDate, const Crit3DDate& lastDate,
+                                       std::vector<float> &values) const
+{
+    values.clear();
+    THourlyVarOffset varOffset = getHourlyVarOffset(myVar);
+    if (varOffset == nullptr || lastDate < firstDate)
+        return false;
+
+    int nrDays = firstDate.daysTo(lastDate) + 1;
+    int nrDayValues = std::max(hourlyFraction, 1) * 24;
+    values.resize(unsigned(nrDays * nrDayValues), NODATA);
+    if (_obsDataH == nullptr)
+        return true;
+
+    int firstIndex = _obsDataH[0].date.daysTo(firstDate);
+    int i1 = std::max(0, -firstIndex);
+    int i2 = std::min(nrDays, int(nrObsDataDaysH) - firstIndex);
+    for (int i = i1; i < i2; i++)
+    {
+        const float* dayValues = _obsDataH[firstIndex + i].*varOffset;
+        std::copy(dayValues, dayValues + nrDayValues, values.begin() + i * nrDayValues);
+    }
+
+    return true;
 }
 
 float Crit3DMeteoPoint::getMeteoPointValueM(const Crit3DDate &myDate, meteoVariable myVar) const
@@ -1289,7 +1341,7 @@ bool Crit3DMeteoPoint::computeHourlyDerivedVar(const Crit3DTime &dateTime, meteo
     {
         if (computeLeafWetness(getMeteoPointValueH(myDate, myHour, 0, precipitation),
                                getMeteoPointValueH(myDate, myHour, 0, airRelHumidity), &valueShort))
-            setMeteoPointValueH(myDate, myHour, 0, leafWetness, float(valueShort));
+            value = float(valueShort);
     }
     else if (myVar == referenceEvapotranspiration)
     {
@@ -1335,6 +1387,75 @@ bool Crit3DMeteoPoint::computeDailyDerivedVar(const Crit3DDate &date, meteoVaria
 }
 
 
+// derived variable on the loaded days of [firstDate, lastDate], computed on the whole series
+bool Crit3DMeteoPoint::computeDailyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate,
+                                                    meteoVariable myVar, Crit3DMeteoSettings& meteoSettings)
+{
+    if (myVar != dailyReferenceEvapotranspirationHS || nrObsDataDaysD == 0)
+        return false;
+
+    std::vector<float> tMin, tMax, et0;
+    getDailySeries(dailyAirTemperatureMin, firstDate, lastDate, tMin);
+    getDailySeries(dailyAirTemperatureMax, firstDate, lastDate, tMax);
+
+    dailyEtpHargreavesSeries(tMin, tMax, firstDate, latitude, &meteoSettings, et0);
+
+    int firstIndex = obsDataD[0].date.daysTo(firstDate);
+    int i1 = std::max(0, -firstIndex);
+    int i2 = std::min(int(et0.size()), int(nrObsDataDaysD) - firstIndex);
+    for (int i = i1; i < i2; i++)
+    {
+        obsDataD[unsigned(firstIndex + i)].et0_hs = et0[unsigned(i)];
+    }
+
+    return true;
+}
+
+
+// hourly derived variable on the loaded days of [firstDate, lastDate] (all the values of each day)
+bool Crit3DMeteoPoint::computeHourlyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate,
+                                                     meteoVariable myVar, bool useNetRad)
+{
+    if (_obsDataH == nullptr || (myVar != leafWetness && myVar != referenceEvapotranspiration))
+        return false;
+
+    int nrDayValues = std::max(hourlyFraction, 1) * 24;
+    int firstIndex = std::max(0, _obsDataH[0].date.daysTo(firstDate));
+    int lastIndex = std::min(int(nrObsDataDaysH) - 1, _obsDataH[0].date.daysTo(lastDate));
+
+    for (int d = firstIndex; d <= lastIndex; d++)
+    {
+        TObsDataH &dayData = _obsDataH[d];
+
+        for (int i = 0; i < nrDayValues; i++)
+        {
+            if (myVar == leafWetness)
+            {
+                short valueShort;
+                if (computeLeafWetness(dayData.prec[i], dayData.rhAir[i], &valueShort))
+                    dayData.leafW[i] = valueShort;
+                else
+                    dayData.leafW[i] = int(NODATA);
+            }
+            else if (useNetRad)
+            {
+                dayData.et0[i] = float(ET0_Penman_hourly_net_rad(double(point.z), double(dayData.netIrradiance[i]),
+                                                                 double(dayData.tAir[i]), double(dayData.rhAir[i]),
+                                                                 double(dayData.windScalInt[i])));
+            }
+            else
+            {
+                dayData.et0[i] = float(ET0_Penman_hourly(double(point.z), double(dayData.transmissivity[i] / float(0.75)),
+                                                         double(dayData.irradiance[i]), double(dayData.tAir[i]),
+                                                         double(dayData.rhAir[i]), double(dayData.windScalInt[i])));
+            }
+        }
+    }
+
+    return true;
+}
+
+
 bool Crit3DMeteoPoint::computeMonthlyAggregate(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable dailyMeteoVar,
                                                Crit3DMeteoSettings* meteoSettings, Crit3DQuality* qualityCheck,
                                                Crit3DClimateParameters* climateParam)
@@ -1455,11 +1576,17 @@ float Crit3DMeteoPoint::getPercValueVariable(const Crit3DDate &firstDate, const
     int nrValidValues = 0;
     int nrTotValues = 0;
 
-    for (Crit3DDate myDate = firstDate; myDate <= lastDate; ++myDate)
+    std::vector<float> values;
+    if (! getDailySeries(dailyMeteoVar, firstDate, lastDate, values))
+    {
+        // not stored variable
+        values.assign(unsigned(std::max(firstDate.daysTo(lastDate) + 1, 0)), NODATA);
+    }
+
+    for (unsigned i = 0; i < values.size(); i++)
     {
         nrTotValues = nrTotValues + 1;
-        float value = getMeteoPointValueD(myDate, dailyMeteoVar);
-        quality::qualityType qualityT = qualityCheck.syntacticQualitySingleValue(dailyMeteoVar, value);
+        quality::qualityType qualityT = qualityCheck.syntacticQualitySingleValue(dailyMeteoVar, values[i]);
         if (qualityT == quality::accepted)
         {
             nrValidValues = nrValidValues + 1;
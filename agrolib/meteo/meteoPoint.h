@@ -61,6 +61,14 @@
         float waterTable;       // [m]
     };
 
+    // offset of a stored variable inside the observation structs (column of the variable)
+    // resolved once per query, nullptr if the variable is not stored as float
+    typedef float TObsDataD::* TDailyVarOffset;
+    typedef float* TObsDataH::* THourlyVarOffset;
+
+    TDailyVarOffset getDailyVarOffset(meteoVariable myVar);
+    THourlyVarOffset getHourlyVarOffset(meteoVariable myVar);
+
     struct TObsDataM {
         int _month;
         int _year;
@@ -133,9 +141,10 @@
 
             void cleanObsDataH();
             void cleanAllData();
+            void copyPropertiesTo(Crit3DMeteoPoint &outPoint);
 
             bool isDateLoadedH(const Crit3DDate& myDate);
-            bool isDateTimeLoadedH(const Crit3DTime& myDateTime);
+            bool isDateTimeLoadedH(const Crit3DTime& myDateTime) const;
             bool isDateIntervalLoadedH(const Crit3DDate& date1, const Crit3DDate& date2);
             bool isDateIntervalLoadedH(const Crit3DTime& time1, const Crit3DTime& time2);
             float obsDataConsistencyH(meteoVariable myVar, const Crit3DTime& time1, const Crit3DTime& time2);
@@ -156,12 +165,29 @@
             bool existDailyData() { return ! obsDataD.empty(); }
             bool existHourlyData() { return (nrObsDataDaysH > 0); }
 
+            // day index access: compute the index once (getDailyIndex / getHourlyDayIndex) and iterate
+            int getDailyIndex(const Crit3DDate& myDate) const;
+            int getDailyIndex(const Crit3DSerialDate& myDate) const;
+            int getHourlyDayIndex(const Crit3DDate& myDate) const;
+            float getMeteoPointValueD(int dayIndex, meteoVariable myVar) const;
+            float getMeteoPointValueD(int dayIndex, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings) const;
+            bool setMeteoPointValueD(int dayIndex, meteoVariable myVar, float myValue);
+            float getMeteoPointValueH(int dayIndex, int valueIndex, meteoVariable myVar) const;
+
             float getMeteoPointValueH(const Crit3DDate& myDate, int myHour, int myMinutes, meteoVariable myVar) const;
             bool setMeteoPointValueH(const Crit3DDate& myDate, int myHour, int myMinutes, meteoVariable myVar, float myValue);
             float getMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar, Crit3DMeteoSettings* meteoSettings) const;
             float getMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar) const;
             bool setMeteoPointValueD(const Crit3DDate& myDate, meteoVariable myVar, float myValue);
             bool getMeteoPointValueDayH(const Crit3DDate& myDate, TObsDataH *&hourlyValues);
+
+            // bulk accessors: stored values (no derived values), NODATA outside the loaded period
+            // daily series are gathered copies (array of daily records), hourly days are contiguous
+            bool getDailySeries(meteoVariable myVar, const Crit3DDate& firstDate, const Crit3DDate& lastDate,
+                                std::vector<float> &values) const;
+            const float* getHourlyDayValues(meteoVariable myVar, const Crit3DDate& myDate) const;
+            bool getHourlySeries(meteoVariable myVar, const Crit3DDate& firstDate, const Crit3DDate& lastDate,
+                                 std::vector<float> &values) const;
             Crit3DDate getMeteoPointHourlyValuesDate(int index) const;
             float getMeteoPointValue(const Crit3DTime& myTime, meteoVariable myVar, Crit3DMeteoSettings *meteoSettings);
             float getMeteoPointValueM(const Crit3DDate &myDate, meteoVariable myVar) const;
@@ -184,6 +210,10 @@
 
             bool computeHourlyDerivedVar(const Crit3DTime &dateTime, meteoVariable myVar, bool useNetRad);
             bool computeDailyDerivedVar(const Crit3DDate &date, meteoVariable myVar, Crit3DMeteoSettings &meteoSettings);
+            bool computeHourlyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate,
+                                               meteoVariable myVar, bool useNetRad);
+            bool computeDailyDerivedVarPeriod(const Crit3DDate &firstDate, const Crit3DDate &lastDate,
+                                              meteoVariable myVar, Crit3DMeteoSettings &meteoSettings);
             bool computeMonthlyAggregate(const Crit3DDate &firstDate, const Crit3DDate &lastDate, meteoVariable dailyMeteoVar,
                                          Crit3DMeteoSettings *meteoSettings, Crit3DQuality *qualityCheck, Crit3DClimateParameters *climateParam);
 
@@ -197,6 +227,10 @@
     private:
             TObsDataH *_obsDataH;
 
+            // serial date of the first daily value (obsDataD[0].date), updated when obsDataD changes
+            mutable Crit3DDate _firstDateD;
+            mutable Crit3DSerialDate _firstSerialDateD;
+
     };
 
 
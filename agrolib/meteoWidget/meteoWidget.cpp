@@ -49,6 +49,7 @@ Crit3DMeteoWidget::Crit3DMeteoWidget(bool isGrid, QString projectPath, Crit3DMet
     _isInitialized = false;
     _isEnsemble = false;
     _nrMembers = NODATA;
+    _hourlyStep = 1;
 
     maxEnsembleBar = -1;
     maxEnsembleLine = NODATA;
@@ -575,7 +576,7 @@ bool Crit3DMeteoWidget::isAlreadyPresent(const std::string &idMeteoPoint, const
 }
 
 
-void Crit3DMeteoWidget::drawMeteoPoint(Crit3DMeteoPoint mp, bool isAppend)
+void Crit3DMeteoWidget::drawMeteoPoint(const Crit3DMeteoPoint &mp, bool isAppend)
 {
     if (! _isInitialized) return;
 
@@ -608,7 +609,7 @@ void Crit3DMeteoWidget::drawMeteoPoint(Crit3DMeteoPoint mp, bool isAppend)
     show();
 }
 
-void Crit3DMeteoWidget::addMeteoPointsEnsemble(Crit3DMeteoPoint mp)
+void Crit3DMeteoWidget::addMeteoPointsEnsemble(const Crit3DMeteoPoint &mp)
 {
     _meteoPointsEnsemble.append(mp);
 }
@@ -1518,6 +1519,59 @@ void Crit3DMeteoWidget::drawDailyVar()
 }
 
 
+// summary of the hourly values in [firstHour, lastHour) from the first date
+struct HourlyStepSummary
+{
+    double minValue, maxValue, sumValue;
+    int minHour, maxHour;
+    int nrValidValues;
+    bool isLoaded;
+};
+
+static HourlyStepSummary getHourlyStepSummary(const Crit3DMeteoPoint &mp, meteoVariable meteoVar,
+                                              const std::vector<Crit3DDate> &dates, int firstHour, int lastHour)
+{
+    HourlyStepSummary summary;
+    summary.minValue = NODATA;
+    summary.maxValue = NODATA;
+    summary.sumValue = 0;
+    summary.minHour = NODATA;
+    summary.maxHour = NODATA;
+    summary.nrValidValues = 0;
+    summary.isLoaded = false;
+
+    for (int hour = firstHour; hour < lastHour; hour++)
+    {
+        const Crit3DDate &myDate = dates[hour / 24];
+        int h = hour % 24;
+
+        double value = mp.getMeteoPointValueH(myDate, h, 0, meteoVar);
+        if (value == NODATA)
+        {
+            if (! summary.isLoaded && mp.isDateTimeLoadedH(Crit3DTime(myDate, h)))
+                summary.isLoaded = true;
+            continue;
+        }
+
+        if (summary.nrValidValues == 0 || value < summary.minValue)
+        {
+            summary.minValue = value;
+            summary.minHour = hour;
+        }
+        if (summary.nrValidValues == 0 || value > summary.maxValue)
+        {
+            summary.maxValue = value;
+            summary.maxHour = hour;
+        }
+        summary.sumValue += value;
+        summary.nrValidValues++;
+        summary.isLoaded = true;
+    }
+
+    return summary;
+}
+
+
 void Crit3DMeteoWidget::drawHourlyVar()
 {
     if (! _isInitialized) return;
@@ -1547,107 +1601,130 @@ void Crit3DMeteoWidget::drawHourlyVar()
     int nDays = firstDate->date().daysTo(lastDate->date())+1;
     int nrValues = nDays*24;
 
+    // level of detail
+    _hourlyStep = 1;
+    if (nrValues > METEOWIDGET_MAX_HOURLY_VALUES)
+    {
+        _hourlyStep = int(ceil(double(nrValues) / METEOWIDGET_MAX_HOURLY_VALUES));
+    }
+    int nrSteps = (nrValues + _hourlyStep - 1) / _hourlyStep;
+
     // virtual x axis
     int nrIntervals;
-    if (nrValues <= 36)
+    if (nrSteps <= 36)
     {
-        nrIntervals = nrValues/3;
+        nrIntervals = nrSteps/3;
     }
     else
     {
         nrIntervals = 12;
     }
-    double step = double(nrValues) / double(nrIntervals);
+    double step = double(nrSteps) / double(nrIntervals);
     double nextIndex = step / 2 - 0.5;
-    long index;
 
-    int nMeteoPoints = _meteoPoints.size();
-    QDate myDate = firstDate->date();
-    Crit3DDate myCrit3DDate;
+    QDateTime firstDateTime(firstDate->date(), QTime(0,0,0), Qt::UTC);
     QDateTime myDateTime;
+    for (int index = 0; index < nrSteps; index++)
+    {
+        // set categories
+        categories.append(QString::number(index));
+        if (index == round(nextIndex))
+        {
+            myDateTime = firstDateTime.addSecs(3600 * _hourlyStep * index);
+            categoriesVirtual.append(myDateTime.toString("MMM dd <br> yyyy <br> hh:mm"));
+            nextIndex += step;
+        }
+    }
 
+    std::vector<Crit3DDate> dates(nDays);
+    QDate myDate = firstDate->date();
     for (int d = 0; d < nDays; d++)
     {
-        myCrit3DDate = getCrit3DDate(myDate);
+        dates[d] = getCrit3DDate(myDate);
+        myDate = myDate.addDays(1);
+    }
 
-        for (int h = 0; h < 24; h++)
+    int nMeteoPoints = _meteoPoints.size();
+    for (int mp = 0; mp < nMeteoPoints; mp++)
+    {
+        if (isLine)
         {
-            index = d*24+h;
-            // set categories
-            categories.append(QString::number(index));
-            if (index == round(nextIndex))
+            for (int i = 0; i < nameLines.size(); i++)
             {
-                myDateTime.setDate(myDate);
-                myDateTime.setTime(QTime(h, 0, 0));
-                myDateTime.setTimeZone(QTimeZone::utc());
-                categoriesVirtual.append(myDateTime.toString("MMM dd <br> yyyy <br> hh:mm"));
-                nextIndex += step;
-            }
+                meteoVariable meteoVar = getMeteoVar(nameLines[i].toStdString());
+                if (meteoVar == noMeteoVar)
+                {
+                    continue;
+                }
 
-            for (int mp=0; mp < nMeteoPoints; mp++)
-            {
-                if (isLine)
+                bool isSum = varToSumList.contains(nameLines[i]);
+                for (int index = 0; index < nrSteps; index++)
                 {
-                    for (int i = 0; i < nameLines.size(); i++)
+                    HourlyStepSummary summary = getHourlyStepSummary(_meteoPoints[mp], meteoVar, dates, index * _hourlyStep,
+                                                                     std::min((index+1) * _hourlyStep, nrValues));
+                    if (summary.nrValidValues == 0)
                     {
-                        meteoVariable meteoVar = getMeteoVar(nameLines[i].toStdString());
-                        if (meteoVar == noMeteoVar)
+                        if (summary.isLoaded)
                         {
-                            continue;
+                            lineSeries[mp][i]->append(index, NODATA); // nodata hours are not drawed if they are the first of the last hour of the serie
                         }
+                        continue;
+                    }
 
-                        double value = _meteoPoints[mp].getMeteoPointValueH(myCrit3DDate, h, 0, meteoVar);
-                        if (value != NODATA)
+                    if (_hourlyStep == 1 || isSum)
+                    {
+                        lineSeries[mp][i]->append(index, summary.sumValue);
+                    }
+                    else
+                    {
+                        // min/max envelope, in time order
+                        if (summary.minHour <= summary.maxHour)
                         {
-                            lineSeries[mp][i]->append(index, value);
-                            if (value > maxLine)
-                            {
-                                maxLine = value;
-                            }
-                            if (value < minLine)
-                            {
-                                minLine = value;
-                            }
+                            lineSeries[mp][i]->append(index, summary.minValue);
+                            if (summary.maxHour != summary.minHour)
+                                lineSeries[mp][i]->append(index, summary.maxValue);
                         }
                         else
                         {
-                            if (_meteoPoints[mp].isDateTimeLoadedH(Crit3DTime(myCrit3DDate,h)))
-                            {
-                                lineSeries[mp][i]->append(index, value); // nodata hours are not drawed if they are the first of the last hour of the serie
-                            }
+                            lineSeries[mp][i]->append(index, summary.maxValue);
+                            lineSeries[mp][i]->append(index, summary.minValue);
                         }
                     }
+
+                    maxLine = std::max(maxLine, (_hourlyStep == 1 || isSum) ? summary.sumValue : summary.maxValue);
+                    minLine = std::min(minLine, (_hourlyStep == 1 || isSum) ? summary.sumValue : summary.minValue);
                 }
+            }
+        }
 
-                if (isBar)
+        if (isBar)
+        {
+            for (int j = 0; j < nameBar.size(); j++)
+            {
+                meteoVariable meteoVar = getMeteoVar(nameBar[j].toStdString());
+                if (meteoVar == noMeteoVar)
                 {
-                    for (int j = 0; j < nameBar.size(); j++)
-                    {
-                        meteoVariable meteoVar = getMeteoVar(nameBar[j].toStdString());
-                        if (meteoVar == noMeteoVar)
-                        {
-                            continue;
-                        }
+                    continue;
+                }
 
-                        double value = _meteoPoints[mp].getMeteoPointValueH(myCrit3DDate, h, 0, meteoVar);
-                        if (value != NODATA)
-                        {
-                            *setVector[mp][j] << value;
-                            if (value > maxBar)
-                            {
-                                maxBar = value;
-                            }
-                        }
-                        else
-                        {
-                            *setVector[mp][j] << 0;
-                        }
+                // groups of hours: sum for the cumulated variables, otherwise maximum
+                bool isSum = varToSumList.contains(nameBar[j]);
+                for (int index = 0; index < nrSteps; index++)
+                {
+                    HourlyStepSummary summary = getHourlyStepSummary(_meteoPoints[mp], meteoVar, dates, index * _hourlyStep,
+                                                                     std::min((index+1) * _hourlyStep, nrValues));
+                    if (summary.nrValidValues == 0)
+                    {
+                        *setVector[mp][j] << 0;
+                        continue;
                     }
+
+                    double value = isSum ? summary.sumValue : summary.maxValue;
+                    *setVector[mp][j] << value;
+                    maxBar = std::max(maxBar, value);
                 }
             }
         }
-
-        myDate=myDate.addDays(1);
     }
 
     if (isBar)
@@ -1737,13 +1814,9 @@ void Crit3DMeteoWidget::drawHourlyVar()
     if (axisY_sx->min() <= 0 && axisY_sx->max() >= 0)
     {
         zeroLine->clear();
-        for (int d = 0; d < nDays; d++)
+        for (int index = 0; index < nrSteps; index++)
         {
-            for (int h = 0; h < 24; h++)
-            {
-                int index = d*24+h;
-                zeroLine->append(index, 0);
-            }
+            zeroLine->append(index, 0);
         }
         chart->addSeries(zeroLine);
         zeroLine->attachAxis(axisX);
@@ -2636,7 +2709,7 @@ bool Crit3DMeteoWidget::computeTooltipLineSeries(QLineSeries *series, QPointF po
                 else if (_currentFrequency == hourly)
                 {
                     QDateTime xDate(firstDate->date(), QTime(0,0,0), Qt::UTC);
-                    xDate = xDate.addSecs(3600*doy);
+                    xDate = xDate.addSecs(3600*_hourlyStep*doy);
                     m_tooltip->setText(QString("%1 \n%2 nan ").arg(series->name()).arg(xDate.toString("MMM dd yyyy hh:mm")));
                 }
                 else if (_currentFrequency == monthly)
@@ -2775,7 +2848,7 @@ bool Crit3DMeteoWidget::computeTooltipLineSeries(QLineSeries *series, QPointF po
         else if (_currentFrequency == hourly)
         {
             QDateTime xDate(firstDate->date(), QTime(0,0,0), Qt::UTC);
-            xDate = xDate.addSecs(3600*doy);
+            xDate = xDate.addSecs(3600*_hourlyStep*doy);
             for(int i = 0; i < series->count(); i++)
             {
                 if (series->at(i).x() == doy)
@@ -2857,7 +2930,7 @@ void Crit3DMeteoWidget::tooltipBar(bool state, int index, QBarSet *barset)
         {
 
             QDateTime xDate(firstDate->date(), QTime(0,0,0), Qt::UTC);
-            xDate = xDate.addSecs(3600*index);
+            xDate = xDate.addSecs(3600*_hourlyStep*index);
             valueStr = QString("%1 \n%2 %3 ").arg(xDate.toString("MMM dd yyyy hh:mm")).arg(barset->label()).arg(barset->at(index), 0, 'f', 1);
         }
         else if (_currentFrequency == monthly)
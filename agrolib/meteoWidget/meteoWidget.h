@@ -7,6 +7,9 @@
     #include "meteoPoint.h"
     #include "callout.h"
 
+    // level of detail: longer hourly periods are drawn as a min/max envelope of groups of hours
+    #define METEOWIDGET_MAX_HOURLY_VALUES 2400
+
     class Crit3DMeteoWidget : public QWidget
     {
         Q_OBJECT
@@ -33,9 +36,9 @@
 
             bool isAlreadyPresent(const std::string &idMeteoPoint, const std::string &dataset);
 
-            void addMeteoPointsEnsemble(Crit3DMeteoPoint mp);
+            void addMeteoPointsEnsemble(const Crit3DMeteoPoint &mp);
 
-            void drawMeteoPoint(Crit3DMeteoPoint mp, bool isAppend);
+            void drawMeteoPoint(const Crit3DMeteoPoint &mp, bool isAppend);
             void drawEnsemble();
 
     private:
@@ -52,6 +55,7 @@
 
             frequencyType _currentFrequency;
             QDate _currentDate;
+            int _hourlyStep;                    // number of hours for each x value of the hourly graph
 
             QDate firstDailyDate;
             QDate lastDailyDate;
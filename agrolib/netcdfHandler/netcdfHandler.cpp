@@ -86,6 +86,9 @@ NetCDFHandler::NetCDFHandler()
     lon = nullptr;
     time = nullptr;
 
+    chunkCacheBytes = 0;
+    chunkCacheMaxBytes = NETCDF_CHUNK_CACHE_DEFAULT;
+
     this->clear();
 }
 
@@ -155,6 +158,8 @@ void NetCDFHandler::clear()
     timeUnit = "";
 
     missingValue = NODATA;
+
+    clearChunkCache();
 }
 
 
@@ -727,6 +732,16 @@ bool NetCDFHandler::readProperties(string fileName)
 }
 
 
+// integer variables are stored in hundredths
+double NetCDFHandler::getOutputValue(const NetCDFVariable &var, double value)
+{
+    if (var.type <= NC_INT)
+        return value / 100;
+
+    return value;
+}
+
+
 bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Crit3DTime seriesFirstTime, Crit3DTime seriesLastTime, stringstream *buffer)
 {
     // check dimensions
@@ -763,19 +778,7 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
 
     // search row, col
     int row, col;
-    if (isLatLon)
-    {
-        gis::getRowColFromLatLon(latLonHeader, geoPoint, &row, &col);
-        if (isYincreasing)
-            row = (nrLat-1) - row;
-    }
-    else
-    {
-        gis::Crit3DUtmPoint utmPoint;
-        gis::getUtmFromLatLon(utmZone, geoPoint, &utmPoint);
-        gis::getRowColFromXY(*(dataGrid.header), utmPoint, &row, &col);
-        row = (nrY -1) - row;
-    }
+    getRowColFromGeoPoint(geoPoint, row, col);
 
     // check time indexes
     if (seriesFirstTime < getFirstTime() || seriesLastTime > getLastTime())
@@ -785,17 +788,8 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
     }
 
     // search time indexes
-    int t1 = NODATA;
-    int t2 = NODATA;
-    int i = 0;
-    while ((i < nrTime) && (t1 == NODATA || t2 == NODATA))
-    {
-        if (getTime(i) == seriesFirstTime)
-            t1 = i;
-        if (getTime(i) == seriesLastTime)
-            t2 = i;
-        i++;
-    }
+    long t1 = getTimeIndex(seriesFirstTime);
+    long t2 = getTimeIndex(seriesLastTime);
 
     // check time range
     if  (t1 == NODATA || t2 == NODATA)
@@ -804,6 +798,15 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
         return false;
     }
 
+    // read the whole series
+    std::vector<double> values;
+    std::string errorStr;
+    if (! extractPointSeries(idVar, row, col, t1, t2, values, errorStr))
+    {
+        *buffer << errorStr << endl;
+        return false;
+    }
+
     *buffer << "variable: " << var.getVarName() << endl;
 
     // write position
@@ -819,30 +822,497 @@ bool NetCDFHandler::exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Cr
     *buffer << endl;
 
     // write data
-    size_t* index = new size_t[3];
-    index[indexYLonDim] = size_t(row);
-    index[indexXLatDim] = size_t(col);
+    for (long t = t1; t <= t2; t++)
+    {
+        *buffer << getDateTimeStr(t) << ", " << getOutputValue(var, values[unsigned(t - t1)]) << endl;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief exportPointsDataSeries
+ * writes the series of many points in csv format (one column for each point),
+ * reading them with extractPointsSeries. Points outside the grid are skipped.
+ */
+bool NetCDFHandler::exportPointsDataSeries(int idVar, const std::vector<gis::Crit3DGeoPoint> &geoPoints,
+                                           const std::vector<std::string> &pointIds,
+                                           const Crit3DTime &seriesFirstTime, const Crit3DTime &seriesLastTime,
+                                           std::stringstream *buffer)
+{
+    NetCDFVariable var = getVariableFromId(idVar);
+    if (var.getVarName() == "")
+    {
+        *buffer << "Wrong variable!" << endl;
+        return false;
+    }
+
+    if (geoPoints.size() != pointIds.size())
+    {
+        *buffer << "Wrong number of point ids!" << endl;
+        return false;
+    }
+
+    std::vector<std::vector<double>> series;
+    std::string errorStr;
+    if (! extractPointsSeries(idVar, geoPoints, seriesFirstTime, seriesLastTime, series, errorStr))
+    {
+        *buffer << errorStr << endl;
+        return false;
+    }
+
+    std::vector<unsigned int> insideIndex;
+    for (unsigned int i = 0; i < series.size(); i++)
+    {
+        if (! series[i].empty())
+            insideIndex.push_back(i);
+    }
+
+    if (insideIndex.empty())
+    {
+        *buffer << "No points inside the grid!" << endl;
+        return false;
+    }
+
+    long t1 = getTimeIndex(seriesFirstTime);
+    long t2 = getTimeIndex(seriesLastTime);
+
+    *buffer << "date";
+    for (unsigned int i : insideIndex)
+    {
+        *buffer << "," << pointIds[i];
+    }
+    *buffer << endl;
+
+    for (long t = t1; t <= t2; t++)
+    {
+        *buffer << getDateTimeStr(t);
+        for (unsigned int i : insideIndex)
+        {
+            *buffer << "," << getOutputValue(var, series[i][unsigned(t - t1)]);
+        }
+        *buffer << endl;
+    }
+
+    return true;
+}
+
+
+// returns row and col of the netCDF arrays (not of dataGrid)
+void NetCDFHandler::getRowColFromGeoPoint(const gis::Crit3DGeoPoint& geoPoint, int &row, int &col)
+{
+    if (isLatLon)
+    {
+        gis::getRowColFromLatLon(latLonHeader, geoPoint, &row, &col);
+        if (isYincreasing)
+            row = (nrLat-1) - row;
+    }
+    else
+    {
+        gis::Crit3DUtmPoint utmPoint;
+        gis::getUtmFromLatLon(utmZone, geoPoint, &utmPoint);
+        gis::getRowColFromXY(*(dataGrid.header), utmPoint, &row, &col);
+        row = (nrY -1) - row;
+    }
+}
+
+
+// binary search: time values are monotonic
+long NetCDFHandler::getTimeIndex(const Crit3DTime& myTime)
+{
+    long first = 0;
+    long last = nrTime - 1;
+
+    while (first <= last)
+    {
+        long middle = (first + last) / 2;
+        Crit3DTime middleTime = getTime(int(middle));
+
+        if (middleTime == myTime)
+            return middle;
+
+        if (middleTime < myTime)
+            first = middle + 1;
+        else
+            last = middle - 1;
+    }
+
+    return NODATA;
+}
+
+
+/*!
+ * \brief getVarLayout
+ * returns the position of the time, row and col dimensions in the variable,
+ * the length of each dimension and the chunk sizes (if the variable is chunked)
+ */
+bool NetCDFHandler::getVarLayout(int idVar, int &varType, int &posTime, int &posRow, int &posCol,
+                                 size_t* dimLength, size_t* chunkSize, bool &isChunked)
+{
+    char name[NC_MAX_NAME+1];
+    nc_type ncVarType;
+    int nrVarDimensions, nrVarAttributes;
+    int varDimIds[NC_MAX_VAR_DIMS];
+
+    if (nc_inq_var(ncId, idVar, name, &ncVarType, &nrVarDimensions, varDimIds, &nrVarAttributes) != NC_NOERR)
+        return false;
+
+    varType = int(ncVarType);
+
+    if (nrVarDimensions != 3)
+        return false;
+
+    // dimension id of rows and columns
+    int idDimRow = isLatLon ? indexXLatDim : indexYLonDim;
+    int idDimCol = isLatLon ? indexYLonDim : indexXLatDim;
+
+    posTime = NODATA;
+    posRow = NODATA;
+    posCol = NODATA;
+    for (int d = 0; d < 3; d++)
+    {
+        nc_inq_dim(ncId, varDimIds[d], name, &(dimLength[d]));
+
+        if (varDimIds[d] == indexTimeDim)
+            posTime = d;
+        else if (varDimIds[d] == idDimRow)
+            posRow = d;
+        else if (varDimIds[d] == idDimCol)
+            posCol = d;
+    }
+
+    if (posTime == NODATA || posRow == NODATA || posCol == NODATA)
+        return false;
+
+    int storage;
+    if (nc_inq_var_chunking(ncId, idVar, &storage, chunkSize) != NC_NOERR)
+        storage = NC_CONTIGUOUS;
+
+    isChunked = (storage == NC_CHUNKED);
+
+    return true;
+}
+
+
+double NetCDFHandler::ChunkBlock::getValue(size_t index) const
+{
+    if (varType == NC_FLOAT)
+        return double(floatValues[index]);
+    else if (varType <= NC_INT)
+        return double(intValues[index]);
+    else
+        return doubleValues[index];
+}
 
-    for (int t = t1; t <= t2; t++)
+
+size_t NetCDFHandler::ChunkBlock::getNrBytes() const
+{
+    return floatValues.size() * sizeof(float) + intValues.size() * sizeof(int)
+           + doubleValues.size() * sizeof(double);
+}
+
+
+/*!
+ * \brief readHyperslab
+ * reads the hyperslab (block.start, block.count) with the native type of the variable
+ * (no float rounding of double and int values, no widening of float values)
+ */
+bool NetCDFHandler::readHyperslab(int idVar, int varType, ChunkBlock &block, std::string &errorStr)
+{
+    size_t nrValues = block.count[0] * block.count[1] * block.count[2];
+    block.varType = varType;
+
+    int retVal;
+    if (varType == NC_FLOAT)
+    {
+        block.floatValues.resize(nrValues);
+        retVal = nc_get_vara_float(ncId, idVar, block.start, block.count, block.floatValues.data());
+    }
+    else if (varType <= NC_INT)
+    {
+        block.intValues.resize(nrValues);
+        retVal = nc_get_vara_int(ncId, idVar, block.start, block.count, block.intValues.data());
+    }
+    else
+    {
+        block.doubleValues.resize(nrValues);
+        retVal = nc_get_vara_double(ncId, idVar, block.start, block.count, block.doubleValues.data());
+    }
+
+    if (retVal != NC_NOERR)
+    {
+        errorStr = nc_strerror(retVal);
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief getChunkBlock
+ * returns the decompressed chunk from the LRU cache, reading it from file if needed.
+ * The pointer is valid until the next call.
+ */
+const NetCDFHandler::ChunkBlock* NetCDFHandler::getChunkBlock(int idVar, int varType, const size_t* chunkIndex, const size_t* chunkSize,
+                                                              const size_t* dimLength, std::string &errorStr)
+{
+    ChunkKey key = {size_t(idVar), chunkIndex[0], chunkIndex[1], chunkIndex[2]};
+
+    auto it = chunkMap.find(key);
+    if (it != chunkMap.end())
+    {
+        // move to front (most recently used)
+        chunkList.splice(chunkList.begin(), chunkList, it->second);
+        return &(it->second->second);
+    }
+
+    ChunkBlock block;
+    for (int d = 0; d < 3; d++)
+    {
+        block.start[d] = chunkIndex[d] * chunkSize[d];
+        block.count[d] = std::min(chunkSize[d], dimLength[d] - block.start[d]);
+    }
+
+    if (! readHyperslab(idVar, varType, block, errorStr))
+        return nullptr;
+
+    // remove least recently used chunks
+    size_t nrBytes = block.getNrBytes();
+    while (! chunkList.empty() && chunkCacheBytes + nrBytes > chunkCacheMaxBytes)
+    {
+        chunkCacheBytes -= chunkList.back().second.getNrBytes();
+        chunkMap.erase(chunkList.back().first);
+        chunkList.pop_back();
+    }
+
+    chunkList.emplace_front(key, std::move(block));
+    chunkMap[key] = chunkList.begin();
+    chunkCacheBytes += nrBytes;
+
+    return &(chunkList.front().second);
+}
+
+
+void NetCDFHandler::clearChunkCache()
+{
+    chunkList.clear();
+    chunkMap.clear();
+    chunkCacheBytes = 0;
+}
+
+
+/*!
+ * \brief extractPointSeries
+ * reads the series of a cell (row, col of the netCDF arrays) between two time indexes
+ * with a single hyperslab read, or through the chunk cache if the variable is chunked
+ */
+bool NetCDFHandler::extractPointSeries(int idVar, int row, int col, long firstTimeIndex, long lastTimeIndex,
+                                       std::vector<double> &values, std::string &errorStr)
+{
+    int varType, posTime, posRow, posCol;
+    size_t dimLength[3], chunkSize[3];
+    bool isChunked;
+
+    if (! getVarLayout(idVar, varType, posTime, posRow, posCol, dimLength, chunkSize, isChunked))
+    {
+        errorStr = "Wrong variable dimensions: required (time, x, y) or (time, lon, lat).";
+        return false;
+    }
+
+    if (row < 0 || col < 0 || size_t(row) >= dimLength[posRow] || size_t(col) >= dimLength[posCol])
+    {
+        errorStr = "Wrong position.";
+        return false;
+    }
+
+    if (firstTimeIndex < 0 || firstTimeIndex > lastTimeIndex || size_t(lastTimeIndex) >= dimLength[posTime])
+    {
+        errorStr = "Wrong time index.";
+        return false;
+    }
+
+    size_t t1 = size_t(firstTimeIndex);
+    size_t t2 = size_t(lastTimeIndex);
+    values.resize(t2 - t1 + 1);
+
+    if (! isChunked || chunkCacheMaxBytes == 0)
     {
-        index[indexTimeDim] = unsigned(t);
-        if (var.type == NC_DOUBLE)
+        ChunkBlock slab;
+        slab.start[posTime] = t1;
+        slab.count[posTime] = t2 - t1 + 1;
+        slab.start[posRow] = size_t(row);
+        slab.count[posRow] = 1;
+        slab.start[posCol] = size_t(col);
+        slab.count[posCol] = 1;
+
+        if (! readHyperslab(idVar, varType, slab, errorStr))
+            return false;
+
+        for (size_t i = 0; i < values.size(); i++)
+            values[i] = slab.getValue(i);
+
+        return true;
+    }
+
+    size_t chunkIndex[3], local[3];
+    chunkIndex[posRow] = size_t(row) / chunkSize[posRow];
+    chunkIndex[posCol] = size_t(col) / chunkSize[posCol];
+
+    size_t t = t1;
+    while (t <= t2)
+    {
+        chunkIndex[posTime] = t / chunkSize[posTime];
+
+        const ChunkBlock* block = getChunkBlock(idVar, varType, chunkIndex, chunkSize, dimLength, errorStr);
+        if (block == nullptr)
+            return false;
+
+        local[posRow] = size_t(row) - block->start[posRow];
+        local[posCol] = size_t(col) - block->start[posCol];
+
+        size_t lastT = std::min(t2, block->start[posTime] + block->count[posTime] - 1);
+        for (; t <= lastT; t++)
         {
-            double value;
-            nc_get_var1_double(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << value << endl;
+            local[posTime] = t - block->start[posTime];
+            values[t - t1] = block->getValue((local[0] * block->count[1] + local[1]) * block->count[2] + local[2]);
         }
-        if (var.type == NC_FLOAT)
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief extractPointsSeries
+ * reads the series of many points: requests are grouped by spatial chunk, then each time chunk
+ * is read once and its values are copied to all the points of the spatial chunk.
+ * Points outside the grid return an empty series.
+ */
+bool NetCDFHandler::extractPointsSeries(int idVar, const std::vector<gis::Crit3DGeoPoint> &geoPoints,
+                                        const Crit3DTime &seriesFirstTime, const Crit3DTime &seriesLastTime,
+                                        std::vector<std::vector<double>> &series, std::string &errorStr)
+{
+    series.clear();
+    series.resize(geoPoints.size());
+
+    if (! isTimeReadable())
+    {
+        errorStr = "Wrong or missing time dimension.";
+        return false;
+    }
+
+    long t1 = getTimeIndex(seriesFirstTime);
+    long t2 = getTimeIndex(seriesLastTime);
+    if  (t1 == NODATA || t2 == NODATA)
+    {
+        errorStr = "Time out of range.";
+        return false;
+    }
+
+    int varType, posTime, posRow, posCol;
+    size_t dimLength[3], chunkSize[3];
+    bool isChunked;
+    if (! getVarLayout(idVar, varType, posTime, posRow, posCol, dimLength, chunkSize, isChunked))
+    {
+        errorStr = "Wrong variable dimensions: required (time, x, y) or (time, lon, lat).";
+        return false;
+    }
+
+    if (t1 < 0 || t1 > t2 || size_t(t2) >= dimLength[posTime])
+    {
+        errorStr = "Wrong time index.";
+        return false;
+    }
+
+    // requests inside the grid
+    std::vector<std::array<int, 3>> requests;          // row, col, point index
+    for (unsigned int i = 0; i < geoPoints.size(); i++)
+    {
+        if (! isPointInside(geoPoints[i]))
+            continue;
+
+        int row, col;
+        getRowColFromGeoPoint(geoPoints[i], row, col);
+        requests.push_back({row, col, int(i)});
+    }
+
+    if (! isChunked || chunkCacheMaxBytes == 0)
+    {
+        // a single hyperslab read for each point
+        for (unsigned int i = 0; i < requests.size(); i++)
         {
-            float value;
-            nc_get_var1_float(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << value << endl;
+            if (! extractPointSeries(idVar, requests[i][0], requests[i][1], t1, t2, series[unsigned(requests[i][2])], errorStr))
+                return false;
         }
-        if (var.type <= NC_INT)
+        return true;
+    }
+
+    // group requests by spatial chunk
+    auto isSameChunk = [&](const std::array<int, 3> &a, const std::array<int, 3> &b)
+    {
+        return (size_t(a[0]) / chunkSize[posRow] == size_t(b[0]) / chunkSize[posRow])
+               && (size_t(a[1]) / chunkSize[posCol] == size_t(b[1]) / chunkSize[posCol]);
+    };
+
+    std::sort(requests.begin(), requests.end(), [&](const std::array<int, 3> &a, const std::array<int, 3> &b)
+    {
+        size_t chunkRowA = size_t(a[0]) / chunkSize[posRow];
+        size_t chunkRowB = size_t(b[0]) / chunkSize[posRow];
+        if (chunkRowA != chunkRowB)
+            return chunkRowA < chunkRowB;
+        return (size_t(a[1]) / chunkSize[posCol]) < (size_t(b[1]) / chunkSize[posCol]);
+    });
+
+    std::vector<size_t> groupFirst;                    // first request of each spatial chunk, plus the end
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        if (i == 0 || ! isSameChunk(requests[i-1], requests[i]))
+            groupFirst.push_back(i);
+    }
+    groupFirst.push_back(requests.size());
+
+    size_t firstTime = size_t(t1);
+    size_t lastTime = size_t(t2);
+    for (unsigned int i = 0; i < requests.size(); i++)
+    {
+        series[unsigned(requests[i][2])].resize(lastTime - firstTime + 1);
+    }
+
+    // time chunks (outer) and points of each spatial chunk (inner): each chunk is decompressed once
+    size_t chunkIndex[3], local[3];
+    size_t firstChunkTime = firstTime / chunkSize[posTime];
+    size_t lastChunkTime = lastTime / chunkSize[posTime];
+
+    for (size_t chunkTime = firstChunkTime; chunkTime <= lastChunkTime; chunkTime++)
+    {
+        chunkIndex[posTime] = chunkTime;
+
+        for (size_t g = 0; g + 1 < groupFirst.size(); g++)
         {
-            int value;
-            nc_get_var1_int(ncId, idVar, index, &value);
-            *buffer << getDateTimeStr(t) << ", " << double(value)/100 << endl;
+            chunkIndex[posRow] = size_t(requests[groupFirst[g]][0]) / chunkSize[posRow];
+            chunkIndex[posCol] = size_t(requests[groupFirst[g]][1]) / chunkSize[posCol];
+
+            const ChunkBlock* block = getChunkBlock(idVar, varType, chunkIndex, chunkSize, dimLength, errorStr);
+            if (block == nullptr)
+                return false;
+
+            size_t blockFirstTime = std::max(firstTime, block->start[posTime]);
+            size_t blockLastTime = std::min(lastTime, block->start[posTime] + block->count[posTime] - 1);
+
+            for (size_t i = groupFirst[g]; i < groupFirst[g+1]; i++)
+            {
+                std::vector<double> &values = series[unsigned(requests[i][2])];
+                local[posRow] = size_t(requests[i][0]) - block->start[posRow];
+                local[posCol] = size_t(requests[i][1]) - block->start[posCol];
+
+                for (size_t t = blockFirstTime; t <= blockLastTime; t++)
+                {
+                    local[posTime] = t - block->start[posTime];
+                    values[t - firstTime] = block->getValue((local[0] * block->count[1] + local[1]) * block->count[2] + local[2]);
+                }
+            }
         }
     }
 
@@ -859,6 +1329,87 @@ bool NetCDFHandler::createNewFile(std::string fileName)
 }
 
 
+// metadata shared by writeMetadata and writeMetadataTimeSeries
+bool NetCDFHandler::writeGlobalAttributes(const string& title)
+{
+    int status = nc_put_att_text(ncId, NC_GLOBAL, "title", title.length(), title.c_str());
+    if (status != NC_NOERR) return false;
+    status = nc_put_att_text(ncId, NC_GLOBAL, "history", 11, "Version 1.0");
+    if (status != NC_NOERR) return false;
+    status = nc_put_att_text(ncId, NC_GLOBAL, "Conventions", 6, "CF-1.7");
+    return (status == NC_NOERR);
+}
+
+
+bool NetCDFHandler::defineLatLonDimensions(int &varLat, int &varLon)
+{
+    // lat
+    int status = nc_def_dim(ncId, "lat", unsigned(nrLat), &idLat);
+    if (status != NC_NOERR) return false;
+
+    status = nc_def_var (ncId, "lat", NC_FLOAT, 1, &idLat, &varLat);
+    if (status != NC_NOERR) return false;
+
+    status = nc_put_att_text(ncId, varLat, "standard_name", 8, "latitude");
+    if (status != NC_NOERR) return false;
+    status = nc_put_att_text(ncId, varLat, "units", 13, "degrees_north");
+    if (status != NC_NOERR) return false;
+
+    // lon
+    status = nc_def_dim(ncId, "lon", unsigned(nrLon), &idLon);
+    if (status != NC_NOERR) return false;
+
+    status = nc_def_var (ncId, "lon", NC_FLOAT, 1, &idLon, &varLon);
+    if (status != NC_NOERR) return false;
+
+    status = nc_put_att_text(ncId, varLon, "standard_name", 9, "longitude");
+    if (status != NC_NOERR) return false;
+    status = nc_put_att_text(ncId, varLon, "units", 12, "degrees_east");
+    return (status == NC_NOERR);
+}
+
+
+bool NetCDFHandler::writeVariableAttributes(const string& variableName, const string& variableUnit)
+{
+    int status = nc_put_att_text(ncId, variables[0].id, "long_name", variableName.length(), variableName.c_str());
+    if (status != NC_NOERR) return false;
+
+    // Units are not required for dimensionless quantities
+    if (variableUnit != "")
+    {
+        status = nc_put_att_text(ncId, variables[0].id, "units", variableUnit.length(), variableUnit.c_str());
+        if (status != NC_NOERR) return false;
+    }
+
+    // no data
+    float missing[] = {NODATA};
+    status = nc_put_att_float(ncId, variables[0].id, "missing_value", NC_FLOAT, 1, missing);
+    return (status == NC_NOERR);
+}
+
+
+// to be called after nc_enddef
+bool NetCDFHandler::writeLatLonVectors(const gis::Crit3DLatLonHeader& latLonHeader, int varLat, int varLon)
+{
+    lat = new float[unsigned(nrLat)];
+    lon = new float[unsigned(nrLon)];
+    for (int row = 0; row < nrLat; row++)
+    {
+        lat[row] = float(latLonHeader.llCorner.latitude + latLonHeader.dy * (latLonHeader.nrRows - row - 0.5));
+    }
+    for (int col = 0; col < nrLon; col++)
+    {
+        lon[col] = float(latLonHeader.llCorner.longitude + latLonHeader.dx * (col + 0.5));
+    }
+
+    int status = nc_put_var_float(ncId, varLat, lat);
+    if (status != NC_NOERR) return false;
+
+    status = nc_put_var_float(ncId, varLon, lon);
+    return (status == NC_NOERR);
+}
+
+
 bool NetCDFHandler::writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, const string& title,
                                   const string& variableName, const string& variableUnit,
                                   const Crit3DDate& myDate, int nDays, int refYearStart, int refYearEnd)
@@ -884,12 +1435,7 @@ bool NetCDFHandler::writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, c
     int varTimeBounds = 0;
 
     // global attributes
-    status = nc_put_att_text(ncId, NC_GLOBAL, "title", title.length(), title.c_str());
-    if (status != NC_NOERR) return false;
-    status = nc_put_att_text(ncId, NC_GLOBAL, "history", 11, "Version 1.0");
-    if (status != NC_NOERR) return false;
-    status = nc_put_att_text(ncId, NC_GLOBAL, "Conventions", 6, "CF-1.7");
-    if (status != NC_NOERR) return false;
+    if (! writeGlobalAttributes(title)) return false;
 
     // time
     if (timeDimensionExists)
@@ -927,29 +1473,8 @@ bool NetCDFHandler::writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, c
         }
     }
 
-    // lat
-    status = nc_def_dim(ncId, "lat", unsigned(nrLat), &idLat);
-    if (status != NC_NOERR) return false;
-
-    status = nc_def_var (ncId, "lat", NC_FLOAT, 1, &idLat, &varLat);
-    if (status != NC_NOERR) return false;
-
-    status = nc_put_att_text(ncId, varLat, "standard_name", 8, "latitude");
-    if (status != NC_NOERR) return false;
-    status = nc_put_att_text(ncId, varLat, "units", 13, "degrees_north");
-    if (status != NC_NOERR) return false;
-
-    // lon
-    status = nc_def_dim(ncId, "lon", unsigned(nrLon), &idLon);
-    if (status != NC_NOERR) return false;
-
-    status = nc_def_var (ncId, "lon", NC_FLOAT, 1, &idLon, &varLon);
-    if (status != NC_NOERR) return false;
-
-    status = nc_put_att_text(ncId, varLon, "standard_name", 9, "longitude");
-    if (status != NC_NOERR) return false;
-    status = nc_put_att_text(ncId, varLon, "units", 12, "degrees_east");
-    if (status != NC_NOERR) return false;
+    // lat/lon
+    if (! defineLatLonDimensions(varLat, varLon)) return false;
 
     // generic variable
     variables.resize(1);
@@ -986,20 +1511,7 @@ bool NetCDFHandler::writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, c
     }
 
     // attributes
-    status = nc_put_att_text(ncId, variables[0].id, "long_name", variableName.length(), variableName.c_str());
-    if (status != NC_NOERR) return false;
-
-    // Units are not required for dimensionless quantities
-    if (variableUnit != "")
-    {
-        status = nc_put_att_text(ncId, variables[0].id, "units", variableUnit.length(), variableUnit.c_str());
-        if (status != NC_NOERR) return false;
-    }
-
-    // no data
-    float missing[] = {NODATA};
-    status = nc_put_att_float(ncId, variables[0].id, "missing_value", NC_FLOAT, 1, missing);
-    if (status != NC_NOERR) return false;
+    if (! writeVariableAttributes(variableName, variableUnit)) return false;
 
     // compression
     int shuffle = NC_SHUFFLE;
@@ -1038,34 +1550,135 @@ bool NetCDFHandler::writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, c
         }
     }
 
-    // set lat/lon arrays
-    lat = new float[unsigned(nrLat)];
-    lon = new float[unsigned(nrLon)];
+    // write lat/lon vectors
+    return writeLatLonVectors(latLonHeader, varLat, varLon);
+}
+
+
+bool NetCDFHandler::writeData_NoTime(const gis::Crit3DRasterGrid& myDataGrid)
+{
+    if (ncId == NODATA) return false;
+
+    float* var = new float[unsigned(nrLat*nrLon)];
+
     for (int row = 0; row < nrLat; row++)
     {
-        lat[row] = float(latLonHeader.llCorner.latitude + latLonHeader.dy * (latLonHeader.nrRows - row - 0.5));
-    }
-    for (int col = 0; col < nrLon; col++)
-    {
-        lon[col] = float(latLonHeader.llCorner.longitude + latLonHeader.dx * (col + 0.5));
+        for (int col = 0; col < nrLon; col++)
+        {
+            float value = myDataGrid.value[row][col];
+            // check on not active cells (for meteo grid)
+            if (isEqual(value, myDataGrid.header->flag) || isEqual(value, NO_ACTIVE))
+                value = NODATA;
+
+            var[row*nrLon + col] = value;
+        }
     }
 
-    // write lat/lon vectors
-    status = nc_put_var_float(ncId, varLat, lat);
+    int status = nc_put_var_float(ncId, variables[0].id, var);
     if (status != NC_NOERR) return false;
 
-    status = nc_put_var_float(ncId, varLon, lon);
+    return true;
+}
+
+
+bool NetCDFHandler::writeMetadataTimeSeries(const gis::Crit3DLatLonHeader& latLonHeader, const string& title,
+                                            const string& variableName, const string& variableUnit,
+                                            const Crit3DDate& referenceDate, bool isHourlySeries,
+                                            int chunkTime, int chunkLat, int chunkLon, int deflateLevel)
+{
+    if (ncId == NODATA || referenceDate == NO_DATE) return false;
+
+    nrLat = latLonHeader.nrRows;
+    nrLon = latLonHeader.nrCols;
+    nrTime = 0;
+
+    isLatLon = true;
+    isHourly = isHourlySeries;
+    isDaily = ! isHourlySeries;
+    firstDate = referenceDate;
+
+    int dimTime, varLat, varLon, status;
+
+    // global attributes
+    if (! writeGlobalAttributes(title)) return false;
+
+    // time (unlimited)
+    status = nc_def_dim(ncId, "time", NC_UNLIMITED, &dimTime);
     if (status != NC_NOERR) return false;
 
-    return true;
+    status = nc_def_var (ncId, "time", NC_DOUBLE, 1, &dimTime, &idTime);
+    if (status != NC_NOERR) return false;
+
+    status = nc_put_att_text(ncId, idTime, "standard_name", 4, "time");
+    if (status != NC_NOERR) return false;
+
+    if (isHourly)
+        timeUnit = "hours since " + referenceDate.toISOString() + " 00:00:00";
+    else
+        timeUnit = "days since " + referenceDate.toISOString();
+
+    status = nc_put_att_text(ncId, idTime, "units", timeUnit.length(), timeUnit.c_str());
+    if (status != NC_NOERR) return false;
+
+    std::string timeCalendarAtt = "gregorian" ;
+    status = nc_put_att_text(ncId, idTime, "calendar", timeCalendarAtt.length(), timeCalendarAtt.c_str());
+    if (status != NC_NOERR) return false;
+
+    // lat/lon
+    if (! defineLatLonDimensions(varLat, varLon)) return false;
+
+    // generic variable (time, lat, lon)
+    indexTimeDim = dimTime;
+    indexXLatDim = idLat;
+    indexYLonDim = idLon;
+
+    variables.resize(1);
+    int varDimId[3];
+    varDimId[0] = dimTime;
+    varDimId[1] = idLat;
+    varDimId[2] = idLon;
+
+    status = nc_def_var (ncId, variableName.c_str(), NC_FLOAT, 3, varDimId, &(variables[0].id));
+    if (status != NC_NOERR) return false;
+
+    variables[0].name = variableName;
+    variables[0].longName = variableName;
+    variables[0].unit = variableUnit;
+    variables[0].type = NC_FLOAT;
+
+    if (! writeVariableAttributes(variableName, variableUnit)) return false;
+
+    // chunking: a few time steps of a spatial tile, so that both maps and point series are cheap to read
+    size_t chunkSize[3];
+    chunkSize[0] = size_t(std::max(1, chunkTime));
+    chunkSize[1] = size_t(std::min(long(std::max(1, chunkLat)), nrLat));
+    chunkSize[2] = size_t(std::min(long(std::max(1, chunkLon)), nrLon));
+    status = nc_def_var_chunking(ncId, variables[0].id, NC_CHUNKED, chunkSize);
+    if (status != NC_NOERR) return false;
+
+    // compression
+    if (deflateLevel > 0)
+    {
+        status = nc_def_var_deflate(ncId, variables[0].id, NC_SHUFFLE, 1, std::min(deflateLevel, 9));
+        if (status != NC_NOERR) return false;
+    }
+
+    // end of metadata
+    status = nc_enddef(ncId);
+    if (status != NC_NOERR) return false;
+
+    return writeLatLonVectors(latLonHeader, varLat, varLon);
 }
 
 
-bool NetCDFHandler::writeData_NoTime(const gis::Crit3DRasterGrid& myDataGrid)
+bool NetCDFHandler::appendTimeSlice(const gis::Crit3DRasterGrid& myDataGrid, const Crit3DTime& myTime)
 {
-    if (ncId == NODATA) return false;
+    if (ncId == NODATA || nrTime == NODATA) return false;
 
-    float* var = new float[unsigned(nrLat*nrLon)];
+    if (myDataGrid.header->nrRows != nrLat || myDataGrid.header->nrCols != nrLon)
+        return false;
+
+    std::vector<float> values(size_t(nrLat * nrLon));
 
     for (int row = 0; row < nrLat; row++)
     {
@@ -1076,13 +1689,39 @@ bool NetCDFHandler::writeData_NoTime(const gis::Crit3DRasterGrid& myDataGrid)
             if (isEqual(value, myDataGrid.header->flag) || isEqual(value, NO_ACTIVE))
                 value = NODATA;
 
-            var[row*nrLon + col] = value;
+            values[size_t(row*nrLon + col)] = value;
         }
     }
 
-    int status = nc_put_var_float(ncId, variables[0].id, var);
+    return appendTimeSlice(values.data(), myTime);
+}
+
+
+// values: nrLat * nrLon map, row major (north to south)
+bool NetCDFHandler::appendTimeSlice(const float* values, const Crit3DTime& myTime)
+{
+    if (ncId == NODATA || nrTime == NODATA || idTime == NODATA) return false;
+
+    // time value since reference date
+    double timeValue = double(firstDate.daysTo(myTime.date));
+    if (isHourly)
+        timeValue = timeValue * 24 + double(myTime.time) / HOUR_SECONDS;
+    else
+        timeValue += double(myTime.time) / DAY_SECONDS;
+
+    size_t timeIndex = size_t(nrTime);
+
+    size_t start[] = {timeIndex, 0, 0};
+    size_t count[] = {1, size_t(nrLat), size_t(nrLon)};
+
+    int status = nc_put_vara_float(ncId, variables[0].id, start, count, values);
     if (status != NC_NOERR) return false;
 
+    status = nc_put_var1_double(ncId, idTime, &timeIndex, &timeValue);
+    if (status != NC_NOERR) return false;
+
+    nrTime++;
+
     return true;
 }
 
@@ -1253,15 +1892,7 @@ bool NetCDFHandler::extractVariableMap(int idVar, const Crit3DTime &myTime, std:
     }
 
     // search time index
-    long timeIndex = NODATA;
-    for (long i = 0; i < nrTime; i++)
-    {
-        if (getTime(i) == myTime)
-        {
-            timeIndex = i;
-            break;
-        }
-    }
+    long timeIndex = getTimeIndex(myTime);
     if  (timeIndex == NODATA)
     {
         errorStr = "No available time index.";
@@ -1269,44 +1900,87 @@ bool NetCDFHandler::extractVariableMap(int idVar, const Crit3DTime &myTime, std:
     }
 
     // get data
-    size_t* index = new size_t[3];
-    index[indexTimeDim] = size_t(timeIndex);
+    int varType, posTime, posRow, posCol;
+    size_t dimLength[3], chunkSize[3];
+    bool isChunked;
+    if (! getVarLayout(idVar, varType, posTime, posRow, posCol, dimLength, chunkSize, isChunked))
+    {
+        errorStr = "Wrong variable dimensions: required (time, x, y) or (time, lon, lat).";
+        return false;
+    }
 
-    for (int row = 0; row < dataGrid.header->nrRows; row++)
+    int nrRows = dataGrid.header->nrRows;
+    int nrCols = dataGrid.header->nrCols;
+    if (dimLength[posRow] != size_t(nrRows) || dimLength[posCol] != size_t(nrCols))
     {
-        if (isYincreasing)
-            index[indexYLonDim] = size_t((nrLat-1) - row);
-        else
-            index[indexYLonDim] = size_t(row);
+        errorStr = "Wrong variable size.";
+        return false;
+    }
 
-        for (int col = 0; col < dataGrid.header->nrCols; col++)
-        {
-            index[indexXLatDim] = size_t(col);
-            float value = dataGrid.header->flag;
+    size_t local[3];
 
-            if (currentVar.type == NC_DOUBLE)
-            {
-                double valueDouble;
-                nc_get_var1_double(ncId, idVar, index, &valueDouble);
-                value = float(valueDouble);
-            }
-            if (currentVar.type == NC_FLOAT)
+    if (! isChunked || chunkCacheMaxBytes == 0)
+    {
+        // whole map in a single hyperslab read
+        ChunkBlock slab;
+        slab.start[posTime] = size_t(timeIndex);
+        slab.count[posTime] = 1;
+        slab.start[posRow] = 0;
+        slab.count[posRow] = size_t(nrRows);
+        slab.start[posCol] = 0;
+        slab.count[posCol] = size_t(nrCols);
+
+        if (! readHyperslab(idVar, varType, slab, errorStr))
+            return false;
+
+        local[posTime] = 0;
+        for (int fileRow = 0; fileRow < nrRows; fileRow++)
+        {
+            int row = isYincreasing ? (nrRows-1) - fileRow : fileRow;
+            local[posRow] = size_t(fileRow);
+            for (int col = 0; col < nrCols; col++)
             {
-                nc_get_var1_float(ncId, idVar, index, &value);
+                local[posCol] = size_t(col);
+                dataGrid.value[row][col] = float(slab.getValue((local[0] * slab.count[1] + local[1]) * slab.count[2] + local[2]));
             }
-            if (currentVar.type <= NC_INT)
+        }
+
+        return true;
+    }
+
+    // chunked variable: read through the chunk cache
+    size_t chunkIndex[3];
+    chunkIndex[posTime] = size_t(timeIndex) / chunkSize[posTime];
+    size_t nrChunkRows = (size_t(nrRows) + chunkSize[posRow] - 1) / chunkSize[posRow];
+    size_t nrChunkCols = (size_t(nrCols) + chunkSize[posCol] - 1) / chunkSize[posCol];
+
+    for (size_t chunkRow = 0; chunkRow < nrChunkRows; chunkRow++)
+    {
+        chunkIndex[posRow] = chunkRow;
+        for (size_t chunkCol = 0; chunkCol < nrChunkCols; chunkCol++)
+        {
+            chunkIndex[posCol] = chunkCol;
+
+            const ChunkBlock* block = getChunkBlock(idVar, varType, chunkIndex, chunkSize, dimLength, errorStr);
+            if (block == nullptr)
+                return false;
+
+            local[posTime] = size_t(timeIndex) - block->start[posTime];
+            for (size_t i = 0; i < block->count[posRow]; i++)
             {
-                int valueInt;
-                nc_get_var1_int(ncId, idVar, index, &valueInt);
-                value = float(valueInt);
+                int fileRow = int(block->start[posRow] + i);
+                int row = isYincreasing ? (nrRows-1) - fileRow : fileRow;
+                local[posRow] = i;
+                for (size_t j = 0; j < block->count[posCol]; j++)
+                {
+                    local[posCol] = j;
+                    int col = int(block->start[posCol] + j);
+                    dataGrid.value[row][col] = float(block->getValue((local[0] * block->count[1] + local[1]) * block->count[2] + local[2]));
+                }
             }
-
-            dataGrid.value[row][col] = value;
         }
     }
 
-    delete[] index;
-
     return true;
 }
 
@@ -6,6 +6,12 @@
     #endif
 
     #include <sstream>
+    #include <list>
+    #include <map>
+    #include <array>
+
+    #define NETCDF_CHUNK_CACHE_DEFAULT 67108864         // [bytes] 64 MB
+    #define NETCDF_CHUNK_LATLON_DEFAULT 64              // [cells] side of the spatial chunk of time series
 
     class NetCDFVariable
     {
@@ -45,6 +51,42 @@
 
         gis::Crit3DRasterGrid dataGrid;
 
+        // LRU cache of decompressed chunks (key: idVar, chunk index on each dimension)
+        struct ChunkBlock
+        {
+            // values are stored with the native type of the variable
+            int varType;
+            std::vector<float> floatValues;
+            std::vector<int> intValues;
+            std::vector<double> doubleValues;
+            size_t start[3];
+            size_t count[3];
+
+            double getValue(size_t index) const;
+            size_t getNrBytes() const;
+        };
+        typedef std::array<size_t, 4> ChunkKey;
+        typedef std::list<std::pair<ChunkKey, ChunkBlock>> ChunkList;
+
+        ChunkList chunkList;
+        std::map<ChunkKey, ChunkList::iterator> chunkMap;
+        size_t chunkCacheBytes;
+        size_t chunkCacheMaxBytes;
+
+        bool getVarLayout(int idVar, int &varType, int &posTime, int &posRow, int &posCol,
+                          size_t* dimLength, size_t* chunkSize, bool &isChunked);
+        bool readHyperslab(int idVar, int varType, ChunkBlock &block, std::string &errorStr);
+        const ChunkBlock* getChunkBlock(int idVar, int varType, const size_t* chunkIndex, const size_t* chunkSize,
+                                        const size_t* dimLength, std::string &errorStr);
+        double getOutputValue(const NetCDFVariable &var, double value);
+        bool writeGlobalAttributes(const std::string &title);
+        bool defineLatLonDimensions(int &varLat, int &varLon);
+        bool writeVariableAttributes(const std::string &variableName, const std::string &variableUnit);
+        bool writeLatLonVectors(const gis::Crit3DLatLonHeader& latLonHeader, int varLat, int varLon);
+
+        long getTimeIndex(const Crit3DTime &myTime);
+        void getRowColFromGeoPoint(const gis::Crit3DGeoPoint &geoPoint, int &row, int &col);
+
     public:
         int ncId;
         bool isUTM;
@@ -99,9 +141,20 @@
 
         bool readProperties(std::string fileName);
         bool exportDataSeries(int idVar, gis::Crit3DGeoPoint geoPoint, Crit3DTime seriesFirstTime, Crit3DTime seriesLastTime, std::stringstream *buffer);
+        bool exportPointsDataSeries(int idVar, const std::vector<gis::Crit3DGeoPoint> &geoPoints, const std::vector<std::string> &pointIds,
+                                    const Crit3DTime &seriesFirstTime, const Crit3DTime &seriesLastTime, std::stringstream *buffer);
         bool extractVariableMap_old(int idVar, const Crit3DTime &myTime, std::string &error);
         bool extractVariableMap(int idVar, const Crit3DTime &myTime, std::string &errorStr);
 
+        // batched (hyperslab) extraction
+        bool extractPointSeries(int idVar, int row, int col, long firstTimeIndex, long lastTimeIndex,
+                                std::vector<double> &values, std::string &errorStr);
+        bool extractPointsSeries(int idVar, const std::vector<gis::Crit3DGeoPoint> &geoPoints,
+                                 const Crit3DTime &seriesFirstTime, const Crit3DTime &seriesLastTime,
+                                 std::vector<std::vector<double>> &series, std::string &errorStr);
+
+        void clearChunkCache();
+
         bool createNewFile(std::string fileName);
 
         bool writeMetadata(const gis::Crit3DLatLonHeader& latLonHeader, const std::string &title,
@@ -109,6 +162,17 @@
                            const Crit3DDate &myDate, int nDays, int refYearStart, int refYearEnd);
 
         bool writeData_NoTime(const gis::Crit3DRasterGrid& myDataGrid);
+
+        // time series (unlimited time dimension, one slice at a time)
+        bool writeMetadataTimeSeries(const gis::Crit3DLatLonHeader& latLonHeader, const std::string &title,
+                                     const std::string &variableName, const std::string &variableUnit,
+                                     const Crit3DDate &referenceDate, bool isHourlySeries,
+                                     int chunkTime, int chunkLat, int chunkLon, int deflateLevel);
+
+        bool appendTimeSlice(const gis::Crit3DRasterGrid& myDataGrid, const Crit3DTime& myTime);
+        bool appendTimeSlice(const float* values, const Crit3DTime& myTime);
+
+        inline long getNrTimeSlices() { return (nrTime == NODATA ? 0 : nrTime); }
     };
 
 
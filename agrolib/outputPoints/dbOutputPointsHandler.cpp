@@ -131,37 +131,32 @@ bool Crit3DOutputPointsDbHandler::saveHourlyMeteoData(const QString &tableName,
         return false;
     }
 
-    QString timeStr = myTime.toString("yyyy-MM-dd HH:mm:ss");
-    QString queryString = QString("SELECT * FROM '%1' WHERE DATE_TIME='%2'").arg(tableName, timeStr);
-    QSqlQuery query(_db);
+    std::vector<QDateTime> timeList = {myTime};
+    return saveHourlyMeteoDataPeriod(tableName, timeList, varList, valuesList, errorStr);
+}
 
-    if (! query.exec(queryString))
-    {
-        errorStr = QString("Error in reading table: %1 \nTime: %2 \n%3")
-                            .arg(tableName, timeStr, query.lastError().text());
-        return false;
-    }
 
-    query.last();
-    int querySize = query.at() + 1;     // SQLITE doesn't support SIZE
-    if (querySize > 0)
-    {
-        return saveHourlyMeteoData_update(tableName, timeStr, varList, valuesList, errorStr);
-    }
-    else
+/*!
+ * \brief saveHourlyMeteoDataPeriod
+ * writes a block of hourly values with one prepared upsert statement in a single transaction:
+ * existing rows are updated only in the columns of varList
+ * values are stored by column: index = varIndex * nrTimes + timeIndex
+ */
+bool Crit3DOutputPointsDbHandler::saveHourlyMeteoDataPeriod(const QString &tableName, const std::vector<QDateTime> &timeList,
+                                                            const std::vector<meteoVariable> &varList,
+                                                            const std::vector<float> &values, QString &errorStr)
+{
+    size_t nrTimes = timeList.size();
+    if (varList.empty() || nrTimes == 0)
+        return true;
+
+    if (values.size() != varList.size() * nrTimes)
     {
-        return saveHourlyMeteoData_insert(tableName, timeStr, varList, valuesList, errorStr);
+        errorStr = "Error saving values: number of values is not as expected.";
+        return false;
     }
 
-}
-
-
-bool Crit3DOutputPointsDbHandler::saveHourlyMeteoData_update(const QString &tableName, const QString timeStr,
-                                                             const std::vector<meteoVariable> &varList,
-                                                             const std::vector<float> &values,
-                                                             QString &errorStr)
-{
-    QList<QString> assignList;
+    QList<QString> fieldList, placeholderList, assignList;
     for (unsigned int i = 0; i < varList.size(); i++)
     {
         QString fieldStr = QString::fromStdString(getMeteoVarName(varList[i]));
@@ -171,58 +166,46 @@ bool Crit3DOutputPointsDbHandler::saveHourlyMeteoData_update(const QString &tabl
             return false;
         }
 
-        QString valueStr = QString::number(values[i], 'f', 2);
-
-        assignList.push_back("'" + fieldStr + "'=" + valueStr);
+        fieldList.push_back("\"" + fieldStr + "\"");
+        placeholderList.push_back("?");
+        assignList.push_back("\"" + fieldStr + "\"=excluded.\"" + fieldStr + "\"");
     }
 
+    QString queryString = QString("INSERT INTO '%1' (DATE_TIME,%2) VALUES (?,%3) ON CONFLICT(DATE_TIME) DO UPDATE SET %4")
+                              .arg(tableName, fieldList.join(','), placeholderList.join(','), assignList.join(','));
+
     QSqlQuery qry(_db);
-    QString queryString = QString("UPDATE '%1' SET %2 WHERE DATE_TIME = DATETIME('%3')").arg(tableName, assignList.join(','), timeStr);
-    if (! qry.exec(queryString))
+    if (! qry.prepare(queryString))
     {
-        errorStr = QString("Error saving values in table:%1 Time:%2\n%3")
-                       .arg(tableName, timeStr, qry.lastError().text());
+        errorStr = QString("Error saving values in table:%1\n%2").arg(tableName, qry.lastError().text());
         return false;
     }
 
-    return true;
-}
-
+    _db.transaction();
 
-bool Crit3DOutputPointsDbHandler::saveHourlyMeteoData_insert(const QString &tableName, const QString timeStr,
-                                                             const std::vector<meteoVariable> &varList,
-                                                             const std::vector<float> &values,
-                                                             QString &errorStr)
-{
-    // field list
-    QString fieldList = "'DATE_TIME'";
-    for (unsigned int i = 0; i < varList.size(); i++)
+    for (size_t t = 0; t < nrTimes; t++)
     {
-        QString newField = QString::fromStdString(getMeteoVarName(varList[i]));
-        if (newField != "")
+        QString timeStr = timeList[t].toString("yyyy-MM-dd HH:mm:ss");
+        qry.addBindValue(timeStr);
+
+        // values rounded to two decimals
+        for (size_t i = 0; i < varList.size(); i++)
         {
-            fieldList += ",'" + newField + "'";
+            qry.addBindValue(QString::number(values[i * nrTimes + t], 'f', 2).toDouble());
         }
-        else
+
+        if (! qry.exec())
         {
-            errorStr = QString("Error saving values in table:%1 \nMissing variable name").arg(tableName);
+            errorStr = QString("Error saving values in table:%1 Time:%2\n%3")
+                           .arg(tableName, timeStr, qry.lastError().text());
+            _db.rollback();
             return false;
         }
     }
 
-    // values list
-    QString valuesList = "'" + timeStr + "'";
-    for (unsigned int i = 0; i < values.size(); i++)
-    {
-        valuesList += "," + QString::number(values[i], 'f', 2);
-    }
-
-    QSqlQuery qry(_db);
-    QString queryString = QString("INSERT INTO '%1' (%2) VALUES (%3)").arg(tableName, fieldList, valuesList);
-    if (! qry.exec(queryString))
+    if (! _db.commit())
     {
-        errorStr = QString("Error saving values in table:%1 Time:%2\n%3")
-                       .arg(tableName, timeStr, qry.lastError().text());
+        errorStr = QString("Error saving values in table:%1\n%2").arg(tableName, _db.lastError().text());
         return false;
     }
 
@@ -230,7 +213,6 @@ bool Crit3DOutputPointsDbHandler::saveHourlyMeteoData_insert(const QString &tabl
 }
 
 
-
 // variableDepth  [cm]
 bool Crit3DOutputPointsDbHandler::saveHourlyCriteria3D_Data(const QString &tableName, const QDateTime& myTime,
                                                             const std::vector<float>& values,
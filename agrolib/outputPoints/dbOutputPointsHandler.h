@@ -34,6 +34,10 @@
                                 const std::vector<meteoVariable> &varList,
                                 const std::vector<float> &valuesList, QString &errorStr);
 
+        bool saveHourlyMeteoDataPeriod(const QString &tableName, const std::vector<QDateTime> &timeList,
+                                       const std::vector<meteoVariable> &varList,
+                                       const std::vector<float> &values, QString &errorStr);
+
         bool saveHourlyCriteria3D_Data(const QString &tableName, const QDateTime& myTime,
                                        const std::vector<float>& values,
                                        const std::vector<int>& waterContentDepthList,
@@ -49,16 +53,6 @@
     private:
 
         QSqlDatabase _db;
-
-        bool saveHourlyMeteoData_insert(const QString &tableName, const QString timeStr,
-                                        const std::vector<meteoVariable> &varList,
-                                        const std::vector<float> &values,
-                                        QString &errorStr);
-
-        bool saveHourlyMeteoData_update(const QString &tableName, const QString timeStr,
-                                         const std::vector<meteoVariable> &varList,
-                                         const std::vector<float> &values,
-                                         QString &errorStr);
     };
 
 
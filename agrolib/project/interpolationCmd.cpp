@@ -136,7 +136,7 @@ void Crit3DProxyGridSeries::addGridToSeries(QString name_, int year_)
 
 
 bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myDate, const gis::Crit3DRasterGrid& gridBase,
-                                gis::Crit3DRasterGrid *gridOut, QString &errorStr)
+                                gis::Crit3DRasterGrid *gridOut, bool isParallelComputing, QString &errorStr)
 {
     errorStr = "";
     std::vector <QString> gridNames = mySeries.getGridName();
@@ -154,7 +154,7 @@ bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myD
             return false;
         }
 
-        gis::resampleGrid(tmpGrid, gridOut, gridBase.header, aggrAverage, 0);
+        gis::resampleGrid(tmpGrid, gridOut, gridBase.header, aggrAverage, 0, isParallelComputing);
         return true;
     }
 
@@ -198,7 +198,7 @@ bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myD
     {
         tmpGrid = secondGrid;
         secondGrid.clear();
-        gis::resampleGrid(tmpGrid, &secondGrid, firstGrid.header, aggrAverage, 0);
+        gis::resampleGrid(tmpGrid, &secondGrid, firstGrid.header, aggrAverage, 0, isParallelComputing);
         tmpGrid.initializeGrid();
     }
 
@@ -211,7 +211,7 @@ bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myD
         return false;
     }
 
-    gis::resampleGrid(tmpGrid, gridOut, gridBase.header, aggrAverage, 0);
+    gis::resampleGrid(tmpGrid, gridOut, gridBase.header, aggrAverage, 0, isParallelComputing);
 
     gridOut->setMapTime(tmpGrid.getMapTime());
 
@@ -223,7 +223,7 @@ bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myD
 }
 
 bool modifiedInterpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myDate, const gis::Crit3DRasterGrid& gridBase,
-                                gis::Crit3DRasterGrid *gridOut, QString &errorStr)
+                                gis::Crit3DRasterGrid *gridOut, bool isParallelComputing, QString &errorStr)
 {
     errorStr = "";
     std::vector <QString> gridNames = mySeries.getGridName();
@@ -288,7 +288,7 @@ bool modifiedInterpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, Q
     {
         tmpGrid = secondGrid;
         secondGrid.clear();
-        gis::resampleGrid(tmpGrid, &secondGrid, firstGrid.header, aggrAverage, 0);
+        gis::resampleGrid(tmpGrid, &secondGrid, firstGrid.header, aggrAverage, 0, isParallelComputing);
         tmpGrid.initializeGrid();
     }
 
@@ -316,7 +316,8 @@ bool modifiedInterpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, Q
 
 
 bool checkProxyGridSeries(Crit3DInterpolationSettings &interpolationSettings, const gis::Crit3DRasterGrid& gridBase,
-                          std::vector <Crit3DProxyGridSeries> myProxySeries, QDate myDate, QString &errorStr)
+                          std::vector <Crit3DProxyGridSeries> myProxySeries, QDate myDate,
+                          bool isParallelComputing, QString &errorStr)
 {
     unsigned i,j;
     gis::Crit3DRasterGrid* gridOut;
@@ -331,7 +332,7 @@ bool checkProxyGridSeries(Crit3DInterpolationSettings &interpolationSettings, co
                 if (myProxySeries[j].getGridName().size() > 0)
                 {
                     gridOut = new gis::Crit3DRasterGrid();
-                    if (! modifiedInterpolateProxyGridSeries(myProxySeries[j], myDate, gridBase, gridOut, errorStr))
+                    if (! modifiedInterpolateProxyGridSeries(myProxySeries[j], myDate, gridBase, gridOut, isParallelComputing, errorStr))
                     {
                         errorStr = "Error in interpolate proxy gris series: " + errorStr;
                         gridOut->clear();
@@ -68,17 +68,18 @@
     };
 
     bool checkProxyGridSeries(Crit3DInterpolationSettings &interpolationSettings, const gis::Crit3DRasterGrid &gridBase,
-                              std::vector <Crit3DProxyGridSeries> mySeries, QDate myDate, QString &errorStr);
+                              std::vector <Crit3DProxyGridSeries> mySeries, QDate myDate,
+                              bool isParallelComputing, QString &errorStr);
 
     bool interpolationRaster(std::vector <Crit3DInterpolationDataPoint> &dataPoints, Crit3DInterpolationSettings &interpolationSettings,
                              Crit3DMeteoSettings *meteoSettings, gis::Crit3DRasterGrid* outputGrid,
                              gis::Crit3DRasterGrid &raster, meteoVariable variable, bool isParallelComputing);
 
     bool interpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myDate, const gis::Crit3DRasterGrid& gridBase,
-                                    gis::Crit3DRasterGrid *gridOut, QString &errorStr);
+                                    gis::Crit3DRasterGrid *gridOut, bool isParallelComputing, QString &errorStr);
 
     bool modifiedInterpolateProxyGridSeries(const Crit3DProxyGridSeries& mySeries, QDate myDate, const gis::Crit3DRasterGrid& gridBase,
-                                    gis::Crit3DRasterGrid *gridOut, QString &errorStr);
+                                    gis::Crit3DRasterGrid *gridOut, bool isParallelComputing, QString &errorStr);
 
     bool topographicIndex(const gis::Crit3DRasterGrid &DEM, std::vector <float> windowWidths, gis::Crit3DRasterGrid& outGrid);
 
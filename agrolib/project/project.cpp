@@ -25,6 +25,7 @@
 #include <QDir>
 #include <QFile>
 #include <QSqlQuery>
+#include <QCryptographicHash>
 #include <QMessageBox>
 #include <string>
 #include <unordered_map>
@@ -46,6 +47,7 @@ Project::Project()
     _verboseStdoutLogging = true;
 
     _formLog = nullptr;
+    _spatialQualityRunDepth = 0;
 
     initializeProject();
 
@@ -84,6 +86,8 @@ void Project::initializeProject()
     meteoSettings->initialize();
     quality->initialize();
     checkSpatialQuality = true;
+    clearSpatialFlagsCache();
+    _spatialQualityRunKeys.clear();
 
     parametersSettings = nullptr;
     projectSettings = nullptr;
@@ -1046,6 +1050,7 @@ void Project::closeMeteoPointsDB()
     }
 
     clearMeteoPoints();
+    clearSpatialFlagsCache();
 
     dbPointsFileName = "";
     meteoPointsLoaded = false;
@@ -1527,12 +1532,20 @@ bool Project::loadMeteoPointsData(const QDate& firstDate, const QDate& lastDate,
     if (! meteoPointsLoaded)
         return false;
 
+    return loadMeteoPointsData(meteoPoints, firstDate, lastDate, loadHourly, loadDaily, showInfo);
+}
+
+
+// load data of the meteo points db into points (same list of meteoPoints, or a temporary copy)
+bool Project::loadMeteoPointsData(std::vector<Crit3DMeteoPoint> &points, const QDate& firstDate, const QDate& lastDate,
+                                  bool loadHourly, bool loadDaily, bool showInfo)
+{
     //check date
     if (firstDate == QDate(1800, 1, 1) || lastDate == QDate(1800, 1, 1))
         return false;
 
     int step = 0;
-    int nrMeteoPoints = (int)meteoPoints.size();
+    int nrMeteoPoints = (int)points.size();
     if (showInfo)
     {
         QString infoStr = "Load meteo points data: " + firstDate.toString();
@@ -1559,11 +1572,11 @@ bool Project::loadMeteoPointsData(const QDate& firstDate, const QDate& lastDate,
         for (int i=0; i < nrMeteoPoints; ++i)
         {
             if (loadHourly && isMeteoPointsHourly)
-                if (meteoPointsDbHandler->loadHourlyData(myDb, myFirstDate, myLastDate, meteoPoints[i]))
+                if (meteoPointsDbHandler->loadHourlyData(myDb, myFirstDate, myLastDate, points[i]))
                     isDataOk[i] = true;
             if (loadDaily && isMeteoPointsDaily)
             {
-                if (meteoPointsDbHandler->loadDailyData(myDb, myFirstDate, myLastDate, meteoPoints[i]))
+                if (meteoPointsDbHandler->loadDailyData(myDb, myFirstDate, myLastDate, points[i]))
                     isDataOk[i] = true;
             }
 
@@ -2193,7 +2206,7 @@ bool Project::loadProxyGrids()
             /*if (DEM.isLoaded && gis::readEsriGrid(fileName.toStdString(), &proxyGrid, myError))
             {
                 gis::Crit3DRasterGrid* resGrid = new gis::Crit3DRasterGrid();
-                gis::resampleGrid(proxyGrid, resGrid, DEM.header, aggrAverage, 0);
+                gis::resampleGrid(proxyGrid, resGrid, DEM.header, aggrAverage, 0, _isParallelComputing);
                 myProxy->setGrid(resGrid);
             }
             else
@@ -2355,11 +2368,24 @@ bool Project::writeTopographicDistanceMap(int pointIndex, const gis::Crit3DRaste
     if (gis::topographicDistanceMap(meteoPoints[pointIndex].point, demMap, &myMap))
     {
         fileName = pathTd.toStdString() + "TD_" + QFileInfo(demFileName).baseName().toStdString() + "_" + meteoPoints[pointIndex].id;
+
+        // the loaded map can be a view of the same file: it is released before writing and mapped again
+        gis::Crit3DRasterGrid* loadedMap = meteoPoints[pointIndex].topographicDistance;
+        bool isMapped = (loadedMap != nullptr && loadedMap->isMemoryMapped());
+        if (isMapped)
+            loadedMap->clear();
+
         if (! gis::writeEsriGrid(fileName, &myMap, myError))
         {
             logError(QString::fromStdString(myError));
             return false;
         }
+
+        if (isMapped && ! gis::readEsriGridMapped(fileName, loadedMap, myError))
+        {
+            logError(QString::fromStdString(myError));
+            return false;
+        }
     }
     return true;
 }
@@ -2414,8 +2440,11 @@ bool Project::loadTopographicDistanceMaps(bool onlyWithData, bool showInfo)
                 logInfo(QString::fromStdString(fileName) + " successfully created!");
         }
 
-        meteoPoints[i].topographicDistance = new gis::Crit3DRasterGrid();
-        if (! gis::readEsriGrid(fileName, meteoPoints[i].topographicDistance, myError))
+        // read-only maps: pages are loaded on demand
+        if (meteoPoints[i].topographicDistance == nullptr)
+            meteoPoints[i].topographicDistance = new gis::Crit3DRasterGrid();
+
+        if (! gis::readEsriGridMapped(fileName, meteoPoints[i].topographicDistance, myError))
         {
             logError(QString::fromStdString(myError));
             return false;
@@ -2608,7 +2637,7 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
     gis::Crit3DRasterGrid* macroAreasGrid = new gis::Crit3DRasterGrid();
     std::string fileName = mapsFolder.toStdString() + "glocalWeight_";
 
-    std::vector<float> areaCells;
+    TMacroAreaCells areaCells;
     int nrCols, nrRows;
     double myX, myY;
     float myValue = NODATA;
@@ -2632,15 +2661,15 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
     }
 
     unsigned nrAreasWithCells = 0;
-    std::vector<Crit3DMacroArea> existingAreas = interpolationSettings.getMacroAreas();
+    const std::vector<Crit3DMacroArea>& existingAreas = interpolationSettings.getMacroAreas();
 
     for (std::size_t i = 0; i < myAreas.size(); i++)
     {
         //se ci sono già celle caricate di DEM o grid, salvale
         if (i < existingAreas.size())
         {
-            myAreas[i].setAreaCellsDEM(existingAreas[i].getAreaCellsDEM());
-            myAreas[i].setAreaCellsGrid(existingAreas[i].getAreaCellsGrid());
+            myAreas[i].setAreaCellsDEM(existingAreas[i].getAreaCellsDEMPtr());
+            myAreas[i].setAreaCellsGrid(existingAreas[i].getAreaCellsGridPtr());
         }
 
         if (!QFile::exists(QString::fromStdString(fileName) + QString::number(i) + ".flt"))
@@ -2658,9 +2687,9 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
         {
             for (unsigned row = 0; row < unsigned(meteoGridDbHandler->gridStructure().header().nrRows); row++)
                     for (unsigned col = 0; col < unsigned(meteoGridDbHandler->gridStructure().header().nrCols); col++)
-                        if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+                        if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
                         {
-                            meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->glocalWeights.resize(myAreas.size());
+                            meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->glocalWeights.resize(myAreas.size());
                         }
 
             meteoGridDbHandler->meteoGrid()->assignGridGlocalWeightValues(macroAreasGrid, (int)i);
@@ -2672,8 +2701,8 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
             {
                 if (isGrid)
                 {
-                    if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
-                        myValue = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->glocalWeights[i];
+                    if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
+                        myValue = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->glocalWeights[i];
                 }
                 else
                 {
@@ -2683,8 +2712,7 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
 
                 if (! isEqual(myValue, NODATA) && ! isEqual(myValue, 0))
                 {
-                    areaCells.push_back(row*nrCols+col);
-                    areaCells.push_back(myValue);
+                    areaCells.push_back(unsigned(row) * unsigned(nrCols) + unsigned(col), myValue);
                 }
             }
         }
@@ -2693,11 +2721,11 @@ bool Project::loadGlocalWeightMaps(std::vector<Crit3DMacroArea> &myAreas, bool i
             nrAreasWithCells++;
 
         if (isGrid)
-            myAreas[i].setAreaCellsGrid(areaCells);
+            myAreas[i].setAreaCellsGrid(std::move(areaCells));
         else
-            myAreas[i].setAreaCellsDEM(areaCells);
+            myAreas[i].setAreaCellsDEM(std::move(areaCells));
 
-        areaCells.clear();
+        areaCells = TMacroAreaCells();
     }
     macroAreasGrid->clear();
 
@@ -2806,11 +2834,11 @@ bool Project::groupCellsInArea(std::vector<int> &areaPoints, int index, bool isG
         {
             for (int j = 0; j < meteoGridDbHandler->meteoGrid()->gridStructure().header().nrCols; j++)
             {
-                if (!meteoGridDbHandler->meteoGrid()->meteoPoints()[i][j]->active)
+                if (!meteoGridDbHandler->meteoGrid()->meteoPointPointer(i, j)->active)
                     continue;
 
-                myX = meteoGridDbHandler->meteoGrid()->meteoPoints()[i][j]->point.utm.x;
-                myY = meteoGridDbHandler->meteoGrid()->meteoPoints()[i][j]->point.utm.y;
+                myX = meteoGridDbHandler->meteoGrid()->meteoPointPointer(i, j)->point.utm.x;
+                myY = meteoGridDbHandler->meteoGrid()->meteoPointPointer(i, j)->point.utm.y;
 
                 zoneNr = macroAreas->getValueFromXY(myX, myY);
 
@@ -2903,7 +2931,12 @@ bool Project::interpolationOutputPoints(std::vector <Crit3DInterpolationDataPoin
     std::vector <double> proxyValues;
     proxyValues.resize(unsigned(interpolationSettings.getProxyNr()));
 
-    for (unsigned int i = 0; i < outputPoints.size(); i++)
+    bool isDetrending = getUseDetrendingVar(myVar);
+    int nrOutputPoints = int(outputPoints.size());
+
+    // points are independent (as the cells in interpolationRaster)
+    #pragma omp parallel for if(_isParallelComputing) firstprivate(proxyValues)
+    for (int i = 0; i < nrOutputPoints; i++)
     {
         if(!outputPoints[i].active)
             continue;
@@ -2917,15 +2950,25 @@ bool Project::interpolationOutputPoints(std::vector <Crit3DInterpolationDataPoin
         if (gis::isOutOfGridRowCol(row, col, *outputGrid))
             continue;
 
-        if (getUseDetrendingVar(myVar))
+        if (isDetrending)
         {
             getProxyValuesXY(x, y, interpolationSettings, proxyValues);
         }
 
         outputPoints[i].currentValue = interpolate(interpolationPoints, interpolationSettings,
                                                     meteoSettings, myVar, x, y, z, proxyValues, true);
+    }
 
-        outputGrid->value[row][col] = outputPoints[i].currentValue;
+    // serial copy: more points can fall in the same cell
+    for (int i = 0; i < nrOutputPoints; i++)
+    {
+        if(!outputPoints[i].active)
+            continue;
+
+        int row, col;
+        outputGrid->getRowCol(outputPoints[i].utm.x, outputPoints[i].utm.y, row, col);
+        if (! gis::isOutOfGridRowCol(row, col, *outputGrid))
+            outputGrid->value[row][col] = outputPoints[i].currentValue;
     }
 
     return true;
@@ -3011,6 +3054,274 @@ bool Project::computeStatisticsGlocalCrossValidation(Crit3DMacroArea myArea)
 }
 
 
+static int getSpatialQualityBlockDays(frequencyType myFreq)
+{
+    return (myFreq == daily) ? 366 : 31;
+}
+
+
+void Project::clearSpatialFlagsCache()
+{
+    _spatialFlagsVariable = noMeteoVar;
+    _spatialFlagsKey = "";
+    _spatialFlagsVersion = NODATA;
+    _spatialFlagsFirstDate = QDate();
+    _spatialFlagsLastDate = QDate();
+    _spatialFlags.clear();
+}
+
+
+/*!
+ * \brief getSpatialQualitySettingsKey
+ * hash of the quality settings and of the meteo points used by the spatial quality control:
+ * the stored flags are valid only for the same key
+ */
+QString Project::getSpatialQualitySettingsKey(meteoVariable myVar)
+{
+    QString keyStr = QString::fromStdString(getVariableString(myVar));
+
+    keyStr += QString("|%1,%2,%3").arg(quality->getReferenceHeight()).arg(quality->getRelHumTolerance())
+                                  .arg(quality->getWaterTableMaximumDepth());
+
+    keyStr += QString("|%1,%2,%3,%4,%5,%6,%7,%8,%9").arg(meteoSettings->getMinimumPercentage())
+                  .arg(meteoSettings->getRainfallThreshold()).arg(meteoSettings->getThomThreshold())
+                  .arg(meteoSettings->getTemperatureThreshold()).arg(meteoSettings->getTransSamaniCoefficient())
+                  .arg(meteoSettings->getHourlyIntervals()).arg(meteoSettings->getWindIntensityDefault())
+                  .arg(int(meteoSettings->getAutomaticTavg())).arg(int(meteoSettings->getAutomaticET0HS()));
+
+    keyStr += QString("|%1,%2,%3,%4,%5").arg(int(qualityInterpolationSettings.getInterpolationMethod()))
+                  .arg(int(qualityInterpolationSettings.getUseLapseRateCode()))
+                  .arg(int(qualityInterpolationSettings.getUseThermalInversion()))
+                  .arg(int(qualityInterpolationSettings.getUseTD()))
+                  .arg(qualityInterpolationSettings.getTopoDist_maxKh());
+
+    keyStr += QString("|%1,%2,%3,%4,%5,%6").arg(int(qualityInterpolationSettings.getUseLocalDetrending()))
+                  .arg(int(qualityInterpolationSettings.getUseGlocalDetrending()))
+                  .arg(int(qualityInterpolationSettings.getUseBestDetrending()))
+                  .arg(int(qualityInterpolationSettings.getUseMultipleDetrending()))
+                  .arg(qualityInterpolationSettings.getMinRegressionR2())
+                  .arg(qualityInterpolationSettings.getMinPointsLocalDetrending());
+
+    Crit3DProxyCombination myCombination = qualityInterpolationSettings.getSelectedCombination();
+    for (unsigned int i = 0; i < qualityInterpolationSettings.getProxyNr(); i++)
+    {
+        keyStr += "|" + QString::fromStdString(qualityInterpolationSettings.getProxyName(i))
+                  + "," + QString::number(int(myCombination.isProxyActive(i)));
+    }
+
+    keyStr += "|" + FloatVectorToStringList(climateParameters.tminLapseRate).join(",")
+              + "|" + FloatVectorToStringList(climateParameters.tmaxLapseRate).join(",")
+              + "|" + FloatVectorToStringList(climateParameters.tdMinLapseRate).join(",")
+              + "|" + FloatVectorToStringList(climateParameters.tdMaxLapseRate).join(",");
+
+    for (unsigned int i = 0; i < meteoPoints.size(); i++)
+    {
+        keyStr += "|" + QString::fromStdString(meteoPoints[i].id) + "," + QString::number(int(meteoPoints[i].active))
+                  + "," + QString::number(int(meteoPoints[i].lapseRateCode));
+    }
+
+    return QString::fromLatin1(QCryptographicHash::hash(keyStr.toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+
+/*!
+ * \brief computeSpatialQualityFlags
+ * syntactic and spatial quality control of the period (blocks of days),
+ * the flags are saved in the meteo points db and reused by the interpolation
+ * data are loaded in a temporary copy of the points: the project meteoPoints are not modified
+ */
+bool Project::computeSpatialQualityFlags(meteoVariable myVar, const QDate &firstDate, const QDate &lastDate)
+{
+    if (! meteoPointsLoaded || meteoPointsDbHandler == nullptr)
+    {
+        errorString = ERROR_STR_MISSING_DB;
+        return false;
+    }
+
+    frequencyType myFreq = getVarFrequency(myVar);
+    if (myFreq != daily && myFreq != hourly)
+    {
+        errorString = "Wrong variable: " + QString::fromStdString(getVariableString(myVar));
+        return false;
+    }
+
+    if (! firstDate.isValid() || ! lastDate.isValid() || firstDate > lastDate)
+    {
+        errorString = "Wrong dates";
+        return false;
+    }
+
+    QString settingsKey = getSpatialQualitySettingsKey(myVar);
+
+    std::vector<Crit3DMeteoPoint> qcPoints(meteoPoints.size());
+    for (unsigned int i = 0; i < meteoPoints.size(); i++)
+    {
+        meteoPoints[i].copyPropertiesTo(qcPoints[i]);
+    }
+
+    int blockDays = getSpatialQualityBlockDays(myFreq);
+    int nrDays = int(firstDate.daysTo(lastDate)) + 1;
+    setProgressBar("Spatial quality control...", nrDays);
+
+    bool isOk = true;
+    std::string errorStdStr;
+    QDate blockFirstDate = firstDate;
+    while (blockFirstDate <= lastDate)
+    {
+        QDate blockLastDate = std::min(blockFirstDate.addDays(blockDays - 1), lastDate);
+        updateProgressBarText("Spatial quality control: " + blockFirstDate.toString("yyyy-MM-dd")
+                              + " - " + blockLastDate.toString("yyyy-MM-dd"));
+
+        if (! loadMeteoPointsData(qcPoints, blockFirstDate, blockLastDate, myFreq == hourly, myFreq == daily, false))
+        {
+            errorString = "Error in loading meteo points data.";
+            isOk = false;
+            break;
+        }
+
+        std::vector<Crit3DTime> timeList;
+        for (QDate myDate = blockFirstDate; myDate <= blockLastDate; myDate = myDate.addDays(1))
+        {
+            if (myFreq == daily)
+                timeList.push_back(getCrit3DTime(myDate, 1));
+            else
+            {
+                for (int hour = 1; hour <= 24; hour++)
+                    timeList.push_back(getCrit3DTime(myDate, hour));
+            }
+        }
+
+        std::vector<int> qualityFlags;
+        if (! spatialQualityControlPeriod(quality, myVar, qcPoints, timeList, qualityInterpolationSettings,
+                                         meteoSettings, &climateParameters, _isParallelComputing, qualityFlags, errorStdStr))
+        {
+            errorString = "Error in spatial quality control: " + QString::fromStdString(errorStdStr);
+            isOk = false;
+            break;
+        }
+
+        if (! meteoPointsDbHandler->writeSpatialQualityFlags(myVar, timeList, qcPoints, qualityFlags, settingsKey))
+        {
+            errorString = "Error in saving quality flags: " + meteoPointsDbHandler->getErrorString();
+            isOk = false;
+            break;
+        }
+
+        updateProgressBar(int(firstDate.daysTo(blockLastDate)));
+
+        blockFirstDate = blockLastDate.addDays(1);
+    }
+
+    for (unsigned int i = 0; i < qcPoints.size(); i++)
+    {
+        qcPoints[i].cleanAllData();
+    }
+
+    clearSpatialFlagsCache();
+    closeProgressBar();
+    return isOk;
+}
+
+
+/*!
+ * \brief getSpatialQualityRunKey
+ * settings key of the spatial quality control: inside a run (Crit3DSpatialQualityRun)
+ * it is computed once for each variable, otherwise at each call
+ */
+QString Project::getSpatialQualityRunKey(meteoVariable myVar)
+{
+    if (! checkSpatialQuality || ! isSpatialQualityVar(myVar))
+        return "";
+
+    if (_spatialQualityRunDepth == 0)
+        return getSpatialQualitySettingsKey(myVar);
+
+    auto it = _spatialQualityRunKeys.find(myVar);
+    if (it == _spatialQualityRunKeys.end())
+        it = _spatialQualityRunKeys.insert({myVar, getSpatialQualitySettingsKey(myVar)}).first;
+
+    return it->second;
+}
+
+
+void Project::beginSpatialQualityRun()
+{
+    if (_spatialQualityRunDepth == 0)
+        _spatialQualityRunKeys.clear();
+
+    _spatialQualityRunDepth++;
+}
+
+
+void Project::endSpatialQualityRun()
+{
+    if (_spatialQualityRunDepth > 0)
+        _spatialQualityRunDepth--;
+
+    if (_spatialQualityRunDepth == 0)
+        _spatialQualityRunKeys.clear();
+}
+
+
+/*!
+ * \brief getStoredSpatialFlags
+ * flags saved by computeSpatialQualityFlags (index of meteoPoints), empty if not available
+ * settingsKey: see getSpatialQualityRunKey
+ * the flags are loaded from the db by blocks of days and kept until the settings or the points change
+ */
+std::vector<int> Project::getStoredSpatialFlags(meteoVariable myVar, const Crit3DTime& myTime, const QString &settingsKey)
+{
+    std::vector<int> spatialFlags;
+
+    if (! checkSpatialQuality || meteoPointsDbHandler == nullptr || ! isSpatialQualityVar(myVar))
+        return spatialFlags;
+
+    frequencyType myFreq = getVarFrequency(myVar);
+    if (myFreq != daily && myFreq != hourly)
+        return spatialFlags;
+
+    QDate myDate = getQDate(myTime.date);
+
+    if (myVar != _spatialFlagsVariable || settingsKey != _spatialFlagsKey
+        || meteoPointsDbHandler->getSpatialQualityVersion() != _spatialFlagsVersion
+        || ! _spatialFlagsFirstDate.isValid() || myDate < _spatialFlagsFirstDate || myDate > _spatialFlagsLastDate)
+    {
+        clearSpatialFlagsCache();
+
+        QDate lastDate = myDate.addDays(getSpatialQualityBlockDays(myFreq) - 1);
+        Crit3DTime firstTime = getCrit3DTime(myDate, (myFreq == daily) ? 1 : 0);
+        Crit3DTime lastTime = getCrit3DTime(lastDate, 24);
+
+        if (! meteoPointsDbHandler->loadSpatialQualityFlags(myVar, firstTime, lastTime, settingsKey, _spatialFlags))
+        {
+            clearSpatialFlagsCache();
+            return spatialFlags;
+        }
+
+        _spatialFlagsVariable = myVar;
+        _spatialFlagsKey = settingsKey;
+        _spatialFlagsVersion = meteoPointsDbHandler->getSpatialQualityVersion();
+        _spatialFlagsFirstDate = myDate;
+        _spatialFlagsLastDate = lastDate;
+    }
+
+    auto timeIt = _spatialFlags.constFind(Crit3DMeteoPointsDbHandler::getSpatialQualityTimeString(myVar, myTime));
+    if (timeIt == _spatialFlags.constEnd() || timeIt.value().isEmpty())
+        return spatialFlags;
+
+    const QMap<QString, int> &flagMap = timeIt.value();
+    spatialFlags.resize(meteoPoints.size(), quality::missing_data);
+    for (unsigned int i = 0; i < meteoPoints.size(); i++)
+    {
+        auto it = flagMap.constFind(QString::fromStdString(meteoPoints[i].id));
+        if (it != flagMap.constEnd())
+            spatialFlags[i] = it.value();
+    }
+
+    return spatialFlags;
+}
+
+
 bool Project::interpolationCv(meteoVariable myVar, const Crit3DTime& myTime)
 {
     if (! checkInterpolation(myVar)) return false;
@@ -3041,11 +3352,13 @@ bool Project::interpolationCv(meteoVariable myVar, const Crit3DTime& myTime)
     std::vector <Crit3DInterpolationDataPoint> interpolationPoints;
     std::string errorStdStr;
 
+    std::vector<int> storedSpatialFlags = getStoredSpatialFlags(myVar, myTime, getSpatialQualityRunKey(myVar));
+
     // check quality and pass data to interpolation
     if (! checkAndPassDataToInterpolation(quality, myVar, meteoPoints, myTime,
                                          qualityInterpolationSettings, interpolationSettings, meteoSettings,
                                          &climateParameters, interpolationPoints,
-                                         checkSpatialQuality, errorStdStr))
+                                         checkSpatialQuality, errorStdStr, &storedSpatialFlags))
     {
         logError("No data available: " + QString::fromStdString(getVariableString(myVar)) + "\n" + QString::fromStdString(errorStdStr));
         return false;
@@ -3110,10 +3423,12 @@ bool Project::interpolationDem(meteoVariable myVar, const Crit3DTime& myTime, gi
     std::vector <Crit3DInterpolationDataPoint> interpolationPoints;
     std::string errorStdStr;
 
+    std::vector<int> storedSpatialFlags = getStoredSpatialFlags(myVar, myTime, getSpatialQualityRunKey(myVar));
+
     // check quality and pass data to interpolation
     if (! checkAndPassDataToInterpolation(quality, myVar, meteoPoints, myTime,
                                          qualityInterpolationSettings, interpolationSettings, meteoSettings, &climateParameters, interpolationPoints,
-                                         checkSpatialQuality, errorStdStr))
+                                         checkSpatialQuality, errorStdStr, &storedSpatialFlags))
     {
         errorString = "No data available: " + QString::fromStdString(getVariableString(myVar))
                       + "\n" + QString::fromStdString(errorStdStr);
@@ -3159,9 +3474,11 @@ bool Project::interpolationDemLocalDetrending(meteoVariable myVar, const Crit3DT
     std::vector <Crit3DInterpolationDataPoint> interpolationPoints;
     std::string errorStdStr;
 
+    std::vector<int> storedSpatialFlags = getStoredSpatialFlags(myVar, myTime, getSpatialQualityRunKey(myVar));
+
     if (! checkAndPassDataToInterpolation(quality, myVar, meteoPoints, myTime, qualityInterpolationSettings,
                                           interpolationSettings, meteoSettings, &climateParameters, interpolationPoints,
-                                            checkSpatialQuality, errorStdStr))
+                                            checkSpatialQuality, errorStdStr, &storedSpatialFlags))
     {
         errorString = "No data available: " + QString::fromStdString(getVariableString(myVar))
                       + "\n" + QString::fromStdString(errorStdStr);
@@ -3268,9 +3585,11 @@ bool Project::interpolationDemGlocalDetrending(meteoVariable myVar, const Crit3D
     std::vector <Crit3DInterpolationDataPoint> interpolationPoints;
     std::string errorStdStr;
 
+    std::vector<int> storedSpatialFlags = getStoredSpatialFlags(myVar, myTime, getSpatialQualityRunKey(myVar));
+
     if (! checkAndPassDataToInterpolation(quality, myVar, meteoPoints, myTime, qualityInterpolationSettings,
                                             interpolationSettings, meteoSettings, &climateParameters, interpolationPoints,
-                                            checkSpatialQuality, errorStdStr))
+                                            checkSpatialQuality, errorStdStr, &storedSpatialFlags))
     {
         errorString = "No data available: " + QString::fromStdString(getVariableString(myVar))
                       + "\n" + QString::fromStdString(errorStdStr);
@@ -3313,38 +3632,38 @@ bool Project::interpolationDemGlocalDetrending(meteoVariable myVar, const Crit3D
                 elevationPos = pos;
         }
 
+        // cells are shared between the copies of the settings: firstprivate copies only the fitting state
         Crit3DInterpolationSettings myInterpolationSettings = interpolationSettings;
         std::vector<double> proxyValues(myInterpolationSettings.getProxyNr());
 
-        #pragma omp parallel for if (_isParallelComputing) firstprivate(myInterpolationSettings, proxyValues) shared(isOk)
-        for (int areaIndex = 0; areaIndex < myInterpolationSettings.getMacroAreasSize(); areaIndex++)
+        // weighted values of each area, written only by the thread computing that area
+        int nrAreas = interpolationSettings.getMacroAreasSize();
+        std::vector<std::vector<float>> areaValues(nrAreas);
+
+        #pragma omp parallel for if (_isParallelComputing) firstprivate(myInterpolationSettings, proxyValues) shared(isOk) schedule(dynamic)
+        for (int areaIndex = 0; areaIndex < nrAreas; areaIndex++)
         {
             if (!isOk)
                 continue;   // early skip if already failed
 
-            // load macro area and its cells
-            Crit3DMacroArea macroArea = myInterpolationSettings.getMacroArea(areaIndex);
-            std::vector<float> areaCells = macroArea.getAreaCellsDEM();
-            std::vector<Crit3DInterpolationDataPoint> subsetInterpolationPoints;
-            double interpolatedValue = NODATA;
-
+            const TMacroAreaCells& areaCells = interpolationSettings.getMacroArea(areaIndex).getAreaCellsDEM();
             if (areaCells.empty())
                 continue;
 
-            macroAreaDetrending(macroArea, myVar, myInterpolationSettings, meteoSettings,
+            std::vector<Crit3DInterpolationDataPoint> subsetInterpolationPoints;
+            macroAreaDetrending(interpolationSettings.getMacroArea(areaIndex), myVar, myInterpolationSettings, meteoSettings,
                                 meteoPoints, interpolationPoints, subsetInterpolationPoints, elevationPos);
 
+            std::vector<float> &values = areaValues[areaIndex];
+            values.resize(areaCells.size(), NODATA);
+
             // calculate value for every cell
-            for (std::size_t cellIndex = 0; cellIndex < areaCells.size(); cellIndex = cellIndex + 2)
+            for (std::size_t i = 0; i < areaCells.size(); i++)
             {
-                if (!isOk)
-                    break;   // early skip if already failed
-
-                int row = int(areaCells[cellIndex] / DEM.header->nrCols);
-                int col = int(areaCells[cellIndex]) % DEM.header->nrCols;
+                int row = int(areaCells.index[i] / unsigned(myHeader.nrCols));
+                int col = int(areaCells.index[i] % unsigned(myHeader.nrCols));
 
                 float z = DEM.value[row][col];
-
                 if (isEqual(z, myHeader.flag))
                     continue;
 
@@ -3352,25 +3671,44 @@ bool Project::interpolationDemGlocalDetrending(meteoVariable myVar, const Crit3D
                 gis::getUtmXYFromRowCol(myHeader, row, col, &x, &y);
 
                 if (! getSignificantProxyValuesXY(x, y, myInterpolationSettings, proxyValues))
-                {
-                    myRaster->value[row][col] = NODATA;
                     continue;
-                }
 
-                interpolatedValue = interpolate(subsetInterpolationPoints, myInterpolationSettings, meteoSettings,
-                                                myVar, x, y, z, proxyValues, true);
+                double interpolatedValue = interpolate(subsetInterpolationPoints, myInterpolationSettings, meteoSettings,
+                                                       myVar, x, y, z, proxyValues, true);
 
                 if (isEqual(interpolatedValue, NODATA))
-                    isOk = false; // cannot return directly; set flag instead
-
-                // protect writes if same cell could be touched by multiple threads
-                #pragma omp critical
                 {
-                    if (isEqual(myRaster->value[row][col], NODATA))
-                        myRaster->value[row][col] = interpolatedValue * areaCells[cellIndex + 1];
-                    else
-                        myRaster->value[row][col] += interpolatedValue * areaCells[cellIndex + 1];
+                    isOk = false;   // cannot return directly; set flag instead
+                    break;
                 }
+
+                values[i] = float(interpolatedValue) * areaCells.weight[i];
+            }
+        }
+
+        if (! isOk)
+            return false;
+
+        // sum the weighted values, in the order of the areas
+        for (int areaIndex = 0; areaIndex < nrAreas; areaIndex++)
+        {
+            const TMacroAreaCells& areaCells = interpolationSettings.getMacroArea(areaIndex).getAreaCellsDEM();
+            const std::vector<float> &values = areaValues[areaIndex];
+
+            for (std::size_t i = 0; i < values.size(); i++)
+            {
+                int row = int(areaCells.index[i] / unsigned(myHeader.nrCols));
+                int col = int(areaCells.index[i] % unsigned(myHeader.nrCols));
+
+                if (isEqual(DEM.value[row][col], myHeader.flag))
+                    continue;
+
+                if (isEqual(values[i], NODATA))
+                    myRaster->value[row][col] = NODATA;
+                else if (isEqual(myRaster->value[row][col], NODATA))
+                    myRaster->value[row][col] = values[i];
+                else
+                    myRaster->value[row][col] += values[i];
             }
         }
     }
@@ -3574,7 +3912,7 @@ bool Project::meteoGridAggregateProxy(std::vector <gis::Crit3DRasterGrid*> &myGr
 
         proxyGrid = interpolationSettings.getProxy(i)->getGrid();
         if (proxyGrid != nullptr && proxyGrid->isLoaded)
-            gis::resampleGrid(*proxyGrid, myGrid, meteoGridRaster.header, aggrAverage, 0);
+            gis::resampleGrid(*proxyGrid, myGrid, meteoGridRaster.header, aggrAverage, 0, _isParallelComputing);
 
         myGrids.push_back(myGrid);
     }
@@ -3594,10 +3932,12 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
     if (interpolationSettings.getUseMultipleDetrending())
         interpolationSettings.clearFitting();
 
+    std::vector<int> storedSpatialFlags = getStoredSpatialFlags(myVar, myTime, getSpatialQualityRunKey(myVar));
+
     // check quality and pass data to interpolation
     if (! checkAndPassDataToInterpolation(quality, myVar, meteoPoints, myTime, qualityInterpolationSettings,
                                           interpolationSettings, meteoSettings, &climateParameters, interpolationPoints,
-                                          checkSpatialQuality, errorStdStr))
+                                          checkSpatialQuality, errorStdStr, &storedSpatialFlags))
     {
         logError("No data available: " + QString::fromStdString(getVariableString(myVar)));
         return false;
@@ -3641,12 +3981,12 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
         {
             for (unsigned row = 0; row < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows); row++)
             {
-                if(!meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+                if(!meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
                     continue;
 
-                myX = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.utm.x;
-                myY = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.utm.y;
-                myZ = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.z;
+                myX = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.utm.x;
+                myY = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.utm.y;
+                myZ = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.z;
 
                 if (getUseDetrendingVar(myVar))
                 {
@@ -3669,9 +4009,9 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
                         proxyIndex++;
                     }*/
 
-                    for (size_t p = 0; p < meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->proxyValues.size(); p++)
+                    for (size_t p = 0; p < meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->proxyValues.size(); p++)
                     {
-                        proxyValues[p] = (double(meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->proxyValues[p]));
+                        proxyValues[p] = (double(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->proxyValues[p]));
                     }
 
                     if (interpolationSettings.getUseLocalDetrending())
@@ -3699,19 +4039,19 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
 
                 if (freq == hourly)
                 {
-                    if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->nrObsDataDaysH == 0)
-                        meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->initializeObsDataH(1, 1, myTime.date);
+                    if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->nrObsDataDaysH == 0)
+                        meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->initializeObsDataH(1, 1, myTime.date);
 
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->setMeteoPointValueH(myTime.date, myTime.getHour(), myTime.getMinutes(), myVar, float(interpolatedValue));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = float(interpolatedValue);
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->setMeteoPointValueH(myTime.date, myTime.getHour(), myTime.getMinutes(), myVar, float(interpolatedValue));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = float(interpolatedValue);
                 }
                 else if (freq == daily)
                 {
-                    if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->nrObsDataDaysD == 0)
-                        meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->initializeObsDataD(1, myTime.date);
+                    if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->nrObsDataDaysD == 0)
+                        meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->initializeObsDataD(1, myTime.date);
 
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->setMeteoPointValueD(myTime.date, myVar, float(interpolatedValue));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = float(interpolatedValue);
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->setMeteoPointValueD(myTime.date, myVar, float(interpolatedValue));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = float(interpolatedValue);
                 }
 
             }
@@ -3724,18 +4064,17 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
         {
             for (unsigned row = 0; row < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows); row++)
             {
-                if(!meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+                if(!meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
                     continue;
 
                 if (freq == hourly)
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = NODATA;
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = NODATA;
                 else if (freq == daily)
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = NODATA;
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = NODATA;
             }
         }
 
         unsigned row, col;
-        std::vector<float> areaCells;
         float myValue = NODATA;
 
         int elevationPos = NODATA;
@@ -3749,7 +4088,7 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
         {
             //load macro area and its cells
             Crit3DMacroArea macroArea = interpolationSettings.getMacroArea(areaIndex);
-            areaCells = macroArea.getAreaCellsGrid();
+            const TMacroAreaCells& areaCells = macroArea.getAreaCellsGrid();
 			std::vector<Crit3DInterpolationDataPoint> subsetInterpolationPoints;
 
             if (areaCells.empty())
@@ -3759,17 +4098,17 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
                                 interpolationPoints, subsetInterpolationPoints, elevationPos);
             unsigned nrCols = meteoGridDbHandler->meteoGrid()->gridStructure().header().nrCols;
             //calculate value for every cell
-            for (unsigned cellIndex = 0; cellIndex < areaCells.size(); cellIndex = cellIndex + 2)
+            for (unsigned cellIndex = 0; cellIndex < areaCells.size(); cellIndex++)
             {
-                row = unsigned(areaCells[cellIndex]/nrCols);
-                col = int(areaCells[cellIndex])%nrCols;
+                row = areaCells.index[cellIndex] / nrCols;
+                col = areaCells.index[cellIndex] % nrCols;
 
-                if(!meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+                if(!meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
                     continue;
 
-                myX = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.utm.x;
-                myY = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.utm.y;
-                myZ = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.z;
+                myX = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.utm.x;
+                myY = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.utm.y;
+                myZ = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.z;
 
                 if(getUseDetrendingVar(myVar))
                 {
@@ -3799,7 +4138,7 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
                         }*/
 
 
-                        proxyValues[i] = (double(meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->proxyValues[i]));
+                        proxyValues[i] = (double(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->proxyValues[i]));
 
                         if (isEqual(proxyValues[i], NODATA))
                             proxyFlag = false;
@@ -3816,36 +4155,35 @@ bool Project::interpolationGrid(meteoVariable myVar, const Crit3DTime& myTime)
                         errorString = "Error in interpolation. Check the glocal related files, rewrite the weight maps, reload the project and try again.";
                         return false;
                     }
-                    interpolatedValue = interpolate(subsetInterpolationPoints, interpolationSettings, meteoSettings, myVar, myX, myY, myZ, proxyValues, true)
-                                    * areaCells[cellIndex + 1];
+                    interpolatedValue = temp * areaCells.weight[cellIndex];
                 }
 
                 if (freq == hourly)
                 {
-                    if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->nrObsDataDaysH == 0)
-                        meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->initializeObsDataH(1, 1, myTime.date);
+                    if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->nrObsDataDaysH == 0)
+                        meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->initializeObsDataH(1, 1, myTime.date);
 
-                    myValue = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue;
+                    myValue = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue;
 
                     if (isEqual(myValue, NODATA))
                         myValue = 0;
 
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->setMeteoPointValueH(myTime.date, myTime.getHour(), myTime.getMinutes(), myVar, float(interpolatedValue+myValue));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = float(interpolatedValue+myValue);
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->setMeteoPointValueH(myTime.date, myTime.getHour(), myTime.getMinutes(), myVar, float(interpolatedValue+myValue));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = float(interpolatedValue+myValue);
 
                 }
                 else if (freq == daily)
                 {
-                    if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->nrObsDataDaysD == 0)
-                        meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->initializeObsDataD(1, myTime.date);
+                    if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->nrObsDataDaysD == 0)
+                        meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->initializeObsDataD(1, myTime.date);
 
-                    myValue = meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue;
+                    myValue = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue;
 
                     if (isEqual(myValue, NODATA))
                         myValue = 0;
 
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->setMeteoPointValueD(myTime.date, myVar, float(interpolatedValue+myValue));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue = float(interpolatedValue+myValue);
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->setMeteoPointValueD(myTime.date, myVar, float(interpolatedValue+myValue));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue = float(interpolatedValue+myValue);
                 }
             }
         }
@@ -5380,8 +5718,8 @@ bool Project::exportMeteoGridToCsv(QString fileName)
             if (!meteoGridDbHandler->meteoGrid()->gridStructure().isUTM())
                 newRow = meteoGridDbHandler->meteoGrid()->gridStructure().nrRow() - 1 - row;
 
-            std::string id = meteoGridDbHandler->meteoGrid()->meteoPoints()[newRow][col]->id;
-            std::string name = meteoGridDbHandler->meteoGrid()->meteoPoints()[newRow][col]->name;
+            std::string id = meteoGridDbHandler->meteoGrid()->meteoPointPointer(newRow, col)->id;
+            std::string name = meteoGridDbHandler->meteoGrid()->meteoPointPointer(newRow, col)->name;
 
             out << QString::fromStdString(id + ',' + name + ',') + QString::number(value) + "\n";
         }
@@ -5974,6 +6312,22 @@ bool Project::waterTableComputeSingleWell(int indexWell)
     if (indexWell == NODATA)
         return false;
 
+    WaterTable waterTable;
+    if (! waterTableLoadWellMeteoData(indexWell, waterTable))
+        return false;
+
+    waterTable.computeWaterTableParameters(wellPoints[indexWell], 5);
+
+    waterTable.computeWaterTableSeries();        // prepare series to show
+
+    waterTableList.push_back(waterTable);
+    return true;
+}
+
+
+// load the meteo series of the nearest meteo point (or grid cell) of the well
+bool Project::waterTableLoadWellMeteoData(int indexWell, WaterTable &waterTable)
+{
     // sono necessari 24 mesi di dati meteo precedenti il primo dato osservato di falda
     wellPoints[indexWell].updateDates();
     QDate firstMeteoDate = wellPoints[indexWell].getFirstObsDate().addDays(-730);
@@ -6004,6 +6358,9 @@ bool Project::waterTableComputeSingleWell(int indexWell)
     std::vector<float> inputTMin;
     std::vector<float> inputTMax;
     std::vector<float> inputPrec;
+    inputTMin.reserve(linkedMeteoPoint.nrObsDataDaysD);
+    inputTMax.reserve(linkedMeteoPoint.nrObsDataDaysD);
+    inputPrec.reserve(linkedMeteoPoint.nrObsDataDaysD);
 
     for (int i = 0; i < linkedMeteoPoint.nrObsDataDaysD; i++)
     {
@@ -6016,14 +6373,70 @@ bool Project::waterTableComputeSingleWell(int indexWell)
         inputPrec.push_back(prec);
     }
 
-    WaterTable waterTable(inputTMin, inputTMax, inputPrec, getQDate(linkedMeteoPoint.getFirstDailyData()),
-                          getQDate(linkedMeteoPoint.getLastDailyData()), *meteoSettings);
+    waterTable = WaterTable(inputTMin, inputTMax, inputPrec, getQDate(linkedMeteoPoint.getFirstDailyData()),
+                            getQDate(linkedMeteoPoint.getLastDailyData()), *meteoSettings);
+    return true;
+}
 
-    waterTable.computeWaterTableParameters(wellPoints[indexWell], 5);
 
-    waterTable.computeWaterTableSeries();        // prepare series to show
+// calibration of all wells
+// meteo data are loaded serially (db access), then wells are computed in parallel
+// computedWellIndex: index in wellPoints of each element of waterTableList
+bool Project::waterTableComputeAllWells(std::vector<int> &computedWellIndex)
+{
+    waterTableList.clear();
+    computedWellIndex.clear();
+
+    int nrWells = int(wellPoints.size());
+    std::vector<WaterTable> wellWaterTables;
+    wellWaterTables.reserve(nrWells);
+
+    setProgressBar("Load meteo data of wells...", nrWells);
+    for (int i = 0; i < nrWells; i++)
+    {
+        QString idStr = wellPoints[i].getId();
+        if (wellPoints[i].getObsDepthNr() == 0)
+        {
+            logInfo("The well " + idStr + " has not data. Import data before.");
+            continue;
+        }
+
+        WaterTable waterTable;
+        if (! waterTableLoadWellMeteoData(i, waterTable))
+        {
+            logInfo("Error in computing well: " + idStr);
+            continue;
+        }
+
+        wellWaterTables.push_back(waterTable);
+        computedWellIndex.push_back(i);
+        updateProgressBar(i);
+    }
+    closeProgressBar();
+
+    int nrComputedWells = int(wellWaterTables.size());
+    if (nrComputedWells == 0)
+    {
+        errorString = "No well computed.";
+        return false;
+    }
+
+    logInfoGUI("Computing " + QString::number(nrComputedWells) + " wells...");
+
+    #pragma omp parallel for schedule(dynamic) if(_isParallelComputing)
+    for (int i = 0; i < nrComputedWells; i++)
+    {
+        wellWaterTables[i].computeWaterTableParameters(wellPoints[computedWellIndex[i]], 5);
+        wellWaterTables[i].computeWaterTableSeries();
+    }
+
+    closeLogInfo();
+
+    for (int i = 0; i < nrComputedWells; i++)
+    {
+        waterTableList.push_back(wellWaterTables[i]);
+    }
 
-    waterTableList.push_back(waterTable);
     return true;
 }
 
@@ -6218,7 +6631,7 @@ bool Project::assignAltitudeToAggregationPoints()
     // resample aggregation DEM
     gis::Crit3DRasterGrid *aggregationDEM;
     aggregationDEM = new(gis::Crit3DRasterGrid);
-    gis::resampleGrid(DEM, aggregationDEM, aggregationRaster->header, aggrAverage, 0.1f);
+    gis::resampleGrid(DEM, aggregationDEM, aggregationRaster->header, aggrAverage, 0.1f, _isParallelComputing);
 
     setProgressBar("Compute altitude..", (int)meteoPoints.size());
 
@@ -90,7 +90,21 @@
 
         FormInfo* _formLog;
 
+        // spatial quality flags of the last loaded period
+        meteoVariable _spatialFlagsVariable;
+        QString _spatialFlagsKey;
+        int _spatialFlagsVersion;
+        QDate _spatialFlagsFirstDate;
+        QDate _spatialFlagsLastDate;
+        QMap<QString, QMap<QString, int>> _spatialFlags;
+
+        // settings keys of the spatial quality control, computed once for each run over a period
+        int _spatialQualityRunDepth;
+        std::map<meteoVariable, QString> _spatialQualityRunKeys;
+
         void clearMeteoPoints();
+        void clearSpatialFlagsCache();
+        QString getSpatialQualitySettingsKey(meteoVariable myVar);
         bool createDefaultProject(const QString &fileName);
         bool searchDefaultPath(QString &defaultPath);
 
@@ -260,6 +274,8 @@
         bool loadDEM(const QString & fileName);
         void closeDEM();
         bool loadMeteoPointsData(const QDate &firstDate, const QDate &lastDate, bool loadHourly, bool loadDaily, bool showInfo);
+        bool loadMeteoPointsData(std::vector<Crit3DMeteoPoint> &points, const QDate &firstDate, const QDate &lastDate,
+                                 bool loadHourly, bool loadDaily, bool showInfo);
         bool loadMeteoPointsData_singleDataset(const QDate &firstDate, const QDate &lastDate, bool loadHourly, bool loadDaily, const QString &dataset, bool showInfo);
         bool loadMeteoPointsDB(QString dbName);
         bool loadMeteoGridDB(QString xmlName);
@@ -309,6 +325,11 @@
         bool interpolationOutputPoints(std::vector <Crit3DInterpolationDataPoint> &interpolationPoints,
                                        gis::Crit3DRasterGrid *outputGrid, meteoVariable myVar);
         bool interpolationCv(meteoVariable myVar, const Crit3DTime& myTime);
+        bool computeSpatialQualityFlags(meteoVariable myVar, const QDate &firstDate, const QDate &lastDate);
+        std::vector<int> getStoredSpatialFlags(meteoVariable myVar, const Crit3DTime& myTime, const QString &settingsKey);
+        QString getSpatialQualityRunKey(meteoVariable myVar);
+        void beginSpatialQualityRun();
+        void endSpatialQualityRun();
         bool computeResidualsAndStatisticsGlocalDetrending(meteoVariable myVar, std::vector<Crit3DInterpolationDataPoint> &interpolationPoints);
 
         bool computeStatisticsCrossValidation();
@@ -358,6 +379,8 @@
         bool waterTableImportLocation(const QString &csvFileName);
         bool waterTableImportDepths(const QString &csvDepthsFileName);
         bool waterTableComputeSingleWell(int indexWell);
+        bool waterTableLoadWellMeteoData(int indexWell, WaterTable &waterTable);
+        bool waterTableComputeAllWells(std::vector<int> &computedWellIndex);
         void waterTableShowSingleWell(const WaterTable &waterTable, const QString &idWell);
 
         bool waterTableAssignNearestMeteoPoint(bool isMeteoGrid, double wellUtmX, double wellUtmY,
@@ -386,4 +409,16 @@
     };
 
 
+    // scope of a run over a period: the spatial quality settings keys are computed once
+    class Crit3DSpatialQualityRun
+    {
+    public:
+        explicit Crit3DSpatialQualityRun(Project* project) : _project(project) { _project->beginSpatialQualityRun(); }
+        ~Crit3DSpatialQualityRun() { _project->endSpatialQualityRun(); }
+
+    private:
+        Project* _project;
+    };
+
+
 #endif // PROJECT_H
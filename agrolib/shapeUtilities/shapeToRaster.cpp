@@ -1,11 +1,248 @@
 #include <float.h>
 #include <math.h>
+#include <algorithm>
 
 #include "shapeToRaster.h"
 #include "commonConstants.h"
 #include "gis.h"
 #include "basicMath.h"
 
+#define SCANLINE_BAND_ROWS 64
+
+
+/* ----------------------------------------------------------------------
+ * Scanline rasterization
+ * Each polygon part is filled with an edge table: every edge is crossed
+ * only by the rows whose cell center lies in its y range.
+ * The inside test is the same of ShapeObject::pointInPolygon
+ * (even-odd rule on each part, holes first, center of cell),
+ * so the filled cells are the same of the point-in-polygon scan.
+ * ---------------------------------------------------------------------- */
+
+// first col in [c0, c1] whose cell center satisfies isActive (monotone in x), c1+1 if none
+template <class Predicate>
+static int firstActiveCol(const gis::Crit3DRasterGrid &raster, double xValue, int c0, int c1, Predicate isActive)
+{
+    double x, y;
+    int col = int(floor((xValue - raster.header->llCorner.x) * raster.header->invCellSize - 0.5));
+    col = std::min(std::max(col, c0), c1 + 1);
+
+    while (col > c0)
+    {
+        raster.getXY(0, col-1, x, y);
+        if (! isActive(x)) break;
+        col--;
+    }
+    while (col <= c1)
+    {
+        raster.getXY(0, col, x, y);
+        if (isActive(x)) break;
+        col++;
+    }
+
+    return col;
+}
+
+
+// first row in [r0, r1] whose cell center has y <= yValue (or y < yValue), r1+1 if none
+static int firstRowBelow(const gis::Crit3DRasterGrid &raster, double yValue, bool isStrict, int r0, int r1)
+{
+    double x, y;
+    auto isActive = [&](int row) {
+        raster.getXY(row, 0, x, y);
+        return isStrict ? (y < yValue) : (y <= yValue);
+    };
+
+    int row = raster.header->nrRows - int(floor((yValue - raster.header->llCorner.y) * raster.header->invCellSize + 0.5));
+    row = std::min(std::max(row, r0), r1 + 1);
+
+    while (row > r0 && isActive(row-1))
+        row--;
+    while (row <= r1 && ! isActive(row))
+        row++;
+
+    return row;
+}
+
+
+// col intervals (first, last) of the shape on each row of [r0, r1], limited to [c0, c1]
+static void getShapeRowSpans(const ShapeObject &object, const gis::Crit3DRasterGrid &raster, int r0, int r1, int c0, int c1,
+                             std::vector<std::vector<std::pair<int, int>>> &outerSpans,
+                             std::vector<std::vector<std::pair<int, int>>> &holeSpans)
+{
+    size_t nrRows = size_t(std::max(r1 - r0 + 1, 0));
+    outerSpans.assign(nrRows, std::vector<std::pair<int, int>>());
+    holeSpans.assign(nrRows, std::vector<std::pair<int, int>>());
+    if (nrRows == 0 || c1 < c0)
+        return;
+
+    const Point<double>* vertices = object.getVertices();
+    const Box<double> bounds = object.getBounds();
+    const std::vector<ShapeObject::Part> parts = object.getParts();
+
+    std::vector<std::vector<int>> rowCrossings(nrRows);
+    double x, y;
+
+    for (const ShapeObject::Part &part : parts)
+    {
+        if (part.length == 0)
+            continue;
+
+        // part bounding box (inclusive)
+        double xMin = std::max(part.boundsPart.xmin, bounds.xmin);
+        double xMax = std::min(part.boundsPart.xmax, bounds.xmax);
+        double yMin = std::max(part.boundsPart.ymin, bounds.ymin);
+        double yMax = std::min(part.boundsPart.ymax, bounds.ymax);
+
+        int pc0 = firstActiveCol(raster, xMin, c0, c1, [&](double xc) { return xc >= xMin; });
+        int pc1 = firstActiveCol(raster, xMax, c0, c1, [&](double xc) { return xc > xMax; }) - 1;
+        int pr0 = firstRowBelow(raster, yMax, false, r0, r1);
+        int pr1 = firstRowBelow(raster, yMin, true, r0, r1) - 1;
+        if (pc1 < pc0 || pr1 < pr0)
+            continue;
+
+        for (int row = pr0; row <= pr1; row++)
+            rowCrossings[size_t(row - r0)].clear();
+
+        // edge table: each edge (i, j) on the rows with min(yi, yj) < y <= max(yi, yj)
+        unsigned long last = part.offset + part.length - 1;
+        unsigned long j = last;
+        for (unsigned long i = part.offset; i <= last; i++)
+        {
+            const Point<double> &vi = vertices[i];
+            const Point<double> &vj = vertices[j];
+            j = i;
+
+            if (vi.y == vj.y)
+                continue;
+
+            double edgeYMin = std::min(vi.y, vj.y);
+            double edgeYMax = std::max(vi.y, vj.y);
+            double edgeXMin = std::min(vi.x, vj.x);
+
+            int er0 = std::max(firstRowBelow(raster, edgeYMax, false, pr0, pr1), pr0);
+            int er1 = std::min(firstRowBelow(raster, edgeYMin, false, pr0, pr1) - 1, pr1);
+
+            for (int row = er0; row <= er1; row++)
+            {
+                raster.getXY(row, 0, x, y);
+                double xCross = vi.x + (y - vi.y) / (vj.y - vi.y) * (vj.x - vi.x);
+
+                // the edge is counted for the cells with x >= min(xi, xj) and x > xCross
+                int col = firstActiveCol(raster, std::max(xCross, edgeXMin), pc0, pc1,
+                                         [&](double xc) { return xc >= edgeXMin && xCross < xc; });
+                rowCrossings[size_t(row - r0)].push_back(col);
+            }
+        }
+
+        // even-odd rule: the cell is inside when an odd number of crossings is active
+        for (int row = pr0; row <= pr1; row++)
+        {
+            std::vector<int> &crossings = rowCrossings[size_t(row - r0)];
+            std::sort(crossings.begin(), crossings.end());
+
+            std::vector<std::pair<int, int>> &spans = part.hole ? holeSpans[size_t(row - r0)] : outerSpans[size_t(row - r0)];
+            for (size_t k = 0; k < crossings.size(); k += 2)
+            {
+                int first = crossings[k];
+                int lastCol = (k + 1 < crossings.size()) ? crossings[k+1] - 1 : pc1;
+                if (first <= lastCol)
+                    spans.push_back(std::make_pair(first, lastCol));
+            }
+        }
+    }
+}
+
+
+// calls cellFunction(row, col) for each cell of [r0, r1] x [c0, c1] with the center inside the shape
+template <class CellFunction>
+static void forEachCellInShape(const ShapeObject &object, const gis::Crit3DRasterGrid &raster,
+                               int r0, int r1, int c0, int c1, CellFunction cellFunction)
+{
+    std::vector<std::vector<std::pair<int, int>>> outerSpans, holeSpans;
+    getShapeRowSpans(object, raster, r0, r1, c0, c1, outerSpans, holeSpans);
+
+    std::vector<char> isInside(size_t(std::max(c1 - c0 + 1, 0)));
+    for (int row = r0; row <= r1; row++)
+    {
+        const auto &outer = outerSpans[size_t(row - r0)];
+        if (outer.empty())
+            continue;
+
+        std::fill(isInside.begin(), isInside.end(), 0);
+        for (const auto &span : outer)
+            std::fill(isInside.begin() + (span.first - c0), isInside.begin() + (span.second - c0 + 1), 1);
+        for (const auto &span : holeSpans[size_t(row - r0)])
+            std::fill(isInside.begin() + (span.first - c0), isInside.begin() + (span.second - c0 + 1), 0);
+
+        for (int col = c0; col <= c1; col++)
+        {
+            if (isInside[size_t(col - c0)])
+                cellFunction(row, col);
+        }
+    }
+}
+
+
+// rasterizes the shapes in index order on row bands, in parallel:
+// each band is written by one thread, so the result does not depend on the threads
+template <class CellFunction>
+static void rasterizeShapeObjects(const std::vector<ShapeObject> &objects, const std::vector<bool> &isSelected,
+                                  const gis::Crit3DRasterGrid &raster, bool isParallelComputing, CellFunction cellFunction)
+{
+    int nrShapes = int(objects.size());
+
+    // bounds of each shape
+    std::vector<int> r0(nrShapes), r1(nrShapes), c0(nrShapes), c1(nrShapes);
+    for (int shapeIndex = 0; shapeIndex < nrShapes; shapeIndex++)
+    {
+        Box<double> bounds = objects[shapeIndex].getBounds();
+        gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0[shapeIndex], &c0[shapeIndex]);
+        gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1[shapeIndex], &c1[shapeIndex]);
+
+        // check bounds
+        r0[shapeIndex] = MAXVALUE(r0[shapeIndex]-1, 0);
+        r1[shapeIndex] = MINVALUE(r1[shapeIndex]+1, raster.header->nrRows -1);
+        c0[shapeIndex] = MAXVALUE(c0[shapeIndex]-1, 0);
+        c1[shapeIndex] = MINVALUE(c1[shapeIndex]+1, raster.header->nrCols -1);
+    }
+
+    int nrBands = (raster.header->nrRows + SCANLINE_BAND_ROWS - 1) / SCANLINE_BAND_ROWS;
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int band = 0; band < nrBands; band++)
+    {
+        int bandFirstRow = band * SCANLINE_BAND_ROWS;
+        int bandLastRow = std::min(bandFirstRow + SCANLINE_BAND_ROWS, raster.header->nrRows) - 1;
+
+        for (int shapeIndex = 0; shapeIndex < nrShapes; shapeIndex++)
+        {
+            if (! isSelected[size_t(shapeIndex)])
+                continue;
+
+            int firstRow = std::max(r0[shapeIndex], bandFirstRow);
+            int lastRow = std::min(r1[shapeIndex], bandLastRow);
+            if (firstRow > lastRow)
+                continue;
+
+            forEachCellInShape(objects[shapeIndex], raster, firstRow, lastRow, c0[shapeIndex], c1[shapeIndex],
+                               [&](int row, int col) { cellFunction(shapeIndex, row, col); });
+        }
+    }
+}
+
+
+static void loadShapeObjects(const Crit3DShapeHandler &shapeHandler, std::vector<ShapeObject> &objects)
+{
+    int nrShapes = shapeHandler.getShapeCount();
+    objects.resize(size_t(std::max(nrShapes, 0)));
+    for (int shapeIndex = 0; shapeIndex < nrShapes; shapeIndex++)
+    {
+        shapeHandler.getShape(shapeIndex, objects[size_t(shapeIndex)]);
+    }
+}
+
+
 
 bool initializeRasterFromShape(const Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &raster, double cellSize)
 {
@@ -49,7 +286,7 @@ bool initializeRasterFromShape(const Crit3DShapeHandler &shapeHandler, gis::Crit
 }
 
 
-bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, const Crit3DShapeHandler &shapeHandler)
+bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, const Crit3DShapeHandler &shapeHandler, bool isParallelComputing)
 {
     int nrShapes = shapeHandler.getShapeCount();
     if (nrShapes <= 0)
@@ -58,49 +295,27 @@ bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, const Crit3DShapeH
         return false;
     }
 
-    ShapeObject object;
-    double x, y;
-    Box<double> bounds;
-    int r0, r1, c0, c1;
+    std::vector<ShapeObject> objects;
+    loadShapeObjects(shapeHandler, objects);
+    std::vector<bool> isSelected(nrShapes, true);
 
     raster.emptyGrid();
 
-    for (int shapeIndex = 0; shapeIndex < nrShapes; shapeIndex++)
+    // the first shape containing the cell wins
+    rasterizeShapeObjects(objects, isSelected, raster, isParallelComputing, [&](int shapeIndex, int row, int col)
     {
-        shapeHandler.getShape(shapeIndex, object);
-
-        // get bounds
-        bounds = object.getBounds();
-        gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0, &c0);
-        gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1, &c1);
-
-        // check bounds
-        r0 = MAXVALUE(r0-1, 0);
-        r1 = MINVALUE(r1+1, raster.header->nrRows -1);
-        c0 = MAXVALUE(c0-1, 0);
-        c1 = MINVALUE(c1+1, raster.header->nrCols -1);
-
-        for (int row = r0; row <= r1; row++)
+        if (isEqual(raster.value[row][col], raster.header->flag))
         {
-            for (int col = c0; col <= c1; col++)
-            {
-                if (isEqual(raster.value[row][col], raster.header->flag))
-                {
-                    raster.getXY(row, col, x, y);
-                    if (object.pointInPolygon(x, y))
-                    {
-                        raster.value[row][col] = float(shapeIndex);
-                    }
-                }
-            }
+            raster.value[row][col] = float(shapeIndex);
         }
-    }
+    });
 
     return true;
 }
 
 
-bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, const std::string &fieldName)
+bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, const std::string &fieldName,
+                         bool isParallelComputing)
 {
     int nrShape = shapeHandler.getShapeCount();
     if (nrShape <= 0)
@@ -109,67 +324,45 @@ bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shap
         return false;
     }
 
-    ShapeObject object;
-    double x, y, fieldValue;
-    Box<double> bounds;
-    int r0, r1, c0, c1;
-
     int fieldIndex = shapeHandler.getDBFFieldIndex(fieldName.c_str());
 
+    std::vector<ShapeObject> objects;
+    loadShapeObjects(shapeHandler, objects);
+
+    std::vector<double> fieldValues(nrShape);
+    std::vector<bool> isSelected(nrShape);
     for (int shapeIndex = 0; shapeIndex < nrShape; shapeIndex++)
     {
-        shapeHandler.getShape(shapeIndex, object);
-
-        fieldValue = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
+        fieldValues[size_t(shapeIndex)] = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
+        isSelected[size_t(shapeIndex)] = ! isEqual(fieldValues[size_t(shapeIndex)], NODATA);
+    }
 
-        if (! isEqual(fieldValue, NODATA))
+    rasterizeShapeObjects(objects, isSelected, raster, isParallelComputing, [&](int shapeIndex, int row, int col)
+    {
+        if (isEqual(raster.value[row][col], raster.header->flag))
         {
-            // get bounds
-            bounds = object.getBounds();
-            gis::getRowColFromXY(*(raster.header), bounds.xmin, bounds.ymax, &r0, &c0);
-            gis::getRowColFromXY(*(raster.header), bounds.xmax, bounds.ymin, &r1, &c1);
-
-            // check bounds
-            r0 = MAXVALUE(r0-1, 0);
-            r1 = MINVALUE(r1+1, raster.header->nrRows -1);
-            c0 = MAXVALUE(c0-1, 0);
-            c1 = MINVALUE(c1+1, raster.header->nrCols -1);
-
-            for (int row = r0; row <= r1; row++)
-            {
-                for (int col = c0; col <= c1; col++)
-                {
-                    if (isEqual(raster.value[row][col], raster.header->flag))
-                    {
-                        raster.getXY(row, col, x, y);
-                        if (object.pointInPolygon(x, y))
-                        {
-                            raster.value[row][col] = float(fieldValue);
-                        }
-                    }
-                }
-            }
+            raster.value[row][col] = float(fieldValues[size_t(shapeIndex)]);
         }
-    }
+    });
 
     return true;
 }
 
 
 bool rasterizeShape(Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &newRaster,
-                    const std::string &field, double cellSize)
+                    const std::string &field, double cellSize, bool isParallelComputing)
 {
     if (! initializeRasterFromShape(shapeHandler, newRaster, cellSize))
         return false;
 
     if (field == "Shape ID")
     {
-        if (! fillRasterWithShapeNumber(newRaster, shapeHandler))
+        if (! fillRasterWithShapeNumber(newRaster, shapeHandler, isParallelComputing))
             return false;
     }
     else
     {
-        if (! fillRasterWithField(newRaster, shapeHandler, field))
+        if (! fillRasterWithField(newRaster, shapeHandler, field, isParallelComputing))
             return false;
     }
 
@@ -178,7 +371,7 @@ bool rasterizeShape(Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &new
 
 
 bool rasterizeShapeWithRef(const gis::Crit3DRasterGrid &refRaster, gis::Crit3DRasterGrid &newRaster,
-                             Crit3DShapeHandler &shapeHandler, const std::string &fieldName)
+                             Crit3DShapeHandler &shapeHandler, const std::string &fieldName, bool isParallelComputing)
 {
     newRaster.initializeGrid(*(refRaster.header));
 
@@ -195,53 +388,32 @@ bool rasterizeShapeWithRef(const gis::Crit3DRasterGrid &refRaster, gis::Crit3DRa
         fieldIndex = shapeHandler.getDBFFieldIndex(fieldName.c_str());
     }
 
-    ShapeObject object;
-    double x, y, fieldValue;
-    Box<double> bounds;
-    int r0, r1, c0, c1;
+    std::vector<ShapeObject> objects;
+    loadShapeObjects(shapeHandler, objects);
 
+    std::vector<double> fieldValues(nrShape);
+    std::vector<bool> isSelected(nrShape);
     for (int shapeIndex = 0; shapeIndex < nrShape; shapeIndex++)
     {
-        shapeHandler.getShape(shapeIndex, object);
-
         if (fieldName == "Shape ID")
         {
-            fieldValue = shapeIndex;
+            fieldValues[size_t(shapeIndex)] = shapeIndex;
         }
         else
         {
-            fieldValue = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
+            fieldValues[size_t(shapeIndex)] = shapeHandler.getNumericValue(shapeIndex, fieldIndex);
         }
+        isSelected[size_t(shapeIndex)] = ! isEqual(fieldValues[size_t(shapeIndex)], NODATA);
+    }
 
-        if (! isEqual(fieldValue, NODATA))
+    // the last shape containing the cell wins
+    rasterizeShapeObjects(objects, isSelected, newRaster, isParallelComputing, [&](int shapeIndex, int row, int col)
+    {
+        if (! isEqual(refRaster.value[row][col], refRaster.header->flag))
         {
-            // get bounds
-            bounds = object.getBounds();
-            gis::getRowColFromXY(*(newRaster.header), bounds.xmin, bounds.ymax, &r0, &c0);
-            gis::getRowColFromXY(*(newRaster.header), bounds.xmax, bounds.ymin, &r1, &c1);
-
-            // check bounds
-            r0 = MAXVALUE(r0-1, 0);
-            r1 = MINVALUE(r1+1, newRaster.header->nrRows -1);
-            c0 = MAXVALUE(c0-1, 0);
-            c1 = MINVALUE(c1+1, newRaster.header->nrCols -1);
-
-            for (int row = r0; row <= r1; row++)
-            {
-                for (int col = c0; col <= c1; col++)
-                {
-                    if (! isEqual(refRaster.value[row][col], refRaster.header->flag))
-                    {
-                        newRaster.getXY(row, col, x, y);
-                        if (object.pointInPolygon(x, y))
-                        {
-                            newRaster.value[row][col] = float(fieldValue);
-                        }
-                    }
-                }
-            }
+            newRaster.value[row][col] = float(fieldValues[size_t(shapeIndex)]);
         }
-    }
+    });
 
     return true;
 }
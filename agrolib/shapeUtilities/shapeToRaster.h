@@ -10,14 +10,16 @@
 
     bool initializeRasterFromShape(const Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &raster, double cellSize);
 
-    bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, const Crit3DShapeHandler &shapeHandler);
+    bool fillRasterWithShapeNumber(gis::Crit3DRasterGrid &raster, const Crit3DShapeHandler &shapeHandler, bool isParallelComputing);
 
-    bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, const std::string &valField);
+    bool fillRasterWithField(gis::Crit3DRasterGrid &raster, Crit3DShapeHandler &shapeHandler, const std::string &valField,
+                             bool isParallelComputing);
 
-    bool rasterizeShape(Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &newRaster, const std::string &field, double cellSize);
+    bool rasterizeShape(Crit3DShapeHandler &shapeHandler, gis::Crit3DRasterGrid &newRaster, const std::string &field,
+                        double cellSize, bool isParallelComputing);
 
     bool rasterizeShapeWithRef(const gis::Crit3DRasterGrid &refRaster, gis::Crit3DRasterGrid &newRaster,
-                               Crit3DShapeHandler &shapeHandler, const std::string &fieldName);
+                               Crit3DShapeHandler &shapeHandler, const std::string &fieldName, bool isParallelComputing);
 
 
 #endif // SHAPETORASTER_H
@@ -25,6 +25,9 @@ CONFIG += c++11 c++14 c++17
 
 DEFINES += _CRT_SECURE_NO_WARNINGS
 
+# parallel computing settings
+include($$absolute_path(../parallel.pri))
+
 INCLUDEPATH =  ../crit3dDate ../mathFunctions ../gis ../shapeHandler  ../utilities
 
 SOURCES += \
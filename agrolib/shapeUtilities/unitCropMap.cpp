@@ -33,15 +33,19 @@ bool computeUcmPrevailing(Crit3DShapeHandler &shapeUCM, Crit3DShapeHandler &shap
 
     // CROP (reference shape)
     //if (showInfo) formInfo.start("[1/8] Rasterize crop (reference)...", 0);
-    fillRasterWithShapeNumber(rasterRef, shapeUCM);
+    fillRasterWithShapeNumber(rasterRef, shapeUCM, true);
+
+    // zone index of the reference shape, used for both the analysis
+    Crit3DZoneIndex refIndex;
+    refIndex.build(rasterRef, shapeUCM.getShapeCount());
 
     // meteo grid
     //if (showInfo) formInfo.setText("[2/8] Rasterize meteo grid...");
-    fillRasterWithShapeNumber(rasterVal, shapeMeteo);
+    fillRasterWithShapeNumber(rasterVal, shapeMeteo, true);
 
     //if (showInfo) formInfo.setText("[3/8] Compute matrix crop/meteo...");
     std::vector <int> vectorNull;
-    std::vector <std::vector<int> > matrix = computeMatrixAnalysis(shapeUCM, shapeMeteo, rasterRef, rasterVal, vectorNull);
+    std::vector <std::vector<int> > matrix = computeMatrixAnalysis(refIndex, shapeMeteo, rasterVal, vectorNull, true);
 
     //if (showInfo) formInfo.setText("[4/8] Zonal statistic crop/meteo...");
     bool isOk = zonalStatisticsShapeMajority(shapeUCM, shapeMeteo, matrix, vectorNull, idMeteo, "ID_METEO", threshold, errorStr);
@@ -50,10 +54,10 @@ bool computeUcmPrevailing(Crit3DShapeHandler &shapeUCM, Crit3DShapeHandler &shap
     if (isOk)
     {
         //if (showInfo) formInfo.setText("[5/8] Rasterize soil...");
-        fillRasterWithShapeNumber(rasterVal, shapeSoil);
+        fillRasterWithShapeNumber(rasterVal, shapeSoil, true);
 
         //if (showInfo) formInfo.setText("[6/8] Compute matrix crop/soil...");
-        matrix = computeMatrixAnalysis(shapeUCM, shapeSoil, rasterRef, rasterVal, vectorNull);
+        matrix = computeMatrixAnalysis(refIndex, shapeSoil, rasterVal, vectorNull, true);
 
         //if (showInfo) formInfo.setText("[7/8] Zonal statistic crop/soil...");
         isOk = zonalStatisticsShapeMajority(shapeUCM, shapeSoil, matrix, vectorNull, idSoil, "ID_SOIL", threshold, errorStr);
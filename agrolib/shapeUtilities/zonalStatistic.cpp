@@ -11,45 +11,114 @@
 #include "shapeHandler.h"
 
 
-std::vector <std::vector<int>> computeMatrixAnalysis(Crit3DShapeHandler &shapeRef, Crit3DShapeHandler &shapeVal,
-                          gis::Crit3DRasterGrid &rasterRef, gis::Crit3DRasterGrid &rasterVal, std::vector<int> &vectorNull)
+Crit3DZoneIndex::Crit3DZoneIndex()
 {
-    unsigned int nrRefShapes = unsigned(shapeRef.getShapeCount());
-    unsigned int nrValShapes = unsigned(shapeVal.getShapeCount());
+    clear();
+}
+
+
+void Crit3DZoneIndex::clear()
+{
+    _zoneStart.assign(1, 0);
+    _cellIndex.clear();
+}
+
+
+/*!
+ * \brief build the index from the zone raster: the zone of each cell is int(value) in [0, nrZones)
+ * the cells of each zone are stored in raster order
+ */
+bool Crit3DZoneIndex::build(const gis::Crit3DRasterGrid &zoneRaster, int nrZones)
+{
+    clear();
+    if (nrZones <= 0 || zoneRaster.header == nullptr)
+        return false;
+
+    _header = *(zoneRaster.header);
+
+    const long nrCells = zoneRaster.nrCells();
+    const float* zoneValues = zoneRaster.data();
+    const int flag = int(zoneRaster.header->flag);
+
+    // count the cells of each zone
+    _zoneStart.assign(size_t(nrZones) + 1, 0);
+    for (long i = 0; i < nrCells; i++)
+    {
+        int zone = int(zoneValues[i]);
+        if (zone != flag && zone >= 0 && zone < nrZones)
+            _zoneStart[size_t(zone) + 1]++;
+    }
+
+    for (int zone = 0; zone < nrZones; zone++)
+        _zoneStart[size_t(zone) + 1] += _zoneStart[size_t(zone)];
+
+    // fill
+    _cellIndex.resize(size_t(_zoneStart[size_t(nrZones)]));
+    std::vector<long> position(_zoneStart.begin(), _zoneStart.end() - 1);
+    for (long i = 0; i < nrCells; i++)
+    {
+        int zone = int(zoneValues[i]);
+        if (zone != flag && zone >= 0 && zone < nrZones)
+            _cellIndex[size_t(position[size_t(zone)]++)] = i;
+    }
+
+    return true;
+}
+
+
+std::vector <std::vector<int>> computeMatrixAnalysis(const Crit3DZoneIndex &refIndex, const Crit3DShapeHandler &shapeVal,
+                                                     const gis::Crit3DRasterGrid &rasterVal, std::vector<int> &vectorNull,
+                                                     bool isParallelComputing)
+{
+    int nrRefShapes = refIndex.nrZones();
+    int nrValShapes = shapeVal.getShapeCount();
 
     // analysis matrix
     vectorNull.clear();
-    vectorNull.resize(nrRefShapes, 0);
-    std::vector <std::vector<int>> matrix(nrRefShapes, std::vector<int>(nrValShapes, 0));
+    vectorNull.resize(unsigned(nrRefShapes), 0);
+    std::vector <std::vector<int>> matrix(unsigned(nrRefShapes), std::vector<int>(unsigned(nrValShapes), 0));
 
-    double x, y;
-    int rowVal, colVal;
-    int flagRef = int(rasterRef.header->flag);
+    const gis::Crit3DRasterHeader &refHeader = refIndex.header();
+    const bool isSameGeometry = refIndex.isSameGeometry(*(rasterVal.header));
+    const float* values = rasterVal.data();
     int flagVal = int(rasterVal.header->flag);
-    for (int row = 0; row < rasterRef.header->nrRows; row++)
+
+    // each zone writes only its row of the matrix
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int refIndexZone = 0; refIndexZone < nrRefShapes; refIndexZone++)
     {
-        for (int col = 0; col < rasterRef.header->nrCols; col++)
+        std::vector<int> &matrixRow = matrix[unsigned(refIndexZone)];
+        const long* cells = refIndex.zoneCells(refIndexZone);
+        const long nrCells = refIndex.nrZoneCells(refIndexZone);
+
+        for (long i = 0; i < nrCells; i++)
         {
-            int refIndex = int(rasterRef.value[row][col]);
-            if (refIndex != flagRef && refIndex >= 0 && refIndex < signed(nrRefShapes))
+            int valIndex;
+            if (isSameGeometry)
             {
-                rasterRef.getXY(row, col, x, y);
+                valIndex = int(values[cells[i]]);
+            }
+            else
+            {
+                int row = int(cells[i] / refHeader.nrCols);
+                int col = int(cells[i] % refHeader.nrCols);
+                double x = refHeader.llCorner.x + refHeader.cellSize * (double(col) + 0.5);
+                double y = refHeader.llCorner.y + refHeader.cellSize * (double(refHeader.nrRows - row) - 0.5);
                 if (gis::isOutOfGridXY(x, y, rasterVal.header))
                 {
-                    vectorNull[unsigned(refIndex)]++;
+                    vectorNull[unsigned(refIndexZone)]++;
                     continue;
                 }
 
+                int rowVal, colVal;
                 gis::getRowColFromXY(*(rasterVal.header), x, y, rowVal, colVal);
-
-                int valIndex = int(rasterVal.value[rowVal][colVal]);
-                if (valIndex != flagVal && valIndex >= 0 && valIndex < signed(nrValShapes))
-                {
-                    matrix[unsigned(refIndex)][unsigned(valIndex)]++;
-                }
-                else
-                    vectorNull[unsigned(refIndex)]++;
+                valIndex = int(rasterVal.value[rowVal][colVal]);
             }
+
+            if (valIndex != flagVal && valIndex >= 0 && valIndex < nrValShapes)
+                matrixRow[unsigned(valIndex)]++;
+            else
+                vectorNull[unsigned(refIndexZone)]++;
         }
     }
 
@@ -58,7 +127,8 @@ std::vector <std::vector<int>> computeMatrixAnalysis(Crit3DShapeHandler &shapeRe
 
 
 std::vector <std::vector<int>> computeMatrixAnalysisRaster(const Crit3DShapeHandler &shapeRef, const gis::Crit3DRasterGrid &rasterVal,
-                                                           std::vector<int> &categories, std::vector<int> &vectorNull)
+                                                           std::vector<int> &categories, std::vector<int> &vectorNull,
+                                                           bool isParallelComputing)
 {
     unsigned int nrRefShapes = unsigned(shapeRef.getShapeCount());
 
@@ -76,39 +146,44 @@ std::vector <std::vector<int>> computeMatrixAnalysisRaster(const Crit3DShapeHand
     // create reference raster from shapefile (same header of rasterVal)
     gis::Crit3DRasterGrid rasterRef;
     rasterRef.initializeGrid(*(rasterVal.header));
-    fillRasterWithShapeNumber(rasterRef, shapeRef);
+    fillRasterWithShapeNumber(rasterRef, shapeRef, isParallelComputing);
+
+    Crit3DZoneIndex refIndex;
+    refIndex.build(rasterRef, signed(nrRefShapes));
+    rasterRef.clear();
 
     // analysis matrix
     vectorNull.clear();
     vectorNull.resize(nrRefShapes, 0);
     std::vector <std::vector<int>> matrix(nrRefShapes, std::vector<int>(nrCategories, 0));
 
-    int flagInt = int(rasterRef.header->flag);
-    for (int row = 0; row < rasterRef.header->nrRows; row++)
+    const float* values = rasterVal.data();
+    int flagInt = int(rasterVal.header->flag);
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int refZone = 0; refZone < refIndex.nrZones(); refZone++)
     {
-        for (int col = 0; col < rasterRef.header->nrCols; col++)
+        const long* cells = refIndex.zoneCells(refZone);
+        const long nrCells = refIndex.nrZoneCells(refZone);
+
+        for (long i = 0; i < nrCells; i++)
         {
-            int refIndex = int(rasterRef.value[row][col]);
-            if (refIndex != flagInt && refIndex >= 0 && refIndex < static_cast<int>(nrRefShapes))
+            int valueInt = int(values[cells[i]]);
+            if (valueInt == flagInt)
             {
-                int valueInt = int(rasterVal.value[row][col]);
-                if (valueInt == flagInt)
-                {
-                    vectorNull[refIndex]++;
-                    continue;
-                }
+                vectorNull[refZone]++;
+                continue;
+            }
 
-                auto it = categoryIndex.find(valueInt);
+            auto it = categoryIndex.find(valueInt);
 
-                if (it != categoryIndex.end())
-                {
-                    int valIndex = it->second;
-                    matrix[refIndex][valIndex]++;
-                }
-                else
-                {
-                    vectorNull[refIndex]++;
-                }
+            if (it != categoryIndex.end())
+            {
+                matrix[refZone][it->second]++;
+            }
+            else
+            {
+                vectorNull[refZone]++;
             }
         }
     }
@@ -117,6 +192,149 @@ std::vector <std::vector<int>> computeMatrixAnalysisRaster(const Crit3DShapeHand
 }
 
 
+// majority of the values (sorted in place): the smallest value wins in case of ties
+static float majorityValue(std::vector<float> &values)
+{
+    std::sort(values.begin(), values.end());
+
+    float majority = NODATA;
+    size_t maxCount = 0;
+    size_t first = 0;
+    while (first < values.size())
+    {
+        size_t last = first + 1;
+        while (last < values.size() && isEqual(values[last], values[first]))
+            last++;
+
+        if (last - first > maxCount)
+        {
+            maxCount = last - first;
+            majority = values[first];
+        }
+        first = last;
+    }
+
+    return majority;
+}
+
+
+/*!
+ * \brief zonal statistics of a value raster with the same header of the zone index
+ * elab: aggrAverage, aggrSum, aggrMin, aggrMax, aggrStdDeviation, aggrMedian, aggr95Perc, aggrPrevailing
+ * weightRaster (optional, same header): cells with a nodata or negative weight are skipped by all the methods,
+ * the weights are used only by the average and the sum (weighted average, weighted sum)
+ * zoneValues[zone] is NODATA if the ratio of valid cells is below threshold
+ */
+bool zonalStatisticsRaster(const Crit3DZoneIndex &zoneIndex, const gis::Crit3DRasterGrid &valueRaster,
+                           const gis::Crit3DRasterGrid *weightRaster, aggregationMethod elab, double threshold,
+                           std::vector<float> &zoneValues, bool isParallelComputing, std::string &errorStr)
+{
+    if (! zoneIndex.isSameGeometry(*(valueRaster.header)))
+    {
+        errorStr = "The value raster has a different header from the zone raster.";
+        return false;
+    }
+    if (weightRaster != nullptr && ! zoneIndex.isSameGeometry(*(weightRaster->header)))
+    {
+        errorStr = "The weight raster has a different header from the zone raster.";
+        return false;
+    }
+    if (elab != aggrAverage && elab != aggrSum && elab != aggrMin && elab != aggrMax && elab != aggrStdDeviation
+        && elab != aggrMedian && elab != aggr95Perc && elab != aggrPrevailing)
+    {
+        errorStr = "Wrong aggregation method.";
+        return false;
+    }
+
+    const int nrZones = zoneIndex.nrZones();
+    zoneValues.assign(size_t(std::max(nrZones, 0)), NODATA);
+
+    const float* values = valueRaster.data();
+    const float flag = valueRaster.header->flag;
+    const float* weights = (weightRaster != nullptr) ? weightRaster->data() : nullptr;
+    const float weightFlag = (weightRaster != nullptr) ? weightRaster->header->flag : NODATA;
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int zone = 0; zone < nrZones; zone++)
+    {
+        const long* cells = zoneIndex.zoneCells(zone);
+        const long nrCells = zoneIndex.nrZoneCells(zone);
+        if (nrCells == 0)
+            continue;
+
+        // collect the valid values
+        std::vector<float> zoneList;
+        zoneList.reserve(size_t(nrCells));
+        double sumValues = 0;
+        double sumWeights = 0;
+        for (long i = 0; i < nrCells; i++)
+        {
+            float value = values[cells[i]];
+            if (isEqual(value, flag))
+                continue;
+
+            if (weights != nullptr)
+            {
+                float weight = weights[cells[i]];
+                if (isEqual(weight, weightFlag) || weight < 0)
+                    continue;
+
+                sumValues += double(value) * double(weight);
+                sumWeights += double(weight);
+            }
+            else
+            {
+                sumValues += double(value);
+            }
+
+            zoneList.push_back(value);
+        }
+
+        int nrValues = int(zoneList.size());
+        if (nrValues == 0 || double(nrValues) / double(nrCells) < threshold)
+            continue;
+
+        float result = NODATA;
+        switch (elab)
+        {
+            case aggrAverage:
+                if (weights == nullptr)
+                    result = float(sumValues / nrValues);
+                else if (sumWeights > 0)
+                    result = float(sumValues / sumWeights);
+                break;
+            case aggrSum:
+                result = float(sumValues);
+                break;
+            case aggrMin:
+                result = *std::min_element(zoneList.begin(), zoneList.end());
+                break;
+            case aggrMax:
+                result = *std::max_element(zoneList.begin(), zoneList.end());
+                break;
+            case aggrStdDeviation:
+                result = statistics::standardDeviation(zoneList, nrValues);
+                break;
+            case aggrMedian:
+                result = sorting::percentile(zoneList, nrValues, 50, true);
+                break;
+            case aggr95Perc:
+                result = sorting::percentile(zoneList, nrValues, 95, true);
+                break;
+            case aggrPrevailing:
+                result = majorityValue(zoneList);
+                break;
+            default:
+                break;
+        }
+
+        zoneValues[size_t(zone)] = result;
+    }
+
+    return true;
+}
+
+
 bool zonalStatisticsShape(Crit3DShapeHandler& shapeRef, Crit3DShapeHandler& shapeVal,
                           const std::vector <std::vector<int>> &matrix, std::vector<int> &vectorNull,
                           const std::string &valField, const std::string &valFieldOutput,
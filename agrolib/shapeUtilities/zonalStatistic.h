@@ -7,12 +7,47 @@
     #ifndef GIS_H
         #include "gis.h"
     #endif
+    #ifndef STATISTICS_H
+        #include "statistics.h"
+    #endif
+
+    /*!
+     * \brief zone -> cells index (CSR) of a zone raster
+     * the cells of zone z are cellIndex[zoneStart[z]] .. cellIndex[zoneStart[z+1] - 1] (row * nrCols + col)
+     * build it once and reuse it for all the value rasters with the same header
+     */
+    class Crit3DZoneIndex
+    {
+    public:
+        Crit3DZoneIndex();
+
+        bool build(const gis::Crit3DRasterGrid &zoneRaster, int nrZones);
+        void clear();
+
+        int nrZones() const { return int(_zoneStart.size()) - 1; }
+        long nrZoneCells(int zone) const { return _zoneStart[zone + 1] - _zoneStart[zone]; }
+        const long* zoneCells(int zone) const { return _cellIndex.data() + _zoneStart[zone]; }
 
-    std::vector <std::vector<int>> computeMatrixAnalysis(Crit3DShapeHandler &shapeRef, Crit3DShapeHandler &shapeVal,
-                              gis::Crit3DRasterGrid &rasterRef, gis::Crit3DRasterGrid &rasterVal, std::vector<int> &vectorNull);
+        const gis::Crit3DRasterHeader& header() const { return _header; }
+        bool isSameGeometry(const gis::Crit3DRasterHeader &otherHeader) const { return _header == otherHeader; }
+
+    private:
+        gis::Crit3DRasterHeader _header;
+        std::vector<long> _zoneStart;
+        std::vector<long> _cellIndex;
+    };
+
+    std::vector <std::vector<int>> computeMatrixAnalysis(const Crit3DZoneIndex &refIndex, const Crit3DShapeHandler &shapeVal,
+                                                         const gis::Crit3DRasterGrid &rasterVal, std::vector<int> &vectorNull,
+                                                         bool isParallelComputing);
 
     std::vector <std::vector<int>> computeMatrixAnalysisRaster(const Crit3DShapeHandler &shapeRef, const gis::Crit3DRasterGrid &rasterVal,
-                                                              std::vector<int> &categories, std::vector<int> &vectorNull);
+                                                              std::vector<int> &categories, std::vector<int> &vectorNull,
+                                                              bool isParallelComputing);
+
+    bool zonalStatisticsRaster(const Crit3DZoneIndex &zoneIndex, const gis::Crit3DRasterGrid &valueRaster,
+                               const gis::Crit3DRasterGrid *weightRaster, aggregationMethod elab, double threshold,
+                               std::vector<float> &zoneValues, bool isParallelComputing, std::string &errorStr);
 
     bool zonalStatisticsShape(Crit3DShapeHandler &shapeRef, Crit3DShapeHandler &shapeVal,
                               const std::vector<std::vector<int>> &matrix, std::vector<int> &vectorNull,
@@ -1,4 +1,6 @@
 #include <cstring>
+#include <vector>
+#include <algorithm>
 #include <cassert>
 #include <omp.h>
 #include <iostream>
@@ -40,10 +42,18 @@ namespace soilFluxes3D::v2
         hostSolverAlloc(matrixA.columnIndeces, matrixA.numRows);
         hostSolverAlloc(matrixA.values, matrixA.numRows);
 
+        // contiguous storage, rows padded to maxColumns
+        const std::size_t matrixSize = static_cast<std::size_t>(matrixA.numRows) * matrixA.maxColumns;
+        hostSolverAlloc(matrixA.columnData, matrixSize);
+        hostSolverAlloc(matrixA.valuesData, matrixSize);
+        if(_status == solverStatus::Error)
+            return SF3Derror_t::MemoryError;
+
         for (SF3Duint_t rowIdx = 0; rowIdx < matrixA.numRows; ++rowIdx)
         {
-            hostSolverAlloc(matrixA.columnIndeces[rowIdx], matrixA.maxColumns);
-            hostSolverAlloc(matrixA.values[rowIdx], matrixA.maxColumns);
+            const std::size_t offset = static_cast<std::size_t>(rowIdx) * matrixA.maxColumns;
+            matrixA.columnIndeces[rowIdx] = matrixA.columnData + offset;
+            matrixA.values[rowIdx] = matrixA.valuesData + offset;
         }
 
         //initialize vector data
@@ -111,15 +121,15 @@ namespace soilFluxes3D::v2
             return SF3Derror_t::SolverError;
 
         //Destruct matrix variable
-        __parfor(_parameters.enableOMP)
-        for (SF3Duint_t rowIdx = 0; rowIdx < matrixA.numRows; ++rowIdx)
-        {
-            hostSolverFree(matrixA.columnIndeces[rowIdx]);
-            hostSolverFree(matrixA.values[rowIdx]);
-        }
         hostSolverFree(matrixA.numColsInRow);
         hostSolverFree(matrixA.columnIndeces);
         hostSolverFree(matrixA.values);
+        hostSolverFree(matrixA.columnData);
+        hostSolverFree(matrixA.valuesData);
+
+        hostSolverFree(heatColoring.rows);
+        heatColoring.numColors = 0;
+        heatColoring.isComputed = false;
 
         //Destruct matrix variable
         hostSolverFree(vectorX.values);
@@ -195,13 +205,7 @@ namespace soilFluxes3D::v2
         //__parforop(_parameters.enableOMP, max, courantMax)
         for(SF3Duint_t index = 0; index <  nodeGrid.nrSurfaceNodes; ++index)
         {
-            double x = vectorB.values[index];
-            for(u8_t j = 1; j < matrixA.numColsInRow[index]; ++j)
-            {
-                double value = matrixA.values[index][j];
-                if (value != 0.)
-                    x -= value * vectorX.values[matrixA.columnIndeces[index][j]];
-            }
+            double x = subtractRowProduct(matrixA, index, vectorX.values, vectorB.values[index]);
             x /= matrixA.values[index][0];
 
             double h = x - nodeGrid.z[index];
@@ -286,7 +290,7 @@ namespace soilFluxes3D::v2
         __parfor(_parameters.enableOMP)
         for (SF3Duint_t row = 0; row < matrixA.numRows; ++row)
         {
-            auto& rowValues = matrixA.values[row];
+            double* rowValues = matrixA.valuesData + static_cast<std::size_t>(row) * matrixA.maxColumns;
             const u8_t nrCols = matrixA.numColsInRow[row];
             const double invDiag = 1.0 / rowValues[0];
 
@@ -335,7 +339,7 @@ namespace soilFluxes3D::v2
     void CPUSolver::computeDiagonalElement(SF3Duint_t row, double deltaT)
     {
         u8_t nrElements = matrixA.numColsInRow[row];
-        auto& rowValues = matrixA.values[row];
+        double* rowValues = matrixA.valuesData + static_cast<std::size_t>(row) * matrixA.maxColumns;
 
         double sum = 0.;
         for (size_t col = 1; col < nrElements; ++col)
@@ -568,6 +572,9 @@ namespace soilFluxes3D::v2
         }
 
         // Solve linear system
+        if(! heatColoring.isComputed)
+            computeHeatColoring();
+
         solveLinearSystem(_parameters.maxApproximationsNumber - 1, processType::Heat);
 
         // Store new temperatures
@@ -605,6 +612,87 @@ namespace soilFluxes3D::v2
     }
 
 
+    /*!
+     * \brief greedy coloring of the heat nodes on the link topology, used to parallelize
+     *  the Gauss-Seidel sweep. If the links are not symmetric the coloring is discarded
+     *  and the sweep falls back to the natural ordering
+     */
+    bool CPUSolver::computeHeatColoring()
+    {
+        heatColoring.isComputed = true;
+        heatColoring.numColors = 0;
+
+        const u8_t noColor = maxMatrixColumns;
+        std::vector<u8_t> nodeColor(nodeGrid.nrNodes, noColor);
+        SF3Duint_t colorCount[maxMatrixColumns] = {0};
+        u8_t nrColors = 0;
+
+        for (SF3Duint_t nodeIdx = 0; nodeIdx < nodeGrid.nrNodes; ++nodeIdx)
+        {
+            if(nodeGrid.surfaceFlag[nodeIdx])
+                continue;
+
+            bool isUsed[maxMatrixColumns] = {false};
+            for (u8_t linkIdx = 0; linkIdx < maxTotalLink; ++linkIdx)
+            {
+                if(nodeGrid.linkData[linkIdx].linkType[nodeIdx] == linkType_t::NoLink)
+                    continue;
+
+                u8_t linkedColor = nodeColor[nodeGrid.linkData[linkIdx].linkIndex[nodeIdx]];
+                if(linkedColor != noColor)
+                    isUsed[linkedColor] = true;
+            }
+
+            u8_t color = 0;
+            while (isUsed[color])
+                color++;
+
+            nodeColor[nodeIdx] = color;
+            colorCount[color]++;
+            nrColors = std::max(nrColors, static_cast<u8_t>(color + 1));
+        }
+
+        // check the coloring also against the backward links
+        for (SF3Duint_t nodeIdx = 0; nodeIdx < nodeGrid.nrNodes; ++nodeIdx)
+        {
+            if(nodeGrid.surfaceFlag[nodeIdx])
+                continue;
+
+            for (u8_t linkIdx = 0; linkIdx < maxTotalLink; ++linkIdx)
+            {
+                if(nodeGrid.linkData[linkIdx].linkType[nodeIdx] == linkType_t::NoLink)
+                    continue;
+
+                if(nodeColor[nodeGrid.linkData[linkIdx].linkIndex[nodeIdx]] == nodeColor[nodeIdx])
+                    return false;
+            }
+        }
+
+        SF3Duint_t nrHeatNodes = 0;
+        for (u8_t color = 0; color < nrColors; ++color)
+        {
+            heatColoring.colorOffset[color] = nrHeatNodes;
+            nrHeatNodes += colorCount[color];
+        }
+        heatColoring.colorOffset[nrColors] = nrHeatNodes;
+
+        if(nrHeatNodes == 0 || hostAlloc(heatColoring.rows, nrHeatNodes) != SF3Derror_t::SF3Dok)
+            return false;
+
+        // rows sorted by color, in natural order inside each color
+        SF3Duint_t colorPosition[maxMatrixColumns];
+        std::copy(heatColoring.colorOffset, heatColoring.colorOffset + nrColors, colorPosition);
+        for (SF3Duint_t nodeIdx = 0; nodeIdx < nodeGrid.nrNodes; ++nodeIdx)
+        {
+            if(nodeColor[nodeIdx] != noColor)
+                heatColoring.rows[colorPosition[nodeColor[nodeIdx]]++] = nodeIdx;
+        }
+
+        heatColoring.numColors = nrColors;
+        return true;
+    }
+
+
     bool CPUSolver::linealSolver(u8_t approximationNr)
     {
         u32_t nrIterationMax = calcCurrentMaxIterationNumber(approximationNr);
@@ -683,7 +771,7 @@ namespace soilFluxes3D::v2
                     currErrorNorm = JacobiWaterCPU(vectorX, vectorNewX, matrixA, vectorB);
                     break;
                 case processType::Heat:
-                    currErrorNorm = GaussSeidelHeatCPU(vectorX, matrixA, vectorB);
+                    currErrorNorm = GaussSeidelHeatCPU(vectorX, matrixA, vectorB, heatColoring);
                     break;
                 default:
                     throw std::runtime_error("Process not available");
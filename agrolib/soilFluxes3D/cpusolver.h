@@ -12,6 +12,7 @@ namespace soilFluxes3D::v2
             MatrixCPU matrixA;
             VectorCPU vectorB, vectorX, vectorNewX;
             VectorCPU vectorC;
+            MatrixColoringCPU heatColoring;
 
             bool waterMainLoop(double maxTimeStep, double& acceptedTimeStep);
             balanceResult_t waterApproximationLoop(double deltaT);
@@ -24,6 +25,7 @@ namespace soilFluxes3D::v2
             bool checkCourant(double deltaT);
 
             bool heatLoop(double timeStepHeat, double timeStepWater);
+            bool computeHeatColoring();
 
             bool solveLinearSystem(u8_t approximationNr, processType computationType) override;
             bool linealSolver(u8_t approximationNr);
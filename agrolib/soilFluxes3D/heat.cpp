@@ -661,24 +661,50 @@ namespace soilFluxes3D::v2::Heat
     }
 
 
-    double GaussSeidelHeatCPU(VectorCPU& vectorX, const MatrixCPU& matrixA, const VectorCPU& vectorB)
+    double GaussSeidelHeatCPU(VectorCPU& vectorX, const MatrixCPU& matrixA, const VectorCPU& vectorB, const MatrixColoringCPU& coloring)
     {
         double infinityNorm = -1;
-        for(SF3Duint_t rowIdx = 0; rowIdx < matrixA.numRows; ++rowIdx)
+
+        // natural ordering
+        if(coloring.numColors == 0)
         {
-            if(nodeGrid.surfaceFlag[rowIdx])
-                continue;
+            for(SF3Duint_t rowIdx = 0; rowIdx < matrixA.numRows; ++rowIdx)
+            {
+                if(nodeGrid.surfaceFlag[rowIdx])
+                    continue;
 
-            if(matrixA.values[rowIdx][0] == 0.)
-                continue;
+                if(matrixA.values[rowIdx][0] == 0.)
+                    continue;
+
+                double newXvalue = subtractRowProduct(matrixA, rowIdx, vectorX.values, vectorB.values[rowIdx]);
+
+                double deltaX = std::fabs(newXvalue - vectorX.values[rowIdx]);
+                vectorX.values[rowIdx] = newXvalue;
+                infinityNorm = std::max(infinityNorm, deltaX);
+            }
 
-            double newXvalue = vectorB.values[rowIdx];
-            for(u8_t colIdx = 1; colIdx < matrixA.numColsInRow[rowIdx]; ++colIdx)
-                newXvalue -= matrixA.values[rowIdx][colIdx] * vectorX.values[matrixA.columnIndeces[rowIdx][colIdx]];
+            return infinityNorm;
+        }
+
+        // multicolor ordering: rows of the same color are independent
+        for(u8_t color = 0; color < coloring.numColors; ++color)
+        {
+            const SF3Duint_t firstIdx = coloring.colorOffset[color];
+            const SF3Duint_t lastIdx = coloring.colorOffset[color + 1];
 
-            double deltaX = std::fabs(newXvalue - vectorX.values[rowIdx]);
-            vectorX.values[rowIdx] = newXvalue;
-            infinityNorm = std::max(infinityNorm, deltaX);
+            __parforop(__ompStatus, max, infinityNorm)
+            for(SF3Duint_t idx = firstIdx; idx < lastIdx; ++idx)
+            {
+                const SF3Duint_t rowIdx = coloring.rows[idx];
+                if(matrixA.values[rowIdx][0] == 0.)
+                    continue;
+
+                double newXvalue = subtractRowProduct(matrixA, rowIdx, vectorX.values, vectorB.values[rowIdx]);
+
+                double deltaX = std::fabs(newXvalue - vectorX.values[rowIdx]);
+                vectorX.values[rowIdx] = newXvalue;
+                infinityNorm = std::max(infinityNorm, deltaX);
+            }
         }
 
         return infinityNorm;
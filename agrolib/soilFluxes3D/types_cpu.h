@@ -4,6 +4,11 @@
 
 namespace soilFluxes3D::v2
 {
+    /*!
+     * \brief sparse matrix in ELL layout: every row has maxColumns slots stored contiguously,
+     *  column 0 is the diagonal and the unused slots are padded with zeros.
+     *  columnIndeces and values are row pointers into the contiguous arrays (used by lineal)
+     */
     struct MatrixCPU
     {
         SF3Duint_t numRows;
@@ -11,6 +16,21 @@ namespace soilFluxes3D::v2
         u8_t* numColsInRow = nullptr;
         SF3Duint_t** columnIndeces = nullptr;
         double** values = nullptr;
+
+        SF3Duint_t* columnData = nullptr;       /*!< [numRows * maxColumns] column indices */
+        double* valuesData = nullptr;           /*!< [numRows * maxColumns] coefficients */
+    };
+
+    /*!
+     * \brief rows grouped by color: rows of the same color are not linked to each other,
+     *  so a Gauss-Seidel sweep can update them in parallel
+     */
+    struct MatrixColoringCPU
+    {
+        bool isComputed = false;
+        u8_t numColors = 0;
+        SF3Duint_t colorOffset[maxMatrixColumns + 1] = {0};
+        SF3Duint_t* rows = nullptr;
     };
 
     struct VectorCPU
@@ -19,6 +39,22 @@ namespace soilFluxes3D::v2
         double* values;
     };
 
+    /*!
+     * \brief returns value - sum of the off-diagonal products A[row][col] * x[col]
+     */
+    inline double subtractRowProduct(const MatrixCPU& matrix, SF3Duint_t row, const double* x, double value)
+    {
+        const std::size_t offset = static_cast<std::size_t>(row) * matrix.maxColumns;
+        const double* rowValues = matrix.valuesData + offset;
+        const SF3Duint_t* rowColumns = matrix.columnData + offset;
+        const u8_t nrCols = matrix.numColsInRow[row];
+
+        for(u8_t col = 1; col < nrCols; ++col)
+            value -= rowValues[col] * x[rowColumns[col]];
+
+        return value;
+    }
+
     template<typename T>
     inline SF3Derror_t allocHostPointer(T*& ptr, const std::size_t count)
     {
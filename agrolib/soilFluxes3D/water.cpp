@@ -569,15 +569,7 @@ namespace soilFluxes3D::v2::Water
         #pragma omp parallel for if(__ompStatus) schedule(static) reduction(+:sumNorm)
         for(SF3Duint_t row = 0; row < matrixA.numRows; ++row)
         {
-            double x_new = vectorB.values[row];
-
-            const uint32_t nrCols = matrixA.numColsInRow[row];
-            for(uint32_t col = 1; col < nrCols; ++col)
-            {
-                const uint32_t index = matrixA.columnIndeces[row][col];
-                const double A = matrixA.values[row][col];
-                x_new -= A * vectorX.values[index];
-            }
+            double x_new = subtractRowProduct(matrixA, row, vectorX.values, vectorB.values[row]);
 
             // check surface water level (it must be <= 0)
             const double z_i = nodeGrid.z[row];
@@ -607,9 +599,7 @@ namespace soilFluxes3D::v2::Water
 
         for (SF3Duint_t row = 0; row < matrixA.numRows; ++row)
         {
-            double newCurrValue = vectorB.values[row];
-            for (u8_t col = 1; col < matrixA.numColsInRow[row]; ++col)
-                newCurrValue -= matrixA.values[row][col] * vectorX.values[matrixA.columnIndeces[row][col]];
+            double newCurrValue = subtractRowProduct(matrixA, row, vectorX.values, vectorB.values[row]);
 
             if(nodeGrid.surfaceFlag[row] && newCurrValue < nodeGrid.z[row])
                 newCurrValue = nodeGrid.z[row];
@@ -221,6 +221,19 @@ QDate getQDate(const Crit3DDate& d)
 }
 
 
+// QDate and Crit3DSerialDate use the same julian day number
+QDate getQDate(const Crit3DSerialDate& d)
+{
+    return QDate::fromJulianDay(d.julianDay);
+}
+
+
+Crit3DSerialDate getSerialDate(const QDate& d)
+{
+    return Crit3DSerialDate::fromJulianDay(long(d.toJulianDay()));
+}
+
+
 QDateTime getQDateTime(const Crit3DTime &t)
 {
     QDateTime dateTime;
@@ -11,6 +11,7 @@
     #include <QDateTime>
 
     class Crit3DDate;
+    class Crit3DSerialDate;
     class Crit3DTime;
     class QVariant;
 
@@ -19,6 +20,8 @@
     Crit3DTime getCrit3DTime(const QDate& t, int hour);
 
     QDate getQDate(const Crit3DDate &myDate);
+    QDate getQDate(const Crit3DSerialDate &myDate);
+    Crit3DSerialDate getSerialDate(const QDate &myDate);
     QDateTime getQDateTime(const Crit3DTime &myCrit3DTime);
     int decadeFromDate(QDate date);
     void intervalDecade(int decade, int year, int* dayStart, int* dayEnd, int* month);
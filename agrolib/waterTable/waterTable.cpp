@@ -5,6 +5,7 @@
 #include "crit3dDate.h"
 
 #include <math.h>
+#include <algorithm>
 
 
 WaterTable::WaterTable()
@@ -26,6 +27,7 @@ void WaterTable::initializeWaterTable()
 {
     _isCWBEquationReady = false;
     _isClimateReady = false;
+    _isCWBSumReady = false;
 
     _alpha = NODATA;
     _h0 = NODATA;
@@ -45,6 +47,19 @@ void WaterTable::initializeWaterTable(const Well &myWell)
     _well = myWell;
     _well.updateDates();
 
+    // QMap keys are already sorted
+    _obsDates.clear();
+    _obsDepths.clear();
+    _obsDates.reserve(_well.depths.size());
+    _obsDepths.reserve(_well.depths.size());
+    QMapIterator<QDate, float> it(_well.depths);
+    while (it.hasNext())
+    {
+        it.next();
+        _obsDates.push_back(it.key());
+        _obsDepths.push_back(it.value());
+    }
+
     initializeWaterTable();
 }
 
@@ -58,6 +73,11 @@ void WaterTable::cleanAllVectors()
 
     _hindcastSeries.clear();
     _interpolationSeries.clear();
+
+    _cumCWB.clear();
+    _cumIndexCWB.clear();
+    _cumNrValidDays.clear();
+    _isCWBSumReady = false;
 }
 
 
@@ -90,6 +110,7 @@ bool WaterTable::setMeteoData(const QDate &date, float tmin, float tmax, float p
         Crit3DDate myDate = Crit3DDate(date.day(), date.month(), date.year());
         _etpValues[index] = dailyEtpHargreaves(tmin, tmax, myDate, _well.getLatitude(), &_meteoSettings);
         _inputPrec[index] = prec;
+        _isCWBSumReady = false;
         return true;
     }
 
@@ -202,6 +223,7 @@ float WaterTable::getInterpolatedData(int index) const
 bool WaterTable::computeWholeSeriesETP(bool isUpdateAvgCWB)
 {
     _etpValues.clear();
+    _isCWBSumReady = false;
 
     if (_inputTMin.size() != _inputTMax.size() || _inputTMin.size() != _inputPrec.size())
     {
@@ -272,14 +294,11 @@ bool WaterTable::computeCWBCorrelation(int stepDays)
     {
         myCWBSum.clear();
         myObsWT.clear();
-        QMapIterator<QDate, float> it(_well.depths);
 
-        while (it.hasNext())
+        for (unsigned int i = 0; i < _obsDates.size(); i++)
         {
-            it.next();
-            QDate myDate = it.key();
-            int myValue = it.value();
-            float myCWBValue = computeCWB(myDate, nrDays);  // [cm]
+            int myValue = _obsDepths[i];
+            float myCWBValue = computeCWB(_obsDates[i], nrDays);  // [cm]
             if (myCWBValue != NODATA)
             {
                 myCWBSum.push_back(myCWBValue);
@@ -313,29 +332,59 @@ bool WaterTable::computeCWBCorrelation(int stepDays)
 }
 
 
+// prefix sums of valid daily CWB on the meteo series
+// cum[i] = sum of values with index < i
+void WaterTable::updateCWBSums()
+{
+    int nrData = int(std::min(_etpValues.size(), _inputPrec.size()));
+
+    _cumCWB.assign(nrData + 1, 0);
+    _cumIndexCWB.assign(nrData + 1, 0);
+    _cumNrValidDays.assign(nrData + 1, 0);
+
+    for (int i = 0; i < nrData; i++)
+    {
+        float etp = _etpValues[i];
+        float prec = _inputPrec[i];
+        double currentCWB = 0;
+        int isValid = 0;
+        if (! isEqual(etp, NODATA) && ! isEqual(prec, NODATA))
+        {
+            currentCWB = double(prec - etp);
+            isValid = 1;
+        }
+        _cumCWB[i+1] = _cumCWB[i] + currentCWB;
+        _cumIndexCWB[i+1] = _cumIndexCWB[i] + currentCWB * i;
+        _cumNrValidDays[i+1] = _cumNrValidDays[i] + isValid;
+    }
+
+    _isCWBSumReady = true;
+}
+
+
 // compute Climatic Water Balance (CWB) on a nrDaysPeriod
 // expressed as anomaly in [cm] with average value
+// the previous nrDays are weighted linearly: 1 for the day before myDate, 1/nrDays for the first day
+// weight(index) = (index - firstIndex + 1) / nrDays, so the sum is obtained from prefix sums in O(1)
 double WaterTable::computeCWB(const QDate &myDate, int nrDays)
 {
+    if (! _isCWBSumReady)
+        updateCWBSums();
+
+    int nrData = int(_cumNrValidDays.size()) - 1;
+    int lastIndex = _firstMeteoDate.daysTo(myDate);         // excluded
+    int firstIndex = lastIndex - nrDays;
+    int i1 = std::max(firstIndex, 0);
+    int i2 = std::min(lastIndex, nrData);
+
     double sumCWB = 0;
     int nrValidDays = 0;
-    QDate actualDate;
-    for (int shift = 1; shift <= nrDays; shift++)
+    if (i2 > i1)
     {
-        actualDate = myDate.addDays(-shift);
-        int index = _firstMeteoDate.daysTo(actualDate);
-        if (index >= 0 && index < int(_inputPrec.size()))
-        {
-            float etp = _etpValues[index];
-            float prec = _inputPrec[index];
-            if (! isEqual(etp, NODATA) && ! isEqual(prec, NODATA))
-            {
-                double currentCWB = double(prec - etp);
-                double weight = 1 - double(shift-1) / double(nrDays);
-                sumCWB += currentCWB * weight;
-                nrValidDays++;
-            }
-        }
+        double windowSum = _cumCWB[i2] - _cumCWB[i1];
+        double windowIndexSum = _cumIndexCWB[i2] - _cumIndexCWB[i1];
+        sumCWB = (windowIndexSum - double(firstIndex - 1) * windowSum) / double(nrDays);
+        nrValidDays = _cumNrValidDays[i2] - _cumNrValidDays[i1];
     }
 
     if (nrValidDays < (nrDays * _meteoSettings.getMinimumPercentage() / 100))
@@ -355,17 +404,15 @@ double WaterTable::computeCWB(const QDate &myDate, int nrDays)
 // function to compute several statistical indices for watertable depth
 bool WaterTable::computeWaterTableIndices()
 {
-    QMapIterator<QDate, float> it(_well.depths);
     std::vector<float> myObs;
     std::vector<float> myComputed;
     std::vector<float> myClimate;
     float myIntercept, myCoeff;
 
-    while (it.hasNext())
+    for (unsigned int i = 0; i < _obsDates.size(); i++)
     {
-        it.next();
-        QDate myDate = it.key();
-        int myValue = it.value();
+        QDate myDate = _obsDates[i];
+        int myValue = _obsDepths[i];
         float computedValue = getWaterTableDaily(myDate);
         if (computedValue != NODATA)
         {
@@ -530,48 +577,31 @@ bool WaterTable::getWaterTableInterpolation(const QDate &myDate, float &myValue,
     QDate previousDate;
     QDate nextDate;
 
-    QList<QDate> keys = _well.depths.keys();
-
-    // check previuos and next observed data
-    int lastIndex = keys.size() - 1;
-    int i = keys.indexOf(myDate);
-    if (i != -1) // exact data found
+    // check previuos and next observed data (binary search)
+    int nrObs = int(_obsDates.size());
+    int i = int(std::lower_bound(_obsDates.begin(), _obsDates.end(), myDate) - _obsDates.begin());
+    if (i < nrObs && _obsDates[i] == myDate) // exact data found
     {
         indexPrev = i;
-        previousDate = keys[indexPrev];
-        previosValue = _well.depths[previousDate];
         indexNext = i;
-        nextDate = keys[indexNext];
-        nextValue = _well.depths[nextDate];
     }
     else
     {
-        if (keys[0] > myDate)
-        {
-            indexNext = 0;
-            nextDate = keys[indexNext];
-            nextValue = _well.depths[nextDate];
-        }
-        else if (keys[lastIndex] < myDate)
-        {
-            indexPrev = lastIndex;
-            previousDate = keys[indexPrev];
-            previosValue = _well.depths[previousDate];
-        }
-        else
-        {
-            for (int i = 0; i < lastIndex; i++)
-                if (keys[i] < myDate && keys[i+1] > myDate)
-                {
-                    indexPrev = i;
-                    previousDate = keys[indexPrev];
-                    previosValue = _well.depths[previousDate];
-                    indexNext = i + 1;
-                    nextDate = keys[indexNext];
-                    nextValue = _well.depths[nextDate];
-                    break;
-                }
-        }
+        if (i > 0)
+            indexPrev = i - 1;
+        if (i < nrObs)
+            indexNext = i;
+    }
+
+    if (indexPrev != NODATA)
+    {
+        previousDate = _obsDates[indexPrev];
+        previosValue = _obsDepths[indexPrev];
+    }
+    if (indexNext != NODATA)
+    {
+        nextDate = _obsDates[indexNext];
+        nextValue = _obsDepths[indexNext];
     }
 
     if (indexPrev != NODATA)
@@ -46,6 +46,7 @@ class WaterTable
         bool computeWTClimate();
         bool computeCWBCorrelation(int stepDays);
         double computeCWB(const QDate &myDate, int nrDays);
+        void updateCWBSums();
         bool computeWaterTableIndices();
 
         double getWaterTableDaily(const QDate &myDate);
@@ -92,11 +93,21 @@ class WaterTable
         Well _well;
         QString _errorStr;
 
+        // observed depths sorted by date (copy of _well.depths for binary search)
+        std::vector<QDate> _obsDates;
+        std::vector<float> _obsDepths;
+
         std::vector<float> _inputTMin;
         std::vector<float> _inputTMax;
         std::vector<float> _inputPrec;
         std::vector<float> _etpValues;
 
+        // prefix sums of daily CWB (prec - etp) on the meteo series: running window in O(1)
+        std::vector<double> _cumCWB;            // [mm]
+        std::vector<double> _cumIndexCWB;       // [mm] weighted by series index
+        std::vector<int> _cumNrValidDays;
+        bool _isCWBSumReady;
+
         int _nrDaysPeriod;           // [days]
         double _alpha;               // [-]
         double _h0;                  // unit of observed watertable data, usually [cm]
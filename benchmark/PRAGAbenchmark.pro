@@ -0,0 +1,89 @@
+#---------------------------------------------------------
+#
+#   PRAGAbenchmark
+#   micro and macro benchmarks on synthetic data
+#   This project is part of ARPA-SIMC/PRAGA distribution
+#
+#---------------------------------------------------------
+
+QT  += widgets charts network sql xml
+greaterThan(QT_MAJOR_VERSION, 5): QT += core5compat
+
+TARGET = PRAGAbenchmark
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++17
+
+
+INCLUDEPATH +=  ../agrolib/crit3dDate ../agrolib/mathFunctions ../agrolib/meteo ../agrolib/gis  \
+                ../agrolib/interpolation ../agrolib/solarRadiation ../agrolib/utilities  \
+                ../agrolib/outputPoints ../agrolib/dbMeteoPoints ../agrolib/dbMeteoGrid  \
+                ../agrolib/meteoWidget ../agrolib/commonDialogs ../agrolib/commonChartElements \
+                ../agrolib/waterTable ../agrolib/project ../agrolib/proxyWidget \
+                ../agrolib/soilFluxes3D ../src/phenology ../src/climate
+
+CONFIG += debug_and_release
+
+# parallel computing settings
+include($$absolute_path(../agrolib/parallel.pri))
+
+
+CONFIG(debug, debug|release) {
+    LIBS += -L../src/climate/debug -lclimate
+    LIBS += -L../src/phenology/debug -lphenology
+
+    LIBS += -L../agrolib/project/debug -lproject
+    LIBS += -L../agrolib/commonDialogs/debug -lcommonDialogs
+    LIBS += -L../agrolib/waterTable/debug -lwaterTable
+    LIBS += -L../agrolib/proxyWidget/debug -lproxyWidget
+    LIBS += -L../agrolib/meteoWidget/debug -lmeteoWidget
+    LIBS += -L../agrolib/commonChartElements/debug -lcommonChartElements
+    LIBS += -L../agrolib/dbMeteoGrid/debug -ldbMeteoGrid
+    LIBS += -L../agrolib/dbMeteoPoints/debug -ldbMeteoPoints
+    LIBS += -L../agrolib/outputPoints/debug -loutputPoints
+    LIBS += -L../agrolib/utilities/debug -lutilities
+    LIBS += -L../agrolib/solarRadiation/debug -lsolarRadiation
+    LIBS += -L../agrolib/interpolation/debug -linterpolation
+    LIBS += -L../agrolib/meteo/debug -lmeteo
+    LIBS += -L../agrolib/gis/debug -lgis
+    LIBS += -L../agrolib/soilFluxes3D/debug -lsoilFluxes3D
+    LIBS += -L../agrolib/crit3dDate/debug -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/debug -lmathFunctions
+
+} else {
+    LIBS += -L../src/climate/release -lclimate
+    LIBS += -L../src/phenology/release -lphenology
+
+    LIBS += -L../agrolib/project/release -lproject
+    LIBS += -L../agrolib/commonDialogs/release -lcommonDialogs
+    LIBS += -L../agrolib/waterTable/release -lwaterTable
+    LIBS += -L../agrolib/proxyWidget/release -lproxyWidget
+    LIBS += -L../agrolib/meteoWidget/release -lmeteoWidget
+    LIBS += -L../agrolib/commonChartElements/release -lcommonChartElements
+    LIBS += -L../agrolib/dbMeteoGrid/release -ldbMeteoGrid
+    LIBS += -L../agrolib/dbMeteoPoints/release -ldbMeteoPoints
+    LIBS += -L../agrolib/outputPoints/release -loutputPoints
+    LIBS += -L../agrolib/utilities/release -lutilities
+    LIBS += -L../agrolib/solarRadiation/release -lsolarRadiation
+    LIBS += -L../agrolib/interpolation/release -linterpolation
+    LIBS += -L../agrolib/meteo/release -lmeteo
+    LIBS += -L../agrolib/gis/release -lgis
+    LIBS += -L../agrolib/soilFluxes3D/release -lsoilFluxes3D
+    LIBS += -L../agrolib/crit3dDate/release -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/release -lmathFunctions
+}
+
+
+SOURCES += \
+    benchmarkData.cpp \
+    benchmarkSoilFluxes.cpp \
+    benchmarkSuite.cpp \
+    main.cpp
+
+
+HEADERS  += \
+    benchmarkData.h \
+    benchmarkSoilFluxes.h \
+    benchmarkSuite.h
@@ -0,0 +1,437 @@
+#include "benchmarkData.h"
+#include "commonConstants.h"
+
+#include <cmath>
+#include <random>
+#include <QDateTime>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTextStream>
+
+#define BENCHMARK_POINTS_CONNECTION "benchmarkPointsData"
+#define BENCHMARK_GRID_CONNECTION "benchmarkGridData"
+
+
+BenchmarkDataSettings::BenchmarkDataSettings()
+{
+    seed = 42;
+
+    demRows = 400;
+    demCols = 500;
+    cellSize = 100;
+    xllCorner = 600000;
+    yllCorner = 4900000;
+
+    nrStations = 150;
+    firstYear = 2011;
+    lastYear = 2020;
+    nrHourlyDays = 31;
+
+    gridRows = 20;
+    gridCols = 25;
+}
+
+
+// reduced data set, for quick checks
+void BenchmarkDataSettings::setSmall()
+{
+    demRows = 100;
+    demCols = 120;
+    nrStations = 30;
+    firstYear = 2018;
+    lastYear = 2020;
+    nrHourlyDays = 7;
+    gridRows = 5;
+    gridCols = 6;
+}
+
+
+namespace
+{
+    // synthetic daily climate: annual cycle, lapse rate and a random anomaly
+    void dailyTemperature(int doy, double elevation, std::mt19937 &generator,
+                          double &tMin, double &tAvg, double &tMax)
+    {
+        std::normal_distribution<double> anomaly(0., 2.);
+        std::uniform_real_distribution<double> range(6., 14.);
+
+        double tSeaLevel = 13. - 10. * cos(2. * PI * (doy - 15) / 365.);
+        tAvg = tSeaLevel - 0.0065 * elevation + anomaly(generator);
+
+        double halfRange = range(generator) * 0.5;
+        tMin = tAvg - halfRange;
+        tMax = tAvg + halfRange;
+    }
+
+
+    double dailyPrecipitation(std::mt19937 &generator)
+    {
+        std::bernoulli_distribution isWet(0.3);
+        std::exponential_distribution<double> amount(1. / 6.);
+
+        if (! isWet(generator))
+            return 0;
+
+        return std::round(amount(generator) * 10.) / 10.;
+    }
+
+
+    QString roundValue(double value)
+    {
+        return QString::number(std::round(value * 10.) / 10., 'f', 1);
+    }
+}
+
+
+QString getBenchmarkCellId(int row, int col)
+{
+    return QString("%1%2").arg(row, 3, 10, QChar('0')).arg(col, 3, 10, QChar('0'));
+}
+
+
+/*!
+ * \brief createSyntheticDEM
+ * a plain with a set of gaussian hills, saved as ESRI float grid (.hdr/.flt)
+ */
+bool createSyntheticDEM(const BenchmarkDataSettings &settings, const QString &fileNameWithoutExt,
+                        gis::Crit3DRasterGrid &dem, QString &errorStr)
+{
+    gis::Crit3DRasterHeader header;
+    header.nrRows = settings.demRows;
+    header.nrCols = settings.demCols;
+    header.cellSize = settings.cellSize;
+    header.llCorner.x = settings.xllCorner;
+    header.llCorner.y = settings.yllCorner;
+    header.flag = NODATA;
+
+    if (! dem.initializeGrid(header))
+    {
+        errorStr = "Error in DEM initialization.";
+        return false;
+    }
+
+    std::mt19937 generator(settings.seed);
+    std::uniform_real_distribution<double> position(0., 1.);
+    std::uniform_real_distribution<double> hillHeight(200., 1500.);
+    std::uniform_real_distribution<double> hillWidth(2000., 8000.);
+
+    const int nrHills = 12;
+    double width = settings.demCols * settings.cellSize;
+    double height = settings.demRows * settings.cellSize;
+
+    std::vector<double> hillX(nrHills), hillY(nrHills), hillZ(nrHills), hillSigma(nrHills);
+    for (int i = 0; i < nrHills; i++)
+    {
+        hillX[i] = position(generator) * width;
+        hillY[i] = position(generator) * height;
+        hillZ[i] = hillHeight(generator);
+        hillSigma[i] = hillWidth(generator);
+    }
+
+    for (int row = 0; row < header.nrRows; row++)
+    {
+        // row 0 is the northern border
+        double y = (header.nrRows - row - 0.5) * header.cellSize;
+        for (int col = 0; col < header.nrCols; col++)
+        {
+            double x = (col + 0.5) * header.cellSize;
+            double z = 20. + 0.002 * y;
+            for (int i = 0; i < nrHills; i++)
+            {
+                double dx = x - hillX[i];
+                double dy = y - hillY[i];
+                z += hillZ[i] * exp(-(dx*dx + dy*dy) / (2. * hillSigma[i] * hillSigma[i]));
+            }
+            dem.value[row][col] = float(z);
+        }
+    }
+
+    gis::updateMinMaxRasterGrid(&dem);
+    dem.isLoaded = true;
+
+    std::string errorStdStr;
+    if (! gis::writeEsriGrid(fileNameWithoutExt.toStdString(), &dem, errorStdStr))
+    {
+        errorStr = QString::fromStdString(errorStdStr);
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief createSyntheticPointsDb
+ * meteo points DB with the same schema of DATA/TEMPLATE/template_meteo.db:
+ * daily TMIN, TAVG, TMAX, PREC for all the years and hourly TAVG for nrHourlyDays
+ */
+bool createSyntheticPointsDb(const BenchmarkDataSettings &settings, const gis::Crit3DRasterGrid &dem,
+                             const gis::Crit3DGisSettings &gisSettings, const QString &dbName, QString &errorStr)
+{
+    QFile::remove(dbName);
+
+    bool isOk = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", BENCHMARK_POINTS_CONNECTION);
+        db.setDatabaseName(dbName);
+        if (! db.open())
+        {
+            errorStr = db.lastError().text();
+            isOk = false;
+        }
+
+        QSqlQuery qry(db);
+        QStringList statements;
+        statements << "CREATE TABLE variable_properties (id_variable INTEGER, variable TEXT, description TEXT, "
+                      "frequency TEXT, height REAL, resolution TEXT, unit INTEGER, min REAL, max REAL)"
+                   << "INSERT INTO variable_properties VALUES "
+                      "(101, 'TAVG', 'hourly average air temperature at 2 m', '3600', 2.0, '0.1', 'C', -60.0, 60.0), "
+                      "(151, 'DAILY_TMIN', 'daily minimum air temperature at 2 m', '86400', 2.0, '0.1', 'C', -60.0, 60.0), "
+                      "(152, 'DAILY_TMAX', 'daily maximum air temperature at 2 m', '86400', 2.0, '0.1', 'C', -60.0, 60.0), "
+                      "(153, 'DAILY_TAVG', 'daily average air temperature at 2 m', '86400', 2.0, '0.1', 'C', -60.0, 60.0), "
+                      "(154, 'DAILY_PREC', 'daily cumulated precipitation', '86400', 2.0, '0.1', 'mm', 0.0, 1000.0)"
+                   << "CREATE TABLE point_properties (id_point TEXT, name TEXT, dataset TEXT, latitude REAL, longitude REAL, "
+                      "latInt INTEGER, lonInt INTEGER, utm_x NUMERIC, utm_y NUMERIC, altitude REAL, state TEXT, region TEXT, "
+                      "province TEXT, municipality TEXT, is_active INTEGER DEFAULT 1, is_utc INTEGER DEFAULT 1, "
+                      "orog_code NUMERIC DEFAULT 0, PRIMARY KEY(id_point))"
+                   << "CREATE TABLE joint_stations (id_point TEXT, joint_station TEXT, PRIMARY KEY(id_point, joint_station))";
+
+        for (int i = 0; isOk && i < statements.size(); i++)
+        {
+            if (! qry.exec(statements[i]))
+            {
+                errorStr = qry.lastError().text();
+                isOk = false;
+            }
+        }
+
+        std::mt19937 generator(settings.seed + 1);
+        std::uniform_int_distribution<int> randomRow(0, dem.header->nrRows - 1);
+        std::uniform_int_distribution<int> randomCol(0, dem.header->nrCols - 1);
+
+        QDate firstDate(settings.firstYear, 1, 1);
+        QDate lastDate(settings.lastYear, 12, 31);
+        QDate lastHourlyDate = QDate(settings.lastYear, 1, 1).addDays(settings.nrHourlyDays - 1);
+
+        if (isOk)
+            db.transaction();
+
+        for (int i = 0; isOk && i < settings.nrStations; i++)
+        {
+            QString id = QString("bm%1").arg(i + 1, 4, 10, QChar('0'));
+
+            int row = randomRow(generator);
+            int col = randomCol(generator);
+            double utmX, utmY;
+            gis::getUtmXYFromRowCol(*(dem.header), row, col, &utmX, &utmY);
+            double elevation = double(dem.value[row][col]);
+            double lat, lon;
+            gis::getLatLonFromUtm(gisSettings, utmX, utmY, &lat, &lon);
+
+            qry.prepare("INSERT INTO point_properties (id_point, name, dataset, latitude, longitude, utm_x, utm_y, altitude) "
+                        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+            qry.addBindValue(id);
+            qry.addBindValue("benchmark " + id);
+            qry.addBindValue("BENCHMARK");
+            qry.addBindValue(lat);
+            qry.addBindValue(lon);
+            qry.addBindValue(utmX);
+            qry.addBindValue(utmY);
+            qry.addBindValue(std::round(elevation));
+            if (! qry.exec())
+            {
+                errorStr = qry.lastError().text();
+                isOk = false;
+                break;
+            }
+
+            QString tableD = id + "_D";
+            QString tableH = id + "_H";
+            if (! qry.exec(QString("CREATE TABLE `%1` (date_time TEXT(10), id_variable INTEGER, value REAL, "
+                                   "PRIMARY KEY(date_time, id_variable))").arg(tableD))
+                || ! qry.exec(QString("CREATE TABLE `%1` (date_time TEXT(19), id_variable INTEGER, value REAL, "
+                                      "PRIMARY KEY(date_time, id_variable))").arg(tableH)))
+            {
+                errorStr = qry.lastError().text();
+                isOk = false;
+                break;
+            }
+
+            QSqlQuery insertD(db);
+            insertD.prepare(QString("INSERT INTO `%1` (date_time, id_variable, value) VALUES (?, ?, ?)").arg(tableD));
+            QSqlQuery insertH(db);
+            insertH.prepare(QString("INSERT INTO `%1` (date_time, id_variable, value) VALUES (?, ?, ?)").arg(tableH));
+
+            for (QDate date = firstDate; isOk && date <= lastDate; date = date.addDays(1))
+            {
+                double tMin, tAvg, tMax;
+                dailyTemperature(date.dayOfYear(), elevation, generator, tMin, tAvg, tMax);
+                double prec = dailyPrecipitation(generator);
+
+                QString dateStr = date.toString("yyyy-MM-dd");
+                const int dailyIds[4] = {151, 153, 152, 154};
+                const double dailyValues[4] = {tMin, tAvg, tMax, prec};
+                for (int j = 0; j < 4; j++)
+                {
+                    insertD.addBindValue(dateStr);
+                    insertD.addBindValue(dailyIds[j]);
+                    insertD.addBindValue(roundValue(dailyValues[j]).toDouble());
+                    if (! insertD.exec())
+                    {
+                        errorStr = insertD.lastError().text();
+                        isOk = false;
+                        break;
+                    }
+                }
+
+                if (! isOk || date.year() != settings.lastYear || date > lastHourlyDate)
+                    continue;
+
+                // hours 01-24 of the day: hour 24 is stored as 00 of the next day
+                for (int hour = 1; hour <= 24; hour++)
+                {
+                    double t = tAvg + 0.5 * (tMax - tMin) * sin(2. * PI * (hour - 9) / 24.);
+                    QString timeStr = QDateTime(date, QTime(0, 0)).addSecs(hour * 3600).toString("yyyy-MM-dd hh:mm:ss");
+
+                    insertH.addBindValue(timeStr);
+                    insertH.addBindValue(101);
+                    insertH.addBindValue(roundValue(t).toDouble());
+                    if (! insertH.exec())
+                    {
+                        errorStr = insertH.lastError().text();
+                        isOk = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (isOk)
+            db.commit();
+
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(BENCHMARK_POINTS_CONNECTION);
+    return isOk;
+}
+
+
+/*!
+ * \brief createSyntheticGridDb
+ * writes the XML grid definition and a SQLite DB with one <id>_d table for each cell
+ * (PragaTime, VariableCode, Value), the same layout of the MySQL grid tables
+ */
+bool createSyntheticGridDb(const BenchmarkDataSettings &settings, const QString &dbName,
+                           const QString &xmlFileName, QString &errorStr)
+{
+    QFile xmlFile(xmlFileName);
+    if (! xmlFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        errorStr = "Open failure: " + xmlFileName + "\n" + xmlFile.errorString();
+        return false;
+    }
+
+    // the connection is required by the parser, the benchmark opens the SQLite file directly
+    QTextStream xml(&xmlFile);
+    xml << "<xml version=\"1.0\" encoding=\"UTF-8\">\n"
+        << "\t<connection>\n"
+        << "\t\t<provider>QSQLITE</provider>\n"
+        << "\t\t<server>localhost</server>\n"
+        << "\t\t<name>" << dbName << "</name>\n"
+        << "\t\t<user>benchmark</user>\n"
+        << "\t\t<password>benchmark</password>\n"
+        << "\t</connection>\n"
+        << "\t<gridstructure isregular=\"true\" isutm=\"false\" istin=\"false\" isfixedfields=\"false\">\n"
+        << "\t\t<xll>11.0</xll>\n"
+        << "\t\t<yll>44.0</yll>\n"
+        << "\t\t<nrows>" << settings.gridRows << "</nrows>\n"
+        << "\t\t<ncols>" << settings.gridCols << "</ncols>\n"
+        << "\t\t<xwidth>0.0625</xwidth>\n"
+        << "\t\t<ywidth>0.045</ywidth>\n"
+        << "\t</gridstructure>\n"
+        << "\t<tabledaily>\n"
+        << "\t\t<postFix>_d</postFix>\n"
+        << "\t\t<fieldtime>PragaTime</fieldtime>\n"
+        << "\t\t<varcode><varcode>1</varcode><varpraganame>DAILY_TMIN</varpraganame></varcode>\n"
+        << "\t\t<varcode><varcode>2</varcode><varpraganame>DAILY_TMAX</varpraganame></varcode>\n"
+        << "\t\t<varcode><varcode>3</varcode><varpraganame>DAILY_PREC</varpraganame></varcode>\n"
+        << "\t\t<varcode><varcode>4</varcode><varpraganame>DAILY_TAVG</varpraganame></varcode>\n"
+        << "\t</tabledaily>\n"
+        << "</xml>\n";
+    xmlFile.close();
+
+    QFile::remove(dbName);
+
+    bool isOk = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", BENCHMARK_GRID_CONNECTION);
+        db.setDatabaseName(dbName);
+        if (! db.open())
+        {
+            errorStr = db.lastError().text();
+            isOk = false;
+        }
+
+        std::mt19937 generator(settings.seed + 2);
+        std::uniform_real_distribution<double> cellElevation(0., 1200.);
+
+        QDate firstDate(settings.firstYear, 1, 1);
+        QDate lastDate(settings.lastYear, 12, 31);
+
+        if (isOk)
+            db.transaction();
+
+        QSqlQuery qry(db);
+        for (int row = 0; isOk && row < settings.gridRows; row++)
+        {
+            for (int col = 0; isOk && col < settings.gridCols; col++)
+            {
+                QString table = getBenchmarkCellId(row, col) + "_d";
+                if (! qry.exec(QString("CREATE TABLE `%1` (PragaTime DATE, VariableCode INTEGER, Value REAL, "
+                                       "PRIMARY KEY(PragaTime, VariableCode))").arg(table)))
+                {
+                    errorStr = qry.lastError().text();
+                    isOk = false;
+                    break;
+                }
+
+                QSqlQuery insert(db);
+                insert.prepare(QString("INSERT INTO `%1` (PragaTime, VariableCode, Value) VALUES (?, ?, ?)").arg(table));
+
+                double elevation = cellElevation(generator);
+                for (QDate date = firstDate; isOk && date <= lastDate; date = date.addDays(1))
+                {
+                    double tMin, tAvg, tMax;
+                    dailyTemperature(date.dayOfYear(), elevation, generator, tMin, tAvg, tMax);
+                    double prec = dailyPrecipitation(generator);
+
+                    QString dateStr = date.toString("yyyy-MM-dd");
+                    const double values[4] = {tMin, tMax, prec, tAvg};
+                    for (int varCode = 1; varCode <= 4; varCode++)
+                    {
+                        insert.addBindValue(dateStr);
+                        insert.addBindValue(varCode);
+                        insert.addBindValue(roundValue(values[varCode-1]).toDouble());
+                        if (! insert.exec())
+                        {
+                            errorStr = insert.lastError().text();
+                            isOk = false;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (isOk)
+            db.commit();
+
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(BENCHMARK_GRID_CONNECTION);
+    return isOk;
+}
@@ -0,0 +1,52 @@
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+    #ifndef GIS_H
+        #include "gis.h"
+    #endif
+
+    #include <QString>
+
+    /*!
+     * \brief settings of the synthetic data set
+     * all generators are seeded: the same settings always produce the same files
+     */
+    struct BenchmarkDataSettings
+    {
+        unsigned int seed;
+
+        // DEM (UTM zone 32)
+        int demRows;
+        int demCols;
+        double cellSize;                // [m]
+        double xllCorner;
+        double yllCorner;
+
+        // meteo points
+        int nrStations;
+        int firstYear;
+        int lastYear;
+        int nrHourlyDays;               // hourly data at the beginning of lastYear
+
+        // meteo grid (lat/lon)
+        int gridRows;
+        int gridCols;
+
+        BenchmarkDataSettings();
+        void setSmall();
+    };
+
+
+    QString getBenchmarkCellId(int row, int col);
+
+    bool createSyntheticDEM(const BenchmarkDataSettings &settings, const QString &fileNameWithoutExt,
+                            gis::Crit3DRasterGrid &dem, QString &errorStr);
+
+    bool createSyntheticPointsDb(const BenchmarkDataSettings &settings, const gis::Crit3DRasterGrid &dem,
+                                 const gis::Crit3DGisSettings &gisSettings, const QString &dbName, QString &errorStr);
+
+    bool createSyntheticGridDb(const BenchmarkDataSettings &settings, const QString &dbName,
+                               const QString &xmlFileName, QString &errorStr);
+
+
+#endif // BENCHMARKDATA_H
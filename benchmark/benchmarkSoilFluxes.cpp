@@ -0,0 +1,109 @@
+#include "benchmarkSoilFluxes.h"
+#include "soilFluxes3D.h"
+
+using namespace soilFluxes3D;
+
+
+/*!
+ * \brief initializeSoilFluxesCase
+ * a tilted square domain: one surface layer and nrLayers soil layers (10 cm) with free drainage at the bottom,
+ * heterogeneous initial matric potential and ponding on some surface nodes
+ */
+bool initializeSoilFluxesCase(int side, int nrLayers, bool isComputeHeat, int nrThreads, QString &errorStr)
+{
+    SF3Duint_t nrSurfaceNodes = SF3Duint_t(side * side);
+    SF3Duint_t nrNodes = nrSurfaceNodes * SF3Duint_t(nrLayers + 1);
+
+    if (initializeSF3D(nrNodes, nrSurfaceNodes, 4, true, isComputeHeat, false) != SF3Derror_t::SF3Dok)
+    {
+        errorStr = "Error in soilFluxes3D initialization.";
+        return false;
+    }
+
+    setThreadsNumber(u32_t(nrThreads));
+    if (isComputeHeat)
+        initializeHeatFlag(heatFluxSaveMode_t::None, false, false);
+
+    setNumericalParameters(1, 600, 200, 10, 8, 6);
+    setHydraulicProperties(WRCModel::ModifiedVanGenuchten, meanType_t::Logarithmic, 10);
+    setSoilProperties(0, 0, 2.0, 1.4, 1. - 1./1.4, 0.01, 0.05, 0.45, 1e-5, 0.5, 0.02, 0.2);
+    setSurfaceProperties(0, 0.24);
+
+    auto nodeIndex = [&](int layer, int row, int col) { return SF3Duint_t(layer * side * side + row * side + col); };
+    const int dRow[4] = {-1, 1, 0, 0};
+    const int dCol[4] = {0, 0, -1, 1};
+
+    for (int layer = 0; layer <= nrLayers; layer++)
+    {
+        for (int row = 0; row < side; row++)
+        {
+            for (int col = 0; col < side; col++)
+            {
+                SF3Duint_t i = nodeIndex(layer, row, col);
+                double z = 0.01 * (row + col) - (layer == 0 ? 0. : 0.05 + 0.1 * (layer - 1));
+
+                if (layer == 0)
+                {
+                    setNode(i, row, col, z, 1., true, boundaryType_t::NoBoundary);
+                    setNodeSurface(i, 0);
+                    setNodePond(i, (row * side + col) % 7 == 0 ? 0.01 : 0.);
+                }
+                else
+                {
+                    boundaryType_t boundary = (layer == nrLayers) ? boundaryType_t::FreeDrainage : boundaryType_t::NoBoundary;
+                    setNode(i, row, col, z, 0.1, false, boundary, 0, 1.);
+                    setNodeSoil(i, 0, 0);
+                    setNodeMatricPotential(i, -1. - 0.05 * ((row * 7 + col * 3 + layer) % 11));
+                }
+
+                if (layer > 0)
+                    setNodeLink(i, nodeIndex(layer - 1, row, col), linkType_t::Up, 1.);
+                if (layer < nrLayers)
+                    setNodeLink(i, nodeIndex(layer + 1, row, col), linkType_t::Down, 1.);
+
+                for (int k = 0; k < 4; k++)
+                {
+                    int r = row + dRow[k];
+                    int c = col + dCol[k];
+                    if (r < 0 || c < 0 || r >= side || c >= side)
+                        continue;
+
+                    setNodeLink(i, nodeIndex(layer, r, c), linkType_t::Lateral, layer == 0 ? 1. : 0.1);
+                }
+
+                if (isComputeHeat)
+                    setNodeTemperature(i, 283.15 + 0.5 * layer + 0.1 * ((row + col) % 5));
+            }
+        }
+    }
+
+    if (initializeBalance() != SF3Derror_t::SF3Dok)
+    {
+        errorStr = "Error in soilFluxes3D water balance initialization.";
+        return false;
+    }
+
+    return true;
+}
+
+
+bool runSoilFluxesCase(int nrHours, double &waterMBR, QString &errorStr)
+{
+    for (int hour = 0; hour < nrHours; hour++)
+        computePeriod(3600);
+
+    waterMBR = getWaterMBR();
+    if (waterMBR != waterMBR)
+    {
+        errorStr = "soilFluxes3D: wrong water balance.";
+        return false;
+    }
+
+    return true;
+}
+
+
+void cleanSoilFluxesCase()
+{
+    cleanSF3D();
+}
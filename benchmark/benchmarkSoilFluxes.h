@@ -0,0 +1,12 @@
+#ifndef BENCHMARKSOILFLUXES_H
+#define BENCHMARKSOILFLUXES_H
+
+    #include <QString>
+
+    // kept apart from the other benchmarks: soilFluxes3D headers define their own types and macros
+    bool initializeSoilFluxesCase(int side, int nrLayers, bool isComputeHeat, int nrThreads, QString &errorStr);
+    bool runSoilFluxesCase(int nrHours, double &waterMBR, QString &errorStr);
+    void cleanSoilFluxesCase();
+
+
+#endif // BENCHMARKSOILFLUXES_H
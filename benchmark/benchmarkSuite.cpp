@@ -0,0 +1,158 @@
+#include "benchmarkSuite.h"
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+
+
+double BenchmarkResult::minimum() const
+{
+    if (seconds.empty()) return 0;
+    return *std::min_element(seconds.begin(), seconds.end());
+}
+
+
+double BenchmarkResult::maximum() const
+{
+    if (seconds.empty()) return 0;
+    return *std::max_element(seconds.begin(), seconds.end());
+}
+
+
+double BenchmarkResult::mean() const
+{
+    if (seconds.empty()) return 0;
+    return std::accumulate(seconds.begin(), seconds.end(), 0.) / double(seconds.size());
+}
+
+
+double BenchmarkResult::median() const
+{
+    if (seconds.empty()) return 0;
+
+    std::vector<double> sorted = seconds;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    if (n % 2 == 1)
+        return sorted[n/2];
+
+    return 0.5 * (sorted[n/2 - 1] + sorted[n/2]);
+}
+
+
+QJsonObject BenchmarkResult::toJson() const
+{
+    QJsonObject obj;
+    obj.insert("name", name);
+    obj.insert("kind", kind);
+    obj.insert("ok", isOk);
+    if (! isOk)
+        obj.insert("error", errorStr);
+
+    obj.insert("repetitions", int(seconds.size()));
+    obj.insert("items", nrItems);
+
+    QJsonArray samples;
+    for (double value : seconds)
+        samples.append(value);
+    obj.insert("seconds", samples);
+
+    obj.insert("min", minimum());
+    obj.insert("median", median());
+    obj.insert("mean", mean());
+    obj.insert("max", maximum());
+
+    double itemsPerSecond = 0;
+    if (nrItems > 0 && median() > 0)
+        itemsPerSecond = nrItems / median();
+    obj.insert("itemsPerSecond", itemsPerSecond);
+
+    return obj;
+}
+
+
+BenchmarkSuite::BenchmarkSuite()
+{
+    _nrRepetitions = 5;
+    _filter = "";
+}
+
+
+bool BenchmarkSuite::isSelected(const QString &name) const
+{
+    if (_filter.isEmpty())
+        return true;
+
+    return name.contains(_filter, Qt::CaseInsensitive);
+}
+
+
+void BenchmarkSuite::run(const QString &name, const QString &kind, int nrItems,
+                         const std::function<bool(QString&)> &test,
+                         const std::function<void()> &setup)
+{
+    if (! isSelected(name))
+        return;
+
+    BenchmarkResult result;
+    result.name = name;
+    result.kind = kind;
+    result.nrItems = nrItems;
+    result.isOk = true;
+
+    std::cout << "running " << name.toStdString() << std::flush;
+
+    for (int i = 0; i < _nrRepetitions; i++)
+    {
+        if (setup != nullptr)
+            setup();
+
+        auto start = std::chrono::steady_clock::now();
+        bool isOk = test(result.errorStr);
+        auto end = std::chrono::steady_clock::now();
+
+        if (! isOk)
+        {
+            result.isOk = false;
+            break;
+        }
+
+        result.seconds.push_back(std::chrono::duration<double>(end - start).count());
+    }
+
+    if (result.isOk)
+        std::cout << "  median: " << result.median() << " s" << std::endl;
+    else
+        std::cout << "  FAILED: " << result.errorStr.toStdString() << std::endl;
+
+    _results.push_back(result);
+}
+
+
+bool BenchmarkSuite::writeJson(const QString &fileName, QString &errorStr) const
+{
+    QJsonObject root = _info;
+    root.insert("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("repetitions", _nrRepetitions);
+
+    QJsonArray benchmarks;
+    for (const BenchmarkResult &result : _results)
+        benchmarks.append(result.toJson());
+    root.insert("benchmarks", benchmarks);
+
+    QFile outputFile(fileName);
+    if (! outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        errorStr = "Open failure: " + fileName + "\n" + outputFile.errorString();
+        return false;
+    }
+
+    outputFile.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    outputFile.close();
+
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef BENCHMARKSUITE_H
+#define BENCHMARKSUITE_H
+
+    #include <algorithm>
+    #include <functional>
+    #include <vector>
+    #include <QString>
+    #include <QJsonObject>
+
+    struct BenchmarkResult
+    {
+        QString name;
+        QString kind;                   // micro or macro
+        int nrItems;                    // items processed in each repetition
+        bool isOk;
+        QString errorStr;
+        std::vector<double> seconds;
+
+        double minimum() const;
+        double median() const;
+        double mean() const;
+        double maximum() const;
+
+        QJsonObject toJson() const;
+    };
+
+
+    class BenchmarkSuite
+    {
+    public:
+        BenchmarkSuite();
+
+        void setRepetitions(int nrRepetitions) { _nrRepetitions = std::max(1, nrRepetitions); }
+        void setFilter(const QString &filter) { _filter = filter; }
+        void setInfo(const QString &key, const QJsonValue &value) { _info.insert(key, value); }
+
+        bool isSelected(const QString &name) const;
+
+        // the test returns false and fills errorStr on failure; setup runs untimed before each repetition
+        void run(const QString &name, const QString &kind, int nrItems,
+                 const std::function<bool(QString&)> &test,
+                 const std::function<void()> &setup = nullptr);
+
+        const std::vector<BenchmarkResult>& results() const { return _results; }
+
+        bool writeJson(const QString &fileName, QString &errorStr) const;
+
+    private:
+        int _nrRepetitions;
+        QString _filter;
+        QJsonObject _info;
+        std::vector<BenchmarkResult> _results;
+    };
+
+
+#endif // BENCHMARKSUITE_H
@@ -0,0 +1,365 @@
+/*!
+ * PRAGAbenchmark
+ * micro and macro benchmarks on synthetic data: interpolation, meteo DB I/O, elaborations,
+ * solar radiation and soilFluxes3D. Results are written in JSON format.
+ */
+
+#include "benchmarkData.h"
+#include "benchmarkSuite.h"
+#include "benchmarkSoilFluxes.h"
+
+#include "project.h"
+#include "climate.h"
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "interpolation.h"
+#include "spatialControl.h"
+#include "solarRadiation.h"
+#include "utilities.h"
+
+#include <iostream>
+#include <random>
+#include <omp.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QSqlDatabase>
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("PRAGAbenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PRAGA benchmark suite on synthetic data");
+    parser.addHelpOption();
+    QCommandLineOption outputOption("output", "JSON output file (default: benchmark.json)", "file", "benchmark.json");
+    QCommandLineOption workDirOption("workdir", "directory for the synthetic data", "dir",
+                                     QDir::temp().filePath("PRAGAbenchmark"));
+    QCommandLineOption repetitionsOption("repetitions", "number of repetitions (default: 5)", "n", "5");
+    QCommandLineOption filterOption("filter", "run only the benchmarks whose name contains this string", "string");
+    QCommandLineOption smallOption("small", "reduced data set");
+    QCommandLineOption serialOption("serial", "disable parallel computing");
+    parser.addOptions({outputOption, workDirOption, repetitionsOption, filterOption, smallOption, serialOption});
+    parser.process(app);
+
+    BenchmarkDataSettings dataSettings;
+    if (parser.isSet(smallOption))
+        dataSettings.setSmall();
+
+    bool isParallelComputing = ! parser.isSet(serialOption);
+
+    QString workDir = QDir(parser.value(workDirOption)).absolutePath();
+    if (! QDir().mkpath(workDir))
+    {
+        std::cout << "Error: cannot create " << workDir.toStdString() << std::endl;
+        return 1;
+    }
+
+    BenchmarkSuite suite;
+    suite.setRepetitions(parser.value(repetitionsOption).toInt());
+    suite.setFilter(parser.value(filterOption));
+    suite.setInfo("seed", int(dataSettings.seed));
+    suite.setInfo("demRows", dataSettings.demRows);
+    suite.setInfo("demCols", dataSettings.demCols);
+    suite.setInfo("nrStations", dataSettings.nrStations);
+    suite.setInfo("firstYear", dataSettings.firstYear);
+    suite.setInfo("lastYear", dataSettings.lastYear);
+    suite.setInfo("gridCells", dataSettings.gridRows * dataSettings.gridCols);
+    suite.setInfo("parallelComputing", isParallelComputing);
+    suite.setInfo("maxThreads", isParallelComputing ? omp_get_max_threads() : 1);
+
+    // synthetic data
+    QString errorStr;
+    QString demFileName = workDir + "/benchmark_dem";
+    QString pointsDbName = workDir + "/benchmark_meteo.db";
+    QString gridDbName = workDir + "/benchmark_grid.db";
+    QString gridXmlName = workDir + "/benchmark_grid.xml";
+
+    std::cout << "Create synthetic data in " << workDir.toStdString() << std::endl;
+
+    gis::Crit3DGisSettings gisSettings;
+    gis::Crit3DRasterGrid syntheticDEM;
+    if (! createSyntheticDEM(dataSettings, demFileName, syntheticDEM, errorStr)
+        || ! createSyntheticPointsDb(dataSettings, syntheticDEM, gisSettings, pointsDbName, errorStr)
+        || ! createSyntheticGridDb(dataSettings, gridDbName, gridXmlName, errorStr))
+    {
+        std::cout << "Error in synthetic data: " << errorStr.toStdString() << std::endl;
+        return 1;
+    }
+
+    // project: elevation proxy, DEM and meteo points
+    Project myProject;
+    myProject.modality = MODE_CONSOLE;
+    myProject.setParallelComputing(isParallelComputing);
+
+    Crit3DProxy proxyElevation;
+    proxyElevation.setName("elevation");
+    proxyElevation.setForQualityControl(true);
+    myProject.addProxyToProject({proxyElevation}, {true}, {1});
+
+    if (! myProject.loadDEM(demFileName + ".flt") || ! myProject.loadMeteoPointsDB(pointsDbName))
+    {
+        std::cout << "Error in project: " << myProject.errorString.toStdString() << std::endl;
+        return 1;
+    }
+
+    QDate firstDate(dataSettings.firstYear, 1, 1);
+    QDate lastDate(dataSettings.lastYear, 12, 31);
+    QDate firstHourlyDate(dataSettings.lastYear, 1, 1);
+    QDate lastHourlyDate = firstHourlyDate.addDays(dataSettings.nrHourlyDays - 1);
+    int nrPoints = int(myProject.meteoPoints.size());
+    int nrYears = dataSettings.lastYear - dataSettings.firstYear + 1;
+    int nrDemCells = myProject.DEM.header->nrRows * myProject.DEM.header->nrCols;
+
+    // DB I/O
+    suite.run("loadMeteoPointsData_hourly", "macro", nrPoints, [&](QString &error)
+    {
+        if (myProject.loadMeteoPointsData(firstHourlyDate, lastHourlyDate, true, false, false))
+            return true;
+        error = "loadMeteoPointsData: no hourly data.";
+        return false;
+    });
+
+    suite.run("loadMeteoPointsData_daily", "macro", nrPoints, [&](QString &error)
+    {
+        if (myProject.loadMeteoPointsData(firstDate, lastDate, false, true, false))
+            return true;
+        error = "loadMeteoPointsData: no daily data.";
+        return false;
+    });
+
+    // the following benchmarks work on data already in memory
+    if (! myProject.loadMeteoPointsData(firstDate, lastDate, false, true, false)
+        || ! myProject.loadMeteoPointsData(firstHourlyDate, lastHourlyDate, true, false, false))
+    {
+        std::cout << "Error in loading meteo points data." << std::endl;
+        return 1;
+    }
+
+    if (suite.isSelected("loadGridDailyData"))
+    {
+        Crit3DMeteoGridDbHandler gridHandler;
+        if (! gridHandler.parseXMLGrid(gridXmlName, errorStr))
+        {
+            std::cout << "Error in grid XML: " << errorStr.toStdString() << std::endl;
+            return 1;
+        }
+
+        // SQLite connection: openDatabase() supports only the MySQL provider
+        {
+            QSqlDatabase gridDb = QSqlDatabase::addDatabase("QSQLITE", "benchmarkGrid");
+            gridDb.setDatabaseName(gridDbName);
+            if (! gridDb.open())
+            {
+                std::cout << "Error in grid DB: " << gridDbName.toStdString() << std::endl;
+                return 1;
+            }
+            gridHandler.setDb(gridDb);
+        }
+
+        std::vector<QString> cellIdList;
+        for (int row = 0; row < dataSettings.gridRows; row++)
+        {
+            for (int col = 0; col < dataSettings.gridCols; col++)
+            {
+                std::string id = getBenchmarkCellId(row, col).toStdString();
+                double utmX, utmY;
+                gridHandler.meteoGrid()->fillMeteoPoint(unsigned(row), unsigned(col), id, id, "BENCHMARK", 0, true, utmX, utmY);
+                cellIdList.push_back(QString::fromStdString(id));
+            }
+        }
+
+        suite.run("loadGridDailyData", "macro", int(cellIdList.size()), [&](QString &error)
+        {
+            for (const QString &id : cellIdList)
+            {
+                if (! gridHandler.loadGridDailyData(error, id, firstDate, lastDate))
+                    return false;
+            }
+            return true;
+        });
+
+        // also removes the connection
+        gridHandler.closeDatabase();
+    }
+
+    // interpolation
+    Crit3DDate interpolationDate(15, 7, dataSettings.lastYear);
+    Crit3DTime interpolationTime(interpolationDate, 0);
+    gis::Crit3DRasterGrid outputRaster;
+
+    suite.run("interpolationDem_DAILY_TAVG", "macro", nrDemCells, [&](QString &error)
+    {
+        if (myProject.interpolationDem(dailyAirTemperatureAvg, interpolationTime, &outputRaster))
+            return true;
+        error = myProject.errorString;
+        return false;
+    });
+
+    if (suite.isSelected("interpolate_DAILY_TAVG"))
+    {
+        std::vector<Crit3DInterpolationDataPoint> interpolationPoints;
+        std::string errorStdStr;
+        if (! checkAndPassDataToInterpolation(myProject.quality, dailyAirTemperatureAvg, myProject.meteoPoints, interpolationTime,
+                                              myProject.qualityInterpolationSettings, myProject.interpolationSettings,
+                                              myProject.meteoSettings, &(myProject.climateParameters), interpolationPoints,
+                                              myProject.checkSpatialQuality, errorStdStr)
+            || ! preInterpolation(interpolationPoints, myProject.interpolationSettings, myProject.meteoSettings,
+                                  &(myProject.climateParameters), myProject.meteoPoints, dailyAirTemperatureAvg,
+                                  interpolationTime, errorStdStr))
+        {
+            std::cout << "Error in interpolation data: " << errorStdStr << std::endl;
+            return 1;
+        }
+
+        // random DEM cells, proxy values are read before timing
+        const int nrSamples = 20000;
+        std::mt19937 generator(dataSettings.seed + 3);
+        std::uniform_int_distribution<int> randomRow(0, myProject.DEM.header->nrRows - 1);
+        std::uniform_int_distribution<int> randomCol(0, myProject.DEM.header->nrCols - 1);
+
+        std::vector<float> sampleX, sampleY, sampleZ;
+        std::vector<std::vector<double>> sampleProxyValues;
+        while (int(sampleX.size()) < nrSamples)
+        {
+            int row = randomRow(generator);
+            int col = randomCol(generator);
+            float z = myProject.DEM.value[row][col];
+            if (isEqual(z, myProject.DEM.header->flag))
+                continue;
+
+            double x, y;
+            gis::getUtmXYFromRowCol(*(myProject.DEM.header), row, col, &x, &y);
+            std::vector<double> proxyValues;
+            getProxyValuesXY(float(x), float(y), myProject.interpolationSettings, proxyValues);
+
+            sampleX.push_back(float(x));
+            sampleY.push_back(float(y));
+            sampleZ.push_back(z);
+            sampleProxyValues.push_back(proxyValues);
+        }
+
+        suite.run("interpolate_DAILY_TAVG", "micro", nrSamples, [&](QString &error)
+        {
+            int nrValid = 0;
+            for (int i = 0; i < nrSamples; i++)
+            {
+                float value = interpolate(interpolationPoints, myProject.interpolationSettings, myProject.meteoSettings,
+                                          dailyAirTemperatureAvg, sampleX[i], sampleY[i], sampleZ[i],
+                                          sampleProxyValues[i], true);
+                if (! isEqual(value, NODATA))
+                    nrValid++;
+            }
+            if (nrValid > 0)
+                return true;
+            error = "interpolate: no valid values.";
+            return false;
+        });
+    }
+
+    // solar radiation
+    myProject.radSettings.setGisSettings(&(myProject.gisSettings));
+    Crit3DTime radiationTime(interpolationDate, 12 * 3600);
+
+    suite.run("computeRadiationDEM", "macro", nrDemCells, [&](QString &error)
+    {
+        if (radiation::computeRadiationDEM(&(myProject.radSettings), myProject.DEM, myProject.radiationMaps,
+                                           radiationTime, isParallelComputing))
+            return true;
+        error = "Error in computeRadiationDEM.";
+        return false;
+    });
+
+    // elaborations: annual average temperature of each point, data already loaded
+    Crit3DClimate climate;
+    climate.setVariable(dailyAirTemperatureAvg);
+    climate.setElab1("average");
+    climate.setPeriodType(annualPeriod);
+    climate.setGenericPeriodDateStart(QDate(dataSettings.firstYear, 1, 1));
+    climate.setGenericPeriodDateEnd(QDate(dataSettings.firstYear, 12, 31));
+    climate.setNYears(0);
+
+    suite.run("elaborationOnPoint_annualAverage", "macro", nrPoints * nrYears, [&](QString &error)
+    {
+        int nrValid = 0;
+        for (int i = 0; i < nrPoints; i++)
+        {
+            for (int year = dataSettings.firstYear; year <= dataSettings.lastYear; year++)
+            {
+                climate.setYearStart(year);
+                climate.setYearEnd(year);
+                if (elaborationOnPoint(error, myProject.meteoPointsDbHandler, nullptr, &(myProject.meteoPoints[i]),
+                                       &climate, false, QDate(year, 1, 1), QDate(year, 12, 31), false,
+                                       myProject.meteoSettings, true))
+                    nrValid++;
+            }
+        }
+        if (nrValid > 0)
+            return true;
+        error = "elaborationOnPoint: no valid values. " + error;
+        return false;
+    });
+
+    // soilFluxes3D: initialization is not timed
+    int nrThreads = isParallelComputing ? omp_get_max_threads() : 1;
+    QString soilFluxesError;
+    bool isSoilFluxesOk = false;
+
+    const int waterSide = 40;
+    const int waterLayers = 20;
+    suite.run("soilFluxes3D_water", "macro", waterSide * waterSide * (waterLayers + 1), [&](QString &error)
+    {
+        double waterMBR;
+        if (! isSoilFluxesOk)
+        {
+            error = soilFluxesError;
+            return false;
+        }
+        return runSoilFluxesCase(3, waterMBR, error);
+    },
+    [&]()
+    {
+        cleanSoilFluxesCase();
+        isSoilFluxesOk = initializeSoilFluxesCase(waterSide, waterLayers, false, nrThreads, soilFluxesError);
+    });
+
+    const int heatSide = 10;
+    const int heatLayers = 10;
+    suite.run("soilFluxes3D_waterHeat", "macro", heatSide * heatSide * (heatLayers + 1), [&](QString &error)
+    {
+        double waterMBR;
+        if (! isSoilFluxesOk)
+        {
+            error = soilFluxesError;
+            return false;
+        }
+        return runSoilFluxesCase(1, waterMBR, error);
+    },
+    [&]()
+    {
+        cleanSoilFluxesCase();
+        isSoilFluxesOk = initializeSoilFluxesCase(heatSide, heatLayers, true, nrThreads, soilFluxesError);
+    });
+
+    cleanSoilFluxesCase();
+
+    // output
+    QString outputFileName = parser.value(outputOption);
+    if (! suite.writeJson(outputFileName, errorStr))
+    {
+        std::cout << "Error: " << errorStr.toStdString() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results written in " << outputFileName.toStdString() << std::endl;
+
+    for (const BenchmarkResult &result : suite.results())
+    {
+        if (! result.isOk)
+            return 1;
+    }
+
+    return 0;
+}
@@ -26,7 +26,7 @@ INCLUDEPATH +=  ../mapGraphics \
                 ../agrolib/commonDialogs ../agrolib/commonChartElements ../agrolib/inOutDataXML \
                 ../agrolib/waterTable ../agrolib/project ../agrolib/proxyWidget \
                 ../src/phenology ../src/drought ../src/climate ../src/pointStatisticsWidget \
-                ../src/homogeneityWidget ../src/synchronicityWidget ../src/pragaDialogs ../src/pragaProject
+                ../src/homogeneity ../src/homogeneityWidget ../src/synchronicityWidget ../src/pragaDialogs ../src/pragaProject
 
 CONFIG += debug_and_release
 
@@ -41,6 +41,7 @@ CONFIG(debug, debug|release) {
     LIBS += -L../src/pragaDialogs/debug -lpragaDialogs
     LIBS += -L../src/synchronicityWidget/debug -lsynchronicityWidget
     LIBS += -L../src/homogeneityWidget/debug -lhomogeneityWidget
+    LIBS += -L../src/homogeneity/debug -lhomogeneity
     LIBS += -L../src/pointStatisticsWidget/debug -lpointStatisticsWidget
     LIBS += -L../src/climate/debug -lclimate
     LIBS += -L../src/drought/debug -ldrought
@@ -84,6 +85,7 @@ CONFIG(debug, debug|release) {
     LIBS += -L../src/pragaDialogs/release -lpragaDialogs
     LIBS += -L../src/synchronicityWidget/release -lsynchronicityWidget
     LIBS += -L../src/homogeneityWidget/release -lhomogeneityWidget
+    LIBS += -L../src/homogeneity/release -lhomogeneity
     LIBS += -L../src/pointStatisticsWidget/release -lpointStatisticsWidget
     LIBS += -L../src/climate/release -lclimate
     LIBS += -L../src/drought/release -ldrought
@@ -277,41 +277,41 @@ void MainWindow::mouseMove(const QPoint& mapPos)
     {
         int row, col;
         if (meteoGridObj->getRowCol(geoPoint, &row, &col) &&
-            myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+            myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
         {
-            std::string id = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id;
-            std::string name = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->name;
-            QString elev = QString::number(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->point.z);
+            std::string id = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id;
+            std::string name = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->name;
+            QString elev = QString::number(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->point.z);
             switch(currentGridVisualization)
             {
                 case showCurrentVariable:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue;
                     break;
                 }
                 case showCVResidual:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->residual;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->residual;
                     break;
                 }
                 case showElaboration:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->elaboration;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->elaboration;
                     break;
                 }
                 case showAnomalyAbsolute:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomaly;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomaly;
                     break;
                 }
                 case showAnomalyPercentage:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomalyPercentage;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomalyPercentage;
                     break;
                 }
                 case showClimate:
                 {
-                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->climate;
+                    value = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->climate;
                     break;
                 }
                 default:
@@ -525,11 +525,11 @@ void MainWindow::mousePressEvent(QMouseEvent *event)
         // GRID - context menu (solo se caricata, visibile e cella attiva)
         if (meteoGridObj->isLoaded && currentGridVisualization != notShown && meteoGridObj->getRowCol(geoPoint, &row, &col))
         {
-            std::string id = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[unsigned(row)][unsigned(col)]->id;
-            std::string dataset = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[unsigned(row)][unsigned(col)]->dataset;
-            std::string name = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[unsigned(row)][unsigned(col)]->name;
+            std::string id = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(unsigned(row), unsigned(col))->id;
+            std::string dataset = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(unsigned(row), unsigned(col))->dataset;
+            std::string name = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(unsigned(row), unsigned(col))->name;
 
-            if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[unsigned(row)][unsigned(col)]->active)
+            if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(unsigned(row), unsigned(col))->active)
             {
                 QMenu menu;
                 QAction *openMeteoWidget = menu.addAction("Open new meteo widget");
@@ -1037,7 +1037,7 @@ void MainWindow::interpolateDemGUI()
             gis::Crit3DRasterGrid* proxyGrid = myProject.interpolationSettings.getProxy(i)->getGrid();
 
             if (myProject.DEM.isLoaded && proxyGrid != nullptr && proxyGrid->isLoaded)
-                gis::resampleGrid(*proxyGrid, resGrid, myProject.DEM.header, aggrAverage, 0);
+                gis::resampleGrid(*proxyGrid, resGrid, myProject.DEM.header, aggrAverage, 0, myProject.isParallelComputing());
 
             myProxy->setGrid(resGrid);
         }
@@ -1400,6 +1400,49 @@ void MainWindow::on_timeEdit_valueChanged(int myHour)
     }
 
 
+    // extract the data series of all active output points
+    void MainWindow::on_actionNetCDF_ExportOutputPointsSeries_triggered()
+    {
+        if (myProject.outputPoints.empty())
+        {
+            myProject.logWarning("Load output points before.");
+            return;
+        }
+
+        int idVar;
+        QDateTime firstTime, lastTime;
+        if (! netCDF_ExportDataSeries(&(myProject.netCDF), idVar, firstTime, lastTime))
+            return;
+
+        std::vector<gis::Crit3DGeoPoint> geoPoints;
+        std::vector<std::string> pointIds;
+        for (unsigned int i = 0; i < myProject.outputPoints.size(); i++)
+        {
+            if (myProject.outputPoints[i].active)
+            {
+                geoPoints.push_back(gis::Crit3DGeoPoint(myProject.outputPoints[i].latitude, myProject.outputPoints[i].longitude));
+                pointIds.push_back(myProject.outputPoints[i].id);
+            }
+        }
+
+        QString fileName = QFileDialog::getSaveFileName(nullptr, "Save data series", "", "csv files (*.csv)");
+        if (fileName.isEmpty())
+            return;
+
+        std::stringstream buffer;
+        if (! myProject.netCDF.exportPointsDataSeries(idVar, geoPoints, pointIds, getCrit3DTime(firstTime), getCrit3DTime(lastTime), &buffer))
+        {
+            myProject.logError(QString::fromStdString(buffer.str()));
+            return;
+        }
+
+        std::ofstream myFile;
+        myFile.open(fileName.toStdString());
+        myFile << buffer.str();
+        myFile.close();
+    }
+
+
     void MainWindow::on_actionFileMeteogridExportNetcdf_triggered()
     {
         if (! myProject.checkMeteoGridForExport()) return;
@@ -6194,47 +6237,47 @@ void MainWindow::on_actionStatistical_Summary_triggered()
                 for (int row = 0; row < myProject.meteoGridDbHandler->gridStructure().header().nrRows; row++)
                     for (int col = 0; col < myProject.meteoGridDbHandler->gridStructure().header().nrCols; col++)
                     {
-                        if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+                        if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
                         {
                             switch(currentGridVisualization)
                             {
                                 case showCurrentVariable:
                                 {
-                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue != NODATA)
+                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue != NODATA)
                                     {
-                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->currentValue);
+                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->currentValue);
                                     }
                                     break;
                                 }
                                 case showElaboration:
                                 {
-                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->elaboration != NODATA)
+                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->elaboration != NODATA)
                                     {
-                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->elaboration);
+                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->elaboration);
                                     }
                                     break;
                                 }
                                 case showAnomalyAbsolute:
                                 {
-                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomaly != NODATA)
+                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomaly != NODATA)
                                     {
-                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomaly);
+                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomaly);
                                     }
                                     break;
                                 }
                                 case showAnomalyPercentage:
                                 {
-                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomalyPercentage != NODATA)
+                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomalyPercentage != NODATA)
                                     {
-                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->anomalyPercentage);
+                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->anomalyPercentage);
                                     }
                                     break;
                                 }
                                 case showClimate:
                                 {
-                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->climate != NODATA)
+                                    if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->climate != NODATA)
                                     {
-                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->climate);
+                                        validValues.push_back(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->climate);
                                     }
                                     break;
                                 }
@@ -6248,13 +6291,13 @@ void MainWindow::on_actionStatistical_Summary_triggered()
                             {
                                     if (statistics::minList(validValues, int(validValues.size())) == validValues[validValues.size() - 1])
                                 {
-                                    idMin = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id;
-                                    nameMin = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->name;
+                                    idMin = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id;
+                                    nameMin = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->name;
                                 }
                                     if (statistics::maxList(validValues, int(validValues.size())) == validValues[validValues.size() - 1])
                                 {
-                                    idMax = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id;
-                                    nameMax = myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->name;
+                                    idMax = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id;
+                                    nameMax = myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->name;
                                 }
                             }
                         }
@@ -6854,9 +6897,9 @@ void MainWindow::on_actionFileMeteogridData_XMLexport_triggered()
         myProject.updateProgressBar(row);
         for (int col = 0; col < myProject.meteoGridDbHandler->gridStructure().header().nrCols; col++)
         {
-            if (myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active)
+            if (myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
             {
-                    if ( !myProject.loadXMLExportDataGrid(QString::fromStdString(myProject.meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id), myFirstTime, myLastTime ))
+                    if ( !myProject.loadXMLExportDataGrid(QString::fromStdString(myProject.meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id), myFirstTime, myLastTime ))
                     {
                         myProject.logError();
                         myProject.closeProgressBar();
@@ -7028,40 +7071,24 @@ void MainWindow::on_actionWaterTable_computeAllWells_triggered()
         return;
     }
 
-    // clear all waterTable
-    myProject.waterTableList.clear();
-    myProject.setProgressBar("Computing well...", int(myProject.wellPoints.size()));
-
-    for (int i = 0; i < myProject.wellPoints.size(); i++)
+    std::vector<int> computedWellIndex;
+    if (! myProject.waterTableComputeAllWells(computedWellIndex))
     {
-        QString idStr = myProject.wellPoints[i].getId();
-        if (myProject.wellPoints[i].getObsDepthNr() == 0)
-        {
-            myProject.logInfo("The well " + idStr + " has not data. Import data before.");
-            continue;
-        }
-
-        if (! myProject.waterTableComputeSingleWell(i))
-        {
-            myProject.logInfo("Error in computing well: " + idStr);
-            continue;
-        }
-
-        if (myProject.waterTableList.last().getIdWell() == idStr)
-        {
-            QString text = " ID: " + idStr;
-            text += "\n R2: " + QString::number(myProject.waterTableList.last().getR2(),'f', 2);
-            text += "\n H0: " + QString::number(myProject.waterTableList.last().getH0(),'f', 2);
-            text += "\n alpha: " + QString::number(myProject.waterTableList.last().getAlpha(),'f', 2);
-            text += "\n nr. days: " + QString::number(myProject.waterTableList.last().getNrDaysPeriod());
-            text += "\n avg daily CWB: " + QString::number(myProject.waterTableList.last().getAvgDailyCWB(),'f', 2);
-            wellsListObj[i]->SquareObject::setToolTip(text);
-        }
-
-        myProject.updateProgressBar(i);
+        myProject.logError(myProject.errorString);
+        return;
     }
 
-    myProject.closeProgressBar();
+    for (int i = 0; i < myProject.waterTableList.size(); i++)
+    {
+        const WaterTable &waterTable = myProject.waterTableList[i];
+        QString text = " ID: " + waterTable.getIdWell();
+        text += "\n R2: " + QString::number(waterTable.getR2(),'f', 2);
+        text += "\n H0: " + QString::number(waterTable.getH0(),'f', 2);
+        text += "\n alpha: " + QString::number(waterTable.getAlpha(),'f', 2);
+        text += "\n nr. days: " + QString::number(waterTable.getNrDaysPeriod());
+        text += "\n avg daily CWB: " + QString::number(waterTable.getAvgDailyCWB(),'f', 2);
+        wellsListObj[computedWellIndex[i]]->SquareObject::setToolTip(text);
+    }
 
     return;
 }
@@ -117,6 +117,7 @@
             void on_actionFileNetCDF_Open_triggered();
             void on_actionNetCDF_Close_triggered();
             void on_actionNetCDF_ShowMetadata_triggered();
+            void on_actionNetCDF_ExportOutputPointsSeries_triggered();
 
             void on_netCDFButtonVariable_clicked();
             void on_actionFileMeteogridExportNetcdf_triggered();
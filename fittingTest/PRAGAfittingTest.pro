@@ -0,0 +1,38 @@
+#---------------------------------------------------------
+#
+#   PRAGAfittingTest
+#   test of the analytic jacobian of the fitting functions:
+#   derivatives and Marquardt fits are compared with the finite differences
+#   This project is part of ARPA-SIMC/PRAGA distribution
+#
+#---------------------------------------------------------
+
+QT  -= core gui
+
+TARGET = PRAGAfittingTest
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++17
+
+INCLUDEPATH +=  ../agrolib/crit3dDate ../agrolib/mathFunctions
+
+CONFIG += debug_and_release
+
+# parallel computing settings
+include($$absolute_path(../agrolib/parallel.pri))
+
+
+CONFIG(debug, debug|release) {
+    LIBS += -L../agrolib/crit3dDate/debug -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/debug -lmathFunctions
+
+} else {
+    LIBS += -L../agrolib/crit3dDate/release -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/release -lmathFunctions
+}
+
+
+SOURCES += \
+    main.cpp
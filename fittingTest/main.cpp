@@ -0,0 +1,236 @@
+/*!
+ * PRAGAfittingTest
+ * test of the analytic jacobian of the fitting functions: the analytic derivatives are compared
+ * with central finite differences, and the Marquardt fits of the lapse rate piecewise functions
+ * with the fits computed with finite differences, on synthetic temperature profiles.
+ * Returns the number of failed cases.
+ */
+
+#include "commonConstants.h"
+#include "furtherMathFunctions.h"
+
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// deterministic pseudo random numbers (LCG), independent from the platform
+static unsigned long long randomSeed = 1;
+
+static double nextRandom()
+{
+    randomSeed = randomSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return double((randomSeed >> 33) % 1000000) / 1000000.;
+}
+
+
+// the same functions with a different address: getFittingDerivatives returns nullptr
+// and the Marquardt jacobian is computed with finite differences
+static double piecewiseTwoFiniteDiff(double x, std::vector<double> &par)
+{
+    return lapseRatePiecewise_two(x, par);
+}
+
+static double piecewiseThreeFiniteDiff(double x, std::vector<double> &par)
+{
+    return lapseRatePiecewise_three(x, par);
+}
+
+static double piecewiseThreeFreeFiniteDiff(double x, std::vector<double> &par)
+{
+    return lapseRatePiecewise_three_free(x, par);
+}
+
+
+struct FittingCase
+{
+    std::string name;
+    double (*func)(double, std::vector<double>&);
+    double (*finiteDiffFunc)(double, std::vector<double>&);
+    std::vector<double> parametersMin;
+    std::vector<double> parametersMax;
+};
+
+
+static int nrFailures = 0;
+
+static void printResult(const std::string &caseName, bool isOk, const std::string &errorStr)
+{
+    if (isOk)
+    {
+        std::cout << "ok      " << caseName << std::endl;
+    }
+    else
+    {
+        std::cout << "FAILED  " << caseName << "  " << errorStr << std::endl;
+        nrFailures++;
+    }
+}
+
+
+/*!
+ * \brief testDerivatives
+ * analytic derivatives vs central differences, at random points and parameters.
+ * Points near a breakpoint are skipped: the functions are not differentiable there.
+ */
+static void testDerivatives(const FittingCase &fitCase, const std::vector<size_t> &breakpointIndex)
+{
+    fittingDerivatives derivativesFunc = getFittingDerivatives(fitCase.func);
+    if (derivativesFunc == nullptr)
+    {
+        printResult("derivatives " + fitCase.name, false, "no analytic derivatives");
+        return;
+    }
+
+    size_t nrPar = fitCase.parametersMin.size();
+    std::vector<double> par(nrPar), derivatives(nrPar);
+    double maxError = 0;
+    int nrPoints = 0;
+
+    while (nrPoints < 500)
+    {
+        for (size_t k = 0; k < nrPar; k++)
+            par[k] = fitCase.parametersMin[k] + nextRandom() * (fitCase.parametersMax[k] - fitCase.parametersMin[k]);
+
+        // the piecewise functions limit par[2] in place before the derivatives are computed
+        double x = -300 + nextRandom() * 2000;
+        fitCase.func(x, par);
+
+        bool isNearBreakpoint = false;
+        double breakpoint = 0;
+        for (size_t index : breakpointIndex)
+        {
+            breakpoint += par[index];
+            if (fabs(x - breakpoint) < 1)
+                isNearBreakpoint = true;
+        }
+        if (isNearBreakpoint)
+            continue;
+
+        derivativesFunc(x, par, derivatives);
+
+        for (size_t k = 0; k < nrPar; k++)
+        {
+            // the minimum of par[2] is never active here (parametersMin > 10)
+            double h = (fitCase.parametersMax[k] - fitCase.parametersMin[k]) * 1e-6;
+            std::vector<double> parPlus = par;
+            std::vector<double> parMinus = par;
+            parPlus[k] += h;
+            parMinus[k] -= h;
+            double finiteDiff = (fitCase.func(x, parPlus) - fitCase.func(x, parMinus)) / (2*h);
+
+            maxError = std::max(maxError, fabs(derivatives[k] - finiteDiff) / std::max(1., fabs(finiteDiff)));
+        }
+        nrPoints++;
+    }
+
+    printResult("derivatives " + fitCase.name, maxError < 1e-6, "max error " + std::to_string(maxError));
+}
+
+
+/*!
+ * \brief testFitting
+ * Marquardt multi-start fits with the analytic jacobian vs finite differences,
+ * on noisy profiles with a thermal inversion.
+ * The fits are not bitwise identical: the parameters are compared as a fraction of their range.
+ */
+static void testFitting(const FittingCase &fitCase, int nrTrials)
+{
+    if (getFittingDerivatives(fitCase.finiteDiffFunc) != nullptr)
+    {
+        printResult("fitting " + fitCase.name, false, "analytic derivatives on the finite differences function");
+        return;
+    }
+
+    size_t nrPar = fitCase.parametersMin.size();
+    double maxParameterDiff = 0;
+    double maxR2Diff = 0;
+
+    for (int trial = 0; trial < nrTrials; trial++)
+    {
+        std::vector<double> x, y, weights;
+        double inversionHeight = 200 + nextRandom() * 600;
+        double t0 = 10 + nextRandom() * 5;
+        for (int i = 0; i < 60; i++)
+        {
+            double z = nextRandom() * 1500;
+            double t;
+            if (z < inversionHeight)
+                t = t0 + 0.002 * z;
+            else
+                t = t0 + 0.002 * inversionHeight - 0.0065 * (z - inversionHeight);
+
+            x.push_back(z);
+            y.push_back(t + (nextRandom() - 0.5) * 0.8);
+            weights.push_back(0.5 + nextRandom());
+        }
+
+        std::vector<double> parametersDelta;
+        for (size_t k = 0; k < nrPar; k++)
+            parametersDelta.push_back((fitCase.parametersMax[k] - fitCase.parametersMin[k]) * 1e-6);
+
+        std::vector<std::vector<double>> firstGuessCombinations;
+        for (int i = 0; i < 3; i++)
+        {
+            std::vector<double> firstGuess;
+            for (size_t k = 0; k < nrPar; k++)
+                firstGuess.push_back(fitCase.parametersMin[k] + (fitCase.parametersMax[k] - fitCase.parametersMin[k]) * (0.25 + 0.25*i));
+            firstGuessCombinations.push_back(firstGuess);
+        }
+
+        std::vector<double> parametersMin = fitCase.parametersMin;
+        std::vector<double> parametersMax = fitCase.parametersMax;
+
+        std::vector<double> analyticPar = firstGuessCombinations[0];
+        double analyticR2 = interpolation::bestFittingMarquardt_nDimension(fitCase.func, 3, parametersMin, parametersMax,
+                                analyticPar, parametersDelta, 200, 1e-4, 0.001, x, y, weights, firstGuessCombinations);
+
+        std::vector<double> finiteDiffPar = firstGuessCombinations[0];
+        double finiteDiffR2 = interpolation::bestFittingMarquardt_nDimension(fitCase.finiteDiffFunc, 3, parametersMin, parametersMax,
+                                finiteDiffPar, parametersDelta, 200, 1e-4, 0.001, x, y, weights, firstGuessCombinations);
+
+        for (size_t k = 0; k < nrPar; k++)
+        {
+            double range = fitCase.parametersMax[k] - fitCase.parametersMin[k];
+            maxParameterDiff = std::max(maxParameterDiff, fabs(analyticPar[k] - finiteDiffPar[k]) / range);
+        }
+        maxR2Diff = std::max(maxR2Diff, fabs(analyticR2 - finiteDiffR2));
+    }
+
+    std::string errorStr = "max parameter difference " + std::to_string(maxParameterDiff)
+                           + " max R2 difference " + std::to_string(maxR2Diff);
+    bool isOk = (maxParameterDiff < 0.005 && maxR2Diff < 0.0001);
+    printResult("fitting " + fitCase.name + " (" + errorStr + ")", isOk, errorStr);
+}
+
+
+int main()
+{
+    std::vector<FittingCase> fitCases = {
+        {"piecewise two", lapseRatePiecewise_two, piecewiseTwoFiniteDiff,
+            {-200, -20, -0.01, -0.015}, {1500, 40, 0.015, 0.001}},
+        {"piecewise three", lapseRatePiecewise_three, piecewiseThreeFiniteDiff,
+            {-200, -20, 50, -0.015, -0.015}, {1500, 40, 1000, 0.015, 0.015}},
+        {"piecewise three free", lapseRatePiecewise_three_free, piecewiseThreeFreeFiniteDiff,
+            {-200, -20, 50, -0.015, -0.015, -0.015}, {1500, 40, 1000, 0.015, 0.015, 0.015}}
+    };
+
+    // breakpoints: par[0], and par[0] + par[2] for the three pieces functions
+    const std::vector<std::vector<size_t>> breakpointIndex = {{0}, {0, 2}, {0, 2}};
+
+    randomSeed = 7;
+    for (size_t i = 0; i < fitCases.size(); i++)
+        testDerivatives(fitCases[i], breakpointIndex[i]);
+
+    FittingCase linearCase = {"linear intercept", functionLinear_intercept, nullptr, {-10, -100}, {10, 100}};
+    testDerivatives(linearCase, {});
+
+    randomSeed = 11;
+    for (const FittingCase &fitCase : fitCases)
+        testFitting(fitCase, 40);
+
+    std::cout << std::endl << nrFailures << " failed cases" << std::endl;
+    return nrFailures;
+}
@@ -0,0 +1,45 @@
+#---------------------------------------------------------
+#
+#   PRAGAgisTest
+#   regression test of the parallel resampleGrid and mapAlgebra:
+#   the outputs are compared with the serial reference implementation on synthetic rasters
+#   This project is part of ARPA-SIMC/PRAGA distribution
+#
+#---------------------------------------------------------
+
+QT  -= core gui
+
+TARGET = PRAGAgisTest
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++17
+
+INCLUDEPATH +=  ../agrolib/crit3dDate ../agrolib/mathFunctions ../agrolib/gis
+
+CONFIG += debug_and_release
+
+# parallel computing settings
+include($$absolute_path(../agrolib/parallel.pri))
+
+
+CONFIG(debug, debug|release) {
+    LIBS += -L../agrolib/gis/debug -lgis
+    LIBS += -L../agrolib/crit3dDate/debug -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/debug -lmathFunctions
+
+} else {
+    LIBS += -L../agrolib/gis/release -lgis
+    LIBS += -L../agrolib/crit3dDate/release -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/release -lmathFunctions
+}
+
+
+SOURCES += \
+    gisReference.cpp \
+    main.cpp
+
+
+HEADERS  += \
+    gisReference.h
@@ -0,0 +1,202 @@
+/*!
+ * gisReference
+ * serial implementations of mapAlgebra and resampleGrid before the parallel version
+ */
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "statistics.h"
+#include "gisReference.h"
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace gisReference
+{
+    bool mapAlgebra(gis::Crit3DRasterGrid* map1, gis::Crit3DRasterGrid* map2,
+                    gis::Crit3DRasterGrid* outputMap, operationType myOperation)
+    {
+        if (! map1 || ! map2 || ! outputMap)
+            return false;
+
+        bool isSameHeader = false;
+        if ( *(map1->header) == *(map2->header) )
+            isSameHeader = true;
+
+        if (! outputMap->initializeGrid(*(map1->header)))
+            return false;
+
+        float x, y;
+        for (int row=0; row < outputMap->header->nrRows; ++row)
+            for (int col=0; col < outputMap->header->nrCols; ++col)
+            {
+                x = map1->value[row][col];
+                if (! isEqual(x, map1->header->flag))
+                {
+                    if (isSameHeader)
+                    {
+                        y = map2->value[row][col];
+                    }
+                    else
+                    {
+                        double utmx, utmy;
+                        map1->getXY(row, col, utmx, utmy);
+                        y = map2->getValueFromXY(utmx, utmy);
+                    }
+
+                    if (! isEqual(y, map2->header->flag))
+                    {
+                        if (myOperation == operationMin)
+                            outputMap->value[row][col] = std::min(x, y);
+                        else if (myOperation == operationMax)
+                            outputMap->value[row][col] = std::max(x, y);
+                        else if (myOperation == operationSum)
+                            outputMap->value[row][col] = (x + y);
+                        else if (myOperation == operationSubtract)
+                            outputMap->value[row][col] = (x - y);
+                        else if (myOperation == operationProduct)
+                            outputMap->value[row][col] = (x * y);
+                        else if (myOperation == operationDivide)
+                        {
+                            // tests y: the original tested map2->value[row][col], wrong with different headers
+                            if (y != 0.f)
+                                outputMap->value[row][col] = (x / y);
+                        }
+                    }
+                }
+            }
+
+        return true;
+    }
+
+
+    bool mapAlgebra(gis::Crit3DRasterGrid* map1, float myValue,
+                    gis::Crit3DRasterGrid* outputMap, operationType myOperation)
+    {
+        if (outputMap == nullptr || map1 == nullptr) return false;
+        if (! (*(map1->header) == *(outputMap->header))) return false;
+
+        for (int row=0; row<outputMap->header->nrRows; row++)
+            for (int col=0; col<outputMap->header->nrCols; col++)
+            {
+                if (! isEqual(map1->value[row][col], map1->header->flag))
+                {
+                    if (myOperation == operationMin)
+                        outputMap->value[row][col] = MINVALUE(map1->value[row][col], myValue);
+                    else if (myOperation == operationMax)
+                        outputMap->value[row][col] = MAXVALUE(map1->value[row][col], myValue);
+                    else if (myOperation == operationSum)
+                        outputMap->value[row][col] = (map1->value[row][col] + myValue);
+                    else if (myOperation == operationSubtract)
+                        outputMap->value[row][col] = (map1->value[row][col] - myValue);
+                    else if (myOperation == operationProduct)
+                        outputMap->value[row][col] = (map1->value[row][col] * myValue);
+                    else if (myOperation == operationDivide)
+                    {
+                        if (myValue != 0.f)
+                            outputMap->value[row][col] = (map1->value[row][col] / myValue);
+                        else
+                            return false;
+                    }
+                }
+            }
+
+        return true;
+    }
+
+
+    void resampleGrid(const gis::Crit3DRasterGrid& oldGrid, gis::Crit3DRasterGrid* newGrid,
+                      gis::Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold)
+    {
+        *(newGrid->header) = *newHeader;
+
+        double resampleFactor = newGrid->header->cellSize / oldGrid.header->cellSize;
+
+        int row, col, tmpRow, tmpCol, nrValues;
+        gis::Crit3DPoint myLL, myUR;
+        std::vector<float> values;
+
+        newGrid->initializeGrid();
+
+        for (row = 0; row < newGrid->header->nrRows; row++)
+            for (col = 0; col < newGrid->header->nrCols; col++)
+            {
+                // initialize
+                newGrid->value[row][col] = newGrid->header->flag;
+                float value = NODATA;
+
+                if (resampleFactor <= 1. || elab == aggrCenter)
+                {
+                    double x, y;
+                    newGrid->getXY(row, col, x, y);
+                    oldGrid.getRowCol(x, y, tmpRow, tmpCol);
+                    if (! gis::isOutOfGridRowCol(tmpRow, tmpCol, oldGrid))
+                    {
+                        float tmpValue = oldGrid.value[tmpRow][tmpCol];
+                        if (! isEqual(tmpValue, oldGrid.header->flag))
+                            value = tmpValue;
+                    }
+                }
+                else
+                {
+                    int nrStep = int(floor(resampleFactor)) + 1;
+                    double step = newGrid->header->cellSize / nrStep;
+                    double halfStep = step * 0.5;
+
+                    double x0, y0;
+                    newGrid->getXY(row, col, x0, y0);
+                    myLL.utm.x = x0 - (newGrid->header->cellSize / 2) + halfStep;
+                    myLL.utm.y = y0 - (newGrid->header->cellSize / 2) + halfStep;
+                    myUR.utm.x = x0 + (newGrid->header->cellSize / 2) - halfStep;
+                    myUR.utm.y = y0 + (newGrid->header->cellSize / 2) - halfStep;
+
+                    values.clear();
+                    int maxNrValues = 0;
+                    for (int i = 0; i < nrStep; i++)
+                    {
+                        double x = myLL.utm.x + step * i;
+                        for (int j = 0; j < nrStep; j++)
+                        {
+                            double y = myLL.utm.y + step * j;
+                            float tmpValue = gis::getValueFromXY(oldGrid, x, y);
+                            if (! isEqual(tmpValue, oldGrid.header->flag))
+                            {
+                                values.push_back(tmpValue);
+                            }
+                            maxNrValues++;
+                        }
+                    }
+                    nrValues = int(values.size());
+
+                    if (maxNrValues > 0)
+                    {
+                        if ((float(nrValues) / float(maxNrValues)) > nodataRatioThreshold)
+                        {
+                            if (elab == aggrAverage)
+                                value = statistics::mean(values);
+                            else if (elab == aggrMedian)
+                                value = sorting::percentile(values, nrValues, 50, true);
+                            else if (elab == aggrPrevailing)
+                            {
+                                int nrMissing = maxNrValues - nrValues;
+                                if (nrMissing < nrValues)
+                                {
+                                    value = gis::prevailingValue(values);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if (! isEqual(value, NODATA))
+                {
+                    newGrid->value[row][col] = value;
+                }
+            }
+
+        gis::updateMinMaxRasterGrid(newGrid);
+        newGrid->isLoaded = true;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef GISREFERENCE_H
+#define GISREFERENCE_H
+
+    #ifndef GIS_H
+        #include "gis.h"
+    #endif
+
+    /*!
+     * serial implementations of resampleGrid and mapAlgebra before the parallel version,
+     * used as reference for the regression test
+     */
+    namespace gisReference
+    {
+        bool mapAlgebra(gis::Crit3DRasterGrid* map1, gis::Crit3DRasterGrid* map2,
+                        gis::Crit3DRasterGrid* outputMap, operationType myOperation);
+        bool mapAlgebra(gis::Crit3DRasterGrid* map1, float myValue,
+                        gis::Crit3DRasterGrid* outputMap, operationType myOperation);
+
+        void resampleGrid(const gis::Crit3DRasterGrid& oldGrid, gis::Crit3DRasterGrid* newGrid,
+                          gis::Crit3DRasterHeader* newHeader, aggregationMethod elab, float nodataRatioThreshold);
+    }
+
+
+#endif // GISREFERENCE_H
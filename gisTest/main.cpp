@@ -0,0 +1,272 @@
+/*!
+ * PRAGAgisTest
+ * regression test of gis::mapAlgebra and gis::resampleGrid (serial and parallel)
+ * against the serial reference implementation, on synthetic rasters.
+ * Returns the number of failed cases.
+ */
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "gis.h"
+#include "gisReference.h"
+
+#include <math.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+
+
+// deterministic pseudo random numbers (LCG), independent from the platform
+static unsigned long long randomSeed = 1;
+
+static float nextRandom()
+{
+    randomSeed = randomSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return float((randomSeed >> 33) % 1000000) / 1000000.f;
+}
+
+
+static gis::Crit3DRasterHeader buildHeader(int nrRows, int nrCols, double cellSize, double llx, double lly)
+{
+    gis::Crit3DRasterHeader header;
+    header.nrRows = nrRows;
+    header.nrCols = nrCols;
+    header.cellSize = cellSize;
+    header.invCellSize = 1. / cellSize;
+    header.flag = NODATA;
+    header.llCorner.x = llx;
+    header.llCorner.y = lly;
+    return header;
+}
+
+
+/*!
+ * \brief buildGrid
+ * random values in [0, 100) with a nodata ratio, or integer classes in [0, nrClasses)
+ * with some zero values (division test)
+ */
+static void buildGrid(gis::Crit3DRasterGrid &grid, const gis::Crit3DRasterHeader &header,
+                      unsigned long long seed, float nodataRatio, int nrClasses)
+{
+    randomSeed = seed;
+    grid.initializeGrid(header);
+
+    for (int row = 0; row < header.nrRows; row++)
+    {
+        for (int col = 0; col < header.nrCols; col++)
+        {
+            if (nextRandom() < nodataRatio)
+                continue;
+
+            float value = nextRandom();
+            if (nrClasses > 0)
+                grid.value[row][col] = floor(value * nrClasses);
+            else if (value < 0.05f)
+                grid.value[row][col] = 0.f;
+            else
+                grid.value[row][col] = value * 100.f;
+        }
+    }
+
+    gis::updateMinMaxRasterGrid(&grid);
+    grid.isLoaded = true;
+}
+
+
+static bool isSameGrid(const gis::Crit3DRasterGrid &first, const gis::Crit3DRasterGrid &second, std::string &errorStr)
+{
+    if (! (*(first.header) == *(second.header)))
+    {
+        errorStr = "different header";
+        return false;
+    }
+
+    for (int row = 0; row < first.header->nrRows; row++)
+    {
+        for (int col = 0; col < first.header->nrCols; col++)
+        {
+            float x = first.value[row][col];
+            float y = second.value[row][col];
+            // bitwise equality: the same operations are expected in the same order
+            if (memcmp(&x, &y, sizeof(float)) != 0 && ! (isnan(x) && isnan(y)))
+            {
+                errorStr = "row " + std::to_string(row) + " col " + std::to_string(col)
+                           + ": " + std::to_string(x) + " != " + std::to_string(y);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+static int nrFailures = 0;
+
+static void printResult(const std::string &caseName, bool isOk, const std::string &errorStr)
+{
+    if (isOk)
+    {
+        std::cout << "ok      " << caseName << std::endl;
+    }
+    else
+    {
+        std::cout << "FAILED  " << caseName << "  " << errorStr << std::endl;
+        nrFailures++;
+    }
+}
+
+
+static const std::string operationName[] = {"min", "max", "sum", "subtract", "product", "divide"};
+
+
+static void testMapAlgebraMaps(gis::Crit3DRasterGrid &map1, gis::Crit3DRasterGrid &map2, const std::string &mapsName)
+{
+    for (int i = operationMin; i <= operationDivide; i++)
+    {
+        operationType operation = operationType(i);
+        gis::Crit3DRasterGrid refMap, serialMap, parallelMap;
+
+        bool refResult = gisReference::mapAlgebra(&map1, &map2, &refMap, operation);
+
+        for (int k = 0; k < 2; k++)
+        {
+            bool isParallel = (k == 1);
+            gis::Crit3DRasterGrid* outMap = isParallel ? &parallelMap : &serialMap;
+            bool result = gis::mapAlgebra(&map1, &map2, outMap, operation, isParallel);
+
+            std::string errorStr;
+            bool isOk = (result == refResult);
+            if (! isOk)
+                errorStr = "different result";
+            else if (result)
+                isOk = isSameGrid(refMap, *outMap, errorStr);
+
+            printResult("mapAlgebra " + mapsName + " " + operationName[i] + (isParallel ? " parallel" : " serial"),
+                        isOk, errorStr);
+        }
+    }
+}
+
+
+static void testMapAlgebraValue(gis::Crit3DRasterGrid &map1, float value)
+{
+    for (int i = operationMin; i <= operationDivide; i++)
+    {
+        operationType operation = operationType(i);
+        gis::Crit3DRasterGrid refMap, serialMap, parallelMap;
+        refMap.initializeGrid(*(map1.header));
+        serialMap.initializeGrid(*(map1.header));
+        parallelMap.initializeGrid(*(map1.header));
+
+        bool refResult = gisReference::mapAlgebra(&map1, value, &refMap, operation);
+
+        for (int k = 0; k < 2; k++)
+        {
+            bool isParallel = (k == 1);
+            gis::Crit3DRasterGrid* outMap = isParallel ? &parallelMap : &serialMap;
+            bool result = gis::mapAlgebra(&map1, value, outMap, operation, isParallel);
+
+            // on failure (division by zero) the reference leaves a partial output: only the result is compared
+            std::string errorStr;
+            bool isOk = (result == refResult);
+            if (! isOk)
+                errorStr = "different result";
+            else if (result)
+                isOk = isSameGrid(refMap, *outMap, errorStr);
+
+            printResult("mapAlgebra value " + std::to_string(value) + " " + operationName[i]
+                            + (isParallel ? " parallel" : " serial"), isOk, errorStr);
+        }
+    }
+}
+
+
+static void testResample(const gis::Crit3DRasterGrid &oldGrid, double factor, double shift, aggregationMethod elab,
+                         const std::string &elabName, float nodataRatioThreshold)
+{
+    const gis::Crit3DRasterHeader* oldHeader = oldGrid.header;
+    double cellSize = oldHeader->cellSize * factor;
+
+    // the new grid exceeds the old one: border cells are partially or completely out of grid
+    double llx = oldHeader->llCorner.x - shift * cellSize;
+    double lly = oldHeader->llCorner.y - shift * cellSize;
+    int nrRows = int(ceil(oldHeader->nrRows * oldHeader->cellSize / cellSize)) + 1;
+    int nrCols = int(ceil(oldHeader->nrCols * oldHeader->cellSize / cellSize)) + 1;
+    gis::Crit3DRasterHeader newHeader = buildHeader(nrRows, nrCols, cellSize, llx, lly);
+
+    gis::Crit3DRasterGrid refGrid, serialGrid, parallelGrid;
+    gisReference::resampleGrid(oldGrid, &refGrid, &newHeader, elab, nodataRatioThreshold);
+
+    for (int k = 0; k < 2; k++)
+    {
+        bool isParallel = (k == 1);
+        gis::Crit3DRasterGrid* newGrid = isParallel ? &parallelGrid : &serialGrid;
+        gis::resampleGrid(oldGrid, newGrid, &newHeader, elab, nodataRatioThreshold, isParallel);
+
+        std::string errorStr;
+        bool isOk = isSameGrid(refGrid, *newGrid, errorStr);
+        if (isOk && ! (isEqual(refGrid.minimum, newGrid->minimum) && isEqual(refGrid.maximum, newGrid->maximum)))
+        {
+            isOk = false;
+            errorStr = "different minimum/maximum";
+        }
+
+        printResult("resampleGrid factor " + std::to_string(factor) + " shift " + std::to_string(shift)
+                        + " " + elabName + " threshold " + std::to_string(nodataRatioThreshold)
+                        + (isParallel ? " parallel" : " serial"), isOk, errorStr);
+    }
+}
+
+
+int main()
+{
+    gis::Crit3DRasterHeader header = buildHeader(157, 211, 20., 600000., 4900000.);
+
+    gis::Crit3DRasterGrid map1, map2, shiftedMap, coarseMap;
+    buildGrid(map1, header, 11, 0.1f, 0);
+    buildGrid(map2, header, 23, 0.2f, 0);
+
+    // different headers: shifted by a fraction of cell, and a coarser cell size
+    gis::Crit3DRasterHeader shiftedHeader = buildHeader(157, 211, 20., 600007.5, 4899993.);
+    buildGrid(shiftedMap, shiftedHeader, 37, 0.2f, 0);
+    gis::Crit3DRasterHeader coarseHeader = buildHeader(60, 80, 50., 599990., 4899990.);
+    buildGrid(coarseMap, coarseHeader, 41, 0.1f, 0);
+
+    testMapAlgebraMaps(map1, map2, "same header");
+    testMapAlgebraMaps(map1, shiftedMap, "shifted header");
+    testMapAlgebraMaps(map1, coarseMap, "coarse header");
+
+    testMapAlgebraValue(map1, 3.5f);
+    testMapAlgebraValue(map1, -2.f);
+    testMapAlgebraValue(map1, 0.f);
+
+    // division by zero on an empty map is not an error
+    gis::Crit3DRasterGrid emptyMap;
+    buildGrid(emptyMap, header, 53, 1.1f, 0);
+    testMapAlgebraValue(emptyMap, 0.f);
+
+    gis::Crit3DRasterGrid classMap;
+    buildGrid(classMap, header, 67, 0.3f, 5);
+
+    const double factors[] = {0.5, 1., 2.5, 4.};
+    const double shifts[] = {0., 0.37};
+    const float thresholds[] = {0.f, 0.5f};
+
+    for (double factor : factors)
+    {
+        for (double shift : shifts)
+        {
+            for (float threshold : thresholds)
+            {
+                testResample(map1, factor, shift, aggrAverage, "average", threshold);
+                testResample(map1, factor, shift, aggrMedian, "median", threshold);
+                testResample(map1, factor, shift, aggrCenter, "center", threshold);
+                testResample(classMap, factor, shift, aggrPrevailing, "prevailing", threshold);
+            }
+        }
+    }
+
+    std::cout << std::endl << nrFailures << " failed cases" << std::endl;
+    return nrFailures;
+}
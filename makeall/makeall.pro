@@ -7,7 +7,7 @@ SUBDIRS =       ../agrolib/crit3dDate  ../agrolib/mathFunctions  ../agrolib/gis
                 ../agrolib/commonDialogs ../agrolib/commonChartElements ../agrolib/inOutDataXML  \
                 ../agrolib/meteoWidget ../agrolib/proxyWidget ../agrolib/graphics ../agrolib/project  \
                 ../src/phenology ../src/climate ../src/drought  ../src/pointStatisticsWidget     \
-                ../src/homogeneityWidget ../src/synchronicityWidget ../src/pragaDialogs ../src/pragaProject \
+                ../src/homogeneity ../src/homogeneityWidget ../src/synchronicityWidget ../src/pragaDialogs ../src/pragaProject \
                 ../bin/PRAGA.pro
 
 CONFIG += ordered
@@ -0,0 +1,12 @@
+TEMPLATE = subdirs
+
+SUBDIRS =       ../agrolib/crit3dDate  ../agrolib/mathFunctions  ../agrolib/gis         \
+                ../agrolib/meteo  ../agrolib/interpolation  ../agrolib/solarRadiation   \
+                ../agrolib/utilities  ../agrolib/outputPoints  ../agrolib/dbMeteoPoints \
+                ../agrolib/dbMeteoGrid ../agrolib/waterTable ../agrolib/commonDialogs   \
+                ../agrolib/commonChartElements ../agrolib/meteoWidget ../agrolib/proxyWidget \
+                ../agrolib/project ../agrolib/soilFluxes3D  \
+                ../src/phenology ../src/climate \
+                ../benchmark/PRAGAbenchmark.pro
+
+CONFIG += ordered
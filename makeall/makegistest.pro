@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS =       ../agrolib/crit3dDate  ../agrolib/mathFunctions  ../agrolib/gis  \
+                ../gisTest/PRAGAgisTest.pro
+
+CONFIG += ordered
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS =       ../agrolib/crit3dDate  ../agrolib/mathFunctions  ../agrolib/gis  \
+                ../agrolib/shapeHandler  ../agrolib/shapeUtilities               \
+                ../zonalStatisticTest/PRAGAzonalStatisticTest.pro
+
+CONFIG += ordered
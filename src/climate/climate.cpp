@@ -250,6 +250,120 @@ bool passingClimateToAnomalyGrid(QString &errorStr, Crit3DMeteoPoint* meteoPoint
 }
 
 
+// dates of the data needed by a climate elaboration
+void getClimatePeriodDates(climatePeriod periodType, int yearStart, int yearEnd, const QDate &genericDateStart,
+                           const QDate &genericDateEnd, int nYears, int offset, QDate &startDate, QDate &endDate)
+{
+    if (periodType == genericPeriod)
+    {
+        startDate.setDate(yearStart, genericDateStart.month(), genericDateStart.day());
+        endDate.setDate(yearEnd + nYears, genericDateEnd.month(), genericDateEnd.day());
+    }
+    else if (periodType == seasonalPeriod)
+    {
+        startDate.setDate(yearStart -1, 12, 1);
+        endDate.setDate(yearEnd, 12, 31);
+    }
+    else
+    {
+        startDate.setDate(yearStart, 1, 1);
+        endDate.setDate(yearEnd, 12, 31);
+        if (offset != 0) //if period != daily, offset is always 0
+        {
+            startDate = startDate.addDays(offset);
+            endDate = endDate.addDays(offset);
+        }
+    }
+}
+
+
+// group the elaborations of the list by loaded series (see TClimateElabGroup)
+// the order of the elaborations is kept inside each group
+void planElaborationList(const Crit3DElabList &listElab, std::vector<TClimateElabGroup> &groups)
+{
+    groups.clear();
+
+    for (int i = 0; i < listElab.listAll().size(); i++)
+    {
+        meteoVariable variable = listElab.listVariable()[i];
+        QString elab1 = listElab.listElab1()[i];
+        meteoComputation elab1MeteoComp = getMeteoCompFromString(MapMeteoComputation, elab1.toStdString());
+
+        QString loadElab1 = "";
+        if (elab1MeteoComp == correctedDegreeDaysSum || elab1MeteoComp == huglin
+            || elab1MeteoComp == winkler || elab1MeteoComp == fregoni)
+        {
+            loadElab1 = elab1;
+        }
+
+        QDate startDate, endDate;
+        getClimatePeriodDates(listElab.listPeriodType()[i], listElab.listYearStart()[i], listElab.listYearEnd()[i],
+                              listElab.listDateStart()[i], listElab.listDateEnd()[i], listElab.listNYears()[i],
+                              listElab.listOffset()[i], startDate, endDate);
+
+        unsigned int g = 0;
+        while (g < groups.size() && (groups[g].variable != variable || groups[g].loadElab1 != loadElab1))
+            g++;
+
+        if (g == groups.size())
+        {
+            TClimateElabGroup newGroup;
+            newGroup.variable = variable;
+            newGroup.loadElab1 = loadElab1;
+            newGroup.firstDate = startDate;
+            newGroup.lastDate = endDate;
+            newGroup.yearStart = listElab.listYearStart()[i];
+            newGroup.yearEnd = listElab.listYearEnd()[i];
+            groups.push_back(newGroup);
+        }
+        else
+        {
+            groups[g].firstDate = std::min(groups[g].firstDate, startDate);
+            groups[g].lastDate = std::max(groups[g].lastDate, endDate);
+            groups[g].yearStart = std::min(groups[g].yearStart, listElab.listYearStart()[i]);
+            groups[g].yearEnd = std::max(groups[g].yearEnd, listElab.listYearEnd()[i]);
+        }
+
+        groups[g].elabIndex.push_back(i);
+    }
+}
+
+
+// copy the elaboration [index] of the list to clima
+void setClimateFromElabList(const Crit3DElabList &listElab, int index, Crit3DClimate* clima)
+{
+    clima->setDailyCumulated(listElab.listDailyCumulated()[index]);
+    clima->setClimateElab(listElab.listAll()[index]);
+    clima->setVariable(listElab.listVariable()[index]);
+    clima->setYearStart(listElab.listYearStart()[index]);
+    clima->setYearEnd(listElab.listYearEnd()[index]);
+    clima->setPeriodStr(listElab.listPeriodStr()[index]);
+    clima->setPeriodType(listElab.listPeriodType()[index]);
+
+    clima->setGenericPeriodDateStart(listElab.listDateStart()[index]);
+    clima->setGenericPeriodDateEnd(listElab.listDateEnd()[index]);
+    clima->setNYears(listElab.listNYears()[index]);
+    clima->setElab1(listElab.listElab1()[index]);
+    clima->setOffset(listElab.listOffset()[index]);
+
+    if (! listElab.listParam1IsClimate()[index])
+    {
+        clima->setParam1IsClimate(false);
+        clima->setParam1(listElab.listParam1()[index]);
+    }
+    else
+    {
+        clima->setParam1IsClimate(true);
+        clima->setParam1ClimateField(listElab.listParam1ClimateField()[index]);
+        int climateIndex = getClimateIndexFromElab(listElab.listDateStart()[index], listElab.listParam1ClimateField()[index]);
+        clima->setParam1ClimateIndex(climateIndex);
+    }
+
+    clima->setElab2(listElab.listElab2()[index]);
+    clima->setParam2(listElab.listParam2()[index]);
+}
+
+
 bool climateOnPoint(QString &errorString, Crit3DMeteoPointsDbHandler* meteoPointsDbHandler, Crit3DMeteoGridDbHandler* meteoGridDbHandler,
                     Crit3DClimate* climate, Crit3DMeteoPoint* meteoPointTemp, std::vector<float> &outputValues,
                     bool isMeteoGrid, const QDate &startDate, const QDate &endDate, bool changeDataSet, Crit3DMeteoSettings* meteoSettings)
@@ -872,7 +986,7 @@ float loadDailyVarSeries(Crit3DMeteoPointsDbHandler *meteoPointsDbHandler,
 
     Crit3DQuality qualityCheck;
     int nrRequestedValues = firstDate.daysTo(lastDate) +1;
-    Crit3DDate currentDate = getCrit3DDate(firstDateDB);
+    Crit3DSerialDate currentDate = getSerialDate(firstDateDB);
     int nrValidValues = 0;
 
     for (unsigned int i = 0; i < dailyValues.size(); i++)
@@ -882,8 +996,8 @@ float loadDailyVarSeries(Crit3DMeteoPointsDbHandler *meteoPointsDbHandler,
         {
             nrValidValues++;
         }
-        meteoPoint->setMeteoPointValueD(currentDate, variable, dailyValues[i]);
-        currentDate = currentDate.addDays(1);
+        meteoPoint->setMeteoPointValueD(meteoPoint->getDailyIndex(currentDate), variable, dailyValues[i]);
+        ++currentDate;
     }
 
     // return data percentage
@@ -1004,25 +1118,26 @@ float loadDailyVarSeries_SaveOutput(Crit3DMeteoPointsDbHandler *meteoPointsDbHan
     }
 
     // fill data
-    Crit3DDate currentCrit3DDate = getCrit3DDate(firstDateDB);
+    Crit3DSerialDate currentDate = getSerialDate(firstDateDB);
     Crit3DQuality qualityCheck;
     int nrValidValues = 0;
     for (unsigned int i = 0; i < dailyValues.size(); i++)
     {
+        int dayIndex = meteoPoint->getDailyIndex(currentDate);
         quality::qualityType qualityT = qualityCheck.syntacticQualitySingleValue(variable, dailyValues[i]);
         if (qualityT == quality::accepted)
         {
-            meteoPoint->setMeteoPointValueD(currentCrit3DDate, variable, dailyValues[i]);
+            meteoPoint->setMeteoPointValueD(dayIndex, variable, dailyValues[i]);
             outputValues.push_back(dailyValues[i]);
             nrValidValues++;
         }
         else
         {
-            meteoPoint->setMeteoPointValueD(currentCrit3DDate, variable, NODATA);
+            meteoPoint->setMeteoPointValueD(dayIndex, variable, NODATA);
             outputValues.push_back(NODATA);
         }
 
-        currentCrit3DDate = currentCrit3DDate.addDays(1);
+        ++currentDate;
     }
 
     // fills the missing final output data
@@ -1044,10 +1159,12 @@ float loadFromMp_SaveOutput(Crit3DMeteoPoint* meteoPoint,
     int nrValidValues = 0;
     int nrRequestedValues = first.daysTo(last) +1;
 
+    std::vector<float> dailyValues;
+    if (! meteoPoint->getDailySeries(variable, getCrit3DDate(first), getCrit3DDate(last), dailyValues))
+        dailyValues.assign(unsigned(nrRequestedValues), NODATA);
 
-    for (QDate myDate = first; myDate<=last; myDate=myDate.addDays(1))
+    for (float value : dailyValues)
     {
-        float value = meteoPoint->getMeteoPointValueD(getCrit3DDate(myDate), variable);
         quality::qualityType qualityT = qualityCheck.syntacticQualitySingleValue(variable, value);
         if (qualityT == quality::accepted)
         {
@@ -1484,12 +1601,12 @@ float computeFregoni(Crit3DMeteoPoint* meteoPoint, Crit3DDate firstDate, Crit3DD
 
     int numberOfDays = difference(firstDate, finishDate) +1;
 
-    Crit3DDate presentDate = firstDate;
+    Crit3DSerialDate presentDate(firstDate);
     for (int i = 0; i < numberOfDays; i++)
     {
-        index = difference(meteoPoint->obsDataD[0].date, presentDate);
+        index = meteoPoint->getDailyIndex(presentDate);
         checkData = false;
-        if (index >= 0 && index < meteoPoint->nrObsDataDaysD)
+        if (index != NODATA)
         {
 
             // TO DO nella versione vb il check prevede anche l'immissione del parametro height
@@ -1513,7 +1630,7 @@ float computeFregoni(Crit3DMeteoPoint* meteoPoint, Crit3DDate firstDate, Crit3DD
             }
             count = count + 1;
         }
-        presentDate = presentDate.addDays(1);
+        ++presentDate;
     }
     if (numberOfDays != 0)
     {
@@ -1834,15 +1951,16 @@ bool elaborateDailyAggrVarFromStartDate(meteoVariable myVar, Crit3DMeteoPoint& m
 {
     outputValues.clear();
 
-    QDate firstObsDate = getQDate(meteoPoint.obsDataD[0].date);
+    Crit3DSerialDate firstSerialDate = getSerialDate(firstDate);
+    int nrDays = firstDate.daysTo(lastDate) + 1;
     Crit3DQuality qualityCheck;
     int nrValidValues = 0;
     float result;
 
-    for (QDate myDate = firstDate; myDate <= lastDate; myDate=myDate.addDays(1))
+    for (int i = 0; i < nrDays; i++)
     {
-        unsigned long index = firstObsDate.daysTo(myDate);
-        if (index >= meteoPoint.obsDataD.size())
+        int index = meteoPoint.getDailyIndex(firstSerialDate.addDays(i));
+        if (index == NODATA)
             break;
 
         switch(myVar)
@@ -1882,7 +2000,7 @@ bool elaborateDailyAggrVarFromStartDate(meteoVariable myVar, Crit3DMeteoPoint& m
             }
             else
             {
-                result = dailyEtpHargreaves(meteoPoint.obsDataD[index].tMin, meteoPoint.obsDataD[index].tMax, getCrit3DDate(myDate), meteoPoint.latitude, meteoSettings);
+                result = dailyEtpHargreaves(meteoPoint.obsDataD[index].tMin, meteoPoint.obsDataD[index].tMax, meteoPoint.obsDataD[index].date, meteoPoint.latitude, meteoSettings);
                 meteoPoint.obsDataD[index].et0_hs = result;
             }
             break;
@@ -2051,16 +2169,26 @@ bool aggregatedHourlyToDaily(meteoVariable myVar, Crit3DMeteoPoint* meteoPoint,
     if (hourlyVar == noMeteoVar || elab == noMeteoComp)
         return false;
 
-    for (date = dateIni; date <= dateFin; date = date.addDays(1))
+    Crit3DSerialDate serialDate(dateIni);
+    for (date = dateIni; date <= dateFin; ++date, ++serialDate)
     {
         dailyValue = NODATA;
         value = NODATA;
         values.clear();
         nValidValues = 0;
 
+        // contiguous values of the day, nullptr for derived variables or missing days
+        const float* dayValues = meteoPoint->getHourlyDayValues(hourlyVar, date);
+        int hourlyDayIndex = meteoPoint->getHourlyDayIndex(date);
+
         for (hour = 1; hour <= 24; hour++)
         {
-            value = meteoPoint->getMeteoPointValueH(date, hour, 0, hourlyVar);
+            int valueIndex = hour * meteoPoint->hourlyFraction - 1;
+            if (dayValues != nullptr)
+                value = dayValues[valueIndex];
+            else
+                value = meteoPoint->getMeteoPointValueH(hourlyDayIndex, valueIndex, hourlyVar);
+
             if (int(value) != NODATA)
             {
                 values.push_back(value);
@@ -2077,7 +2205,7 @@ bool aggregatedHourlyToDaily(meteoVariable myVar, Crit3DMeteoPoint* meteoPoint,
         {
             dailyValue = statisticalElab(elab, param, values, int(values.size()), NODATA);
         }
-        meteoPoint->setMeteoPointValueD(date, myVar, dailyValue);
+        meteoPoint->setMeteoPointValueD(meteoPoint->getDailyIndex(serialDate), myVar, dailyValue);
 
         if (myVar == dailyLeafWetness && dailyValue > 24)
         {
@@ -2179,16 +2307,25 @@ std::vector<float> aggregatedHourlyToDailyList(meteoVariable myVar, Crit3DMeteoP
     if (hourlyVar == noMeteoVar || elab == noMeteoComp)
         return dailyData;
 
-    for (date = dateIni; date <= dateFin; date = date.addDays(1))
+    for (date = dateIni; date <= dateFin; ++date)
     {
         dailyValue = NODATA;
         value = NODATA;
         values.clear();
         nValidValues = 0;
 
+        // contiguous values of the day, nullptr for derived variables or missing days
+        const float* dayValues = meteoPoint->getHourlyDayValues(hourlyVar, date);
+        int hourlyDayIndex = meteoPoint->getHourlyDayIndex(date);
+
         for (hour = 1; hour <= 24; hour++)
         {
-            value = meteoPoint->getMeteoPointValueH(date, hour, 0, hourlyVar);
+            int valueIndex = hour * meteoPoint->hourlyFraction - 1;
+            if (dayValues != nullptr)
+                value = dayValues[valueIndex];
+            else
+                value = meteoPoint->getMeteoPointValueH(hourlyDayIndex, valueIndex, hourlyVar);
+
             if (int(value) != NODATA)
             {
                 values.push_back(value);
@@ -2636,6 +2773,17 @@ void extractValidValues(std::vector<float> &outputValues, float threshold, bool
 }
 
 
+// minimum percentage of valid data of a primary elaboration (shared with the monthly aggregates)
+bool isValidDataPercentage(int nrValidValues, int nrValues, Crit3DMeteoSettings* meteoSettings)
+{
+    if (nrValidValues == 0 || nrValues == 0)
+        return false;
+
+    float validPercentage = (float(nrValidValues) / float(nrValues)) * 100;
+    return (validPercentage >= meteoSettings->getMinimumPercentage());
+}
+
+
 // nYears = 0           same year
 // nYears = -1, +1      beetwen years
 float computeStatistic(std::vector<float> &inputValues, Crit3DMeteoPoint* meteoPoint, Crit3DClimate *clima,
@@ -2755,11 +2903,7 @@ float computeStatistic(std::vector<float> &inputValues, Crit3DMeteoPoint* meteoP
                     }
                 }
 
-                if (nValidValues == 0)
-                    return NODATA;
-
-                float validPercentage = (float(nValidValues) / float(nValues)) * 100;
-                if (validPercentage < meteoSettings->getMinimumPercentage())
+                if (! isValidDataPercentage(nValidValues, nValues, meteoSettings))
                     return NODATA;
 
                 return statisticalElab(elab1, param1, values, nValidValues, meteoSettings->getRainfallThreshold());
@@ -5209,63 +5353,80 @@ bool monthlyAggregateDataSingleCell(Crit3DMeteoGridDbHandler* meteoGridDbHandler
 }
 
 
+/*!
+ * \brief monthlyAggregateDataGrid
+ * monthly aggregation of the daily data of all the active cells of the grid.
+ * The computation is done on copies of the cells (the data loaded on the grid are not modified), in blocks:
+ * the daily data of each block are loaded with multi-table queries, the monthly values are computed
+ * in parallel on the cells and the daily data are released.
+ * The monthly values of the whole grid are saved at the end in a single transaction.
+ */
 bool monthlyAggregateDataGrid(Crit3DMeteoGridDbHandler* meteoGridDbHandler, const QDate &firstDate, const QDate &lastDate,
                               const std::vector<meteoVariable> &dailyMeteoVar, Crit3DMeteoSettings* meteoSettings,
-                              Crit3DQuality *qualityCheck, Crit3DClimateParameters *climateParam, QString &errorStr)
+                              Crit3DQuality *qualityCheck, Crit3DClimateParameters *climateParam,
+                              bool isParallelComputing, QString &errorStr)
 {
+    Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
     int nrMonths = (lastDate.year()-firstDate.year())*12+lastDate.month()-(firstDate.month()-1);
-    bool isMeteoGrid = true;
-    Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
-    float percValue;
-    std::vector<float> outputValues;
-    QList<meteoVariable> meteoVariableList;
+    Crit3DDate firstCrit3DDate = getCrit3DDate(firstDate);
+    Crit3DDate lastCrit3DDate = getCrit3DDate(lastDate);
+
+    std::vector<int> activeCells;
+    meteoGrid->getActiveCells(activeCells);
+
+    // copies of the active cells with the monthly values, and monthly variables computed on each cell
+    std::vector<Crit3DMeteoPoint> cellPoints(activeCells.size());
+    std::vector<QList<meteoVariable>> cellVariableList(activeCells.size());
 
-    for (unsigned row = 0; row < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows); row++)
+    for (unsigned int firstCell = 0; firstCell < activeCells.size(); firstCell += unsigned(MONTHLY_AGGREGATION_BLOCK_CELLS))
     {
-        for (unsigned col = 0; col < unsigned(meteoGridDbHandler->meteoGrid()->gridStructure().header().nrCols); col++)
+        unsigned int lastCell = std::min(firstCell + unsigned(MONTHLY_AGGREGATION_BLOCK_CELLS), unsigned(activeCells.size()));
+
+        std::vector<Crit3DMeteoPoint> blockPoints(lastCell - firstCell);
+        for (unsigned int i = 0; i < blockPoints.size(); i++)
         {
-            meteoVariableList.clear();
-            if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->active)
-            {
-                meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->initializeObsDataM(nrMonths, firstDate.month(), firstDate.year());
-                meteoPointTemp->initializeObsDataM(nrMonths, firstDate.month(), firstDate.year());
-                // copy id to meteoPointTemp
-                meteoPointTemp->id = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->id;
-                meteoPointTemp->latitude = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->latitude;
-                // meteoPointTemp should be init
-                meteoPointTemp->nrObsDataDaysH = 0;
-                meteoPointTemp->nrObsDataDaysD = 0;
+            meteoGrid->cellPointer(activeCells[firstCell + i])->copyPropertiesTo(blockPoints[i]);
+        }
 
-                for(int i = 0; i < dailyMeteoVar.size(); i++)
-                {
-                    if (preElaboration(nullptr, meteoGridDbHandler, meteoPointTemp, isMeteoGrid, dailyMeteoVar[i], noMeteoComp, firstDate, lastDate, outputValues, &percValue, meteoSettings, errorStr))
-                    {
-                        if (meteoPointTemp->computeMonthlyAggregate(getCrit3DDate(firstDate), getCrit3DDate(lastDate), dailyMeteoVar[i], meteoSettings, qualityCheck, climateParam))
-                        {
-                            meteoVariable monthlyVar = updateMeteoVariable(dailyMeteoVar[i], monthly);
-                            if (monthlyVar != noMeteoVar)
-                            {
-                                meteoVariableList.append(monthlyVar);
-                            }
-                        }
-                    }
-                }
-                // copy meteoPointTemp values
-                meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->obsDataM = meteoPointTemp->obsDataM ;
-                if (! meteoVariableList.isEmpty())
+        // the db connection is shared: data are loaded serially
+        if (! meteoGridDbHandler->loadGridDailyDataPoints(errorStr, blockPoints, firstDate, lastDate))
+        {
+            errorStr = "Error in loading grid daily data: " + errorStr;
+            return false;
+        }
+
+        #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+        for (int i = 0; i < int(blockPoints.size()); i++)
+        {
+            Crit3DMeteoPoint &meteoPoint = blockPoints[unsigned(i)];
+            QList<meteoVariable> &variableList = cellVariableList[firstCell + unsigned(i)];
+            meteoPoint.initializeObsDataM(nrMonths, firstDate.month(), firstDate.year());
+
+            for (unsigned int j = 0; j < dailyMeteoVar.size(); j++)
+            {
+                if (meteoPoint.computeMonthlyAggregate(firstCrit3DDate, lastCrit3DDate, dailyMeteoVar[j],
+                                                       meteoSettings, qualityCheck, climateParam))
                 {
-                    if (! meteoGridDbHandler->saveCellGridMonthlyData(errorStr, QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row,col)->id), row, col, firstDate, lastDate, meteoVariableList))
+                    meteoVariable monthlyVar = updateMeteoVariable(dailyMeteoVar[j], monthly);
+                    if (monthlyVar != noMeteoVar)
                     {
-                        delete meteoPointTemp;
-                        return false;
+                        variableList.append(monthlyVar);
                     }
                 }
             }
+
+            // release daily data
+            meteoPoint.obsDataD.clear();
+            meteoPoint.nrObsDataDaysD = 0;
+        }
+
+        for (unsigned int i = 0; i < blockPoints.size(); i++)
+        {
+            cellPoints[firstCell + i] = std::move(blockPoints[i]);
         }
     }
 
-    delete meteoPointTemp;
-    return true;
+    return meteoGridDbHandler->saveGridMonthlyData(errorStr, firstDate, lastDate, cellPoints, cellVariableList);
 }
 
 
@@ -5350,6 +5511,103 @@ int computeAnnualSeriesOnPointFromDaily(Crit3DMeteoPointsDbHandler* meteoPointsD
 }
 
 
+/*!
+ * \brief computeAnnualSeriesOnPointFromAggregates
+ * annual series of sum or average on whole months, read from the monthly aggregates of the points db
+ * returns false if the elaboration cannot be answered by the aggregates: the caller has to use the daily data
+ */
+bool computeAnnualSeriesOnPointFromAggregates(Crit3DMeteoPointsDbHandler* meteoPointsDbHandler, const QString &idPoint,
+                                              Crit3DMeteoSettings* meteoSettings, const Crit3DClimate& climate,
+                                              std::vector<float> &outputValues, std::vector<int> &outputYears,
+                                              int &nrValidYears, QString &errorString)
+{
+    nrValidYears = 0;
+    if (meteoPointsDbHandler == nullptr)
+        return false;
+
+    // only sum and average on the same year
+    meteoComputation elab1 = getMeteoCompFromString(MapMeteoComputation, climate.elab1().toStdString());
+    if ((elab1 != sum && elab1 != average) || climate.elab2() != "" || climate.param1IsClimate()
+        || climate.nYears() != 0 || climate.getCurrentPeriodType() == dailyPeriod)
+        return false;
+
+    // variables computed from other variables
+    meteoVariable myVar = climate.variable();
+    switch(myVar)
+    {
+        case dailyAirTemperatureAvg:
+            if (meteoSettings->getAutomaticTavg()) return false;
+            break;
+        case dailyReferenceEvapotranspirationHS:
+            if (meteoSettings->getAutomaticET0HS()) return false;
+            break;
+        case dailyLeafWetness: case dailyThomDaytime: case dailyThomNighttime: case dailyThomAvg: case dailyThomMax:
+        case dailyThomHoursAbove: case dailyBIC: case dailyAirTemperatureRange:
+        case dailyHeatingDegreeDays: case dailyCoolingDegreeDays:
+            return false;
+        default:
+            break;
+    }
+
+    // whole months
+    QDate periodStart = climate.genericPeriodDateStart();
+    QDate periodEnd = climate.genericPeriodDateEnd();
+    int firstMonth = periodStart.month();
+    int lastMonth = periodEnd.month();
+    if (periodStart.day() != 1 || periodEnd.day() != periodEnd.daysInMonth() || firstMonth > lastMonth)
+        return false;
+    if (lastMonth == 2 && periodEnd.day() != 29)
+        return false;
+
+    int firstYear = climate.yearStart();
+    int lastYear = climate.yearEnd();
+    std::vector<double> monthlySum;
+    std::vector<int> monthlyNrValid, monthlyNrAccepted;
+    if (! meteoPointsDbHandler->loadMonthlyAggregates(idPoint, myVar, firstYear, lastYear,
+                                                      monthlySum, monthlyNrValid, monthlyNrAccepted))
+    {
+        errorString = meteoPointsDbHandler->getErrorString();
+        return false;
+    }
+
+    // same checks of the daily path: at least one value accepted by the syntactic quality control
+    // (preElaborationWithoutLoad) and the minimum percentage of valid values (computeStatistic)
+    outputValues.clear();
+    outputYears.clear();
+    for (int year = firstYear; year <= lastYear; year++)
+    {
+        double yearSum = 0;
+        int nrValid = 0;
+        int nrAccepted = 0;
+        int nrDays = 0;
+        for (int month = firstMonth; month <= lastMonth; month++)
+        {
+            unsigned int index = unsigned(year - firstYear) * 12 + unsigned(month - 1);
+            yearSum += monthlySum[index];
+            nrValid += monthlyNrValid[index];
+            nrAccepted += monthlyNrAccepted[index];
+            nrDays += QDate(year, month, 1).daysInMonth();
+        }
+
+        if (nrAccepted == 0 || ! isValidDataPercentage(nrValid, nrDays, meteoSettings))
+        {
+            outputValues.push_back(NODATA);
+            continue;
+        }
+
+        if (elab1 == sum)
+            outputValues.push_back(float(yearSum));
+        else
+            outputValues.push_back(float(yearSum / nrValid));
+
+        outputYears.push_back(year);
+        nrValidYears++;
+    }
+
+    return true;
+}
+
+
 void computeClimateOnDailyData(Crit3DMeteoPoint meteoPoint, meteoVariable var, QDate firstDate, QDate lastDate,
                               int smooth, float* dataPresence, Crit3DQuality* qualityCheck, Crit3DClimateParameters* climateParam,
                                Crit3DMeteoSettings* meteoSettings, std::vector<float> &dailyClima,
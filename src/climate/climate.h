@@ -26,6 +26,9 @@
         #include "crit3dPhenologyList.h"
     #endif
 
+    // number of grid cells loaded at once in the monthly aggregation
+    #define MONTHLY_AGGREGATION_BLOCK_CELLS 2000
+
 
     const std::map<std::string, int> MapElabWithParam = {
       { "differenceWithThreshold", 1 },
@@ -42,6 +45,27 @@
       { "correctedDegreeDaysSum", 1 }
     };
 
+    // elaborations of a Crit3DElabList sharing the same loaded series: same variable and,
+    // for the elaborations needing a dedicated load (corrected degree days, huglin, winkler, fregoni), same elab1
+    // the series is loaded once on the envelope of their periods
+    struct TClimateElabGroup
+    {
+        meteoVariable variable;
+        QString loadElab1;
+        QDate firstDate;
+        QDate lastDate;
+        int yearStart;
+        int yearEnd;
+        std::vector<int> elabIndex;
+    };
+
+    void getClimatePeriodDates(climatePeriod periodType, int yearStart, int yearEnd, const QDate &genericDateStart,
+                               const QDate &genericDateEnd, int nYears, int offset, QDate &startDate, QDate &endDate);
+
+    void planElaborationList(const Crit3DElabList &listElab, std::vector<TClimateElabGroup> &groups);
+
+    void setClimateFromElabList(const Crit3DElabList &listElab, int index, Crit3DClimate* clima);
+
     bool elaborationOnPoint(QString &errorString, Crit3DMeteoPointsDbHandler* meteoPointsDbHandler,
                             Crit3DMeteoGridDbHandler* meteoGridDbHandler, Crit3DMeteoPoint* meteoPointTemp,
                             Crit3DClimate* clima, bool isMeteoGrid, const QDate& startDate, const QDate& endDate,
@@ -135,6 +159,8 @@
 
     void extractValidValues(std::vector<float> &outputValues, float threshold = NODATA, bool useThreshold = false);
 
+    bool isValidDataPercentage(int nrValidValues, int nrValues, Crit3DMeteoSettings* meteoSettings);
+
     float computeStatistic(std::vector<float> &inputValues, Crit3DMeteoPoint* meteoPoint, Crit3DClimate* clima, 
 						Crit3DDate firstDate, Crit3DDate lastDate, int nYears, meteoComputation elab1, meteoComputation elab2, 
 						Crit3DMeteoSettings *meteoSettings, bool dataAlreadyLoaded);
@@ -176,13 +202,19 @@
                                         Crit3DClimateParameters *climateParam, QString &errorStr);
 
     bool monthlyAggregateDataGrid(Crit3DMeteoGridDbHandler* meteoGridDbHandler, const QDate &firstDate, const QDate &lastDate,
-                    const std::vector<meteoVariable> &dailyMeteoVar, Crit3DMeteoSettings* meteoSettings,
-                    Crit3DQuality *qualityCheck, Crit3DClimateParameters *climateParam, QString &errorStr);
+                                  const std::vector<meteoVariable> &dailyMeteoVar, Crit3DMeteoSettings* meteoSettings,
+                                  Crit3DQuality *qualityCheck, Crit3DClimateParameters *climateParam,
+                                  bool isParallelComputing, QString &errorStr);
 
     int computeAnnualSeriesOnPointFromDaily(Crit3DMeteoPointsDbHandler* meteoPointsDbHandler, Crit3DMeteoGridDbHandler* meteoGridDbHandler,
                                             Crit3DMeteoPoint* meteoPointTemp, Crit3DMeteoSettings* meteoSettings,
                                             const Crit3DClimate& climate, bool isMeteoGrid, bool isAnomaly, bool isDataAlreadyLoaded,
                                             std::vector<float> &outputValues, std::vector<int> &outputYears, QString &errorString);
+
+    bool computeAnnualSeriesOnPointFromAggregates(Crit3DMeteoPointsDbHandler* meteoPointsDbHandler, const QString &idPoint,
+                                                  Crit3DMeteoSettings* meteoSettings, const Crit3DClimate& climate,
+                                                  std::vector<float> &outputValues, std::vector<int> &outputYears,
+                                                  int &nrValidYears, QString &errorString);
     
 	void computeClimateOnDailyData(Crit3DMeteoPoint meteoPoint, meteoVariable var, QDate firstDate, QDate lastDate,
                     int smooth, float* dataPresence, Crit3DQuality* qualityCheck, Crit3DClimateParameters* climateParam,
@@ -26,6 +26,8 @@ win32:{
     TARGET = climate
 }
 
+# parallel computing settings
+include($$absolute_path(../../agrolib/parallel.pri))
 
 INCLUDEPATH +=  ../../agrolib/crit3dDate ../../agrolib/mathFunctions ../../agrolib/gis  \
                 ../../agrolib/meteo ../../agrolib/interpolation ../../agrolib/utilities   \
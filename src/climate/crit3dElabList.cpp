@@ -25,7 +25,7 @@ void Crit3DElabList::setIsMeteoGrid(bool isMeteoGrid)
     _isMeteoGrid = isMeteoGrid;
 }
 
-QList<QString> Crit3DElabList::listAll() const
+const QList<QString>& Crit3DElabList::listAll() const
 {
     return _listAll;
 }
@@ -123,7 +123,7 @@ void Crit3DElabList::eraseElement(unsigned int index)
     }
 }
 
-std::vector<int> Crit3DElabList::listYearStart() const
+const std::vector<int>& Crit3DElabList::listYearStart() const
 {
     return _listYearStart;
 }
@@ -138,7 +138,7 @@ void Crit3DElabList::insertYearStart(int yearStart)
     _listYearStart.push_back(yearStart);
 }
 
-std::vector<int> Crit3DElabList::listYearEnd() const
+const std::vector<int>& Crit3DElabList::listYearEnd() const
 {
     return _listYearEnd;
 }
@@ -153,7 +153,7 @@ void Crit3DElabList::insertYearEnd(int yearEnd)
     _listYearEnd.push_back(yearEnd);
 }
 
-std::vector<meteoVariable> Crit3DElabList::listVariable() const
+const std::vector<meteoVariable>& Crit3DElabList::listVariable() const
 {
     return _listVariable;
 }
@@ -168,7 +168,7 @@ void Crit3DElabList::insertVariable(meteoVariable variable)
     _listVariable.push_back(variable);
 }
 
-std::vector<QString> Crit3DElabList::listPeriodStr() const
+const std::vector<QString>& Crit3DElabList::listPeriodStr() const
 {
     return _listPeriodStr;
 }
@@ -183,7 +183,7 @@ void Crit3DElabList::insertPeriodStr(QString period)
     _listPeriodStr.push_back(period);
 }
 
-std::vector<climatePeriod> Crit3DElabList::listPeriodType() const
+const std::vector<climatePeriod>& Crit3DElabList::listPeriodType() const
 {
     return _listPeriodType;
 }
@@ -198,7 +198,7 @@ void Crit3DElabList::insertPeriodType(climatePeriod period)
     _listPeriodType.push_back(period);
 }
 
-std::vector<QDate> Crit3DElabList::listDateStart() const
+const std::vector<QDate>& Crit3DElabList::listDateStart() const
 {
     return _listDateStart;
 }
@@ -213,7 +213,7 @@ void Crit3DElabList::insertDateStart(QDate dateStart)
     _listDateStart.push_back(dateStart);
 }
 
-std::vector<QDate> Crit3DElabList::listDateEnd() const
+const std::vector<QDate>& Crit3DElabList::listDateEnd() const
 {
     return _listDateEnd;
 }
@@ -228,7 +228,7 @@ void Crit3DElabList::insertDateEnd(QDate dateEnd)
     _listDateEnd.push_back(dateEnd);
 }
 
-std::vector<int> Crit3DElabList::listNYears() const
+const std::vector<int>& Crit3DElabList::listNYears() const
 {
     return _listNYears;
 }
@@ -243,7 +243,7 @@ void Crit3DElabList::insertNYears(int nYears)
     _listNYears.push_back(nYears);
 }
 
-std::vector<int> Crit3DElabList::listOffset() const
+const std::vector<int>& Crit3DElabList::listOffset() const
 {
     return _listOffset;
 }
@@ -258,7 +258,7 @@ void Crit3DElabList::insertOffset(int offset)
     _listOffset.push_back(offset);
 }
 
-std::vector<QString> Crit3DElabList::listElab1() const
+const std::vector<QString>& Crit3DElabList::listElab1() const
 {
     return _listElab1;
 }
@@ -273,7 +273,7 @@ void Crit3DElabList::insertElab1(QString elab1)
     _listElab1.push_back(elab1);
 }
 
-std::vector<float> Crit3DElabList::listParam1() const
+const std::vector<float>& Crit3DElabList::listParam1() const
 {
     return _listParam1;
 }
@@ -288,7 +288,7 @@ void Crit3DElabList::insertParam1(float param1)
     _listParam1.push_back(param1);
 }
 
-std::vector<bool> Crit3DElabList::listParam1IsClimate() const
+const std::vector<bool>& Crit3DElabList::listParam1IsClimate() const
 {
     return _listParam1IsClimate;
 }
@@ -303,7 +303,7 @@ void Crit3DElabList::insertParam1IsClimate(bool param1IsClimate)
     _listParam1IsClimate.push_back(param1IsClimate);
 }
 
-std::vector<QString> Crit3DElabList::listParam1ClimateField() const
+const std::vector<QString>& Crit3DElabList::listParam1ClimateField() const
 {
     return _listParam1ClimateField;
 }
@@ -318,7 +318,7 @@ void Crit3DElabList::insertParam1ClimateField(QString param1ClimateField)
     _listParam1ClimateField.push_back(param1ClimateField);
 }
 
-std::vector<QString> Crit3DElabList::listElab2() const
+const std::vector<QString>& Crit3DElabList::listElab2() const
 {
     return _listElab2;
 }
@@ -333,7 +333,7 @@ void Crit3DElabList::insertElab2(QString elab2)
     _listElab2.push_back(elab2);
 }
 
-std::vector<float> Crit3DElabList::listParam2() const
+const std::vector<float>& Crit3DElabList::listParam2() const
 {
     return _listParam2;
 }
@@ -353,7 +353,7 @@ void Crit3DElabList::insertDailyCumulated(bool dailyCumulated)
     _listDailyCumulated.push_back(dailyCumulated);
 }
 
-std::vector<bool> Crit3DElabList::listDailyCumulated() const
+const std::vector<bool>& Crit3DElabList::listDailyCumulated() const
 {
     return _listDailyCumulated;
 }
@@ -447,7 +447,7 @@ bool Crit3DElabList::addElab(unsigned int index)
     return true;
 }
 
-std::vector<QString> Crit3DElabList::listFileName() const
+const std::vector<QString>& Crit3DElabList::listFileName() const
 {
     return _listFileName;
 }
@@ -0,0 +1,331 @@
+/*!
+    \file homogeneity.cpp
+
+    \abstract
+    homogeneity tests of annual series (SNHT, Craddock) independent from the GUI,
+    with automatic selection of the reference stations and batch computation over a network
+*/
+
+#include "homogeneity.h"
+#include "commonConstants.h"
+#include "statistics.h"
+
+#include <algorithm>
+#include <math.h>
+
+
+// SNHT critical values at 95% for 10, 20, ... 100 years
+static const double SNHT_T95_VALUES[10] {5.7, 6.95, 7.65, 8.1, 8.45, 8.65, 8.8, 8.95, 9.05, 9.15};
+
+
+double getSNHT_T95(int nrYears)
+{
+    int index = nrYears / 10;
+    if (index < 1 || index > 10)
+        return NODATA;
+
+    return SNHT_T95_VALUES[index-1];
+}
+
+
+/*!
+ * \brief computeSNHTQSeries
+ * computes the Q series: candidate series compared with the weighted (r2) average of the reference series.
+ * isRatio: ratio (precipitation) instead of difference
+ */
+bool computeSNHTQSeries(const std::vector<float> &candidateSeries, const std::vector<std::vector<float>> &referenceSeries,
+                        bool isRatio, std::vector<double> &qSeries)
+{
+    qSeries.clear();
+
+    unsigned int nrYears = unsigned(candidateSeries.size());
+    unsigned int nrReference = unsigned(referenceSeries.size());
+    if (nrYears == 0 || nrReference == 0)
+        return false;
+
+    std::vector<double> validValues;
+    for (unsigned int i = 0; i < nrYears; i++)
+    {
+        if (candidateSeries[i] != NODATA)
+            validValues.push_back(double(candidateSeries[i]));
+    }
+    double average = statistics::mean(validValues);
+
+    std::vector<double> refAverage(nrReference);
+    std::vector<float> r2(nrReference);
+    float r2Value, y_intercept, trend;
+
+    for (unsigned int j = 0; j < nrReference; j++)
+    {
+        if (referenceSeries[j].size() != nrYears)
+            return false;
+
+        validValues.clear();
+        for (unsigned int i = 0; i < nrYears; i++)
+        {
+            if (referenceSeries[j][i] != NODATA)
+                validValues.push_back(double(referenceSeries[j][i]));
+        }
+        refAverage[j] = statistics::mean(validValues);
+
+        statistics::linearRegression(candidateSeries, referenceSeries[j], long(nrYears), false, &y_intercept, &trend, &r2Value);
+        r2[j] = r2Value;
+    }
+
+    qSeries.resize(nrYears);
+    for (unsigned int i = 0; i < nrYears; i++)
+    {
+        double sumValues = 0;
+        double sumWeights = 0;
+        for (unsigned int j = 0; j < nrReference; j++)
+        {
+            if (referenceSeries[j][i] != NODATA)
+            {
+                if (isRatio)
+                    sumValues += r2[j] * referenceSeries[j][i] * average / refAverage[j];
+                else
+                    sumValues += r2[j] * (referenceSeries[j][i] - refAverage[j] + average);
+
+                sumWeights += r2[j];
+            }
+        }
+
+        qSeries[i] = NODATA;
+        if (candidateSeries[i] != NODATA)
+        {
+            if (isRatio)
+            {
+                if (sumValues != 0 && sumWeights != 0)
+                    qSeries[i] = double(candidateSeries[i]) / (sumValues / sumWeights);
+            }
+            else if (sumWeights > 0)
+            {
+                qSeries[i] = double(candidateSeries[i]) - (sumValues / sumWeights);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief computeSNHT
+ * Standard Normal Homogeneity Test (Alexandersson, 1986) on the Q series.
+ * The averages of the two sub-series are computed for every breakpoint with prefix sums (O(n))
+ */
+bool computeSNHT(const std::vector<double> &qSeries, TSNHTResult &result)
+{
+    result.tValues.clear();
+    result.tMax = NODATA;
+    result.indexTMax = NODATA;
+    result.isHomogeneous = true;
+
+    int nrYears = int(qSeries.size());
+    result.t95 = getSNHT_T95(nrYears);
+    if (nrYears < 2 || result.t95 == NODATA)
+        return false;
+
+    // standardized series
+    std::vector<double> validValues;
+    for (int i = 0; i < nrYears; i++)
+    {
+        if (qSeries[i] != NODATA)
+            validValues.push_back(qSeries[i]);
+    }
+
+    double qAverage = statistics::mean(validValues);
+    double qDevStd = statistics::standardDeviation(validValues, int(validValues.size()));
+    if (qAverage == NODATA || qDevStd == NODATA || qDevStd == 0)
+        return false;
+
+    // prefix sums of the valid standardized values
+    std::vector<double> sumZ(unsigned(nrYears + 1), 0);
+    std::vector<int> nrValidZ(unsigned(nrYears + 1), 0);
+    for (int i = 0; i < nrYears; i++)
+    {
+        sumZ[i+1] = sumZ[i];
+        nrValidZ[i+1] = nrValidZ[i];
+        if (qSeries[i] != NODATA)
+        {
+            sumZ[i+1] += (qSeries[i] - qAverage) / qDevStd;
+            nrValidZ[i+1]++;
+        }
+    }
+
+    result.tValues.resize(unsigned(nrYears - 1), NODATA);
+    for (int a = 0; a < nrYears - 1; a++)
+    {
+        int n1 = nrValidZ[a+1];
+        int n2 = nrValidZ[nrYears] - n1;
+        if (n1 == 0 || n2 == 0)
+            continue;
+
+        double z1Average = sumZ[a+1] / n1;
+        double z2Average = (sumZ[nrYears] - sumZ[a+1]) / n2;
+
+        result.tValues[a] = (a+1) * z1Average * z1Average + (nrYears - (a+1)) * z2Average * z2Average;
+
+        if (result.tMax == NODATA || result.tValues[a] > result.tMax)
+        {
+            result.tMax = result.tValues[a];
+            result.indexTMax = a;
+        }
+    }
+
+    result.isHomogeneous = ! (result.indexTMax != NODATA && result.tMax >= result.t95);
+
+    return true;
+}
+
+
+/*!
+ * \brief computeCraddock
+ * Craddock test: cumulated differences (or ratios) between candidate and each reference series
+ */
+bool computeCraddock(const std::vector<float> &candidateSeries, const std::vector<std::vector<float>> &referenceSeries,
+                     bool isRatio, std::vector<std::vector<float>> &sValues, std::string &errorStr)
+{
+    unsigned int nrYears = unsigned(candidateSeries.size());
+    unsigned int nrReference = unsigned(referenceSeries.size());
+
+    sValues.clear();
+    sValues.resize(nrReference, std::vector<float>(nrYears, NODATA));
+
+    for (unsigned int j = 0; j < nrReference; j++)
+    {
+        const std::vector<float> &refSeries = referenceSeries[j];
+        if (refSeries.size() != nrYears)
+        {
+            errorStr = "Wrong reference series length";
+            return false;
+        }
+
+        // mean only for common years
+        float candidateSum = 0;
+        float referenceSum = 0;
+        int nrValidYears = 0;
+        for (unsigned int i = 0; i < nrYears; i++)
+        {
+            if (candidateSeries[i] != NODATA && refSeries[i] != NODATA)
+            {
+                candidateSum += candidateSeries[i];
+                referenceSum += refSeries[i];
+                nrValidYears++;
+            }
+        }
+
+        float average = candidateSum / nrValidYears;
+        float refAverage = referenceSum / nrValidYears;
+        float c;
+        if (isRatio)
+        {
+            if (refAverage == 0)
+            {
+                errorStr = "Can not divide by zero";
+                return false;
+            }
+            c = refAverage / average;
+        }
+        else
+        {
+            c = refAverage - average;
+        }
+
+        float lastSum = 0;
+        for (unsigned int i = 0; i < nrYears; i++)
+        {
+            if (candidateSeries[i] != NODATA && refSeries[i] != NODATA)
+            {
+                float d;
+                if (isRatio)
+                    d = c * candidateSeries[i] - refSeries[i];
+                else
+                    d = c + candidateSeries[i] - refSeries[i];
+
+                sValues[j][i] = lastSum + d;
+                lastSum = sValues[j][i];
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief selectReferenceStations
+ * returns the indexes of the nearest stations (within maxDistance [m], if > 0)
+ * with a coefficient of determination greater than minR2
+ */
+std::vector<int> selectReferenceStations(const std::vector<TAnnualSeriesStation> &stations, int candidateIndex,
+                                         int nrReferences, double maxDistance, float minR2)
+{
+    std::vector<int> referenceIndexes;
+    const TAnnualSeriesStation &candidate = stations[unsigned(candidateIndex)];
+
+    std::vector<std::pair<double, int>> distances;
+    for (unsigned int i = 0; i < stations.size(); i++)
+    {
+        if (int(i) == candidateIndex || stations[i].values.size() != candidate.values.size())
+            continue;
+
+        double dx = stations[i].utmX - candidate.utmX;
+        double dy = stations[i].utmY - candidate.utmY;
+        double distance = sqrt(dx*dx + dy*dy);
+        if (maxDistance <= 0 || distance <= maxDistance)
+            distances.push_back(std::make_pair(distance, int(i)));
+    }
+
+    std::sort(distances.begin(), distances.end());
+
+    float r2, y_intercept, trend;
+    for (unsigned int i = 0; i < distances.size() && int(referenceIndexes.size()) < nrReferences; i++)
+    {
+        const TAnnualSeriesStation &reference = stations[unsigned(distances[i].second)];
+        statistics::linearRegression(candidate.values, reference.values, long(candidate.values.size()), false, &y_intercept, &trend, &r2);
+        if (r2 >= minR2)
+            referenceIndexes.push_back(distances[i].second);
+    }
+
+    return referenceIndexes;
+}
+
+
+/*!
+ * \brief computeSNHTAllStations
+ * SNHT over all the stations of a network, each station is tested against its automatically selected references
+ */
+void computeSNHTAllStations(const std::vector<TAnnualSeriesStation> &stations, bool isRatio, int nrReferences,
+                            double maxDistance, float minR2, bool isParallelComputing, std::vector<TSNHTResult> &results)
+{
+    int nrStations = int(stations.size());
+    results.clear();
+    results.resize(unsigned(nrStations));
+
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int i = 0; i < nrStations; i++)
+    {
+        TSNHTResult &result = results[unsigned(i)];
+        result.tMax = NODATA;
+        result.indexTMax = NODATA;
+        result.t95 = NODATA;
+        result.isHomogeneous = true;
+
+        result.referenceIndexes = selectReferenceStations(stations, i, nrReferences, maxDistance, minR2);
+        if (result.referenceIndexes.empty())
+            continue;
+
+        std::vector<std::vector<float>> referenceSeries;
+        for (unsigned int j = 0; j < result.referenceIndexes.size(); j++)
+        {
+            referenceSeries.push_back(stations[unsigned(result.referenceIndexes[j])].values);
+        }
+
+        std::vector<double> qSeries;
+        if (computeSNHTQSeries(stations[unsigned(i)].values, referenceSeries, isRatio, qSeries))
+        {
+            computeSNHT(qSeries, result);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef HOMOGENEITY_H
+#define HOMOGENEITY_H
+
+    #ifndef _VECTOR_
+        #include <vector>
+    #endif
+    #ifndef _STRING_
+        #include <string>
+    #endif
+
+    // default selection of the reference stations
+    #define SNHT_DEFAULT_REFERENCE_MAX_DISTANCE 30000       // [m]
+    #define SNHT_DEFAULT_REFERENCE_MIN_R2 0
+
+    // annual series of a station, used for the automatic selection of reference stations
+    struct TAnnualSeriesStation
+    {
+        std::string id;
+        double utmX;
+        double utmY;
+        std::vector<float> values;         // one value for each year (NODATA if missing)
+    };
+
+    struct TSNHTResult
+    {
+        std::vector<double> tValues;        // T statistic for each breakpoint (NODATA if not computable)
+        double tMax;
+        int indexTMax;                      // index of the year of discontinuity
+        double t95;                         // critical value at 95%
+        bool isHomogeneous;
+        std::vector<int> referenceIndexes;
+    };
+
+    double getSNHT_T95(int nrYears);
+
+    bool computeSNHTQSeries(const std::vector<float> &candidateSeries, const std::vector<std::vector<float>> &referenceSeries,
+                            bool isRatio, std::vector<double> &qSeries);
+
+    bool computeSNHT(const std::vector<double> &qSeries, TSNHTResult &result);
+
+    bool computeCraddock(const std::vector<float> &candidateSeries, const std::vector<std::vector<float>> &referenceSeries,
+                         bool isRatio, std::vector<std::vector<float>> &sValues, std::string &errorStr);
+
+    std::vector<int> selectReferenceStations(const std::vector<TAnnualSeriesStation> &stations, int candidateIndex,
+                                             int nrReferences, double maxDistance, float minR2);
+
+    void computeSNHTAllStations(const std::vector<TAnnualSeriesStation> &stations, bool isRatio, int nrReferences,
+                                double maxDistance, float minR2, bool isParallelComputing, std::vector<TSNHTResult> &results);
+
+
+#endif // HOMOGENEITY_H
@@ -0,0 +1,39 @@
+#-----------------------------------------------------
+#
+#   homogeneity library
+#   homogeneity tests (SNHT, Craddock) without GUI
+#   This project is part of ARPAE PRAGA distribution
+#
+#-----------------------------------------------------
+
+QT       -= core gui
+
+TEMPLATE = lib
+CONFIG += staticlib
+
+CONFIG += debug_and_release
+CONFIG += c++11 c++14 c++17
+
+
+unix:{
+    CONFIG(debug, debug|release) {
+        TARGET = debug/homogeneity
+    } else {
+        TARGET = release/homogeneity
+    }
+}
+win32:{
+    TARGET = homogeneity
+}
+
+# parallel computing settings
+include($$absolute_path(../../agrolib/parallel.pri))
+
+INCLUDEPATH +=  ../../agrolib/mathFunctions
+
+SOURCES +=  \
+    homogeneity.cpp
+
+HEADERS +=  \
+    homogeneity.h
+
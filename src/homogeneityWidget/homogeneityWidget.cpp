@@ -355,29 +355,42 @@ void Crit3DHomogeneityWidget::plotAnnualSeries()
     FormInfo formInfo;
     formInfo.showInfo("compute annual series...");
 
-    // copy all data to meteoPointTemp from joint if there are holes
-    Crit3DMeteoPoint meteoPointTemp;
-    if (_jointPointsIdList.size() != 1)
+    std::vector<int> vectorYears;
+    int validYears = 0;
+
+    // single station: monthly aggregates of the db
+    bool isFromAggregates = false;
+    if (_jointPointsIdList.size() == 1)
     {
-        int numberOfDays = firstDate.daysTo(lastDate)+1;
-        meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
-        for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
-        {
-            checkValueAndMerge(_nearMeteoPointsList[0], &meteoPointTemp, myDate);
-        }
+        isFromAggregates = computeAnnualSeriesOnPointFromAggregates(_meteoPointsDbPointer, QString::fromStdString(_nearMeteoPointsList[0].id),
+                                                                    meteoSettings, _climate, _annualSeries, vectorYears, validYears, myError);
     }
-    else
+
+    if (! isFromAggregates)
     {
-        meteoPointTemp = _nearMeteoPointsList[0];
-    }
+        // copy all data to meteoPointTemp from joint if there are holes
+        Crit3DMeteoPoint meteoPointTemp;
+        if (_jointPointsIdList.size() != 1)
+        {
+            int numberOfDays = firstDate.daysTo(lastDate)+1;
+            meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+            for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
+            {
+                checkValueAndMerge(_nearMeteoPointsList[0], &meteoPointTemp, myDate);
+            }
+        }
+        else
+        {
+            meteoPointTemp = _nearMeteoPointsList[0];
+        }
 
-    bool dataAlreadyLoaded = true;
-    bool isAnomaly = false;
-    std::vector<int> vectorYears;
-    int validYears = computeAnnualSeriesOnPointFromDaily(_meteoPointsDbPointer, nullptr,
+        bool dataAlreadyLoaded = true;
+        bool isAnomaly = false;
+        validYears = computeAnnualSeriesOnPointFromDaily(_meteoPointsDbPointer, nullptr,
                                                          &meteoPointTemp, meteoSettings, _climate, false,
                                                          isAnomaly, dataAlreadyLoaded,
                                                          _annualSeries, vectorYears, myError);
+    }
     formInfo.close();
 
     if (validYears > 0)
@@ -755,75 +768,90 @@ void Crit3DHomogeneityWidget::findReferenceStations()
         if (! _meteoPointsDbPointer->isActivePoint(QString::fromStdString(pointId)))
             continue;
 
-        Crit3DMeteoPoint mpToBeComputed;
-        mpToBeComputed.id = pointId;
-        if (! _meteoPointsDbPointer->loadDailyData(getCrit3DDate(firstDate), getCrit3DDate(lastDate), mpToBeComputed))
-            continue;
-
         QString name = _meteoPointsDbPointer->getNameGivenId(QString::fromStdString(pointId));
-        QList<QString> jointStationsList = _meteoPointsDbPointer->getJointStations(QString::fromStdString(mpToBeComputed.id));
+        QList<QString> jointStationsList = _meteoPointsDbPointer->getJointStations(QString::fromStdString(pointId));
 
-        // copy all data to meteoPointTemp from joint if there are holes
-        Crit3DMeteoPoint meteoPointTemp;
-        if (jointStationsList.size() > 0)
-        {
-            // initialize meteo point
-            int numberOfDays = firstDate.daysTo(lastDate) + 1;
-            meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
-            name += "_Joint";
+        std::vector<float> mpAnnualSeries;
+        std::vector<int> vectorYears;
+        // reset climate structure
+        _climate.setYearStart(firstYear);
+        _climate.setYearEnd(lastYear);
+        _climate.setGenericPeriodDateStart(firstDate);
+        _climate.setGenericPeriodDateEnd(lastDate);
+        _climate.setNYears(0);
+        int validYears = 0;
 
-            // load all joint stations data
-            QList<Crit3DMeteoPoint> jointStationsMpList;
-            for (int j = 0; j < jointStationsList.size(); j++)
-            {
-                Crit3DMeteoPoint mpGet;
-                mpGet.id = jointStationsList[j].toStdString();
-                if (_meteoPointsDbPointer->loadDailyData(getCrit3DDate(firstDate), getCrit3DDate(lastDate), mpGet))
-                    jointStationsMpList.push_back(mpGet);
-            }
+        // station without joint stations: monthly aggregates of the db
+        bool isFromAggregates = false;
+        if (jointStationsList.isEmpty())
+        {
+            isFromAggregates = computeAnnualSeriesOnPointFromAggregates(_meteoPointsDbPointer, QString::fromStdString(pointId),
+                                                                        meteoSettings, _climate, mpAnnualSeries, vectorYears,
+                                                                        validYears, myError);
+        }
 
-            // merge data
-            for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1))
+        if (! isFromAggregates)
+        {
+            Crit3DMeteoPoint mpToBeComputed;
+            mpToBeComputed.id = pointId;
+            if (! _meteoPointsDbPointer->loadDailyData(getCrit3DDate(firstDate), getCrit3DDate(lastDate), mpToBeComputed))
+                continue;
+
+            // copy all data to meteoPointTemp from joint if there are holes
+            Crit3DMeteoPoint meteoPointTemp;
+            if (jointStationsList.size() > 0)
             {
-                Crit3DDate crit3dDate = getCrit3DDate(myDate);
-                float value = mpToBeComputed.getMeteoPointValueD(crit3dDate, myVar, meteoSettings);
-                if (value != NODATA)
+                // initialize meteo point
+                int numberOfDays = firstDate.daysTo(lastDate) + 1;
+                meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+                name += "_Joint";
+
+                // load all joint stations data
+                QList<Crit3DMeteoPoint> jointStationsMpList;
+                for (int j = 0; j < jointStationsList.size(); j++)
                 {
-                    meteoPointTemp.setMeteoPointValueD(crit3dDate, myVar, value);
+                    Crit3DMeteoPoint mpGet;
+                    mpGet.id = jointStationsList[j].toStdString();
+                    if (_meteoPointsDbPointer->loadDailyData(getCrit3DDate(firstDate), getCrit3DDate(lastDate), mpGet))
+                        jointStationsMpList.push_back(mpGet);
                 }
-                else
+
+                // merge data
+                for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1))
                 {
-                    // missing data, check joint stations
-                    for (int j = 0; j < jointStationsMpList.size(); j++)
+                    Crit3DDate crit3dDate = getCrit3DDate(myDate);
+                    float value = mpToBeComputed.getMeteoPointValueD(crit3dDate, myVar, meteoSettings);
+                    if (value != NODATA)
                     {
-                        float valueJoint = jointStationsMpList[j].getMeteoPointValueD(crit3dDate, myVar, meteoSettings);
-                        if (valueJoint != NODATA)
+                        meteoPointTemp.setMeteoPointValueD(crit3dDate, myVar, value);
+                    }
+                    else
+                    {
+                        // missing data, check joint stations
+                        for (int j = 0; j < jointStationsMpList.size(); j++)
                         {
-                            meteoPointTemp.setMeteoPointValueD(crit3dDate, myVar, valueJoint);
-                            break;
+                            float valueJoint = jointStationsMpList[j].getMeteoPointValueD(crit3dDate, myVar, meteoSettings);
+                            if (valueJoint != NODATA)
+                            {
+                                meteoPointTemp.setMeteoPointValueD(crit3dDate, myVar, valueJoint);
+                                break;
+                            }
                         }
                     }
                 }
             }
-        }
-        else
-        {
-            meteoPointTemp = mpToBeComputed;
-        }
+            else
+            {
+                meteoPointTemp = mpToBeComputed;
+            }
 
-        bool dataAlreadyLoaded = true;
-        std::vector<float> mpAnnualSeries;
-        std::vector<int> vectorYears;
-        // reset climate structure
-        _climate.setYearStart(firstYear);
-        _climate.setYearEnd(lastYear);
-        _climate.setGenericPeriodDateStart(firstDate);
-        _climate.setGenericPeriodDateEnd(lastDate);
-        _climate.setNYears(0);
-        int validYears = computeAnnualSeriesOnPointFromDaily(_meteoPointsDbPointer, nullptr,
+            bool dataAlreadyLoaded = true;
+            validYears = computeAnnualSeriesOnPointFromDaily(_meteoPointsDbPointer, nullptr,
                                                              &meteoPointTemp, meteoSettings, _climate, false,
                                                              false, dataAlreadyLoaded,
                                                              mpAnnualSeries, vectorYears, myError);
+        }
+
         if (validYears != 0)
         {
             if ((float)validYears / (float)(lastYear - firstYear + 1) > meteoSettings->getMinimumPercentage() / 100.f)
@@ -976,184 +1004,27 @@ void Crit3DHomogeneityWidget::executeClicked()
 
     if (method.currentText() == "SNHT")
     {
-        std::vector<double> myValidValues;
-        for (int i = 0; i<_annualSeries.size(); i++)
-        {
-            if (_annualSeries[i] != NODATA)
-            {
-                myValidValues.push_back((double)_annualSeries[i]);
-            }
-        }
-        double myAverage = statistics::mean(myValidValues);
-        std::vector<double> myRefAverage;
-        std::vector<float> r2;
         std::vector<std::vector<float>> refSeriesVector;
-        float r2Value, y_intercept, trend;
-
         for (int row = 0; row < nrReference; row++)
         {
-            std::vector<double> myRefValidValues;
             QString name = listSelectedStations.item(row)->text();
-            std::vector<float> refSeries = mapNameAnnualSeries.value(name);
-            refSeriesVector.push_back(refSeries);
-            for (int i = 0; i<refSeries.size(); i++)
-            {
-                if (refSeries[i] != NODATA)
-                {
-                    myRefValidValues.push_back((double)refSeries[i]);
-                }
-            }
-            myRefAverage.push_back(statistics::mean(myRefValidValues));
-            statistics::linearRegression(_annualSeries, refSeries, long(_annualSeries.size()), false, &y_intercept, &trend, &r2Value);
-            r2.push_back(r2Value);
+            refSeriesVector.push_back(mapNameAnnualSeries.value(name));
         }
-        double tmp, sumV;
-        std::vector<double> myQ;
-        if (myVar == dailyPrecipitation)
-        {
-            for (int i = 0; i<_annualSeries.size(); i++)
-            {
-                tmp = 0;
-                sumV = 0;
-                for (int j = 0; j<nrReference; j++)
-                {
-                    if (refSeriesVector[j][i] != NODATA)
-                    {
-                        tmp = tmp + (r2[j] * refSeriesVector[j][i] * myAverage / myRefAverage[j]);
-                        sumV = r2[j] + sumV;
-                    }
-                }
-                if (_annualSeries[i] != NODATA && tmp!= 0 && sumV!= 0)
-                {
-                    myQ.push_back((double)_annualSeries[i]/(tmp/sumV));
-                }
-                else
-                {
-                    myQ.push_back(NODATA);
-                }
-            }
-        }
-        else
-        {
-            for (int i = 0; i<_annualSeries.size(); i++)
-            {
-                tmp = 0;
-                sumV = 0;
-                for (int j = 0; j<nrReference; j++)
-                {
-                    if (refSeriesVector[j][i] != NODATA)
-                    {
-                        tmp = tmp + (r2[j] * (refSeriesVector[j][i] - myRefAverage[j] + myAverage));
-                        sumV = r2[j] + sumV;
-                    }
-                }
-                if (_annualSeries[i] != NODATA)
-                {
-                    if (sumV > 0)
-                    {
-                         myQ.push_back((double)_annualSeries[i]-(tmp/sumV));
-                    }
-                    else
-                    {
-                        myQ.push_back(NODATA);
-                    }
-                }
-                else
-                {
-                    myQ.push_back(NODATA);
-                }
-            }
-        }
-        myValidValues.clear();
-        for (int i = 0; i<myQ.size(); i++)
-        {
-            if (myQ[i] != NODATA)
-            {
-                myValidValues.push_back(myQ[i]);
-            }
-        }
-        double myQAverage = statistics::mean(myValidValues);
-        double myQDevStd = statistics::standardDeviation(myValidValues, int(myValidValues.size()));
-        std::vector<double> myZ;
-        for (int i = 0; i<myQ.size(); i++)
-        {
-            if (myQ[i] != NODATA)
-            {
-                myZ.push_back((myQ[i] - myQAverage) / myQDevStd);
-            }
-            else
-            {
-                myZ.push_back(NODATA);
-            }
-        }
-        myValidValues.clear();
-        for (int i = 0; i<myZ.size(); i++)
-        {
-            if (myZ[i] != NODATA)
-            {
-                myValidValues.push_back(myZ[i]);
-            }
-        }
-
-        //double myZAverage = statistics::mean(myValidValues);
-        //bool isHomogeneous = (qAbs(myZAverage) <= EPSILON);
-        std::vector<double> z1;
-        std::vector<double> z2;
 
-        for (int i = 0; i< myZ.size()-1; i++)
+        bool isRatio = (myVar == dailyPrecipitation);
+        std::vector<double> myQ;
+        computeSNHTQSeries(_annualSeries, refSeriesVector, isRatio, myQ);
+
+        TSNHTResult snhtResult;
+        computeSNHT(myQ, snhtResult);
+        myTValues = snhtResult.tValues;
+        myTValues.resize(_annualSeries.size()-1, NODATA);
+        myTmax = snhtResult.tMax;
+        if (snhtResult.indexTMax != NODATA)
         {
-            myTValues.push_back(NODATA);
+            myYearTmax = myFirstYear + snhtResult.indexTMax;
         }
 
-        for (int a = 0; a < myZ.size()-1; a++)
-        {
-            z1.resize(a+1);
-            z2.resize(myZ.size()-a-1);
-            for (int i = 0; i< myZ.size(); i++)
-            {
-                if (i<=a)
-                {
-                    z1[i] = myZ[i];
-                }
-                else
-                {
-                    z2[i-a-1] = myZ[i];
-                }
-            }
-            myValidValues.clear();
-            for (int i = 0; i<z1.size(); i++)
-            {
-                if (z1[i] != NODATA)
-                {
-                    myValidValues.push_back(z1[i]);
-                }
-            }
-
-            double myZ1Average = statistics::mean(myValidValues);
-            myValidValues.clear();
-            for (int i = 0; i<z2.size(); i++)
-            {
-                if (z2[i] != NODATA)
-                {
-                    myValidValues.push_back(z2[i]);
-                }
-            }
-            double myZ2Average = statistics::mean(myValidValues);
-            if (myZ1Average != NODATA && myZ2Average != NODATA)
-            {
-                myTValues[a] = ( (a+1) * pow(myZ1Average,2)) + ((myZ.size() - (a+1)) * pow(myZ2Average,2));
-                if (myTmax == NODATA)
-                {
-                    myTmax = myTValues[a];
-                    myYearTmax = myFirstYear + a;
-                }
-                else if (myTValues[a] > myTmax)
-                {
-                    myTmax = myTValues[a];
-                    myYearTmax = myFirstYear + a;
-                }
-            }
-        }
         std::vector<int> years;
         std::vector<double> outputValues;
         QList<QPointF> t95Points;
@@ -1176,16 +1047,11 @@ void Crit3DHomogeneityWidget::executeClicked()
             outputValues.push_back(myValue);
         }
 
-        int myT95Index = round(myNrYears / 10);
-        if (myT95Index > 0 && myT95Index <= 10)
+        myT95 = getSNHT_T95(myNrYears);
+        if (myT95 != NODATA)
         {
-            int index = round(myNrYears / 10);
-            myT95 = SNHT_T95_VALUES[index-1];
-            if (myT95 != NODATA)
-            {
-                t95Points.append(QPointF(myFirstYear,myT95));
-                t95Points.append(QPointF(myFirstYear+myTValues.size()-1,myT95));
-            }
+            t95Points.append(QPointF(myFirstYear,myT95));
+            t95Points.append(QPointF(myFirstYear+myTValues.size()-1,myT95));
         }
         else
         {
@@ -1239,88 +1105,23 @@ void Crit3DHomogeneityWidget::executeClicked()
     }
     else if (method.currentText() == "CRADDOCK")
     {
-        float myLastSum;
-        float myReferenceSum;
-        float myAverage;
-        int myValidYears;
-        std::vector<float> myRefAverage;
-        std::vector<float> myC;
-        std::vector<std::vector<float>> mySValues;
-        std::vector<std::vector<float>> myD;
-        // init myD
-        for (int row = 0; row < nrReference; row++)
-        {
-            std::vector<float> vectD;
-            for (int myYear = 0; myYear<_annualSeries.size(); myYear++)
-            {
-                vectD.push_back(NODATA);
-            }
-            myD.push_back(vectD);
-            mySValues.push_back(vectD);
-        }
-
+        std::vector<std::vector<float>> refSeriesVector;
         std::vector<QString> refNames;
         for (int row = 0; row < nrReference; row++)
         {
-            // compute mean only for common years
-            myLastSum = 0;
-            myReferenceSum = 0;
-            myValidYears = 0;
             QString name = listSelectedStations.item(row)->text();
             refNames.push_back(name);
-            std::vector<float> refSeries = mapNameAnnualSeries.value(name);
-            for (int myYear = 0; myYear<_annualSeries.size(); myYear++)
-            {
-                if (_annualSeries[myYear] != NODATA && refSeries[myYear] != NODATA)
-                {
-                    myLastSum = myLastSum + _annualSeries[myYear];
-                    myReferenceSum = myReferenceSum + refSeries[myYear];
-                    myValidYears = myValidYears + 1;
-                }
-            }
-            myAverage = myLastSum / myValidYears;
-            myRefAverage.push_back(myReferenceSum / myValidYears);
-            if (myVar == dailyPrecipitation)
-            {
-                if (myRefAverage[row] == 0)
-                {
-                    QMessageBox::critical(nullptr, "Error", "Can not divide by zero");
-                    return;
-                }
-                myC.push_back(myRefAverage[row] / myAverage);
-            }
-            else
-            {
-                 myC.push_back(myRefAverage[row] - myAverage);
-            }
-            for (int myYear = 0; myYear<_annualSeries.size(); myYear++)
-            {
-                if (_annualSeries[myYear] != NODATA && refSeries[myYear] != NODATA)
-                {
-                    if (myVar == dailyPrecipitation)
-                    {
-                         myD[row][myYear] = myC[row]*_annualSeries[myYear] - refSeries[myYear];
-                    }
-                    else
-                    {
-                        myD[row][myYear] = myC[row]+_annualSeries[myYear] - refSeries[myYear];
-                    }
-                }
-            }
+            refSeriesVector.push_back(mapNameAnnualSeries.value(name));
         }
 
-        // sum
-        for (int row = 0; row < nrReference; row++)
+        bool isRatio = (myVar == dailyPrecipitation);
+        std::vector<std::vector<float>> mySValues;
+        std::string errorStr;
+        if (! computeCraddock(_annualSeries, refSeriesVector, isRatio, mySValues, errorStr))
         {
-            myLastSum = 0;
-            for (int myYear = 0; myYear<_annualSeries.size(); myYear++)
-            {
-                if (myD[row][myYear] != NODATA)
-                {
-                    mySValues[row][myYear] = myLastSum + myD[row][myYear];
-                    myLastSum = mySValues[row][myYear];
-                }
-            }
+            QMessageBox::critical(nullptr, "Error", QString::fromStdString(errorStr));
+            formInfo.close();
+            return;
         }
 
         // draw
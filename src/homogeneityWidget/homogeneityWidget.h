@@ -10,6 +10,7 @@
     #include "crit3dClimate.h"
     #include "interpolationSettings.h"
     #include "interpolationPoint.h"
+    #include "homogeneity.h"
 
 
     class Crit3DHomogeneityWidget : public QWidget
@@ -91,7 +92,6 @@
 
             QString myError;
             double averageValue;
-            float SNHT_T95_VALUES [10] {5.7f,6.95f,7.65f,8.1f,8.45f,8.65f,8.8f,8.95f,9.05f,9.15f};
 
             int getJointStationIndex(const std::string& id);
     };
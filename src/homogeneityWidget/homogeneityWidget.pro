@@ -35,7 +35,7 @@ INCLUDEPATH +=  ../../agrolib/crit3dDate ../../agrolib/mathFunctions ../../agrol
                 ../../agrolib/meteo ../../agrolib/utilities ../../agrolib/dbMeteoPoints \
                 ../../agrolib/dbMeteoGrid  ../../agrolib/commonDialogs    \
                 ../../agrolib/commonChartElements ../../agrolib/interpolation  \
-                ../phenology ../climate
+                ../phenology ../climate ../homogeneity
 
 SOURCES += \
     annualSeriesChartView.cpp \
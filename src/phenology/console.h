@@ -2,14 +2,21 @@
 #define CONSOLE_H
 
     #include <iostream>
+    #include <string>
 
     class Console
     {
     private:
         FILE* m_stream;
+        bool m_isBuffered;
+        std::string m_buffer;
 
     public:
-        Console() : m_stream(nullptr) {}
+        Console() : m_stream(nullptr), m_isBuffered(false) {}
+
+        // senza file di log i messaggi sono accodati in memoria (non su standard output)
+        void SetBuffered(bool isBuffered) { m_isBuffered = isBuffered; }
+        const std::string& Buffer() const { return m_buffer; }
 
         void Open(const char* filename, const char* mode)
         {
@@ -47,6 +54,12 @@
           if( m_stream )
               return fprintf(m_stream, "%s", message);
 
+          if( m_isBuffered )
+          {
+              m_buffer += message;
+              return false;
+          }
+
           printf("%s", message);
           return false;
         }
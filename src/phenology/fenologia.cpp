@@ -51,6 +51,29 @@ std::string getStringMapPhenoCrop(std::map<phenoCrop, std::string> map, phenoCro
     return "";
 }
 
+static bool runFenologia(Stazione& stazione, const Parametri& parametri, Console& console, float* valori)
+{
+    Fenologia fenologia;
+
+    if( fenologia.SceltaColtura(parametri, console) )
+    {
+        fenologia.CalcolaFase(stazione, parametri, console);
+
+        for( long giorno = 0; giorno < stazione.NumeroGiorni(); giorno++ )
+            valori[giorno] = static_cast<float>(fenologia.FaseFenologica(giorno, parametri));
+
+        return true;
+    }
+    else
+    {
+        for( long giorno = 0; giorno < stazione.NumeroGiorni(); giorno++ )
+            valori[giorno] = static_cast<float>(parametri.dato_mancante);
+
+        return false;
+    }
+}
+
+
 void feno( float soglia, int coltura, int varieta, char* logfile, int max_giorni_interpolazione,
            float dato_mancante, int tipoScala, int giornoInizio, int meseInizio, int annoInizio,
            int numeroGiorni, char* nome, char* codice, int lat_gradi, int lat_primi, float lat_secondi,
@@ -76,22 +99,43 @@ void feno( float soglia, int coltura, int varieta, char* logfile, int max_giorni
     stazione.SetDati(tmin, tmax, prec, parametri);
 
     // calcola fase fenologica
-    Fenologia fenologia;
+    runFenologia(stazione, parametri, console, valori);
 
-    if( fenologia.SceltaColtura(parametri, console) )
-    {
-        fenologia.CalcolaFase(stazione, parametri, console);
+    logout(console);
+}
 
-        for( long giorno = 0; giorno < stazione.NumeroGiorni(); giorno++ )
-            valori[giorno] = static_cast<float>(fenologia.FaseFenologica(giorno, parametri));
-    }
-    else
-    {
-        for( long giorno = 0; giorno < stazione.NumeroGiorni(); giorno++ )
-            valori[giorno] = static_cast<float>(parametri.dato_mancante);
-    }
 
-    logout(console);
+bool computePhenologySeries(const Parametri& parametri, double latitudine, int quota,
+                            std::vector<float>& tmin, std::vector<float>& tmax, std::vector<float>& prec,
+                            std::vector<float>& valori, std::string* log)
+{
+    if( parametri.numeroGiorni <= 0
+        || long(tmin.size()) < parametri.numeroGiorni
+        || long(tmax.size()) < parametri.numeroGiorni
+        || long(prec.size()) < parametri.numeroGiorni )
+        return false;
+
+    Console console;
+    console.SetBuffered(log != nullptr);
+
+    // latitudine in gradi decimali
+    long gradi = long(latitudine);
+    double primiDecimali = (latitudine - gradi) * 60.;
+    long primi = long(primiDecimali);
+    Coordinata coordinata(gradi, primi, (primiDecimali - primi) * 60.);
+
+    std::string nome = "";
+    Stazione stazione;
+    stazione.SetAnagrafica(nome.data(), nome.data(), quota, coordinata);
+    stazione.SetDati(tmin.data(), tmax.data(), prec.data(), parametri);
+
+    valori.resize(unsigned(parametri.numeroGiorni));
+    bool isOk = runFenologia(stazione, parametri, console, valori.data());
+
+    if( log != nullptr )
+        *log += console.Buffer();
+
+    return isOk;
 }
 
 
@@ -48,6 +48,12 @@
            char* nome, char* codice, const int lat_gradi, const int lat_primi, const float lat_secondi,
            const int quota, float *tmin, float *tmax, float *prec, float* valori );
 
+    // chiamata senza file di log (es. celle della griglia in parallelo):
+    // serie giornaliere da parametri.dataInizio, i messaggi sono accodati a log se non nullo
+    bool computePhenologySeries(const Parametri& parametri, double latitudine, int quota,
+                                std::vector<float>& tmin, std::vector<float>& tmax, std::vector<float>& prec,
+                                std::vector<float>& valori, std::string* log);
+
 
     class Fenologia
     {
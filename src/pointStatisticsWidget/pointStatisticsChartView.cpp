@@ -47,7 +47,7 @@ PointStatisticsChartView::PointStatisticsChartView(QWidget *parent) :
     m_tooltip->hide();
 }
 
-void PointStatisticsChartView::drawTrend(std::vector<int> years, std::vector<float> outputValues)
+void PointStatisticsChartView::drawTrend(const std::vector<int> &years, const std::vector<float> &outputValues)
 {
 
     if (chart()->series().size() > 0)
@@ -149,7 +149,7 @@ void PointStatisticsChartView::cleanTrendSeries()
     }
 }
 
-void PointStatisticsChartView::drawClima(QList<QPointF> dailyPointList, QList<QPointF> decadalPointList, QList<QPointF> monthlyPointList)
+void PointStatisticsChartView::drawClima(const QList<QPointF> &dailyPointList, const QList<QPointF> &decadalPointList, const QList<QPointF> &monthlyPointList)
 {
     if (chart()->series().size() > 0)
     {
@@ -230,7 +230,7 @@ void PointStatisticsChartView::drawClima(QList<QPointF> dailyPointList, QList<QP
     connect(climaMonthly, &QLineSeries::hovered, this, &PointStatisticsChartView::tooltipClimaSeries);
 }
 
-void PointStatisticsChartView::drawDistribution(std::vector<float> barValues, QList<QPointF> lineValues, int minValue, int maxValue, int classWidthValue)
+void PointStatisticsChartView::drawDistribution(const std::vector<float> &barValues, const QList<QPointF> &lineValues, int minValue, int maxValue, int classWidthValue)
 {
 
     if (chart()->series().size() > 0)
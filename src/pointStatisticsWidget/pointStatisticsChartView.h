@@ -19,9 +19,9 @@ class PointStatisticsChartView : public QChartView
     Q_OBJECT
 public:
     explicit PointStatisticsChartView(QWidget *parent = 0);
-    void drawTrend(std::vector<int> years, std::vector<float> outputValues);
-    void drawClima(QList<QPointF> dailyPointList, QList<QPointF> decadalPointList, QList<QPointF> monthlyPointList);
-    void drawDistribution(std::vector<float> barValues, QList<QPointF> lineValues, int minValue, int maxValue, int classWidthValue);
+    void drawTrend(const std::vector<int> &years, const std::vector<float> &outputValues);
+    void drawClima(const QList<QPointF> &dailyPointList, const QList<QPointF> &decadalPointList, const QList<QPointF> &monthlyPointList);
+    void drawDistribution(const std::vector<float> &barValues, const QList<QPointF> &lineValues, int minValue, int maxValue, int classWidthValue);
     void tooltipTrendSeries(QPointF point, bool state);
     void tooltipClimaSeries(QPointF point, bool state);
     void tooltipDistributionSeries(QPointF point, bool state);
@@ -632,29 +632,43 @@ void Crit3DPointStatisticsWidget::plot()
 
             FormInfo formInfo;
             formInfo.showInfo("compute annual series...");
-            // copy data to MPTemp
-            Crit3DMeteoPoint meteoPointTemp;
-            // copy all data to meteoPointTemp from joint if there are holes
-            if (_idPointList.size() != 1)
+            std::vector<int> vectorYears;
+            int validYears = 0;
+
+            // single point: monthly aggregates of the db
+            bool isFromAggregates = false;
+            if (! isGrid && _idPointList.size() == 1)
             {
-                int numberOfDays = firstDate.daysTo(lastDate)+1;
-                meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
-                for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
-                {
-                    checkValueAndMerge(_meteoPointList[0], &meteoPointTemp, myDate);
-                }
+                isFromAggregates = computeAnnualSeriesOnPointFromAggregates(meteoPointsDbHandler, QString::fromStdString(_meteoPointList[0].id),
+                                                                            meteoSettings, _climateElaboration, outputValues,
+                                                                            vectorYears, validYears, myError);
             }
-            else
+
+            if (! isFromAggregates)
             {
-                meteoPointTemp = _meteoPointList[0];
-            }
+                // copy data to MPTemp
+                Crit3DMeteoPoint meteoPointTemp;
+                // copy all data to meteoPointTemp from joint if there are holes
+                if (_idPointList.size() != 1)
+                {
+                    int numberOfDays = firstDate.daysTo(lastDate)+1;
+                    meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+                    for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
+                    {
+                        checkValueAndMerge(_meteoPointList[0], &meteoPointTemp, myDate);
+                    }
+                }
+                else
+                {
+                    meteoPointTemp = _meteoPointList[0];
+                }
 
-            bool dataAlreadyLoaded = true;
-            std::vector<int> vectorYears;
-            int validYears = computeAnnualSeriesOnPointFromDaily(meteoPointsDbHandler, meteoGridDbHandler,
-                                                             &meteoPointTemp, meteoSettings, _climateElaboration, isGrid,
-                                                             isAnomaly, dataAlreadyLoaded,
-                                                             outputValues, vectorYears, myError);
+                bool dataAlreadyLoaded = true;
+                validYears = computeAnnualSeriesOnPointFromDaily(meteoPointsDbHandler, meteoGridDbHandler,
+                                                                 &meteoPointTemp, meteoSettings, _climateElaboration, isGrid,
+                                                                 isAnomaly, dataAlreadyLoaded,
+                                                                 outputValues, vectorYears, myError);
+            }
 
             formInfo.close();
             if (validYears < 3)
@@ -1569,28 +1583,42 @@ void Crit3DPointStatisticsWidget::showElaboration()
         bool isAnomaly = false;
         FormInfo formInfo;
         formInfo.showInfo("compute...");
-        // copy data to MPTemp
-        Crit3DMeteoPoint meteoPointTemp;
-        // copy all data to meteoPointTemp from joint if there are holes
-        if (_idPointList.size() != 1)
+        std::vector<int> vectorYears;
+        int validYears = 0;
+
+        // single point: monthly aggregates of the db
+        bool isFromAggregates = false;
+        if (! isGrid && _idPointList.size() == 1)
         {
-            int numberOfDays = firstDate.daysTo(lastDate)+1;
-            meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
-            for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
-            {
-                checkValueAndMerge(_meteoPointList[0], &meteoPointTemp, myDate);
-            }
+            isFromAggregates = computeAnnualSeriesOnPointFromAggregates(meteoPointsDbHandler, QString::fromStdString(_meteoPointList[0].id),
+                                                                        meteoSettings, _climateElaboration, outputValues,
+                                                                        vectorYears, validYears, myError);
         }
-        else
+
+        if (! isFromAggregates)
         {
-            meteoPointTemp = _meteoPointList[0];
-        }
-        bool dataAlreadyLoaded = true;
-        std::vector<int> vectorYears;
-        int validYears = computeAnnualSeriesOnPointFromDaily(meteoPointsDbHandler, meteoGridDbHandler,
+            // copy data to MPTemp
+            Crit3DMeteoPoint meteoPointTemp;
+            // copy all data to meteoPointTemp from joint if there are holes
+            if (_idPointList.size() != 1)
+            {
+                int numberOfDays = firstDate.daysTo(lastDate)+1;
+                meteoPointTemp.initializeObsDataD(numberOfDays, getCrit3DDate(firstDate));
+                for (QDate myDate = firstDate; myDate <= lastDate; myDate = myDate.addDays(1) )
+                {
+                    checkValueAndMerge(_meteoPointList[0], &meteoPointTemp, myDate);
+                }
+            }
+            else
+            {
+                meteoPointTemp = _meteoPointList[0];
+            }
+            bool dataAlreadyLoaded = true;
+            validYears = computeAnnualSeriesOnPointFromDaily(meteoPointsDbHandler, meteoGridDbHandler,
                                                              &meteoPointTemp, meteoSettings, _climateElaboration, isGrid,
                                                              isAnomaly, dataAlreadyLoaded,
                                                              outputValues, vectorYears, myError);
+        }
         if (validYears < 3)
         {
             //copy to clima original value for next elab
@@ -19,12 +19,16 @@
 #include "shell.h"
 #include "dialogShiftData.h"
 #include "quality.h"
+#include "homogeneity.h"
 
 #include <qdebug.h>
 #include <QFile>
 #include <QDir>
 #include <QtSql>
 
+#include <algorithm>
+#include <omp.h>
+
 PragaProject::PragaProject()
 {
     initializePragaProject();
@@ -1926,13 +1930,6 @@ bool PragaProject::averageSeriesOnZonesMeteoGrid(meteoVariable variable, meteoCo
         logInfoGUI("Assign aggregation points...");
     }
 
-    std::vector <std::vector<int> > meteoGridRow(zoneGrid->header->nrRows, std::vector<int>(zoneGrid->header->nrCols, NODATA));
-    std::vector <std::vector<int> > meteoGridCol(zoneGrid->header->nrRows, std::vector<int>(zoneGrid->header->nrCols, NODATA));
-
-    meteoGridDbHandler->meteoGrid()->saveRowColfromZone(zoneGrid, meteoGridRow, meteoGridCol);
-
-    std::vector <std::vector<int>> indexRowCol(meteoGridDbHandler->gridStructure().header().nrRows, std::vector<int>(meteoGridDbHandler->gridStructure().header().nrCols, NODATA));
-
     gis::updateMinMaxRasterGrid(zoneGrid);
     if (zoneGrid->minimum < 0 || zoneGrid->maximum < 0)
     {
@@ -1941,6 +1938,10 @@ bool PragaProject::averageSeriesOnZonesMeteoGrid(meteoVariable variable, meteoCo
     }
     const int maximumId = int(zoneGrid->maximum);
 
+    // active meteo grid cells of each zone
+    TZoneIndex zoneIndex;
+    meteoGridDbHandler->meteoGrid()->saveRowColfromZone(zoneGrid, zoneIndex);
+
     std::vector<double> utmXvector(maximumId + 1, 0.);
     std::vector<double> utmYvector(maximumId + 1, 0.);
     std::vector<int> count(maximumId + 1, 0);
@@ -1953,17 +1954,17 @@ bool PragaProject::averageSeriesOnZonesMeteoGrid(meteoVariable variable, meteoCo
 
             if (! isEqual(zoneGridValue, zoneGrid->header->flag))
             {
-                const int zoneIndex = int(zoneGridValue);
+                const int zoneId = int(zoneGridValue);
 
-                if (zoneIndex >= 0 &&  zoneIndex <= maximumId)
+                if (zoneId >= 0 &&  zoneId <= maximumId)
                 {
                     double utmX, utmY;
                     zoneGrid->getXY(zoneRow, zoneCol, utmX, utmY);
 
-                    utmXvector[zoneIndex] += utmX;
-                    utmYvector[zoneIndex] += utmY;
+                    utmXvector[zoneId] += utmX;
+                    utmYvector[zoneId] += utmY;
 
-                    count[zoneIndex]++;
+                    count[zoneId]++;
                 }
             }
         }
@@ -1997,163 +1998,197 @@ bool PragaProject::averageSeriesOnZonesMeteoGrid(meteoVariable variable, meteoCo
         return false;
     }
 
+    // zone index on the series: zones in the order of idZoneVector, cells replaced by the index of their series
+    int nrGridCols = meteoGridDbHandler->gridStructure().header().nrCols;
+    int nrGridCells = meteoGridDbHandler->gridStructure().header().nrRows * nrGridCols;
+    std::vector<int> seriesIndex(unsigned(nrGridCells), NODATA);
+    std::vector<int> seriesCellIndex;
+
+    TZoneIndex zoneSeries;
+    zoneSeries.offset.push_back(0);
+    for (unsigned int i = 0; i < idZoneVector.size(); i++)
+    {
+        int zone = idZoneVector[i];
+        if (zone < zoneIndex.nrZones())
+        {
+            for (unsigned int k = zoneIndex.offset[zone]; k < zoneIndex.offset[zone + 1]; k++)
+            {
+                int cellIndex = zoneIndex.cellIndex[k];
+                if (seriesIndex[cellIndex] == NODATA)
+                {
+                    seriesIndex[cellIndex] = int(seriesCellIndex.size());
+                    seriesCellIndex.push_back(cellIndex);
+                }
+                zoneSeries.cellIndex.push_back(seriesIndex[cellIndex]);
+                zoneSeries.weight.push_back(zoneIndex.weight[k]);
+            }
+        }
+        zoneSeries.offset.push_back(unsigned(zoneSeries.cellIndex.size()));
+    }
+
+    QString varString = QString::fromStdString(getVariableString(variable));
+    unsigned int nrSeries = unsigned(seriesCellIndex.size());
+    if (nrSeries == 0)
+    {
+        errorString = "No active meteo grid cells in the zones.";
+        return false;
+    }
+
+    // the series are loaded and aggregated in blocks of days, each block is saved before loading the next one
+    bool isHourly = (getVarFrequency(variable) == hourly);
+    int stepsPerDay = isHourly ? 24 : 1;
+    int blockDays = isHourly ? ZONE_AGGREGATION_BLOCK_DAYS_HOURLY : ZONE_AGGREGATION_BLOCK_DAYS;
+    QString periodType = isHourly ? "H" : "D";
+    aggregationDbHandler->initAggregatedTables(idZoneVector, aggregationString, periodType, startDate, endDate, variable);
+
     int infoStep = 0;
     if (showInfo)
     {
         closeLogInfo();
-        infoStep = setProgressBar("Creating data array...", this->meteoGridDbHandler->gridStructure().header().nrRows);
+        infoStep = setProgressBar("Computing spatial aggregation...", int(nrSeries));
     }
 
-    // load data
-    unsigned int nrDays = startDate.daysTo(endDate) + 1;
     Crit3DMeteoPoint meteoPointTemp;
     std::vector<float> outputSeries, outputValues;
+    std::vector<bool> isValidSeries(nrSeries, false);
+    bool isDataSaved = false;
 
-    int nrActiveCells = 0;
-    int indexSeries = 0;
-    for (int row = 0; row < meteoGridDbHandler->gridStructure().header().nrRows; row++)
+    for (QDate firstDate = startDate; firstDate <= endDate; firstDate = firstDate.addDays(blockDays))
     {
-        if (showInfo && (row % infoStep) == 0)
-            updateProgressBar(row);
+        QDate lastDate = std::min(firstDate.addDays(blockDays - 1), endDate);
+        int nrDays = firstDate.daysTo(lastDate) + 1;
+        unsigned int nrSteps = unsigned(nrDays * stepsPerDay);
 
-        for (int col = 0; col < meteoGridDbHandler->gridStructure().header().nrCols; col++)
+        if (showInfo)
+            updateProgressBarText("Computing spatial aggregation: " + firstDate.toString("yyyy-MM-dd")
+                                  + " " + lastDate.toString("yyyy-MM-dd"));
+
+        // load data
+        outputSeries.assign(nrSeries * nrSteps, NODATA);
+        bool isBlockData = false;
+        for (unsigned int i = 0; i < nrSeries; i++)
         {
-            std::string id;
-            if (meteoGridDbHandler->meteoGrid()->getMeteoPointActiveId(row, col, id))
-            {
-                ++nrActiveCells;
-                Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col);
+            if (showInfo && (i % unsigned(infoStep)) == 0)
+                updateProgressBar(int(i));
 
-                // copy data to MPTemp
-                meteoPointTemp.id = meteoPoint->id;
-                meteoPointTemp.point.z = meteoPoint->point.z;
-                meteoPointTemp.latitude = meteoPoint->latitude;
-                meteoPointTemp.elaboration = meteoPoint->elaboration;
+            int row = seriesCellIndex[i] / nrGridCols;
+            int col = seriesCellIndex[i] % nrGridCols;
+            Crit3DMeteoPoint* meteoPoint = meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col);
 
-                // meteoPointTemp should be init
-                meteoPointTemp.nrObsDataDaysH = 0;
-                meteoPointTemp.nrObsDataDaysD = 0;
+            // copy data to MPTemp
+            meteoPointTemp.id = meteoPoint->id;
+            meteoPointTemp.point.z = meteoPoint->point.z;
+            meteoPointTemp.latitude = meteoPoint->latitude;
+            meteoPointTemp.elaboration = meteoPoint->elaboration;
 
-                outputValues.clear();
-                float percValue;
-                bool isMeteoGrid = true;
-                if (preElaboration(nullptr, meteoGridDbHandler, &meteoPointTemp, isMeteoGrid,
-                                   variable, elab1MeteoComp, startDate, endDate, outputValues,
-                                   &percValue, meteoSettings, errorString))
+            // meteoPointTemp should be init
+            meteoPointTemp.nrObsDataDaysH = 0;
+            meteoPointTemp.nrObsDataDaysD = 0;
+
+            outputValues.clear();
+            float percValue;
+            bool isMeteoGrid = true;
+            if (preElaboration(nullptr, meteoGridDbHandler, &meteoPointTemp, isMeteoGrid,
+                               variable, elab1MeteoComp, firstDate, lastDate, outputValues,
+                               &percValue, meteoSettings, errorString))
+            {
+                // TODO: percentage? (Problem with outputValues size)
+                if (outputValues.size() == nrSteps)
                 {
-                    // TODO: percentage? (Problem with outputValues size)
-                    if (outputValues.size() == nrDays)
-                    {
-                        outputSeries.insert(outputSeries.end(), outputValues.begin(), outputValues.end());
-                        indexRowCol[row][col] = indexSeries;
-                        ++indexSeries;
-                    }
+                    std::copy(outputValues.begin(), outputValues.end(), outputSeries.begin() + i * nrSteps);
+                    isValidSeries[i] = true;
+                    isBlockData = true;
                 }
             }
         }
+
+        if (! isBlockData)
+            continue;
+
+        bool isOk;
+        if (isHourly)
+        {
+            isOk = hourlyZoneAggregationMeteoGrid(variable, aggregationString, threshold, idZoneVector, zoneSeries,
+                                                  outputSeries, getCrit3DDate(firstDate), nrDays);
+        }
+        else
+        {
+            isOk = dailyZoneAggregationMeteoGrid(variable, aggregationString, threshold, idZoneVector, zoneSeries,
+                                                 outputSeries, getCrit3DDate(firstDate), nrDays);
+        }
+
+        if (! isOk)
+        {
+            if (showInfo)
+                closeProgressBar();
+            return false;
+        }
+
+        isDataSaved = true;
     }
 
     if (showInfo)
         closeProgressBar();
 
     // check valid data
-    QString varString = QString::fromStdString(getVariableString(variable));
-    if (indexSeries == 0)
+    int nrMissingSeries = int(std::count(isValidSeries.begin(), isValidSeries.end(), false));
+    if (! isDataSaved)
     {
         errorString = "Missing data for variable: " + varString + " in all grid cells.";
         return false;
     }
-    else if (indexSeries < nrActiveCells)
+    else if (nrMissingSeries > 0)
     {
-        QString nrMissing = QString::number(nrActiveCells - indexSeries);
-        logWarning("Missing data for variable: " + varString + " in " + nrMissing + " grid cells.");
+        logWarning("Missing data for variable: " + varString + " in " + QString::number(nrMissingSeries) + " grid cells.");
     }
 
-    if (getVarFrequency(variable) == hourly)
-    {
-        return hourlyZoneAggregationMeteoGrid(variable, aggregationString, threshold, zoneGrid, idZoneVector, outputSeries,
-                                             indexRowCol, meteoGridRow, meteoGridCol, getCrit3DDate(startDate), nrDays, showInfo);
-    }
-    else
-    {
-        return dailyZoneAggregationMeteoGrid(variable, aggregationString, threshold, zoneGrid, idZoneVector, outputSeries,
-                                             indexRowCol, meteoGridRow, meteoGridCol, getCrit3DDate(startDate), nrDays, showInfo);
-    }
+    return true;
 }
 
 
-bool PragaProject::dailyZoneAggregationMeteoGrid(meteoVariable variable, const QString& aggregationString, float threshold,
-                                                gis::Crit3DRasterGrid* zoneGrid, std::vector<int> &idZoneVector,
-                                                std::vector<float> &outputSeries, std::vector<std::vector<int>> &indexRowCol,
-                                                std::vector<std::vector<int>> &meteoGridRow, std::vector<std::vector<int>> &meteoGridCol,
-                                                const Crit3DDate& startDate, int nrDays, bool showInfo)
+/*!
+ * \brief aggregateZoneSeries
+ * spatial aggregation of the series of each zone, for each time step
+ * series: nrSteps values for each series (series index of zoneSeries)
+ * the weight of a series is the number of zone raster cells falling in its meteo grid cell
+ */
+static void aggregateZoneSeries(aggregationMethod spatialElab, float threshold, float flag,
+                                const TZoneIndex &zoneSeries, const std::vector<float> &series, unsigned int nrSteps,
+                                bool isParallelComputing, std::vector<std::vector<float>> &elabAggregation)
 {
-    int infoStep = 0;
-    if (showInfo)
-    {
-        infoStep = setProgressBar("Computing spatial aggregation...", nrDays);
-    }
-
-    // matrix of values
-    unsigned int nrOfZones = unsigned(idZoneVector.size());
-    std::vector<std::vector<float>> zoneValues(nrOfZones, std::vector<float>());
+    int nrOfZones = zoneSeries.nrZones();
+    bool useThreshold = ! isEqual(threshold, NODATA);
 
-    aggregationMethod spatialElab = getAggregationMethod(aggregationString.toStdString());
-    std::vector<std::vector<float>> dailyElabAggregation(nrDays, std::vector<float>(nrOfZones, NODATA));
-
-    std::unordered_map<int, int> zoneIndexMap;
-    for (size_t i = 0; i < idZoneVector.size(); ++i)
-    {
-        zoneIndexMap[idZoneVector[i]] = int(i);
-    }
-
-    for (int day = 0; day < nrDays; day++)
+    #pragma omp parallel for if(isParallelComputing) schedule(dynamic)
+    for (int i = 0; i < nrOfZones; i++)
     {
-        if (showInfo && (day % infoStep) == 0)
-            updateProgressBar(day);
+        unsigned int first = zoneSeries.offset[unsigned(i)];
+        unsigned int last = zoneSeries.offset[unsigned(i) + 1];
+        std::vector<float> validValues;
 
-        for (int zoneRow = 0; zoneRow < zoneGrid->header->nrRows; zoneRow++)
+        for (unsigned int step = 0; step < nrSteps; step++)
         {
-            for (int zoneCol = 0; zoneCol < zoneGrid->header->nrCols; zoneCol++)
+            double sum = 0;
+            double sumWeight = 0;
+            validValues.clear();
+
+            for (unsigned int k = first; k < last; k++)
             {
-                float zoneNr = zoneGrid->value[zoneRow][zoneCol];
+                float value = series[unsigned(zoneSeries.cellIndex[k]) * nrSteps + step];
+                if (isEqual(value, flag) || isEqual(value, NODATA))
+                    continue;
+                if (useThreshold && value < threshold)
+                    continue;
 
-                if (! isEqual(zoneNr, zoneGrid->header->flag))
+                if (spatialElab == aggrAverage)
                 {
-                    if (meteoGridRow[zoneRow][zoneCol] != NODATA && meteoGridCol[zoneRow][zoneCol] != NODATA)
-                    {
-                        int indexSeries = indexRowCol[meteoGridRow[zoneRow][zoneCol]][meteoGridCol[zoneRow][zoneCol]];
-
-                        if (indexSeries != NODATA)
-                        {
-                            float value = outputSeries.at(indexSeries * nrDays + day);
-
-                            if (! isEqual(value, meteoGridDbHandler->gridStructure().header().flag))
-                            {
-                                auto it = zoneIndexMap.find(int(zoneNr));
-
-                                if (it == zoneIndexMap.end())
-                                {
-                                    errorString = "Invalid zone number: " + QString::number(zoneNr);
-                                    return false;
-                                }
-
-                                const int index = it->second;
-                                zoneValues[index].push_back(value);
-                            }
-                        }
-                    }
+                    sum += double(value) * zoneSeries.weight[k];
+                    sumWeight += zoneSeries.weight[k];
+                }
+                else
+                {
+                    validValues.insert(validValues.end(), unsigned(zoneSeries.weight[k]), value);
                 }
-            }
-        }
-
-        for (unsigned int i = 0; i < nrOfZones; i++)
-        {
-            std::vector<float> validValues = zoneValues[i];
-            if (! isEqual(threshold, NODATA))
-            {
-                bool useThreshold = true;
-                extractValidValues(validValues, threshold, useThreshold);
             }
 
             float res = NODATA;
@@ -2161,11 +2196,6 @@ bool PragaProject::dailyZoneAggregationMeteoGrid(meteoVariable variable, const Q
 
             switch (spatialElab)
             {
-                case aggrAverage:
-                    {
-                        res = statistics::mean(validValues);
-                        break;
-                    }
                 case aggrMedian:
                     {
                         res = sorting::percentile(validValues, size, 50.0, true);
@@ -2181,6 +2211,12 @@ bool PragaProject::dailyZoneAggregationMeteoGrid(meteoVariable variable, const Q
                         res = sorting::percentile(validValues, size, 95.0, true);
                         break;
                     }
+                case aggrAverage:
+                    {
+                        if (sumWeight > 0)
+                            res = float(sum / sumWeight);
+                        break;
+                    }
                 default:
                     {
                         // default: average
@@ -2189,171 +2225,60 @@ bool PragaProject::dailyZoneAggregationMeteoGrid(meteoVariable variable, const Q
                     }
             }
 
-            dailyElabAggregation[unsigned(day)][i] = res;
-        }
-
-        // clear zoneValues matrix
-        for (unsigned int i = 0; i < nrOfZones; i++)
-        {
-            zoneValues[i].clear();
+            elabAggregation[step][unsigned(i)] = res;
         }
-        // end DAY
     }
+}
 
-    if (showInfo)
-         logInfoGUI("Saving daily data...");
 
-    // save aggregation into DB
+bool PragaProject::dailyZoneAggregationMeteoGrid(meteoVariable variable, const QString& aggregationString, float threshold,
+                                                 const std::vector<int> &idZoneVector, const TZoneIndex &zoneSeries,
+                                                 const std::vector<float> &outputSeries, const Crit3DDate& startDate, int nrDays)
+{
+    unsigned int nrOfZones = unsigned(idZoneVector.size());
+    aggregationMethod spatialElab = getAggregationMethod(aggregationString.toStdString());
+    std::vector<std::vector<float>> dailyElabAggregation(unsigned(nrDays), std::vector<float>(nrOfZones, NODATA));
+
+    aggregateZoneSeries(spatialElab, threshold, meteoGridDbHandler->gridStructure().header().flag, zoneSeries,
+                        outputSeries, unsigned(nrDays), isParallelComputing(), dailyElabAggregation);
+
+    // save aggregation into DB (tables are initialized on the whole period)
     QDate startQDate = getQDate(startDate);
     QDate endQDate = startQDate.addDays(nrDays-1);
     bool isOk = aggregationDbHandler->saveAggregationData(idZoneVector, aggregationString, "D",
-                                                      startQDate, endQDate, variable, dailyElabAggregation);
+                                                      startQDate, endQDate, variable, dailyElabAggregation, false);
 
     if (! isOk)
     {
          errorString = aggregationDbHandler->error();
     }
 
-    if (showInfo)
-        closeProgressBar();
-
     return isOk;
 }
 
 
 bool PragaProject::hourlyZoneAggregationMeteoGrid(meteoVariable variable, const QString& aggregationString, float threshold,
-                                                 gis::Crit3DRasterGrid* zoneRaster, std::vector<int> &idZoneVector,
-                                                 std::vector<float> &outputSeries, std::vector<std::vector<int>> &indexRowCol,
-                                                 std::vector<std::vector<int>> &meteoGridRow, std::vector<std::vector<int>> &meteoGridCol,
-                                                 const Crit3DDate& startDate, int nrDays, bool showInfo)
+                                                  const std::vector<int> &idZoneVector, const TZoneIndex &zoneSeries,
+                                                  const std::vector<float> &outputSeries, const Crit3DDate& startDate, int nrDays)
 {
-    int infoStep = 0;
-    if (showInfo)
-    {
-        infoStep = setProgressBar("Computing spatial aggregation...", nrDays);
-    }
-
-    // matrix of values
     unsigned int nrOfZones = unsigned(idZoneVector.size());
-    std::vector<std::vector<float>> zoneValues(nrOfZones, std::vector<float>());
-
     aggregationMethod spatialElab = getAggregationMethod(aggregationString.toStdString());
-    std::vector<std::vector<float>> hourlyElabAggregation(nrDays * 24, std::vector<float>(nrOfZones, NODATA));
-
-    for (int day = 0; day < nrDays; day++)
-    {
-        if (showInfo && (day % infoStep) == 0)
-            updateProgressBar(day);
-
-        for (int hour = 0; hour < 24; hour++)
-        {
-            for (int row = 0; row < zoneRaster->header->nrRows; row++)
-            {
-                for (int col = 0; col < zoneRaster->header->nrCols; col++)
-                {
-                    float zoneNr = zoneRaster->value[row][col];
-                    if (! isEqual(zoneNr, zoneRaster->header->flag))
-                    {
-                        if (meteoGridRow[row][col] != NODATA && meteoGridCol[row][col] != NODATA)
-                        {
-                            int indexSeries = indexRowCol[meteoGridRow[row][col]][meteoGridCol[row][col]];
-                            if (indexSeries != NODATA)
-                            {
-                                float value = outputSeries.at(indexSeries * nrDays * 24 + (day * 24) + hour);
-                                if (value != meteoGridDbHandler->gridStructure().header().flag)
-                                {
-                                    const auto it = std::find(idZoneVector.begin(), idZoneVector.end(), int(zoneNr));
-                                    if (it == idZoneVector.end())
-                                    {
-                                        errorString = "Invalid zone number: " + QString::number(zoneNr);
-                                        return false;
-                                    }
-                                    int index = std::distance(idZoneVector.begin(), it);
-                                    zoneValues[index].push_back(value);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
-            for (unsigned int i = 0; i < nrOfZones; i++)
-            {
-                std::vector<float> validValues;
-                validValues = zoneValues[i];
-                if (! isEqual(threshold, NODATA))
-                {
-                    bool useThreshold = true;
-                    extractValidValues(validValues, threshold, useThreshold);
-                }
-
-                float res = NODATA;
-                switch (spatialElab)
-                {
-                    case aggrAverage:
-                    {
-                        res = statistics::mean(validValues);
-                        break;
-                    }
-                    case aggrMedian:
-                    {
-                        int size = int(validValues.size());
-                        res = sorting::percentile(validValues, size, 50.0, true);
-                        break;
-                    }
-                    case aggrStdDeviation:
-                    {
-                        res = statistics::standardDeviation(validValues, int(validValues.size()));
-                        break;
-                    }
-                    case aggr95Perc:
-                    {
-                        int size = int(validValues.size());
-                        res = sorting::percentile(validValues, size, 95.0, true);
-                        break;
-                    }
-                    default:
-                    {
-                        // default: average
-                        res = statistics::mean(validValues);
-                        break;
-                    }
-                }
-
-                hourlyElabAggregation[unsigned(day * 24 + hour)][i] = res;
-            }
-
-            // clear zoneValues vectors
-            for (unsigned int i = 0; i < nrOfZones; i++)
-            {
-                zoneValues[i].clear();
-            }
-            // end hour
-        }
-        // end day
-    }
+    std::vector<std::vector<float>> hourlyElabAggregation(unsigned(nrDays * 24), std::vector<float>(nrOfZones, NODATA));
 
-    if (showInfo)
-    {
-        closeProgressBar();
-        logInfoGUI("Saving hourly data...");
-    }
+    aggregateZoneSeries(spatialElab, threshold, meteoGridDbHandler->gridStructure().header().flag, zoneSeries,
+                        outputSeries, unsigned(nrDays * 24), isParallelComputing(), hourlyElabAggregation);
 
-    // save aggregation into DB
+    // save aggregation into DB (tables are initialized on the whole period)
     QDate startQDate = getQDate(startDate);
     QDate endQDate = startQDate.addDays(nrDays-1);
     bool isOk = aggregationDbHandler->saveAggregationData(idZoneVector, aggregationString, "H",
-                                                        startQDate, endQDate, variable, hourlyElabAggregation);
-    hourlyElabAggregation.clear();
+                                                        startQDate, endQDate, variable, hourlyElabAggregation, false);
 
     if (! isOk)
     {
         errorString = aggregationDbHandler->error();
     }
 
-    if (showInfo)
-        closeProgressBar();
-
     return isOk;
 }
 
@@ -2585,27 +2510,19 @@ bool PragaProject::derivedVariablesMeteoGridPeriod(QDate first, QDate last, QLis
         loadMeteoGridDailyData(firstDate, lastDate, false);
     }
 
+    // each cell is computed on the whole period
     if (isHourly)
     {
-        while(firstDateTime <= lastDateTime)
-        {
-            foreach (myVar, hourlyVars)
-                meteoGridDbHandler->meteoGrid()->computeHourlyDerivedVar(getCrit3DTime(firstDateTime), myVar, useNetRad);
-
-            firstDateTime = firstDateTime.addSecs(3600);
-        }
+        foreach (myVar, hourlyVars)
+            meteoGridDbHandler->meteoGrid()->computeHourlyDerivedVarPeriod(getCrit3DDate(first), getCrit3DDate(last),
+                                                                           myVar, useNetRad, isParallelComputing());
     }
 
     if (isDaily)
     {
-        QDate myDate = first;
-        while (myDate <= last)
-        {
-            foreach (myVar, dailyVars)
-                meteoGridDbHandler->meteoGrid()->computeDailyDerivedVar(getCrit3DDate(myDate), myVar, *meteoSettings);
-
-            myDate = myDate.addDays(1);
-        }
+        foreach (myVar, dailyVars)
+            meteoGridDbHandler->meteoGrid()->computeDailyDerivedVarPeriod(getCrit3DDate(first), getCrit3DDate(last),
+                                                                          myVar, *meteoSettings, isParallelComputing());
     }
 
     firstDateTime = QDateTime(first, QTime(1,0), Qt::UTC);
@@ -2618,6 +2535,8 @@ bool PragaProject::derivedVariablesMeteoGridPeriod(QDate first, QDate last, QLis
 
 bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDate, QList <meteoVariable> variables)
 {
+    Crit3DSpatialQualityRun spatialQualityRun(this);
+
     // check
     if (variables.size() == 0)
     {
@@ -2696,18 +2615,34 @@ bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDa
             return false;
     }
 
-    // initialize data list
-    QVector<QList<QString>> dailyDataList;
-    QVector<QList<QString>> hourlyDataList;
-    if (isDaily)
+    // output buffers of each loading period, written with one batch
+    // values: index = (timeIndex * nrVariables + varIndex) * nrOutputPoints + pointIndex
+    int nrOutputPoints = int(outputPoints.size());
+    std::vector<QString> pointCodes(nrOutputPoints);
+    for (int i = 0; i < nrOutputPoints; i++)
     {
-        dailyDataList.resize(int(outputPoints.size()));
+        pointCodes[i] = QString::fromStdString(outputPoints[i].id);
     }
-    if (isHourly)
+
+    std::vector<meteoVariable> dailyVarList, hourlyVarList;
+    std::vector<int> dailyIdVarList, hourlyIdVarList;
+    foreach (myVar, variables)
     {
-        hourlyDataList.resize(int(outputPoints.size()));
+        if (getVarFrequency(myVar) == daily)
+        {
+            dailyVarList.push_back(myVar);
+            dailyIdVarList.push_back(meteoPointsDbHandler->getIdfromMeteoVar(myVar));
+        }
+        else if (getVarFrequency(myVar) == hourly)
+        {
+            hourlyVarList.push_back(myVar);
+            hourlyIdVarList.push_back(meteoPointsDbHandler->getIdfromMeteoVar(myVar));
+        }
     }
 
+    std::vector<QString> dailyTimeList, hourlyTimeList;
+    std::vector<float> dailyValues, hourlyValues;
+
     int nrDays = firstDate.daysTo(lastDate) + 1;
     int nrDaysLoading = std::min(nrDays, 30);
     QDate lastLoadingDate;
@@ -2744,45 +2679,41 @@ bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDa
                 QString dateTimeStr = myDateTime.toString("yyyy-MM-dd hh:mm:ss");
 
                 logInfoGUI("Interpolating hourly variables for " + dateTimeStr);
+                hourlyTimeList.push_back(dateTimeStr);
 
-                foreach (myVar, variables)
+                foreach (myVar, hourlyVarList)
                 {
-                    if (getVarFrequency(myVar) == hourly)
-                    {
-                        setComputeOnlyPoints(true);
+                    setComputeOnlyPoints(true);
 
-                        // TODO special variables
+                    // TODO special variables
 
-                        if (myVar == airRelHumidity && interpolationSettings.getUseDewPoint())
+                    if (myVar == airRelHumidity && interpolationSettings.getUseDewPoint())
+                    {
+                        if (interpolationSettings.getUseInterpolatedTForRH())
                         {
-                            if (interpolationSettings.getUseInterpolatedTForRH())
-                            {
-                                passInterpolatedTemperatureToHumidityPoints(getCrit3DTime(myDate, hour), meteoSettings);
-                            }
+                            passInterpolatedTemperatureToHumidityPoints(getCrit3DTime(myDate, hour), meteoSettings);
+                        }
 
-                            isOk = interpolationDemMain(airDewTemperature, getCrit3DTime(myDate, hour), hourlyMeteoMaps->mapHourlyTdew);
+                        isOk = interpolationDemMain(airDewTemperature, getCrit3DTime(myDate, hour), hourlyMeteoMaps->mapHourlyTdew);
 
-                            if (isOk)
-                            {
-                                hourlyMeteoMaps->computeRelativeHumidityMap(hourlyMeteoMaps->mapHourlyRelHum);
-                            }
-                        }
-                        else
+                        if (isOk)
                         {
-                            isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, hour), getPragaMapFromVar(myVar));
+                            hourlyMeteoMaps->computeRelativeHumidityMap(hourlyMeteoMaps->mapHourlyRelHum);
                         }
+                    }
+                    else
+                    {
+                        isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, hour), getPragaMapFromVar(myVar));
+                    }
 
-                        setComputeOnlyPoints(false);
+                    setComputeOnlyPoints(false);
 
-                        if (! isOk)
-                            return false;
+                    if (! isOk)
+                        return false;
 
-                        int varId = meteoPointsDbHandler->getIdfromMeteoVar(myVar);
-                        for (int i = 0; i < outputPoints.size(); i++)
-                        {
-                            float value = outputPoints[i].currentValue;
-                            hourlyDataList[i].push_back(QString("('%1',%2,%3)").arg(dateTimeStr).arg(varId).arg(value));
-                        }
+                    for (int i = 0; i < nrOutputPoints; i++)
+                    {
+                        hourlyValues.push_back(outputPoints[i].currentValue);
                     }
                 }
             }
@@ -2795,59 +2726,52 @@ bool PragaProject::interpolationOutputPointsPeriod(QDate firstDate, QDate lastDa
             QString dateStr = myDate.toString("yyyy-MM-dd");
 
             logInfoGUI("Interpolating daily variables for " + dateStr);
+            dailyTimeList.push_back(dateStr);
 
-            foreach (myVar, variables)
+            foreach (myVar, dailyVarList)
             {
-                if (getVarFrequency(myVar) == daily)
-                {
-                    setComputeOnlyPoints(true);
+                setComputeOnlyPoints(true);
 
-                    // TODO special variables
+                // TODO special variables
 
-                    isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, 0), getPragaMapFromVar(myVar));
+                isOk = interpolationDemMain(myVar, getCrit3DTime(myDate, 0), getPragaMapFromVar(myVar));
 
-                    setComputeOnlyPoints(false);
+                setComputeOnlyPoints(false);
 
-                    if (! isOk)
-                        return false;
+                if (! isOk)
+                    return false;
 
-                    int varId = meteoPointsDbHandler->getIdfromMeteoVar(myVar);
-                    for (int i = 0; i < outputPoints.size(); i++)
-                    {
-                        float value = outputPoints[i].currentValue;
-                        dailyDataList[i].push_back(QString("('%1',%2,%3)").arg(dateStr).arg(varId).arg(value));
-                    }
+                for (int i = 0; i < nrOutputPoints; i++)
+                {
+                    dailyValues.push_back(outputPoints[i].currentValue);
                 }
             }
         }
 
         if (myDate == lastLoadingDate)
         {
-            // save and clear datalist
-            for (int i = 0; i < outputPoints.size(); i++)
+            // save and clear the buffers
+            logInfoGUI("Saving output points data to " + lastLoadingDate.toString("yyyy-MM-dd"));
+            QString logStr = "";
+            if (isDaily)
             {
-                if (isDaily)
+                if (! outputMeteoPointsDbHandler->writeDataBatch(daily, pointCodes, dailyTimeList, dailyIdVarList, dailyValues, logStr))
                 {
-                    QString logStr = "";
-                    QString pointCode = QString::fromStdString(outputPoints[i].id);
-                    outputMeteoPointsDbHandler->writeDailyDataList(pointCode, dailyDataList[i], logStr);
-                    if (! logStr.isEmpty())
-                    {
-                        logInfo(logStr);
-                    }
-                    dailyDataList[i].clear();
+                    errorString = "Error in saving output points daily data:" + logStr;
+                    return false;
                 }
-                if (isHourly)
+                dailyTimeList.clear();
+                dailyValues.clear();
+            }
+            if (isHourly)
+            {
+                if (! outputMeteoPointsDbHandler->writeDataBatch(hourly, pointCodes, hourlyTimeList, hourlyIdVarList, hourlyValues, logStr))
                 {
-                    QString logStr = "";
-                    QString pointCode = QString::fromStdString(outputPoints[i].id);
-                    outputMeteoPointsDbHandler->writeHourlyDataList(pointCode, hourlyDataList[i], logStr);
-                    if (! logStr.isEmpty())
-                    {
-                        logInfo(logStr);
-                    }
-                    hourlyDataList[i].clear();
+                    errorString = "Error in saving output points hourly data:" + logStr;
+                    return false;
                 }
+                hourlyTimeList.clear();
+                hourlyValues.clear();
             }
         }
 
@@ -2936,7 +2860,7 @@ bool PragaProject::assignProxyValues(meteoVariable myVar)
                         if (! gis::compareGrids(DEM,*proxyGrid))
                         {
                             gis::Crit3DRasterGrid* resGrid = new gis::Crit3DRasterGrid();
-                            gis::resampleGrid(*proxyGrid, resGrid, DEM.header, aggrAverage, 0);
+                            gis::resampleGrid(*proxyGrid, resGrid, DEM.header, aggrAverage, 0, isParallelComputing());
                             myProxy->setGrid(resGrid);
                         }
                     }
@@ -2980,7 +2904,7 @@ bool PragaProject::interpolationMeteoGrid(meteoVariable myVar, frequencyType myF
                                                                            &DEM, getPragaMapFromVar(windVectorX), interpolationSettings.getMeteoGridAggrMethod());
                 meteoGridDbHandler->meteoGrid()->spatialAggregateMeteoGrid(windVectorY, hourly, myTime.date, myTime.getHour(), myTime.getMinutes(),
                                                                            &DEM, getPragaMapFromVar(windVectorY), interpolationSettings.getMeteoGridAggrMethod());
-                meteoGridDbHandler->meteoGrid()->computeWindVectorHourly(myTime.date, myTime.getHour());
+                meteoGridDbHandler->meteoGrid()->computeWindVectorHourly(myTime.date, myTime.getHour(), isParallelComputing());
             }
             else
             {
@@ -3009,13 +2933,13 @@ bool PragaProject::interpolationMeteoGrid(meteoVariable myVar, frequencyType myF
             {
                 passGridTemperatureToHumidityPoints(myTime, meteoSettings);
                 if (! interpolationGrid(airDewTemperature, myTime)) return false;
-                meteoGridDbHandler->meteoGrid()->computeRelativeHumidityFromTd(myTime.date, myTime.getHour());
+                meteoGridDbHandler->meteoGrid()->computeRelativeHumidityFromTd(myTime.date, myTime.getHour(), isParallelComputing());
             }
             else if (myVar == windVectorDirection || myVar == windVectorIntensity)
             {
                 if (! interpolationGrid(windVectorX, myTime)) return false;
                 if (! interpolationGrid(windVectorY, myTime)) return false;
-                meteoGridDbHandler->meteoGrid()->computeWindVectorHourly(myTime.date, myTime.getHour());
+                meteoGridDbHandler->meteoGrid()->computeWindVectorHourly(myTime.date, myTime.getHour(), isParallelComputing());
             }
             else if (myVar == globalIrradiance)
             {
@@ -3049,6 +2973,8 @@ bool PragaProject::interpolationMeteoGridPeriod(QDate dateIni, QDate dateFin, QL
                                                 QList <meteoVariable> derivedVariables, QList <meteoVariable> aggrVariables,
                                                 int nrDaysLoading, int nrDaysSaving)
 {
+    Crit3DSpatialQualityRun spatialQualityRun(this);
+
     // check variables
     if (variables.size() == 0)
     {
@@ -3217,7 +3143,7 @@ bool PragaProject::interpolationMeteoGridPeriod(QDate dateIni, QDate dateFin, QL
         if (useProxies && currentYear != myDate.year())
         {
             logInfoGUI("Interpolating proxy grid series...");
-            if (! checkProxyGridSeries(interpolationSettings, DEM, proxyGridSeries, myDate, errorString)) return false;
+            if (! checkProxyGridSeries(interpolationSettings, DEM, proxyGridSeries, myDate, isParallelComputing(), errorString)) return false;
 
             //cambiare anche questa funz
             if (! readProxyValues()) return false;
@@ -3311,6 +3237,7 @@ bool PragaProject::interpolationMeteoGridPeriod(QDate dateIni, QDate dateFin, QL
 
 bool PragaProject::interpolationCrossValidationPeriod(QDate dateIni, QDate dateFin, meteoVariable myVar, QString filename, int nrDaysLoading, QString glocalCVPointsName)
 {    
+    Crit3DSpatialQualityRun spatialQualityRun(this);
     logInfoGUI("Starting up...");
 
     // check meteo point
@@ -3839,16 +3766,189 @@ void PragaProject::showHomogeneityTestWidgetPoint(const std::string &idMeteoPoin
 }
 
 
-void PragaProject::showSynchronicityTestWidgetPoint(std::string idMeteoPoint)
+/*!
+ * \brief computeHomogeneityTestPoints
+ * SNHT on the annual series of all the active meteo points, with automatic selection of the reference stations
+ * (nearest points with valid series, within maxDistance [m] and with r2 >= minR2). Results are written to a csv file.
+ */
+bool PragaProject::computeHomogeneityTestPoints(meteoVariable myVar, int firstYear, int lastYear, int nrReferences,
+                                                double maxDistance, float minR2, const QString &outputFileName)
 {
-    logInfoGUI("Loading data...");
-
-    // check dates
-    QDate firstDaily = meteoPointsDbHandler->getFirstDate(daily, idMeteoPoint).date();
-    QDate lastDaily = meteoPointsDbHandler->getLastDate(daily, idMeteoPoint).date();
-    bool hasDailyData = !(firstDaily.isNull() || lastDaily.isNull());
-
-    if (!hasDailyData)
+    if (! meteoPointsLoaded || meteoPoints.empty())
+    {
+        errorString = ERROR_STR_MISSING_DB;
+        return false;
+    }
+
+    if (firstYear > lastYear || getSNHT_T95(lastYear - firstYear + 1) == NODATA)
+    {
+        errorString = "Wrong period: the number of years must be between 10 and 109";
+        return false;
+    }
+
+    QFile outputFile(outputFileName);
+    if (! outputFile.open(QIODevice::WriteOnly | QFile::Truncate))
+    {
+        errorString = "Open failure: " + outputFileName;
+        return false;
+    }
+
+    QDate firstDate(firstYear, 1, 1);
+    QDate lastDate(lastYear, 12, 31);
+
+    Crit3DClimate climate;
+    climate.setVariable(myVar);
+    if (myVar == dailyPrecipitation || myVar == dailyReferenceEvapotranspirationHS || myVar == dailyReferenceEvapotranspirationPM || myVar == dailyBIC)
+    {
+        climate.setElab1("sum");
+    }
+    else
+    {
+        climate.setElab1("average");
+    }
+    climate.setYearStart(firstYear);
+    climate.setYearEnd(lastYear);
+    climate.setGenericPeriodDateStart(firstDate);
+    climate.setGenericPeriodDateEnd(lastDate);
+    climate.setNYears(0);
+
+    // annual series: monthly aggregates of the db (serial, single connection)
+    int nrYears = lastYear - firstYear + 1;
+    int nrPoints = int(meteoPoints.size());
+    std::vector<TAnnualSeriesStation> pointSeries;
+    std::vector<int> nrValidYears;
+    pointSeries.resize(unsigned(nrPoints));
+    nrValidYears.resize(unsigned(nrPoints), 0);
+    std::vector<int> dailyIndexList;
+
+    setProgressBar("Computing annual series...", nrPoints);
+    for (int i = 0; i < nrPoints; i++)
+    {
+        updateProgressBar(i);
+
+        if (! meteoPoints[i].active || meteoPoints[i].lapseRateCode == supplemental)
+            continue;
+
+        std::vector<int> validYearsList;
+        QString myError;
+        QString idPoint = QString::fromStdString(meteoPoints[i].id);
+        if (! computeAnnualSeriesOnPointFromAggregates(meteoPointsDbHandler, idPoint, meteoSettings, climate,
+                                                       pointSeries[i].values, validYearsList, nrValidYears[i], myError))
+        {
+            dailyIndexList.push_back(i);
+        }
+    }
+    closeProgressBar();
+
+    // annual series from daily data of the remaining points: one connection for each thread
+    if (! dailyIndexList.empty())
+    {
+        logInfoGUI("Computing annual series from daily data...");
+        int nrDailyPoints = int(dailyIndexList.size());
+        int nrThreads = isParallelComputing()? std::min(omp_get_max_threads(), nrDailyPoints) : 1;
+        QString dbName = meteoPointsDbHandler->getDbName();
+        Crit3DDate myFirstDate = getCrit3DDate(firstDate);
+        Crit3DDate myLastDate = getCrit3DDate(lastDate);
+
+        #pragma omp parallel if(isParallelComputing()) num_threads(nrThreads)
+        {
+            QSqlDatabase myDb;
+            QString connectionName = "homogeneity_" + QString::number(omp_get_thread_num());
+            meteoPointsDbHandler->openNewConnection(myDb, dbName, connectionName);
+
+            #pragma omp for schedule(dynamic)
+            for (int k = 0; k < nrDailyPoints; k++)
+            {
+                int i = dailyIndexList[k];
+                Crit3DMeteoPoint mp;
+                mp.id = meteoPoints[i].id;
+                if (! meteoPointsDbHandler->loadDailyData(myDb, myFirstDate, myLastDate, mp))
+                    continue;
+
+                std::vector<int> validYearsList;
+                QString myError;
+                pointSeries[i].values.clear();
+                nrValidYears[i] = computeAnnualSeriesOnPointFromDaily(meteoPointsDbHandler, nullptr, &mp, meteoSettings, climate,
+                                                                      false, false, true, pointSeries[i].values, validYearsList, myError);
+            }
+
+            myDb.close();
+        }
+
+        for (int i = 0; i < nrThreads; i++)
+        {
+            QSqlDatabase::removeDatabase("homogeneity_" + QString::number(i));
+        }
+    }
+
+    std::vector<TAnnualSeriesStation> stations;
+    for (int i = 0; i < nrPoints; i++)
+    {
+        if (pointSeries[i].values.empty())
+            continue;
+
+        if (float(nrValidYears[i]) / float(nrYears) > meteoSettings->getMinimumPercentage() / 100.f)
+        {
+            TAnnualSeriesStation &station = pointSeries[i];
+            station.id = meteoPoints[i].id;
+            station.utmX = meteoPoints[i].point.utm.x;
+            station.utmY = meteoPoints[i].point.utm.y;
+            stations.push_back(station);
+        }
+    }
+
+    if (stations.size() < 2)
+    {
+        errorString = "Not enough meteo points with valid annual series";
+        return false;
+    }
+
+    // tests
+    logInfoGUI("Computing SNHT on " + QString::number(stations.size()) + " meteo points...");
+    bool isRatio = (myVar == dailyPrecipitation);
+    std::vector<TSNHTResult> results;
+    computeSNHTAllStations(stations, isRatio, nrReferences, maxDistance, minR2, isParallelComputing(), results);
+
+    QTextStream outStream(&outputFile);
+    outStream << "id,isHomogeneous,yearOfDiscontinuity,Tmax,T95,references\n";
+    for (unsigned int i = 0; i < stations.size(); i++)
+    {
+        const TSNHTResult &result = results[i];
+        QList<QString> referenceIdList;
+        for (unsigned int j = 0; j < result.referenceIndexes.size(); j++)
+        {
+            referenceIdList << QString::fromStdString(stations[unsigned(result.referenceIndexes[j])].id);
+        }
+
+        outStream << QString::fromStdString(stations[i].id) << ",";
+        if (result.tMax == NODATA)
+        {
+            outStream << NODATA << "," << NODATA << "," << NODATA << "," << NODATA << ",";
+        }
+        else
+        {
+            int discontinuityYear = result.isHomogeneous ? NODATA : firstYear + result.indexTMax;
+            outStream << int(result.isHomogeneous) << "," << discontinuityYear << ","
+                      << QString::number(result.tMax, 'f', 3) << "," << result.t95 << ",";
+        }
+        outStream << referenceIdList.join(";") << "\n";
+    }
+    outputFile.close();
+
+    return true;
+}
+
+
+void PragaProject::showSynchronicityTestWidgetPoint(std::string idMeteoPoint)
+{
+    logInfoGUI("Loading data...");
+
+    // check dates
+    QDate firstDaily = meteoPointsDbHandler->getFirstDate(daily, idMeteoPoint).date();
+    QDate lastDaily = meteoPointsDbHandler->getLastDate(daily, idMeteoPoint).date();
+    bool hasDailyData = !(firstDaily.isNull() || lastDaily.isNull());
+
+    if (!hasDailyData)
     {
         logInfoGUI("No daily data.");
         return;
@@ -3992,6 +4092,178 @@ void PragaProject::showPointStatisticsWidgetGrid(std::string id)
         return true;
     }
 
+    /*!
+     * \brief exportPhenologyGridToNetCDF
+     * writes the daily stage maps computed by computePhenologyGrid (one time slice for each day)
+     */
+    bool PragaProject::exportPhenologyGridToNetCDF(QString fileName, QString title, phenoScale scale, const QDate &firstDate,
+                                                   int nrDays, const std::vector<float> &phenoValues)
+    {
+        if (! checkMeteoGridForExport()) return false;
+
+        Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
+        int nrRows = meteoGrid->gridStructure().header().nrRows;
+        int nrCols = meteoGrid->gridStructure().header().nrCols;
+        if (phenoValues.size() != size_t(nrRows) * nrCols * nrDays)
+        {
+            errorString = "Wrong size of phenology data";
+            return false;
+        }
+
+        NetCDFHandler netcdfSeries;
+        if (! netcdfSeries.createNewFile(fileName.toStdString()))
+        {
+            logError("Wrong filename: " + fileName);
+            return false;
+        }
+
+        std::string variableName = (scale == BBCH) ? "BBCH stage" : "phenological stage";
+        if (! netcdfSeries.writeMetadataTimeSeries(meteoGridDbHandler->gridStructure().header(), title.toStdString(),
+                                                   variableName, "", getCrit3DDate(firstDate), false, 1,
+                                                   NETCDF_CHUNK_LATLON_DEFAULT, NETCDF_CHUNK_LATLON_DEFAULT, 1))
+        {
+            logError("Error in writing NetCDF metadata.");
+            netcdfSeries.close();
+            return false;
+        }
+
+        Crit3DDate myDate = getCrit3DDate(firstDate);
+        for (int day = 0; day < nrDays; day++)
+        {
+            for (int row = 0; row < nrRows; row++)
+            {
+                for (int col = 0; col < nrCols; col++)
+                {
+                    meteoGrid->meteoPointPointer(row, col)->elaboration = phenoValues[(size_t(row) * nrCols + col) * nrDays + day];
+                }
+            }
+            meteoGrid->fillMeteoRasterElabValue();
+
+            if (! netcdfSeries.appendTimeSlice(meteoGrid->dataMeteoGrid, Crit3DTime(myDate, 0)))
+            {
+                logError("Error in writing data: " + QString::fromStdString(myDate.toISOString()));
+                netcdfSeries.close();
+                return false;
+            }
+            ++myDate;
+        }
+
+        netcdfSeries.close();
+
+        return true;
+    }
+
+
+    /*!
+     * \brief exportMeteoGridSeriesToNetCDF
+     * writes a daily or hourly series of the meteo grid in a single NetCDF-4 file (unlimited time dimension)
+     * one time slice at a time: if loadData is true, the grid data are loaded from DB in blocks of nrDaysLoading days,
+     * otherwise the data already in memory are used (e.g. the output of interpolationMeteoGrid)
+     */
+    bool PragaProject::exportMeteoGridSeriesToNetCDF(QString fileName, meteoVariable myVar, QDate firstDate, QDate lastDate,
+                                                     bool loadData, int nrDaysLoading, int chunkTime, int chunkLatLon, int deflateLevel)
+    {
+        if (! checkMeteoGridForExport()) return false;
+
+        frequencyType freq = getVarFrequency(myVar);
+        if (freq != daily && freq != hourly)
+        {
+            errorString = "Wrong variable: " + QString::fromStdString(getMeteoVarName(myVar));
+            return false;
+        }
+
+        if (firstDate.isNull() || lastDate.isNull() || firstDate > lastDate)
+        {
+            errorString = "Wrong period";
+            return false;
+        }
+
+        if (nrDaysLoading == NODATA || nrDaysLoading <= 0)
+        {
+            nrDaysLoading = firstDate.daysTo(lastDate) + 1;
+        }
+
+        bool isHourlySeries = (freq == hourly);
+        gis::Crit3DLatLonHeader latLonHeader = meteoGridDbHandler->gridStructure().header();
+
+        NetCDFHandler netcdfSeries;
+        if (! netcdfSeries.createNewFile(fileName.toStdString()))
+        {
+            logError("Wrong filename: " + fileName);
+            return false;
+        }
+
+        // chunk: chunkTime time steps of a spatial tile of chunkLatLon x chunkLatLon cells
+        if (! netcdfSeries.writeMetadataTimeSeries(latLonHeader, "MeteoGrid", getMeteoVarName(myVar), getUnitFromVariable(myVar),
+                                                   getCrit3DDate(firstDate), isHourlySeries, chunkTime, chunkLatLon, chunkLatLon, deflateLevel))
+        {
+            logError("Error in writing NetCDF metadata.");
+            netcdfSeries.close();
+            return false;
+        }
+
+        Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
+        QDate loadLastDate = firstDate.addDays(-1);
+        QDate myDate = firstDate;
+
+        while (myDate <= lastDate)
+        {
+            if (loadData && myDate > loadLastDate)
+            {
+                loadLastDate = std::min(myDate.addDays(nrDaysLoading-1), lastDate);
+                logInfoGUI("Loading grid data: " + myDate.toString("yyyy-MM-dd") + "-" + loadLastDate.toString("yyyy-MM-dd"));
+
+                bool isLoaded;
+                if (isHourlySeries)
+                    isLoaded = loadMeteoGridHourlyData(QDateTime(myDate, QTime(1,0), Qt::UTC), QDateTime(loadLastDate.addDays(1), QTime(0,0), Qt::UTC), false);
+                else
+                    isLoaded = loadMeteoGridDailyData(myDate, loadLastDate, false);
+
+                if (! isLoaded)
+                {
+                    errorString = "Error in loading grid data.";
+                    netcdfSeries.close();
+                    return false;
+                }
+            }
+
+            if (isHourlySeries)
+            {
+                for (int myHour = 1; myHour <= 24; myHour++)
+                {
+                    Crit3DTime myTime = getCrit3DTime(myDate, myHour);
+                    meteoGrid->fillCurrentHourlyValue(myTime.date, myTime.getHour(), 0, myVar);
+                    meteoGrid->fillMeteoRaster();
+
+                    if (! netcdfSeries.appendTimeSlice(meteoGrid->dataMeteoGrid, myTime))
+                    {
+                        logError("Error in writing data: " + myDate.toString("yyyy-MM-dd"));
+                        netcdfSeries.close();
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                meteoGrid->fillCurrentDailyValue(getCrit3DDate(myDate), myVar, meteoSettings);
+                meteoGrid->fillMeteoRaster();
+
+                if (! netcdfSeries.appendTimeSlice(meteoGrid->dataMeteoGrid, Crit3DTime(getCrit3DDate(myDate), 0)))
+                {
+                    logError("Error in writing data: " + myDate.toString("yyyy-MM-dd"));
+                    netcdfSeries.close();
+                    return false;
+                }
+            }
+
+            myDate = myDate.addDays(1);
+        }
+
+        netcdfSeries.close();
+
+        return true;
+    }
+
     bool PragaProject::exportXMLElabGridToNetcdf(QString xmlName)
     {
         QString xmlPath = QFileInfo(xmlName).absolutePath()+"/";
@@ -4315,7 +4587,44 @@ void PragaProject::showPointStatisticsWidgetGrid(std::string id)
 
         for (unsigned int i = 0; i<listXMLPhenology->listAll().size(); i++)
         {
-            // TO DO
+            if (listXMLPhenology->listComputation()[i] != currentStage)
+            {
+                logWarning("Phenology: computation not available " + listXMLPhenology->listAll()[i]);
+                continue;
+            }
+
+            QDate dateStart = listXMLPhenology->listDateStart()[i];
+            QDate dateEnd = listXMLPhenology->listDateEnd()[i];
+            std::vector<float> phenoValues;
+            if (! computePhenologyGrid(listXMLPhenology->listCrop()[i], listXMLPhenology->listVariety()[i],
+                                      listXMLPhenology->listVernalization()[i], listXMLPhenology->listScale()[i],
+                                      dateStart, dateEnd, phenoValues))
+            {
+                logInfo("Warning: couldn't compute " + listXMLPhenology->listAll()[i]);
+                continue;
+            }
+
+            QString netcdfName;
+            QString netcdfTitle;
+            if (listXMLPhenology->listFileName().size() <= i || listXMLPhenology->listFileName()[i].isEmpty())
+            {
+                netcdfTitle = "PHENO_" + listXMLPhenology->listAll()[i];
+                netcdfName = xmlPath + "PHENO_" + listXMLPhenology->listAll()[i] + ".nc";
+            }
+            else
+            {
+                netcdfTitle = listXMLPhenology->listFileName()[i];
+                netcdfName = xmlPath + listXMLPhenology->listFileName()[i] + ".nc";
+            }
+
+            int nrDays = int(dateStart.daysTo(dateEnd)) + 1;
+            if (! exportPhenologyGridToNetCDF(netcdfName, netcdfTitle, listXMLPhenology->listScale()[i], dateStart, nrDays, phenoValues))
+            {
+                logInfo("Warning: couldn't export " + netcdfName + "to NetCDF");
+                continue;
+            }
+
+            logInfo("Export of " + netcdfName + " successful");
         }
 
         delete listXMLElab;
@@ -4363,7 +4672,7 @@ bool PragaProject::loadXMLImportData(QString fileName)
     }
 
     errorString = "";
-    if (! inOutData->importDataMain(fileName, errorString))
+    if (! inOutData->importDataMain(fileName, isParallelComputing(), errorString))
     {
         logError();
         return false;
@@ -4778,29 +5087,18 @@ bool PragaProject::monthlyAggregateVariablesGrid(const QDate &firstDate, const Q
         }
     }
 
-    int stepInfo;
     if (showInfo)
     {
-        stepInfo = setProgressBar("Compute monthly data...", meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows);
+        logInfoGUI("Compute monthly data...");
     }
 
-    for (int row = 0; row < meteoGridDbHandler->meteoGrid()->gridStructure().header().nrRows; row++)
-    {
-        if (showInfo)
-        {
-            if ((row % stepInfo) == 0) updateProgressBar(row);
-        }
-        for (int col = 0; col < meteoGridDbHandler->meteoGrid()->gridStructure().header().nrCols; col++)
-        {
-            if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active)
-            {
-                monthlyAggregateDataSingleCell(meteoGridDbHandler, row, col, firstDate, lastDate, dailyMeteoVar,
-                                           meteoSettings, quality, &climateParameters, errorString);
-            }
-        }
-    }
+    bool isOk = monthlyAggregateDataGrid(meteoGridDbHandler, firstDate, lastDate, dailyMeteoVar, meteoSettings,
+                                         quality, &climateParameters, isParallelComputing(), errorString);
 
-    if (showInfo) closeProgressBar();
+    if (showInfo) closeLogInfo();
+
+    if (! isOk)
+        return false;
 
     meteoGridDbHandler->updateMeteoGridDate(errorString);
 
@@ -4808,6 +5106,35 @@ bool PragaProject::monthlyAggregateVariablesGrid(const QDate &firstDate, const Q
 }
 
 
+// monthly aggregation of the whole months touched by the daily data saved on the grid since the last aggregation
+bool PragaProject::monthlyAggregateUpdatedGrid(QList<meteoVariable> &variablesList, bool showInfo)
+{
+    if (! meteoGridLoaded)
+    {
+        errorString = "No meteo grid";
+        return false;
+    }
+
+    QDate firstDate, lastDate;
+    if (! meteoGridDbHandler->getUpdatedDailyPeriod(firstDate, lastDate, errorString))
+        return false;
+
+    if (! firstDate.isValid() || ! lastDate.isValid())
+    {
+        logInfo("No updated daily data.");
+        return true;
+    }
+
+    firstDate.setDate(firstDate.year(), firstDate.month(), 1);
+    lastDate.setDate(lastDate.year(), lastDate.month(), lastDate.daysInMonth());
+
+    if (! monthlyAggregateVariablesGrid(firstDate, lastDate, variablesList, showInfo))
+        return false;
+
+    return meteoGridDbHandler->clearUpdatedDailyPeriod(errorString);
+}
+
+
 bool PragaProject::computeDroughtIndexGrid(droughtIndex index, int firstYear, int lastYear, QDate refDate, int timescale, meteoVariable myVar)
 {
     // check meteo grid
@@ -4900,6 +5227,120 @@ bool PragaProject::computeDroughtIndexGrid(droughtIndex index, int firstYear, in
 }
 
 
+/*!
+ * \brief computePhenologyGrid
+ * runs the phenology model of a crop/variety on every active cell of the meteo grid (daily data from firstDate),
+ * cells are computed in parallel without log file
+ * phenoValues: stage of each cell and day, index = (row * nrCols + col) * nrDays + day
+ */
+bool PragaProject::computePhenologyGrid(phenoCrop crop, phenoVariety variety, int vernalization, phenoScale scale,
+                                        const QDate &firstDate, const QDate &lastDate, std::vector<float> &phenoValues)
+{
+    phenoValues.clear();
+
+    if (! meteoGridLoaded)
+    {
+        logError(ERROR_STR_MISSING_GRID);
+        return false;
+    }
+
+    if (crop == invalidCrop || ! firstDate.isValid() || ! lastDate.isValid() || firstDate > lastDate)
+    {
+        logError("Wrong phenology parameters");
+        return false;
+    }
+
+    logInfoGUI("Load daily grid data...");
+    bool isLoaded = loadMeteoGridDailyData(firstDate, lastDate, false);
+    closeLogInfo();
+    if (! isLoaded)
+    {
+        logError("Error in loading grid data.");
+        return false;
+    }
+
+    Parametri parametri;
+    parametri.coltura = int(crop);
+    parametri.varieta = int(variety);
+    parametri.sogliaVernalizzazione = float(vernalization);
+    parametri.scalaBBCH = (scale == BBCH) ? 1 : 0;
+    parametri.dato_mancante = NODATA;
+    parametri.max_giorni_interpolazione = PHENOLOGY_GRID_MAX_INTERPOLATION_DAYS;
+    parametri.dataInizio = getCrit3DDate(firstDate);
+    parametri.numeroGiorni = int(firstDate.daysTo(lastDate)) + 1;
+
+    Crit3DMeteoGrid* meteoGrid = meteoGridDbHandler->meteoGrid();
+    int nrRows = meteoGrid->gridStructure().header().nrRows;
+    int nrCols = meteoGrid->gridStructure().header().nrCols;
+    int nrDays = parametri.numeroGiorni;
+
+    phenoValues.resize(size_t(nrRows) * nrCols * nrDays, NODATA);
+
+    int nrValidCells = 0;
+    int nrFailedCells = 0;
+    int nrWarningCells = 0;
+    std::string firstLog;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:nrValidCells, nrFailedCells, nrWarningCells) if(isParallelComputing())
+    for (int row = 0; row < nrRows; row++)
+    {
+        std::vector<float> tmin(nrDays), tmax(nrDays), prec(nrDays), values;
+        std::string cellLog;
+
+        for (int col = 0; col < nrCols; col++)
+        {
+            const Crit3DMeteoPoint* cell = meteoGrid->meteoPointPointer(row, col);
+            if (! cell->active)
+                continue;
+
+            Crit3DDate myDate = parametri.dataInizio;
+            for (int day = 0; day < nrDays; day++)
+            {
+                tmin[day] = cell->getMeteoPointValueD(myDate, dailyAirTemperatureMin);
+                tmax[day] = cell->getMeteoPointValueD(myDate, dailyAirTemperatureMax);
+                prec[day] = cell->getMeteoPointValueD(myDate, dailyPrecipitation);
+                ++myDate;
+            }
+
+            cellLog.clear();
+            if (! computePhenologySeries(parametri, cell->latitude, int(cell->point.z), tmin, tmax, prec, values, &cellLog))
+            {
+                nrFailedCells++;
+                continue;
+            }
+
+            if (! cellLog.empty())
+            {
+                nrWarningCells++;
+                #pragma omp critical
+                {
+                    if (firstLog.empty())
+                        firstLog = cell->id + ": " + cellLog;
+                }
+            }
+
+            std::copy(values.begin(), values.end(), phenoValues.begin() + (size_t(row) * nrCols + col) * nrDays);
+            nrValidCells++;
+        }
+    }
+
+    if (nrFailedCells > 0 || nrWarningCells > 0)
+    {
+        logWarning("Phenology: " + QString::number(nrFailedCells) + " failed cells, "
+                   + QString::number(nrWarningCells) + " computed cells with warnings\n"
+                   + QString::fromStdString(firstLog));
+    }
+
+    if (nrValidCells == 0)
+    {
+        logError("Missing data.");
+        return false;
+    }
+
+    return true;
+}
+
+
 // assume che sia stato caricato un progetto con solo aggregationDb
 bool PragaProject::computeDroughtIndexPoint(droughtIndex index, int timescale, int refYearStart, int refYearEnd)
 {
@@ -5172,22 +5613,22 @@ bool PragaProject::activeMeteoGridCellsWithDEM()
         for (int col = 0; col < this->meteoGridDbHandler->gridStructure().header().nrCols; col++)
         {
             meteoGridDbHandler->meteoGrid()->assignCellAggregationPoints(row, col, &DEM, excludeNoData);
-            if (meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->aggregationPointsMaxNr == 0)
+            if (meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->aggregationPointsMaxNr == 0)
             {
-                idNotActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id));
-                meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active = false;
+                idNotActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id));
+                meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active = false;
             }
             else
             {
-                if ((float)meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->aggregationPoints.size() / (float)meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->aggregationPointsMaxNr > minCoverage/100.0)
+                if ((float)meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->aggregationPoints.size() / (float)meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->aggregationPointsMaxNr > minCoverage/100.0)
                 {
-                    idActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active = true;
+                    idActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active = true;
                 }
                 else
                 {
-                    idNotActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->id));
-                    meteoGridDbHandler->meteoGrid()->meteoPoints()[row][col]->active = false;
+                    idNotActiveList.append(QString::fromStdString(meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->id));
+                    meteoGridDbHandler->meteoGrid()->meteoPointPointer(row, col)->active = false;
                 }
             }
         }
@@ -5399,11 +5840,14 @@ bool PragaProject::computeClimatePointXML(QString xmlName)
 
     clima->getListElab()->setListClimateElab(listXMLElab->listAll());
     int validCell = 0;
-    bool changeDataSet = true;
     QDate startDate;
     QDate endDate;
     Crit3DMeteoPoint* meteoPointTemp = new Crit3DMeteoPoint;
 
+    // elaborations on the same series share one data load
+    std::vector<TClimateElabGroup> elabGroups;
+    planElaborationList(*listXMLElab, elabGroups);
+
     for (int i = 0; i < meteoPoints.size(); i++)
     {
         if (meteoPoints[i].active)
@@ -5411,75 +5855,46 @@ bool PragaProject::computeClimatePointXML(QString xmlName)
             meteoPointTemp->id = meteoPoints[i].id;
             meteoPointTemp->point.z = meteoPoints[i].point.z;
             meteoPointTemp->latitude = meteoPoints[i].latitude;
-            changeDataSet = true;
 
-            std::vector<float> outputValues;
-            for (int i = 0; i<listXMLElab->listAll().size(); i++)
-            {
-                clima->setDailyCumulated(listXMLElab->listDailyCumulated()[i]);
-                clima->setClimateElab(listXMLElab->listAll()[i]);
-                clima->setVariable(listXMLElab->listVariable()[i]);
-                clima->setYearStart(listXMLElab->listYearStart()[i]);
-                clima->setYearEnd(listXMLElab->listYearEnd()[i]);
-                clima->setPeriodStr(listXMLElab->listPeriodStr()[i]);
-                clima->setPeriodType(listXMLElab->listPeriodType()[i]);
-
-                clima->setGenericPeriodDateStart(listXMLElab->listDateStart()[i]);
-                clima->setGenericPeriodDateEnd(listXMLElab->listDateEnd()[i]);
-                clima->setNYears(listXMLElab->listNYears()[i]);
-                clima->setElab1(listXMLElab->listElab1()[i]);
-
-                //if (! clima->dailyCumulated()) //offset doesn't matter for non cumlated variables
-                    //clima->setOffset(0);
-                //else
-                    clima->setOffset(listXMLElab->listOffset()[i]);
-
-                if (!listXMLElab->listParam1IsClimate()[i])
-                {
-                    clima->setParam1IsClimate(false);
-                    clima->setParam1(listXMLElab->listParam1()[i]);
-                }
-                else
+            for (unsigned int g = 0; g < elabGroups.size(); g++)
+            {
+                std::vector<float> outputValues;
+                bool changeDataSet = true;
+
+                for (unsigned int k = 0; k < elabGroups[g].elabIndex.size(); k++)
                 {
-                    clima->setParam1IsClimate(true);
-                    clima->setParam1ClimateField(listXMLElab->listParam1ClimateField()[i]);
-                    int climateIndex = getClimateIndexFromElab(listXMLElab->listDateStart()[i], listXMLElab->listParam1ClimateField()[i]);
-                    clima->setParam1ClimateIndex(climateIndex);
+                    setClimateFromElabList(*listXMLElab, elabGroups[g].elabIndex[k], clima);
 
-                }
-                clima->setElab2(listXMLElab->listElab2()[i]);
-                clima->setParam2(listXMLElab->listParam2()[i]);
+                    // the first elaboration of the group loads the whole envelope
+                    if (changeDataSet)
+                    {
+                        startDate = elabGroups[g].firstDate;
+                        endDate = elabGroups[g].lastDate;
+                    }
+                    else
+                    {
+                        getClimatePeriodDates(clima->periodType(), clima->yearStart(), clima->yearEnd(),
+                                              clima->genericPeriodDateStart(), clima->genericPeriodDateEnd(),
+                                              clima->nYears(), clima->offset(), startDate, endDate);
+                    }
 
-                if (clima->periodType() == genericPeriod)
-                {
-                    startDate.setDate(clima->yearStart(), clima->genericPeriodDateStart().month(), clima->genericPeriodDateStart().day());
-                    endDate.setDate(clima->yearEnd() + clima->nYears(), clima->genericPeriodDateEnd().month(), clima->genericPeriodDateEnd().day());
-                }
-                else if (clima->periodType() == seasonalPeriod)
-                {
-                    startDate.setDate(clima->yearStart() -1, 12, 1);
-                    endDate.setDate(clima->yearEnd(), 12, 31);
-                }
-                else
-                {
-                    startDate.setDate(clima->yearStart(), 1, 1);
-                    endDate.setDate(clima->yearEnd(), 12, 31);
-                    if (clima->offset() != 0) //if period != daily, offset is always 0
+                    if (climateOnPoint(errorString, meteoPointsDbHandler, nullptr, clima, meteoPointTemp,
+                                       outputValues, listXMLElab->isMeteoGrid(), startDate, endDate, changeDataSet, meteoSettings))
                     {
-                        startDate = startDate.addDays(clima->offset());
-                        endDate = endDate.addDays(clima->offset());
+                        validCell = validCell + 1;
                     }
-                }
 
-                if (climateOnPoint(errorString, meteoPointsDbHandler, nullptr, clima, meteoPointTemp,
-                                   outputValues, listXMLElab->isMeteoGrid(), startDate, endDate, changeDataSet, meteoSettings))
-                {
-                    validCell = validCell + 1;
+                    if (changeDataSet)
+                    {
+                        clima->setCurrentYearStart(elabGroups[g].yearStart);
+                        clima->setCurrentYearEnd(elabGroups[g].yearEnd);
+                    }
+                    changeDataSet = false;
+
+                    // reset param
+                    clima->resetParam();
                 }
-                changeDataSet = false;
 
-                // reset param
-                clima->resetParam();
                 // reset current values
                 clima->resetCurrentValues();
             }
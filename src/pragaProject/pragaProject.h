@@ -3,6 +3,13 @@
 
     #define PRAGAVERSION "PRAGA v2.1.5 (2026)"
 
+    // days of data loaded for each block of the zone aggregation
+    #define ZONE_AGGREGATION_BLOCK_DAYS 1830
+    #define ZONE_AGGREGATION_BLOCK_DAYS_HOURLY 62
+
+    // phenology grid: missing daily data are not interpolated (grid data are already spatially complete)
+    #define PHENOLOGY_GRID_MAX_INTERPOLATION_DAYS 0
+
     #ifndef CRIT3DCLIMATE_H
         #include "crit3dClimate.h"
     #endif
@@ -27,6 +34,10 @@
         #include "drought.h"
     #endif
 
+    #ifndef FENOLOGIA_H
+        #include "fenologia.h"
+    #endif
+
     #ifndef POINTSTATISTICSWIDGET_H
         #include "pointStatisticsWidget.h"
     #endif
@@ -155,12 +166,17 @@
         bool loadXMLExportData(QString code, QDateTime myFirstTime, QDateTime myLastTime);
         bool loadXMLExportDataGrid(QString code, QDateTime myFirstTime, QDateTime myLastTime);
         bool monthlyAggregateVariablesGrid(const QDate &firstDate, const QDate &lastDate, QList <meteoVariable> &variablesList, bool showInfo);
+        bool monthlyAggregateUpdatedGrid(QList <meteoVariable> &variablesList, bool showInfo);
         bool computeDroughtIndexGrid(droughtIndex index, int firstYear, int lastYear, QDate date, int timescale, meteoVariable myVar);
         bool computeDroughtIndexPoint(droughtIndex index, int timescale, int refYearStart, int refYearEnd);
+        bool computePhenologyGrid(phenoCrop crop, phenoVariety variety, int vernalization, phenoScale scale,
+                                  const QDate &firstDate, const QDate &lastDate, std::vector<float> &phenoValues);
         bool computeDroughtIndexPointGUI(droughtIndex index, int timescale, int refYearStart, int refYearEnd, QDate myDate);
         void showPointStatisticsWidgetPoint(std::string idMeteoPoint);
         void showHomogeneityTestWidgetPoint(const std::string &idMeteoPoint);
         void showSynchronicityTestWidgetPoint(std::string idMeteoPoint);
+        bool computeHomogeneityTestPoints(meteoVariable myVar, int firstYear, int lastYear, int nrReferences,
+                                          double maxDistance, float minR2, const QString &outputFileName);
         void setSynchronicityReferencePoint(std::string idMeteoPoint);
         void showPointStatisticsWidgetGrid(std::string id);
         bool activeMeteoGridCellsWithDEM();
@@ -174,16 +190,12 @@
         bool computeRadiationList(const QString &fileName, QString folderString);
 
         bool dailyZoneAggregationMeteoGrid(meteoVariable variable, const QString& aggregationString, float threshold,
-                                           gis::Crit3DRasterGrid* zoneGrid, std::vector<int> &idZoneVector, std::vector<float> &outputSeries,
-                                           std::vector<std::vector<int>> &indexRowCol,
-                                           std::vector<std::vector<int>> &meteoGridRow, std::vector<std::vector<int>> &meteoGridcol,
-                                           const Crit3DDate& startDate, int nrDays, bool showInfo);
+                                           const std::vector<int> &idZoneVector, const TZoneIndex &zoneSeries,
+                                           const std::vector<float> &outputSeries, const Crit3DDate& startDate, int nrDays);
 
         bool hourlyZoneAggregationMeteoGrid(meteoVariable variable, const QString& aggregationString, float threshold,
-                                           gis::Crit3DRasterGrid* zoneRaster, std::vector<int> &idZoneVector, std::vector<float> &outputSeries,
-                                           std::vector<std::vector<int>> &indexRowCol,
-                                           std::vector<std::vector<int>> &meteoGridRow, std::vector<std::vector<int>> &meteoGridcol,
-                                           const Crit3DDate& startDate, int nrDays, bool showInfo);
+                                            const std::vector<int> &idZoneVector, const TZoneIndex &zoneSeries,
+                                            const std::vector<float> &outputSeries, const Crit3DDate& startDate, int nrDays);
 
         bool shiftMeteoPointsData(bool isAllPoints);
 
@@ -192,6 +204,10 @@
         #ifdef NETCDF
                 bool exportMeteoGridToNetCDF(QString fileName, QString title, QString variableName, std::string variableUnit, Crit3DDate myDate, int nDays, int refYearStart, int refYearEnd);
                 bool exportXMLElabGridToNetcdf(QString xmlName);
+                bool exportPhenologyGridToNetCDF(QString fileName, QString title, phenoScale scale, const QDate &firstDate,
+                                                 int nrDays, const std::vector<float> &phenoValues);
+                bool exportMeteoGridSeriesToNetCDF(QString fileName, meteoVariable myVar, QDate firstDate, QDate lastDate,
+                                                   bool loadData, int nrDaysLoading, int chunkTime, int chunkLatLon, int deflateLevel);
         #endif
 
     };
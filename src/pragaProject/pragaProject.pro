@@ -38,7 +38,7 @@ INCLUDEPATH +=  ../../agrolib/crit3dDate ../../agrolib/mathFunctions ../../agrol
                 ../../agrolib/netcdfHandler ../../agrolib/graphics ../../agrolib/commonDialogs \
                 ../../agrolib/commonChartElements ../../agrolib/inOutDataXML \
                 ../../agrolib/waterTable ../../agrolib/project \
-                ../drought ../phenology ../climate ../pointStatisticsWidget ../homogeneityWidget \
+                ../drought ../phenology ../climate ../pointStatisticsWidget ../homogeneity ../homogeneityWidget \
                 ../synchronicityWidget ../pragaDialogs
 
 
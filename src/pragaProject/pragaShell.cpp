@@ -3,6 +3,7 @@
 #include "shell.h"
 #include "utilities.h"
 #include "commonConstants.h"
+#include "homogeneity.h"
 #include <QFile>
 #include <QTextStream>
 
@@ -29,9 +30,12 @@ QList<QString> getPragaCommandList()
     cmdList.append("GridMonthlyInt  | GridMonthlyIntegrationVariables");
     cmdList.append("GridExport      | GridRaster");
     cmdList.append("Netcdf          | ExportNetcdf");
+    cmdList.append("NetcdfSeries    | ExportNetcdfSeries");
     cmdList.append("SaveLogProc     | SaveLogProceduresGrid");
     cmdList.append("XMLToNetcdf     | ExportXMLElabToNetcdf");
     cmdList.append("ComputeRadList  | ComputeRadiationList");
+    cmdList.append("Homogeneity     | HomogeneityTestPoints");
+    cmdList.append("SpatialQC       | SpatialQualityControl");
 
     return cmdList;
 }
@@ -144,6 +148,11 @@ int PragaProject::executePragaCommand(QList<QString> argumentList, bool* isComma
         *isCommandFound = true;
         return cmdNetcdfExport(this, argumentList);
     }
+    else if (command == "NETCDFSERIES" || command == "EXPORTNETCDFSERIES")
+    {
+        *isCommandFound = true;
+        return cmdNetcdfSeriesExport(this, argumentList);
+    }
     else if (command == "XMLTONETCDF" || command == "EXPORTXMLELABTONECTD")
     {
         *isCommandFound = true;
@@ -180,6 +189,16 @@ int PragaProject::executePragaCommand(QList<QString> argumentList, bool* isComma
         *isCommandFound = true;
         return cmdComputeRadiationList(this, argumentList);
     }
+    else if (command == "HOMOGENEITY" || command == "HOMOGENEITYTESTPOINTS")
+    {
+        *isCommandFound = true;
+        return cmdHomogeneityTestPoints(this, argumentList);
+    }
+    else if (command == "SPATIALQC" || command == "SPATIALQUALITYCONTROL")
+    {
+        *isCommandFound = true;
+        return cmdSpatialQualityControl(this, argumentList);
+    }
     else
     {
         // other specific Praga commands
@@ -585,6 +604,8 @@ int cmdMonthlyIntegrationVariablesGrid(PragaProject* myProject, QList<QString> a
     QList <meteoVariable> variables;
     QString var;
     meteoVariable meteoVar;
+    bool isUpdatedOnly = false;
+    bool isPeriodSet = false;
 
     for (int i = 1; i < argumentList.size(); i++)
     {
@@ -601,24 +622,47 @@ int cmdMonthlyIntegrationVariablesGrid(PragaProject* myProject, QList<QString> a
         {
             QString dateIniStr = argumentList[i].right(argumentList[i].length()-4);
             first = QDate::fromString(dateIniStr, "dd/MM/yyyy");
+            isPeriodSet = true;
         }
         else if (argumentList.at(i).left(4) == "-d2:")
         {
             QString dateFinStr = argumentList[i].right(argumentList[i].length()-4);
             last = QDate::fromString(dateFinStr, "dd/MM/yyyy");
+            isPeriodSet = true;
+        }
+        else if (argumentList.at(i).left(2) == "-u")
+        {
+            // only the months of the daily data saved since the last integration
+            isUpdatedOnly = true;
         }
 
     }
 
-    if (! first.isValid())
+    if (variables.isEmpty())
     {
-        myProject->errorString = "Wrong initial date";
+        myProject->errorString ="Wrong variable";
         return PRAGA_INVALID_COMMAND;
     }
 
-    if (variables.isEmpty())
+    if (isUpdatedOnly)
     {
-        myProject->errorString ="Wrong variable";
+        if (isPeriodSet)
+        {
+            myProject->errorString = "-u cannot be used with -d1 or -d2: the period is given by the updated daily data";
+            return PRAGA_INVALID_COMMAND;
+        }
+
+        if (! myProject->monthlyAggregateUpdatedGrid(variables, false))
+        {
+            myProject->logError();
+            return PRAGA_ERROR;
+        }
+        return PRAGA_OK;
+    }
+
+    if (! first.isValid())
+    {
+        myProject->errorString = "Wrong initial date";
         return PRAGA_INVALID_COMMAND;
     }
 
@@ -810,6 +854,127 @@ int cmdExportDailyGridToRaster(PragaProject* myProject, QList<QString> argumentL
     return PRAGA_OK;
 }
 
+int cmdHomogeneityTestPoints(PragaProject* myProject, QList<QString> argumentList)
+{
+    meteoVariable meteoVar = noMeteoVar;
+    int firstYear = NODATA;
+    int lastYear = NODATA;
+    int nrReferences = 5;
+    double maxDistance = SNHT_DEFAULT_REFERENCE_MAX_DISTANCE;
+    float minR2 = SNHT_DEFAULT_REFERENCE_MIN_R2;
+    QString outputFileName = "";
+
+    for (int i = 1; i < argumentList.size(); i++)
+    {
+        if (argumentList.at(i).left(3) == "-v:")
+        {
+            QString var = argumentList[i].right(argumentList[i].length()-3);
+            meteoVar = getMeteoVar(var.toStdString());
+        }
+        else if (argumentList.at(i).left(4) == "-y1:")
+        {
+            firstYear = argumentList[i].right(argumentList[i].length()-4).toInt();
+        }
+        else if (argumentList.at(i).left(4) == "-y2:")
+        {
+            lastYear = argumentList[i].right(argumentList[i].length()-4).toInt();
+        }
+        else if (argumentList.at(i).left(3) == "-n:")
+        {
+            nrReferences = argumentList[i].right(argumentList[i].length()-3).toInt();
+        }
+        else if (argumentList.at(i).left(3) == "-d:")
+        {
+            maxDistance = argumentList[i].right(argumentList[i].length()-3).toDouble();
+        }
+        else if (argumentList.at(i).left(4) == "-r2:")
+        {
+            minR2 = argumentList[i].right(argumentList[i].length()-4).toFloat();
+        }
+        else if (argumentList.at(i).left(3) == "-o:")
+        {
+            outputFileName = myProject->getCompleteFileName(argumentList[i].right(argumentList[i].length()-3), PATH_PROJECT);
+        }
+    }
+
+    if (meteoVar == noMeteoVar || getVarFrequency(meteoVar) != daily)
+    {
+        myProject->errorString = "Wrong variable";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (firstYear == NODATA || lastYear == NODATA || firstYear > lastYear)
+    {
+        myProject->errorString = "Wrong years";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (nrReferences < 1)
+    {
+        myProject->errorString = "Wrong number of reference stations";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (maxDistance <= 0 || minR2 < 0 || minR2 > 1)
+    {
+        myProject->errorString = "Wrong selection of reference stations: distance must be positive and r2 between 0 and 1";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (outputFileName == "")
+    {
+        myProject->errorString = "Missing output file name";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (! myProject->computeHomogeneityTestPoints(meteoVar, firstYear, lastYear, nrReferences, maxDistance, minR2, outputFileName))
+        return PRAGA_ERROR;
+
+    return PRAGA_OK;
+}
+
+
+int cmdSpatialQualityControl(PragaProject* myProject, QList<QString> argumentList)
+{
+    meteoVariable meteoVar = noMeteoVar;
+    QDate firstDate, lastDate;
+
+    for (int i = 1; i < argumentList.size(); i++)
+    {
+        if (argumentList.at(i).left(3) == "-v:")
+        {
+            QString var = argumentList[i].right(argumentList[i].length()-3);
+            meteoVar = getMeteoVar(var.toStdString());
+        }
+        else if (argumentList.at(i).left(4) == "-d1:")
+        {
+            firstDate = QDate::fromString(argumentList[i].right(argumentList[i].length()-4), "dd/MM/yyyy");
+        }
+        else if (argumentList.at(i).left(4) == "-d2:")
+        {
+            lastDate = QDate::fromString(argumentList[i].right(argumentList[i].length()-4), "dd/MM/yyyy");
+        }
+    }
+
+    if (meteoVar == noMeteoVar)
+    {
+        myProject->errorString = "Wrong variable";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (! firstDate.isValid() || ! lastDate.isValid() || firstDate > lastDate)
+    {
+        myProject->errorString = "Wrong dates";
+        return PRAGA_INVALID_COMMAND;
+    }
+
+    if (! myProject->computeSpatialQualityFlags(meteoVar, firstDate, lastDate))
+        return PRAGA_ERROR;
+
+    return PRAGA_OK;
+}
+
+
 #ifdef NETCDF
     int cmdDroughtIndexGrid(PragaProject* myProject, QList<QString> argumentList)
     {
@@ -982,6 +1147,84 @@ int cmdGridAggregationOnZones(PragaProject* myProject, QList<QString> argumentLi
         return PRAGA_OK;
     }
 
+    int cmdNetcdfSeriesExport(PragaProject* myProject, QList<QString> argumentList)
+    {
+        if (argumentList.size() < 2)
+        {
+            myProject->errorString = "Missing netcdf name";
+            return PRAGA_INVALID_COMMAND;
+        }
+
+        QString netcdfName = myProject->getCompleteFileName(argumentList.at(1), PATH_PROJECT);
+
+        QDate dateIni, dateFin;
+        meteoVariable meteoVar = noMeteoVar;
+        int nrDaysLoading = 365;
+        int chunkTime = 1;
+        int chunkLatLon = NETCDF_CHUNK_LATLON_DEFAULT;
+        int deflateLevel = 1;
+        bool isOk = true;
+
+        for (int i = 2; i < argumentList.size(); i++)
+        {
+            if (argumentList.at(i).left(3) == "-v:")
+            {
+                QString var = argumentList[i].right(argumentList[i].length()-3);
+                meteoVar = getMeteoVar(var.toStdString());
+            }
+            else if (argumentList.at(i).left(4) == "-d1:")
+            {
+                dateIni = QDate::fromString(argumentList[i].right(argumentList[i].length()-4), "dd/MM/yyyy");
+            }
+            else if (argumentList.at(i).left(4) == "-d2:")
+            {
+                dateFin = QDate::fromString(argumentList[i].right(argumentList[i].length()-4), "dd/MM/yyyy");
+            }
+            else if (argumentList.at(i).left(3) == "-l:")
+            {
+                nrDaysLoading = argumentList[i].right(argumentList[i].length()-3).toInt(&isOk);
+            }
+            else if (argumentList.at(i).left(3) == "-c:")
+            {
+                chunkTime = argumentList[i].right(argumentList[i].length()-3).toInt(&isOk);
+            }
+            else if (argumentList.at(i).left(3) == "-s:")
+            {
+                chunkLatLon = argumentList[i].right(argumentList[i].length()-3).toInt(&isOk);
+            }
+            else if (argumentList.at(i).left(3) == "-z:")
+            {
+                deflateLevel = argumentList[i].right(argumentList[i].length()-3).toInt(&isOk);
+            }
+
+            if (! isOk)
+            {
+                myProject->errorString = "Wrong parameter: " + argumentList.at(i);
+                return PRAGA_INVALID_COMMAND;
+            }
+        }
+
+        if (meteoVar == noMeteoVar)
+        {
+            myProject->errorString = "Wrong variable";
+            return PRAGA_INVALID_COMMAND;
+        }
+
+        if (! dateIni.isValid() || ! dateFin.isValid())
+        {
+            myProject->errorString = "Wrong period";
+            return PRAGA_INVALID_COMMAND;
+        }
+
+        if (! myProject->exportMeteoGridSeriesToNetCDF(netcdfName, meteoVar, dateIni, dateFin, true, nrDaysLoading,
+                                                      chunkTime, chunkLatLon, deflateLevel))
+        {
+            return PRAGA_ERROR;
+        }
+
+        return PRAGA_OK;
+    }
+
     int cmdExportXMLElabToNetcdf(PragaProject* myProject, QList<QString> argumentList)
     {
         if (argumentList.size() < 2)
@@ -23,10 +23,13 @@
     int cmdDroughtIndexPoint(PragaProject* myProject, QList<QString> argumentList);
     int cmdSaveLogDataProceduresGrid(PragaProject* myProject, QList<QString> argumentList);
     int cmdComputeRadiationList(PragaProject* myProject, QList<QString> argumentList);
+    int cmdHomogeneityTestPoints(PragaProject* myProject, QList<QString> argumentList);
+    int cmdSpatialQualityControl(PragaProject* myProject, QList<QString> argumentList);
 
     #ifdef NETCDF
         int cmdDroughtIndexGrid(PragaProject* myProject, QList<QString> argumentList);
         int cmdNetcdfExport(PragaProject* myProject, QList<QString> argumentList);
+        int cmdNetcdfSeriesExport(PragaProject* myProject, QList<QString> argumentList);
         int cmdExportXMLElabToNetcdf(PragaProject* myProject, QList<QString> argumentList);
     #endif
 
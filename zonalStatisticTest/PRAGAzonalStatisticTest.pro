@@ -0,0 +1,45 @@
+#---------------------------------------------------------
+#
+#   PRAGAzonalStatisticTest
+#   test of zonalStatisticsRaster (serial and parallel):
+#   the zone values are compared with a reference computation on synthetic rasters
+#   This project is part of ARPA-SIMC/PRAGA distribution
+#
+#---------------------------------------------------------
+
+QT  -= core gui
+
+TARGET = PRAGAzonalStatisticTest
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++17
+
+INCLUDEPATH +=  ../agrolib/crit3dDate ../agrolib/mathFunctions ../agrolib/gis \
+                ../agrolib/shapeHandler ../agrolib/shapeHandler/shapelib ../agrolib/shapeUtilities
+
+CONFIG += debug_and_release
+
+# parallel computing settings
+include($$absolute_path(../agrolib/parallel.pri))
+
+
+CONFIG(debug, debug|release) {
+    LIBS += -L../agrolib/shapeUtilities/debug -lshapeUtilities
+    LIBS += -L../agrolib/shapeHandler/debug -lshapeHandler
+    LIBS += -L../agrolib/gis/debug -lgis
+    LIBS += -L../agrolib/crit3dDate/debug -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/debug -lmathFunctions
+
+} else {
+    LIBS += -L../agrolib/shapeUtilities/release -lshapeUtilities
+    LIBS += -L../agrolib/shapeHandler/release -lshapeHandler
+    LIBS += -L../agrolib/gis/release -lgis
+    LIBS += -L../agrolib/crit3dDate/release -lcrit3dDate
+    LIBS += -L../agrolib/mathFunctions/release -lmathFunctions
+}
+
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,285 @@
+/*!
+ * PRAGAzonalStatisticTest
+ * test of zonalStatisticsRaster (serial and parallel) against a reference computation
+ * that scans the whole zone raster for each zone, on synthetic rasters.
+ * Returns the number of failed cases.
+ */
+
+#include "commonConstants.h"
+#include "basicMath.h"
+#include "statistics.h"
+#include "gis.h"
+#include "zonalStatistic.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+
+// deterministic pseudo random numbers (LCG), independent from the platform
+static unsigned long long randomSeed = 1;
+
+static float nextRandom()
+{
+    randomSeed = randomSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return float((randomSeed >> 33) % 1000000) / 1000000.f;
+}
+
+
+static gis::Crit3DRasterHeader buildHeader(int nrRows, int nrCols)
+{
+    gis::Crit3DRasterHeader header;
+    header.nrRows = nrRows;
+    header.nrCols = nrCols;
+    header.cellSize = 10.;
+    header.invCellSize = 0.1;
+    header.flag = NODATA;
+    header.llCorner.x = 600000.;
+    header.llCorner.y = 4900000.;
+    return header;
+}
+
+
+/*!
+ * \brief buildGrid
+ * values in [minValue, minValue + range) with a nodata ratio, integers if isInteger
+ */
+static void buildGrid(gis::Crit3DRasterGrid &grid, const gis::Crit3DRasterHeader &header, unsigned long long seed,
+                      float nodataRatio, float minValue, float range, bool isInteger)
+{
+    randomSeed = seed;
+    grid.initializeGrid(header);
+
+    for (int row = 0; row < header.nrRows; row++)
+    {
+        for (int col = 0; col < header.nrCols; col++)
+        {
+            if (nextRandom() < nodataRatio)
+                continue;
+
+            float value = minValue + nextRandom() * range;
+            grid.value[row][col] = isInteger ? floor(value) : value;
+        }
+    }
+
+    gis::updateMinMaxRasterGrid(&grid);
+    grid.isLoaded = true;
+}
+
+
+/*!
+ * \brief referenceZonalStatistics
+ * scans the whole raster for each zone: cells with a nodata or negative weight are skipped for all methods
+ */
+static void referenceZonalStatistics(const gis::Crit3DRasterGrid &zoneGrid, int nrZones, const gis::Crit3DRasterGrid &valueGrid,
+                                     const gis::Crit3DRasterGrid *weightGrid, aggregationMethod elab, double threshold,
+                                     std::vector<float> &zoneValues)
+{
+    zoneValues.assign(size_t(nrZones), NODATA);
+
+    for (int zone = 0; zone < nrZones; zone++)
+    {
+        std::vector<float> list;
+        long nrCells = 0;
+        double sumValues = 0;
+        double sumWeights = 0;
+
+        for (int row = 0; row < zoneGrid.header->nrRows; row++)
+        {
+            for (int col = 0; col < zoneGrid.header->nrCols; col++)
+            {
+                if (isEqual(zoneGrid.value[row][col], zoneGrid.header->flag) || int(zoneGrid.value[row][col]) != zone)
+                    continue;
+
+                nrCells++;
+                float value = valueGrid.value[row][col];
+                if (isEqual(value, valueGrid.header->flag))
+                    continue;
+
+                double weight = 1;
+                if (weightGrid != nullptr)
+                {
+                    float w = weightGrid->value[row][col];
+                    if (isEqual(w, weightGrid->header->flag) || w < 0)
+                        continue;
+                    weight = double(w);
+                    sumWeights += weight;
+                }
+
+                sumValues += double(value) * weight;
+                list.push_back(value);
+            }
+        }
+
+        int nrValues = int(list.size());
+        if (nrValues == 0 || double(nrValues) / double(nrCells) < threshold)
+            continue;
+
+        float result = NODATA;
+        switch (elab)
+        {
+            case aggrAverage:
+                if (weightGrid == nullptr)
+                    result = float(sumValues / nrValues);
+                else if (sumWeights > 0)
+                    result = float(sumValues / sumWeights);
+                break;
+            case aggrSum:
+                result = float(sumValues);
+                break;
+            case aggrMin:
+                result = *std::min_element(list.begin(), list.end());
+                break;
+            case aggrMax:
+                result = *std::max_element(list.begin(), list.end());
+                break;
+            case aggrStdDeviation:
+                result = statistics::standardDeviation(list, nrValues);
+                break;
+            case aggrMedian:
+                result = sorting::percentile(list, nrValues, 50, true);
+                break;
+            case aggr95Perc:
+                result = sorting::percentile(list, nrValues, 95, true);
+                break;
+            case aggrPrevailing:
+            {
+                // most frequent value, the smallest one in case of ties
+                std::sort(list.begin(), list.end());
+                int maxCount = 0;
+                for (int i = 0; i < nrValues; i++)
+                {
+                    int count = int(std::count(list.begin(), list.end(), list[size_t(i)]));
+                    if (count > maxCount)
+                    {
+                        maxCount = count;
+                        result = list[size_t(i)];
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        zoneValues[size_t(zone)] = result;
+    }
+}
+
+
+static bool isSameValues(const std::vector<float> &first, const std::vector<float> &second, bool isBitwise, std::string &errorStr)
+{
+    if (first.size() != second.size())
+    {
+        errorStr = "different number of zones";
+        return false;
+    }
+
+    for (size_t i = 0; i < first.size(); i++)
+    {
+        float x = first[i];
+        float y = second[i];
+        bool isSame;
+        if (isBitwise)
+            isSame = (memcmp(&x, &y, sizeof(float)) == 0);
+        else if (isEqual(x, NODATA) || isEqual(y, NODATA))
+            isSame = isEqual(x, y);
+        else
+            isSame = (fabs(x - y) <= 1e-5f * std::max(1.f, fabs(y)));
+
+        if (! isSame)
+        {
+            errorStr = "zone " + std::to_string(i) + ": " + std::to_string(x) + " != " + std::to_string(y);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static int nrFailures = 0;
+
+static void printResult(const std::string &caseName, bool isOk, const std::string &errorStr)
+{
+    if (isOk)
+    {
+        std::cout << "ok      " << caseName << std::endl;
+    }
+    else
+    {
+        std::cout << "FAILED  " << caseName << "  " << errorStr << std::endl;
+        nrFailures++;
+    }
+}
+
+
+static void testZonalStatistics(const gis::Crit3DRasterGrid &zoneGrid, int nrZones, const gis::Crit3DRasterGrid &valueGrid,
+                                const gis::Crit3DRasterGrid *weightGrid, aggregationMethod elab, const std::string &elabName,
+                                double threshold)
+{
+    Crit3DZoneIndex zoneIndex;
+    zoneIndex.build(zoneGrid, nrZones);
+
+    std::vector<float> refValues, serialValues, parallelValues;
+    referenceZonalStatistics(zoneGrid, nrZones, valueGrid, weightGrid, elab, threshold, refValues);
+
+    std::string caseName = elabName + (weightGrid != nullptr ? " weighted" : "") + " threshold " + std::to_string(threshold);
+
+    std::string errorStr;
+    bool isOk = zonalStatisticsRaster(zoneIndex, valueGrid, weightGrid, elab, threshold, serialValues, false, errorStr)
+                && isSameValues(serialValues, refValues, false, errorStr);
+    printResult(caseName + " serial", isOk, errorStr);
+
+    // each zone is computed by a single thread: the parallel result is bitwise identical
+    errorStr = "";
+    isOk = zonalStatisticsRaster(zoneIndex, valueGrid, weightGrid, elab, threshold, parallelValues, true, errorStr)
+           && isSameValues(parallelValues, serialValues, true, errorStr);
+    printResult(caseName + " parallel", isOk, errorStr);
+}
+
+
+int main()
+{
+    const int nrZones = 23;
+    gis::Crit3DRasterHeader header = buildHeader(173, 229);
+
+    // zones with nodata cells, and two zones without cells (nrZones is larger than the zone values)
+    gis::Crit3DRasterGrid zoneGrid, valueGrid, classGrid, weightGrid;
+    buildGrid(zoneGrid, header, 7, 0.05f, 0, float(nrZones - 2), true);
+    buildGrid(valueGrid, header, 19, 0.15f, -10.f, 50.f, false);
+    buildGrid(classGrid, header, 31, 0.15f, 0, 6.f, true);
+    // weights with nodata and negative values (skipped)
+    buildGrid(weightGrid, header, 43, 0.1f, -0.2f, 2.f, false);
+
+    const aggregationMethod methods[] = {aggrAverage, aggrSum, aggrMin, aggrMax, aggrStdDeviation, aggrMedian, aggr95Perc};
+    const std::string methodNames[] = {"average", "sum", "min", "max", "stdDeviation", "median", "95perc"};
+    const double thresholds[] = {0., 0.8};
+
+    for (double threshold : thresholds)
+    {
+        for (int i = 0; i < 7; i++)
+        {
+            testZonalStatistics(zoneGrid, nrZones, valueGrid, nullptr, methods[i], methodNames[i], threshold);
+            testZonalStatistics(zoneGrid, nrZones, valueGrid, &weightGrid, methods[i], methodNames[i], threshold);
+        }
+
+        testZonalStatistics(zoneGrid, nrZones, classGrid, nullptr, aggrPrevailing, "prevailing", threshold);
+        testZonalStatistics(zoneGrid, nrZones, classGrid, &weightGrid, aggrPrevailing, "prevailing", threshold);
+    }
+
+    // different header: error
+    gis::Crit3DRasterGrid otherGrid;
+    buildGrid(otherGrid, buildHeader(100, 100), 59, 0.f, 0, 1.f, false);
+    Crit3DZoneIndex zoneIndex;
+    zoneIndex.build(zoneGrid, nrZones);
+    std::vector<float> zoneValues;
+    std::string errorStr;
+    bool isOk = ! zonalStatisticsRaster(zoneIndex, otherGrid, nullptr, aggrAverage, 0, zoneValues, false, errorStr);
+    printResult("different header", isOk, "no error");
+
+    std::cout << std::endl << nrFailures << " failed cases" << std::endl;
+    return nrFailures;
+}